@@ -0,0 +1,99 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Cost of a light user of a data image: load time, latency of the first calls and resident memory,
+ * compared with preloading all sections, releasing them again and the compiled-in tables.
+ */
+
+#include "config.h"
+#include "xraylib.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef __linux__
+  #include <unistd.h>
+#endif
+
+/* resident set size in MB, negative if unknown */
+static double resident_mb(void) {
+#ifdef __linux__
+	long size, resident;
+	FILE *fp = fopen("/proc/self/statm", "r");
+
+	if (fp == NULL)
+		return -1.0;
+	if (fscanf(fp, "%ld %ld", &size, &resident) != 2)
+		resident = -1;
+	fclose(fp);
+	return resident < 0 ? -1.0 : resident * (double) sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+#else
+	return -1.0;
+#endif
+}
+
+static double light_use(void) {
+	double sum = 0.0;
+	int i;
+
+	for (i = 0 ; i < 100 ; i++)
+		sum += CS_Total(26, 10.0 + i * 0.1, NULL) + LineEnergy(26, KL3_LINE, NULL);
+	return sum;
+}
+
+int main(int argc, char **argv) {
+	xrl_error *error = NULL;
+	double start, load, first, preload;
+	double rss_start, rss_light, rss_all, rss_released, rss_builtin;
+
+	rss_start = resident_mb();
+
+	start = bench_now();
+	if (!XRayLoadDataImage(XRL_DATA_IMAGE, &error)) {
+		fprintf(stderr, "XRayLoadDataImage error: %s\n", error->message);
+		return 1;
+	}
+	load = bench_now() - start;
+
+	start = bench_now();
+	light_use();
+	first = bench_now() - start;
+	rss_light = resident_mb();
+
+	start = bench_now();
+	if (!XRayPreloadDataSections(XRL_DATA_SECTION_ALL, &error)) {
+		fprintf(stderr, "XRayPreloadDataSections error: %s\n", error->message);
+		return 1;
+	}
+	preload = bench_now() - start;
+	rss_all = resident_mb();
+
+	XRayReleaseDataSections(XRL_DATA_SECTION_ALL);
+	rss_released = resident_mb();
+	light_use();
+
+	XRayUnloadDataImage();
+	XRayPreloadDataSections(XRL_DATA_SECTION_ALL, NULL);
+	rss_builtin = resident_mb();
+
+	printf("data sections:\n");
+	printf("  load image:                   %10.3f ms\n", load * 1E3);
+	printf("  first calls (light use):      %10.3f ms\n", first * 1E3);
+	printf("  preload all sections:         %10.3f ms\n", preload * 1E3);
+	printf("  resident at start:            %10.1f MB\n", rss_start);
+	printf("  resident after light use:     %10.1f MB\n", rss_light);
+	printf("  resident with all sections:   %10.1f MB\n", rss_all);
+	printf("  resident after release:       %10.1f MB\n", rss_released);
+	printf("  resident with builtin tables: %10.1f MB\n", rss_builtin);
+
+	return 0;
+}
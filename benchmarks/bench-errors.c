@@ -0,0 +1,71 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Energy scan of the Fe K alpha fluorescence cross section across the K edge:
+ * below the edge every call fails with an error, which is cleared again by the caller.
+ */
+
+#include "config.h"
+#include "xraylib.h"
+#include "xraylib-error-private.h"
+#include "bench.h"
+#include <stdio.h>
+
+#define N_E 100000
+#define N_REPEAT 10
+
+int main(int argc, char **argv) {
+	xrl_error *error = NULL;
+	double start, without, with, allocated, sum = 0.0;
+	int i, repeat, failed = 0;
+
+	start = bench_now();
+	for (repeat = 0 ; repeat < N_REPEAT ; repeat++) {
+		for (i = 0 ; i < N_E ; i++)
+			sum += CS_FluorLine(26, KL3_LINE, 2.0 + i * 10.0 / N_E, NULL);
+	}
+	without = bench_now() - start;
+
+	start = bench_now();
+	for (repeat = 0 ; repeat < N_REPEAT ; repeat++) {
+		for (i = 0 ; i < N_E ; i++) {
+			sum += CS_FluorLine(26, KL3_LINE, 2.0 + i * 10.0 / N_E, &error);
+			if (error != NULL) {
+				failed++;
+				xrl_clear_error(&error);
+			}
+		}
+	}
+	with = bench_now() - start;
+
+	/* what every failure used to cost: a new error with a copy of the message, freed again */
+	start = bench_now();
+	for (repeat = 0 ; repeat < N_REPEAT ; repeat++) {
+		for (i = 0 ; i < N_E ; i++) {
+			double cs = CS_FluorLine(26, KL3_LINE, 2.0 + i * 10.0 / N_E, NULL);
+			if (cs == 0.0) {
+				error = xrl_error_new_literal(XRL_ERROR_INVALID_ARGUMENT, TOO_LOW_EXCITATION_ENERGY);
+				xrl_error_free(error);
+			}
+			sum += cs;
+		}
+	}
+	allocated = bench_now() - start;
+
+	printf("errors: %d energies, %d failures per scan\n", N_E, failed / N_REPEAT);
+	printf("  without error:            %10.4f s (%6.1f ns per call)\n", without, without * 1E9 / ((double) N_E * N_REPEAT));
+	printf("  with shared errors:       %10.4f s (%6.1f ns per call)\n", with, with * 1E9 / ((double) N_E * N_REPEAT));
+	printf("  with allocated errors:    %10.4f s (%6.1f ns per call)\n", allocated, allocated * 1E9 / ((double) N_E * N_REPEAT));
+
+	return sum < 0.0;
+}
@@ -0,0 +1,53 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Table lookups in a tight loop: the checked functions against the inline accessors of xraylib-fast.h.
+ */
+
+#include "config.h"
+#include "xraylib.h"
+#include "xraylib-fast.h"
+#include "bench.h"
+#include <stdio.h>
+
+#define N_REPEAT 2000
+
+int main(int argc, char **argv) {
+	double start, checked, unchecked, sum_checked = 0.0, sum_unchecked = 0.0;
+	int Z, shell, repeat;
+	long n = (long) N_REPEAT * ZMAX * (L3_SHELL + 1);
+
+	start = bench_now();
+	for (repeat = 0 ; repeat < N_REPEAT ; repeat++) {
+		for (Z = 1 ; Z <= ZMAX ; Z++) {
+			for (shell = K_SHELL ; shell <= L3_SHELL ; shell++)
+				sum_checked += FluorYield(Z, shell, NULL) * EdgeEnergy(Z, shell, NULL) * AtomicWeight(Z, NULL);
+		}
+	}
+	checked = bench_now() - start;
+
+	start = bench_now();
+	for (repeat = 0 ; repeat < N_REPEAT ; repeat++) {
+		for (Z = 1 ; Z <= ZMAX ; Z++) {
+			for (shell = K_SHELL ; shell <= L3_SHELL ; shell++)
+				sum_unchecked += FluorYield_unchecked(Z, shell) * EdgeEnergy_unchecked(Z, shell) * AtomicWeight_unchecked(Z);
+		}
+	}
+	unchecked = bench_now() - start;
+
+	printf("fast: %ld lookups of FluorYield, EdgeEnergy and AtomicWeight\n", n);
+	printf("  checked functions:        %10.4f s (%6.2f ns per iteration)\n", checked, checked * 1E9 / n);
+	printf("  unchecked accessors:      %10.4f s (%6.2f ns per iteration)\n", unchecked, unchecked * 1E9 / n);
+
+	return sum_checked != sum_unchecked;
+}
@@ -0,0 +1,83 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/* Reflectivity of a 20 period W/Si mirror: all energies in one call versus one call per energy */
+
+#include "config.h"
+#include "xraylib.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define N_BILAYERS 20
+#define N_E 1000
+#define N_THETA 500
+
+int main(int argc, char **argv) {
+	xrlLayer layers[2 * N_BILAYERS + 1];
+	double *E, *theta, *R;
+	double start, batch, single;
+	xrl_error *error = NULL;
+	int i;
+
+	for (i = 0 ; i < 2 * N_BILAYERS ; i += 2) {
+		layers[i].material = "W";
+		layers[i].density = 19.3;
+		layers[i].thickness = 1.2E-7;
+		layers[i].roughness = 0.3E-7;
+		layers[i + 1].material = "Si";
+		layers[i + 1].density = 2.33;
+		layers[i + 1].thickness = 2.8E-7;
+		layers[i + 1].roughness = 0.3E-7;
+	}
+	layers[2 * N_BILAYERS].material = "Si";
+	layers[2 * N_BILAYERS].density = 2.33;
+	layers[2 * N_BILAYERS].thickness = 0.0;
+	layers[2 * N_BILAYERS].roughness = 0.3E-7;
+
+	E = malloc(N_E * sizeof(double));
+	theta = malloc(N_THETA * sizeof(double));
+	R = malloc((size_t) N_E * N_THETA * sizeof(double));
+	if (E == NULL || theta == NULL || R == NULL)
+		return 1;
+
+	for (i = 0 ; i < N_E ; i++)
+		E[i] = 5.0 + i * 25.0 / N_E;
+	for (i = 0 ; i < N_THETA ; i++)
+		theta[i] = i * 1E-4;
+
+	start = bench_now();
+	if (!Multilayer_Reflectivity(layers, 2 * N_BILAYERS + 1, E, N_E, theta, N_THETA, R, &error)) {
+		fprintf(stderr, "Multilayer_Reflectivity error: %s\n", error->message);
+		return 1;
+	}
+	batch = bench_now() - start;
+
+	start = bench_now();
+	for (i = 0 ; i < N_E ; i++) {
+		if (!Multilayer_Reflectivity(layers, 2 * N_BILAYERS + 1, &E[i], 1, theta, N_THETA, R + (size_t) i * N_THETA, &error)) {
+			fprintf(stderr, "Multilayer_Reflectivity error: %s\n", error->message);
+			return 1;
+		}
+	}
+	single = bench_now() - start;
+
+	printf("multilayer: %d layers, %d energies, %d angles\n", 2 * N_BILAYERS + 1, N_E, N_THETA);
+	printf("  one call:            %10.4f s (%8.1f ns per reflectivity)\n", batch, batch * 1E9 / ((double) N_E * N_THETA));
+	printf("  one call per energy: %10.4f s (%8.1f ns per reflectivity)\n", single, single * 1E9 / ((double) N_E * N_THETA));
+
+	free(E);
+	free(theta);
+	free(R);
+
+	return 0;
+}
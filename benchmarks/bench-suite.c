@@ -0,0 +1,490 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Benchmark suite covering every family of public functions, on fixed workloads:
+ * random elements and energies, sorted energy scans, and multi-element alloys and NIST compounds.
+ *
+ * usage: bench-suite [--json FILE] [--baseline FILE] [--tolerance RATIO] [--filter TEXT]
+ *
+ * Every case is timed as the best of N_REPEAT runs. With --json the results are also written as JSON:
+ * store such a file to compare later runs against it with --baseline. Cases that became slower than
+ * the baseline by more than the tolerance ratio (1.25 by default) are reported, and make the suite fail.
+ * A baseline that does not exist yet is skipped.
+ */
+
+#include "config.h"
+#include "xraylib.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define N_CALLS 50000
+#define N_REPEAT 10
+#define MAX_BASELINE 256
+
+/* the workloads, filled in by workloads_init */
+static int random_Z[N_CALLS];       /* 1 to 92 */
+static int random_Z_heavy[N_CALLS]; /* 20 to 92: with K and L lines */
+static int random_shell[N_CALLS];   /* K to M5 */
+static double random_E[N_CALLS];    /* 1 to 100 keV, uniform in log(E) */
+static double scan_E[N_CALLS];      /* 1 to 100 keV, sorted */
+static double random_theta[N_CALLS];
+static double random_phi[N_CALLS];
+static double random_q[N_CALLS];
+static double random_pz[N_CALLS];
+static double scan_E_bragg[N_CALLS];   /* 5 to 30 keV, sorted: every energy excites the Si 111 reflection */
+static double scan_delta_theta[N_CALLS]; /* -100 to 100 microradians around the Bragg angle, sorted */
+static int random_miller[3 * N_CALLS];  /* 0 to 5, not all zero */
+
+static const char *alloys[] = {"Fe0.7Cr0.18Ni0.1Mn0.02", "Cu0.6Zn0.4", "Ti0.9Al0.06V0.04", "Ni0.6Cr0.2Mo0.1Fe0.05Nb0.05", "Pb0.63Sn0.37"};
+static const char *minerals[] = {"SiO2", "CaCO3", "Ca5(PO4)3F", "KAlSi3O8", "Fe3O4"};
+static const char *nist_compounds[] = {"Water, Liquid", "Bone, Cortical (ICRP)", "Air, Dry (near sea level)", "Polyethylene", "Glass, Lead"};
+static const char *radionuclides[] = {"55Fe", "57Co", "109Cd", "241Am"};
+static const char *symbols[] = {"H", "C", "O", "Si", "Fe", "Cu", "Ag", "W", "Au", "Pb", "U"};
+static const char *crystals[] = {"Si", "Ge", "LiF", "Diamond", "InSb"};
+#define N_ALLOYS (sizeof(alloys) / sizeof(alloys[0]))
+#define N_MINERALS (sizeof(minerals) / sizeof(minerals[0]))
+#define N_NIST_COMPOUNDS (sizeof(nist_compounds) / sizeof(nist_compounds[0]))
+#define N_RADIONUCLIDES (sizeof(radionuclides) / sizeof(radionuclides[0]))
+#define N_SYMBOLS (sizeof(symbols) / sizeof(symbols[0]))
+#define N_CRYSTALS (sizeof(crystals) / sizeof(crystals[0]))
+
+static Crystal_Struct *silicon;
+static Crystal_Reflection *silicon_220;
+static xrl_context *ctx_spline, *ctx_linear;
+
+/* outputs of the batch functions */
+static double batch_output[N_CALLS];
+static xrlComplex batch_F_H[N_CALLS];
+static xrlOpticalConstants batch_constants[N_CALLS];
+
+/* keeps the results alive */
+static volatile double sink;
+
+/* a fixed generator, so every run sees the same workload */
+static unsigned long random_state = 20260101UL;
+
+static double random_uniform(void) {
+	random_state = (random_state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+	return random_state / 2147483648.0;
+}
+
+static void workloads_init(void) {
+	int i;
+
+	for (i = 0 ; i < N_CALLS ; i++) {
+		random_Z[i] = 1 + (int) (random_uniform() * 92);
+		random_Z_heavy[i] = 20 + (int) (random_uniform() * 73);
+		random_shell[i] = K_SHELL + (int) (random_uniform() * (M5_SHELL + 1));
+		random_E[i] = exp(random_uniform() * log(100.0));
+		scan_E[i] = 1.0 + i * 99.0 / N_CALLS;
+		random_theta[i] = 0.01 + random_uniform() * 3.1;
+		random_phi[i] = random_uniform() * 6.28;
+		random_q[i] = random_uniform() * 10.0;
+		random_pz[i] = random_uniform() * 50.0;
+		scan_E_bragg[i] = 5.0 + i * 25.0 / N_CALLS;
+		scan_delta_theta[i] = -1E-4 + i * 2E-4 / N_CALLS;
+		random_miller[3 * i] = (int) (random_uniform() * 6);
+		random_miller[3 * i + 1] = (int) (random_uniform() * 6);
+		random_miller[3 * i + 2] = 1 + (int) (random_uniform() * 5);
+	}
+
+	silicon = Crystal_GetCrystalShared("Si", NULL);
+	silicon_220 = Crystal_Reflection_New(silicon, 2, 2, 0, 1.0, 1.0, NULL);
+	ctx_spline = xrl_context_new(NULL);
+	ctx_linear = xrl_context_new(NULL);
+	xrl_context_set_interpolation(ctx_linear, XRL_INTERPOLATION_LINEAR, NULL);
+}
+
+/* each case evaluates an expression for the first n entries of the workloads */
+#define BENCH_LOOP(name, expr) \
+	static double name(int n) { \
+		double sum = 0.0; \
+		int i; \
+		for (i = 0 ; i < n ; i++) \
+			sum += (expr); \
+		return sum; \
+	}
+
+/* cross sections */
+BENCH_LOOP(cs_total_random, CS_Total(random_Z[i], random_E[i], NULL))
+BENCH_LOOP(cs_total_scan, CS_Total(26, scan_E[i], NULL))
+BENCH_LOOP(cs_photo_random, CS_Photo(random_Z[i], random_E[i], NULL))
+BENCH_LOOP(cs_rayl_random, CS_Rayl(random_Z[i], random_E[i], NULL))
+BENCH_LOOP(cs_compt_random, CS_Compt(random_Z[i], random_E[i], NULL))
+BENCH_LOOP(cs_energy_random, CS_Energy(random_Z[i], random_E[i], NULL))
+BENCH_LOOP(csb_total_random, CSb_Total(random_Z[i], random_E[i], NULL))
+BENCH_LOOP(csb_photo_scan, CSb_Photo(82, scan_E[i], NULL))
+BENCH_LOOP(cs_kn_random, CS_KN(random_E[i], NULL))
+BENCH_LOOP(cs_fluorline_random, CS_FluorLine(random_Z_heavy[i], KL3_LINE, random_E[i], NULL))
+
+/* compounds */
+BENCH_LOOP(cs_total_cp_alloy, CS_Total_CP(alloys[i % N_ALLOYS], random_E[i], NULL))
+BENCH_LOOP(cs_total_cp_mineral, CS_Total_CP(minerals[i % N_MINERALS], random_E[i], NULL))
+BENCH_LOOP(cs_total_cp_nist, CS_Total_CP(nist_compounds[i % N_NIST_COMPOUNDS], random_E[i], NULL))
+BENCH_LOOP(cs_energy_cp_nist, CS_Energy_CP(nist_compounds[i % N_NIST_COMPOUNDS], scan_E[i], NULL))
+BENCH_LOOP(dcs_compt_cp_alloy, DCS_Compt_CP(alloys[i % N_ALLOYS], random_E[i], random_theta[i], NULL))
+
+/* Kissel photoionization and cascades */
+BENCH_LOOP(cs_photo_partial_random, CS_Photo_Partial(random_Z[i], random_shell[i], random_E[i], NULL))
+BENCH_LOOP(cs_total_kissel_random, CS_Total_Kissel(random_Z[i], random_E[i], NULL))
+BENCH_LOOP(kissel_no_cascade_k, CS_FluorLine_Kissel_no_Cascade(random_Z_heavy[i], KL3_LINE, random_E[i], NULL))
+BENCH_LOOP(kissel_cascade_k, CS_FluorLine_Kissel_Cascade(random_Z_heavy[i], KL3_LINE, random_E[i], NULL))
+BENCH_LOOP(kissel_cascade_l, CS_FluorLine_Kissel_Cascade(random_Z_heavy[i], L3M5_LINE, random_E[i], NULL))
+BENCH_LOOP(kissel_cascade_scan, CSb_FluorLine_Kissel_Cascade(82, L3M5_LINE, scan_E[i], NULL))
+
+/* scattering and polarization */
+BENCH_LOOP(ff_rayl_random, FF_Rayl(random_Z[i], random_q[i], NULL))
+BENCH_LOOP(sf_compt_random, SF_Compt(random_Z[i], random_q[i], NULL))
+BENCH_LOOP(dcs_rayl_random, DCS_Rayl(random_Z[i], random_E[i], random_theta[i], NULL))
+BENCH_LOOP(dcs_compt_random, DCS_Compt(random_Z[i], random_E[i], random_theta[i], NULL))
+BENCH_LOOP(dcsp_rayl_random, DCSP_Rayl(random_Z[i], random_E[i], random_theta[i], random_phi[i], NULL))
+BENCH_LOOP(dcsp_compt_random, DCSP_Compt(random_Z[i], random_E[i], random_theta[i], random_phi[i], NULL))
+
+/* double differential Compton cross sections: a call is one energy of the spectrum */
+static double ddcs_compt_spectrum(int n) {
+	DDCS_Compt(82, 100.0, 1.5, scan_E, n, batch_output, NULL);
+	return batch_output[n / 2];
+}
+
+static double ddcsb_compt_spectrum(int n) {
+	DDCSb_Compt(26, 100.0, 0.5, scan_E, n, batch_output, NULL);
+	return batch_output[n / 2];
+}
+
+static double ddcs_compt_cp_spectrum(int n) {
+	DDCS_Compt_CP(alloys[0], 100.0, 1.5, scan_E, n, batch_output, NULL);
+	return batch_output[n / 2];
+}
+
+/* anomalous scattering factors */
+BENCH_LOOP(fi_random, Fi(random_Z[i], random_E[i], NULL))
+BENCH_LOOP(fii_random, Fii(random_Z[i], random_E[i], NULL))
+
+/* evaluation contexts */
+BENCH_LOOP(cs_total_ctx_random, CS_Total_ctx(ctx_spline, random_Z[i], random_E[i]))
+BENCH_LOOP(cs_total_ctx_scan, CS_Total_ctx(ctx_spline, 26, scan_E[i]))
+BENCH_LOOP(cs_total_ctx_linear_scan, CS_Total_ctx(ctx_linear, 26, scan_E[i]))
+BENCH_LOOP(cs_photo_ctx_random, CS_Photo_ctx(ctx_spline, random_Z[i], random_E[i]))
+BENCH_LOOP(csb_compt_ctx_random, CSb_Compt_ctx(ctx_spline, random_Z[i], random_E[i]))
+BENCH_LOOP(ff_rayl_ctx_random, FF_Rayl_ctx(ctx_spline, random_Z[i], random_q[i]))
+BENCH_LOOP(fi_ctx_random, Fi_ctx(ctx_spline, random_Z[i], random_E[i]))
+
+/* Compton profiles */
+BENCH_LOOP(compton_profile_random, ComptonProfile(random_Z[i], random_pz[i], NULL))
+BENCH_LOOP(compton_profile_partial_random, ComptonProfile_Partial(random_Z[i], K_SHELL, random_pz[i], NULL))
+
+/* atomic data */
+BENCH_LOOP(line_energy_random, LineEnergy(random_Z[i], KL3_LINE, NULL))
+BENCH_LOOP(edge_energy_random, EdgeEnergy(random_Z[i], random_shell[i], NULL))
+BENCH_LOOP(fluor_yield_random, FluorYield(random_Z[i], random_shell[i], NULL))
+BENCH_LOOP(radrate_random, RadRate(random_Z[i], KA_LINE, NULL))
+
+/* crystals */
+BENCH_LOOP(bragg_angle_random, Bragg_angle(silicon, 5.0 + random_E[i] / 4.0, 1, 1, 1, NULL))
+BENCH_LOOP(structure_factor_random, Crystal_F_H_StructureFactor(silicon, 5.0 + random_E[i] / 4.0, 1 + i % 2, 1 + i % 2, 1 - i % 2, 1.0, 1.0, NULL).re)
+BENCH_LOOP(reflection_f_h_random, Crystal_Reflection_F_H(silicon_220, 5.0 + random_E[i] / 4.0, NULL).re)
+BENCH_LOOP(darwin_width_random, Crystal_DarwinWidth(silicon, 5.0 + random_E[i] / 4.0, 1, 1, 1, 0.0, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, NULL))
+
+/* batches: a call is one reflection, energy or angle */
+static double structure_factor_batch(int n) {
+	Crystal_F_H_StructureFactor_Batch(silicon, 17.48, random_miller, n, 1.0, 1.0, batch_F_H, NULL);
+	return batch_F_H[n / 2].re;
+}
+
+static double structure_factor_partial_batch(int n) {
+	Crystal_F_H_StructureFactor_Partial_Batch(silicon, 17.48, random_miller, n, 1.0, 1.0, 2, 0, 2, batch_F_H, NULL);
+	return batch_F_H[n / 2].re;
+}
+
+static double reflection_f_h_batch(int n) {
+	Crystal_Reflection_F_H_Batch(silicon_220, scan_E_bragg, n, batch_F_H, NULL);
+	return batch_F_H[n / 2].re;
+}
+
+static double rocking_curve(int n) {
+	Crystal_RockingCurve(silicon, 8.04778, 1, 1, 1, 0.0, 0.1, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0,
+		scan_delta_theta, n, batch_output, NULL);
+	return batch_output[n / 2];
+}
+
+static double rocking_curve_energy(int n) {
+	Crystal_RockingCurve_Energy(silicon, scan_E_bragg, n, 1, 1, 1, Bragg_angle(silicon, 17.48, 1, 1, 1, NULL),
+		0.0, 0.1, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, batch_output, NULL);
+	return batch_output[n / 2];
+}
+
+/* a full pattern: the reflections of silicon down to 0.3 Angstrom at Mo K alpha, and their profile */
+static double powder_silicon(int n) {
+	static double two_theta[2048], profile[2048];
+	double sum = 0.0;
+	int i, j, n_reflections;
+
+	for (j = 0 ; j < 2048 ; j++)
+		two_theta[j] = j * 3.1 / 2048;
+
+	for (i = 0 ; i < n ; i++) {
+		Crystal_PowderReflection *reflections = Crystal_PowderReflections(silicon, 17.48, 0.3, 1.0, &n_reflections, NULL);
+		Crystal_PowderProfile(reflections, n_reflections, 0.002, 0.5, two_theta, 2048, profile, NULL);
+		sum += profile[1024];
+		xrlFree(reflections);
+	}
+	return sum;
+}
+
+/* refractive indices */
+BENCH_LOOP(refractive_re_mineral, Refractive_Index_Re(minerals[i % N_MINERALS], random_E[i], 2.5, NULL))
+BENCH_LOOP(refractive_im_alloy, Refractive_Index_Im(alloys[i % N_ALLOYS], random_E[i], 8.0, NULL))
+BENCH_LOOP(refractive_nist, Refractive_Index(nist_compounds[i % N_NIST_COMPOUNDS], random_E[i], 1.0, NULL).im)
+
+static double refractive_batch_mineral(int n) {
+	Refractive_Index_Batch(minerals[0], scan_E, n, 2.65, 5E-3, batch_constants, NULL);
+	return batch_constants[n / 2].delta;
+}
+
+/* parser and name lookups */
+BENCH_LOOP(symbol_to_z, SymbolToAtomicNumber(symbols[i % N_SYMBOLS], NULL))
+BENCH_LOOP(crystal_shared_lookup, Crystal_GetCrystalShared(crystals[i % N_CRYSTALS], NULL)->a)
+
+static double compound_parser_alloy(int n) {
+	double sum = 0.0;
+	int i;
+
+	for (i = 0 ; i < n ; i++) {
+		struct compoundData *cd = CompoundParser(alloys[i % N_ALLOYS], NULL);
+		sum += cd->molarMass;
+		FreeCompoundData(cd);
+	}
+	return sum;
+}
+
+static double nist_lookup(int n) {
+	double sum = 0.0;
+	int i;
+
+	for (i = 0 ; i < n ; i++) {
+		struct compoundDataNIST *cd = GetCompoundDataNISTByName(nist_compounds[i % N_NIST_COMPOUNDS], NULL);
+		sum += cd->density;
+		FreeCompoundDataNIST(cd);
+	}
+	return sum;
+}
+
+static double radionuclide_lookup(int n) {
+	double sum = 0.0;
+	int i;
+
+	for (i = 0 ; i < n ; i++) {
+		struct radioNuclideData *rnd = GetRadioNuclideDataByName(radionuclides[i % N_RADIONUCLIDES], NULL);
+		sum += rnd->nXrays;
+		FreeRadioNuclideData(rnd);
+	}
+	return sum;
+}
+
+typedef struct {
+	const char *name;
+	const char *family;
+	double (*run)(int n);
+	int calls;
+} bench_case;
+
+static const bench_case cases[] = {
+	{"CS_Total/random", "cross_sections", cs_total_random, N_CALLS},
+	{"CS_Total/scan", "cross_sections", cs_total_scan, N_CALLS},
+	{"CS_Photo/random", "cross_sections", cs_photo_random, N_CALLS},
+	{"CS_Rayl/random", "cross_sections", cs_rayl_random, N_CALLS},
+	{"CS_Compt/random", "cross_sections", cs_compt_random, N_CALLS},
+	{"CS_Energy/random", "cross_sections", cs_energy_random, N_CALLS},
+	{"CSb_Total/random", "cross_sections", csb_total_random, N_CALLS},
+	{"CSb_Photo/scan", "cross_sections", csb_photo_scan, N_CALLS},
+	{"CS_KN/random", "cross_sections", cs_kn_random, N_CALLS},
+	{"CS_FluorLine/random", "cross_sections", cs_fluorline_random, N_CALLS},
+	{"CS_Total_CP/alloy", "compounds", cs_total_cp_alloy, N_CALLS / 10},
+	{"CS_Total_CP/mineral", "compounds", cs_total_cp_mineral, N_CALLS / 10},
+	{"CS_Total_CP/nist", "compounds", cs_total_cp_nist, N_CALLS / 10},
+	{"CS_Energy_CP/nist-scan", "compounds", cs_energy_cp_nist, N_CALLS / 10},
+	{"DCS_Compt_CP/alloy", "compounds", dcs_compt_cp_alloy, N_CALLS / 10},
+	{"CS_Photo_Partial/random", "kissel", cs_photo_partial_random, N_CALLS},
+	{"CS_Total_Kissel/random", "kissel", cs_total_kissel_random, N_CALLS},
+	{"CS_FluorLine_Kissel_no_Cascade/K", "kissel", kissel_no_cascade_k, N_CALLS},
+	{"CS_FluorLine_Kissel_Cascade/K", "kissel", kissel_cascade_k, N_CALLS},
+	{"CS_FluorLine_Kissel_Cascade/L", "kissel", kissel_cascade_l, N_CALLS},
+	{"CSb_FluorLine_Kissel_Cascade/scan", "kissel", kissel_cascade_scan, N_CALLS},
+	{"FF_Rayl/random", "scattering", ff_rayl_random, N_CALLS},
+	{"SF_Compt/random", "scattering", sf_compt_random, N_CALLS},
+	{"DCS_Rayl/random", "scattering", dcs_rayl_random, N_CALLS},
+	{"DCS_Compt/random", "scattering", dcs_compt_random, N_CALLS},
+	{"DCSP_Rayl/random", "scattering", dcsp_rayl_random, N_CALLS},
+	{"DCSP_Compt/random", "scattering", dcsp_compt_random, N_CALLS},
+	{"DDCS_Compt/spectrum", "scattering", ddcs_compt_spectrum, N_CALLS},
+	{"DDCSb_Compt/spectrum", "scattering", ddcsb_compt_spectrum, N_CALLS},
+	{"DDCS_Compt_CP/alloy-spectrum", "scattering", ddcs_compt_cp_spectrum, N_CALLS},
+	{"Fi/random", "anomalous", fi_random, N_CALLS},
+	{"Fii/random", "anomalous", fii_random, N_CALLS},
+	{"CS_Total_ctx/random", "contexts", cs_total_ctx_random, N_CALLS},
+	{"CS_Total_ctx/scan", "contexts", cs_total_ctx_scan, N_CALLS},
+	{"CS_Total_ctx/linear-scan", "contexts", cs_total_ctx_linear_scan, N_CALLS},
+	{"CS_Photo_ctx/random", "contexts", cs_photo_ctx_random, N_CALLS},
+	{"CSb_Compt_ctx/random", "contexts", csb_compt_ctx_random, N_CALLS},
+	{"FF_Rayl_ctx/random", "contexts", ff_rayl_ctx_random, N_CALLS},
+	{"Fi_ctx/random", "contexts", fi_ctx_random, N_CALLS},
+	{"ComptonProfile/random", "compton_profiles", compton_profile_random, N_CALLS},
+	{"ComptonProfile_Partial/random", "compton_profiles", compton_profile_partial_random, N_CALLS},
+	{"LineEnergy/random", "atomic_data", line_energy_random, N_CALLS},
+	{"EdgeEnergy/random", "atomic_data", edge_energy_random, N_CALLS},
+	{"FluorYield/random", "atomic_data", fluor_yield_random, N_CALLS},
+	{"RadRate/random", "atomic_data", radrate_random, N_CALLS},
+	{"Bragg_angle/random", "crystals", bragg_angle_random, N_CALLS},
+	{"Crystal_F_H_StructureFactor/random", "crystals", structure_factor_random, N_CALLS / 10},
+	{"Crystal_F_H_StructureFactor_Batch/random", "crystals", structure_factor_batch, N_CALLS / 10},
+	{"Crystal_F_H_StructureFactor_Partial_Batch/random", "crystals", structure_factor_partial_batch, N_CALLS / 10},
+	{"Crystal_Reflection_F_H/random", "crystals", reflection_f_h_random, N_CALLS},
+	{"Crystal_Reflection_F_H_Batch/scan", "crystals", reflection_f_h_batch, N_CALLS},
+	{"Crystal_DarwinWidth/random", "crystals", darwin_width_random, N_CALLS / 10},
+	{"Crystal_RockingCurve/Si111", "crystals", rocking_curve, N_CALLS},
+	{"Crystal_RockingCurve_Energy/Si111", "crystals", rocking_curve_energy, N_CALLS},
+	{"Crystal_PowderReflections+Profile/Si", "crystals", powder_silicon, 20},
+	{"Refractive_Index_Re/mineral", "refractive_indices", refractive_re_mineral, N_CALLS / 10},
+	{"Refractive_Index_Im/alloy", "refractive_indices", refractive_im_alloy, N_CALLS / 10},
+	{"Refractive_Index/nist", "refractive_indices", refractive_nist, N_CALLS / 10},
+	{"Refractive_Index_Batch/mineral-scan", "refractive_indices", refractive_batch_mineral, N_CALLS},
+	{"CompoundParser/alloy", "lookups", compound_parser_alloy, N_CALLS / 10},
+	{"SymbolToAtomicNumber", "lookups", symbol_to_z, N_CALLS},
+	{"GetCompoundDataNISTByName", "lookups", nist_lookup, N_CALLS / 10},
+	{"GetRadioNuclideDataByName", "lookups", radionuclide_lookup, N_CALLS / 10},
+	{"Crystal_GetCrystalShared", "lookups", crystal_shared_lookup, N_CALLS},
+};
+#define N_CASES (sizeof(cases) / sizeof(cases[0]))
+
+/* reads the names and timings back from a file written with --json, returns the number of cases or -1 */
+static int read_baseline(const char *file_name, char names[][128], double ns[]) {
+	FILE *fp = fopen(file_name, "r");
+	char line[1024];
+	int n = 0;
+
+	if (fp == NULL)
+		return -1;
+
+	while (n < MAX_BASELINE && fgets(line, sizeof(line), fp) != NULL) {
+		char *name = strstr(line, "\"name\": \""), *value = strstr(line, "\"ns_per_call\": "), *end;
+		if (name == NULL || value == NULL)
+			continue;
+		name += strlen("\"name\": \"");
+		if ((end = strchr(name, '"')) == NULL || end - name >= 128)
+			continue;
+		memcpy(names[n], name, end - name);
+		names[n][end - name] = '\0';
+		ns[n] = strtod(value + strlen("\"ns_per_call\": "), NULL);
+		n++;
+	}
+	fclose(fp);
+
+	return n;
+}
+
+int main(int argc, char **argv) {
+	const char *json_file = NULL, *baseline_file = NULL, *filter = NULL;
+	static char baseline_names[MAX_BASELINE][128];
+	double baseline_ns[MAX_BASELINE], ns[N_CASES], tolerance = 1.25;
+	int n_baseline = 0, n_regressions = 0, first = 1;
+	size_t i;
+	FILE *fp = NULL;
+
+	for (i = 1 ; i < (size_t) argc ; i++) {
+		if (strcmp(argv[i], "--json") == 0 && i + 1 < (size_t) argc)
+			json_file = argv[++i];
+		else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < (size_t) argc)
+			baseline_file = argv[++i];
+		else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < (size_t) argc)
+			tolerance = atof(argv[++i]);
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < (size_t) argc)
+			filter = argv[++i];
+		else {
+			fprintf(stderr, "usage: %s [--json FILE] [--baseline FILE] [--tolerance RATIO] [--filter TEXT]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	/* a missing baseline is not an error: the first run is the one that will be stored */
+	if (baseline_file != NULL && (n_baseline = read_baseline(baseline_file, baseline_names, baseline_ns)) < 0) {
+		printf("no baseline found at %s\n", baseline_file);
+		baseline_file = NULL;
+		n_baseline = 0;
+	}
+
+	if (json_file != NULL) {
+		if ((fp = fopen(json_file, "w")) == NULL) {
+			fprintf(stderr, "could not write %s\n", json_file);
+			return 1;
+		}
+		fprintf(fp, "{\n  \"version\": \"%s\",\n  \"repeat\": %d,\n  \"benchmarks\": [\n", VERSION, N_REPEAT);
+	}
+
+	workloads_init();
+
+	printf("suite: best of %d runs%s%s\n", N_REPEAT, baseline_file ? ", compared with " : "", baseline_file ? baseline_file : "");
+	printf("  %-20s %-48s %10s %10s\n", "family", "case", "ns/call", "baseline");
+
+	for (i = 0 ; i < N_CASES ; i++) {
+		double best = 0.0;
+		int repeat, j;
+
+		if (filter != NULL && strstr(cases[i].name, filter) == NULL && strstr(cases[i].family, filter) == NULL)
+			continue;
+
+		for (repeat = 0 ; repeat < N_REPEAT ; repeat++) {
+			double start = bench_now(), elapsed;
+			sink += cases[i].run(cases[i].calls);
+			elapsed = bench_now() - start;
+			if (repeat == 0 || elapsed < best)
+				best = elapsed;
+		}
+		ns[i] = best * 1E9 / cases[i].calls;
+
+		printf("  %-20s %-48s %10.1f", cases[i].family, cases[i].name, ns[i]);
+		for (j = 0 ; j < n_baseline ; j++) {
+			if (strcmp(baseline_names[j], cases[i].name) == 0)
+				break;
+		}
+		if (j < n_baseline && baseline_ns[j] > 0.0) {
+			double ratio = ns[i] / baseline_ns[j];
+			printf(" %9.2fx%s", ratio, ratio > tolerance ? "  REGRESSION" : "");
+			if (ratio > tolerance)
+				n_regressions++;
+		}
+		else if (baseline_file != NULL) {
+			printf(" %10s", "new");
+		}
+		printf("\n");
+
+		if (fp != NULL) {
+			fprintf(fp, "%s    {\"name\": \"%s\", \"family\": \"%s\", \"calls\": %d, \"ns_per_call\": %.2f}", first ? "" : ",\n", cases[i].name, cases[i].family, cases[i].calls, ns[i]);
+			first = 0;
+		}
+	}
+
+	if (fp != NULL) {
+		fprintf(fp, "\n  ]\n}\n");
+		fclose(fp);
+	}
+
+	if (n_regressions > 0) {
+		printf("%d case(s) slower than the baseline by more than a factor %.2f\n", n_regressions, tolerance);
+		return 1;
+	}
+
+	return 0;
+}
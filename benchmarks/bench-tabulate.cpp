@@ -0,0 +1,77 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * xrlpp::tabulate of CS_Total for every element on a fine energy grid, from one thread to all cores.
+ */
+
+#include "config.h"
+#include "xraylib++.h"
+#include "bench.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef XRLPP_HAVE_CXX17
+
+#define N_ENERGIES 20000
+#define N_REPEAT 5
+
+int main(int argc, char **argv) {
+	std::vector<int> Zs;
+	std::vector<double> E(N_ENERGIES);
+	for (int Z = 1 ; Z <= 94 ; Z++)
+		Zs.push_back(Z);
+	for (int i = 0 ; i < N_ENERGIES ; i++)
+		E[i] = 1.0 * std::pow(100.0, static_cast<double>(i) / (N_ENERGIES - 1));
+
+	/* the number of threads to scale to defaults to the number of cores */
+	unsigned max_threads = argc > 1 ? std::max(1, atoi(argv[1])) : std::max(1u, std::thread::hardware_concurrency());
+	long n = (long) N_REPEAT * Zs.size() * E.size();
+	std::vector<double> reference(Zs.size() * E.size());
+	double single = 0.0, sum = 0.0;
+
+	double start = bench_now();
+	for (int repeat = 0 ; repeat < N_REPEAT ; repeat++) {
+		for (std::size_t i = 0 ; i < Zs.size() ; i++)
+			for (std::size_t j = 0 ; j < E.size() ; j++)
+				sum += reference[i * E.size() + j] = CS_Total(Zs[i], E[j], NULL);
+	}
+	double scalar = bench_now() - start;
+
+	printf("tabulate: %ld evaluations of CS_Total, scaling to %u threads\n", n, max_threads);
+	printf("  CS_Total loop:            %10.4f s (%6.2f ns per evaluation)\n", scalar, scalar * 1E9 / n);
+	for (unsigned threads = 1 ; ; threads = std::min(threads * 2, max_threads)) {
+		double start = bench_now();
+		for (int repeat = 0 ; repeat < N_REPEAT ; repeat++) {
+			if (xrlpp::tabulate(XRLPP_BATCH(CS_Total), Zs, E, xrlpp::threads{threads}) != reference)
+				return 1;
+		}
+		double elapsed = bench_now() - start;
+		if (threads == 1)
+			single = elapsed;
+		printf("  %3u threads:              %10.4f s (%6.2f ns per evaluation, %5.2fx)\n", threads, elapsed, elapsed * 1E9 / n, single / elapsed);
+		if (threads == max_threads)
+			break;
+	}
+
+	return sum <= 0.0;
+}
+
+#else
+
+int main(int argc, char **argv) {
+	printf("tabulate: skipped, needs C++17\n");
+	return 0;
+}
+
+#endif
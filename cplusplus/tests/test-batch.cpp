@@ -0,0 +1,138 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+#include "xraylib++.h"
+#include "xraylib-error-private.h"
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+double test_batch_other_unit(void);
+
+#ifdef XRLPP_HAVE_BATCH
+
+static const std::vector<double> energies {1.0, 5.5, 7.1, 7.2, 10.0, 25.0, 50.0, 100.0, 7.1, 1.0};
+
+int main(int argc, char **argv) {
+    assert(std::fabs(test_batch_other_unit() - xrlpp::AtomicWeight(26) - xrlpp::CompoundParser("H2O").molarMass - xrlpp::Crystal::GetCrystal("Si").volume) < 1E-10);
+
+    /* identical to the scalar functions, including the context backed ones */
+    std::vector<double> rv = xrlpp::CS_Total(26, energies);
+    assert(rv.size() == energies.size());
+    for (size_t i = 0 ; i < energies.size() ; i++)
+        assert(rv[i] == xrlpp::CS_Total(26, energies[i]));
+
+    rv = xrlpp::Fi(std::array<int, 3>{26, 29, 79}, 10.0);
+    assert(rv.size() == 3);
+    assert(rv[2] == xrlpp::Fi(79, 10.0));
+
+    int lines[] = {KL3_LINE, KL2_LINE, KM3_LINE};
+    rv = xrlpp::LineEnergy(26, lines);
+    for (size_t i = 0 ; i < 3 ; i++)
+        assert(rv[i] == xrlpp::LineEnergy(26, lines[i]));
+
+    /* the compound is resolved once, as a formula or as a NIST compound */
+    for (const char *compound : {"H2O", "Ca5(PO4)3F", "Water, Liquid"}) {
+        rv = xrlpp::CS_Total_CP(compound, energies);
+        for (size_t i = 0 ; i < energies.size() ; i++)
+            assert(rv[i] == xrlpp::CS_Total_CP(compound, energies[i]));
+        rv = xrlpp::DCSP_Rayl_CP(std::string(compound), energies, 0.5, 0.1);
+        for (size_t i = 0 ; i < energies.size() ; i++)
+            assert(rv[i] == xrlpp::DCSP_Rayl_CP(compound, energies[i], 0.5, 0.1));
+    }
+    rv = xrlpp::Refractive_Index_Re("H2O", energies, 1.0);
+    for (size_t i = 0 ; i < energies.size() ; i++)
+        assert(rv[i] == xrlpp::Refractive_Index_Re("H2O", energies[i], 1.0));
+
+    std::vector<xrlOpticalConstants> constants = xrlpp::Refractive_Index_Batch("H2O", energies, 1.0, 0.001);
+    assert(constants.size() == energies.size());
+    assert(std::fabs(1.0 - constants[4].delta - xrlpp::Refractive_Index_Re("H2O", 10.0, 1.0)) < 1E-12);
+
+    /* failures are collected for the whole batch */
+    std::vector<int> Z {26, 0, 29, 200};
+    try {
+        xrlpp::CS_Total(Z, 10.0);
+        abort();
+    }
+    catch (xrlpp::batch_error &e) {
+        assert(e.failures().size() == 2);
+        assert(e.failures()[0].index == 1);
+        assert(e.failures()[0].code == XRL_ERROR_INVALID_ARGUMENT);
+        assert(e.failures()[0].message == Z_OUT_OF_RANGE);
+        assert(e.failures()[1].index == 3);
+        assert(strcmp(e.what(), "2 of 4 evaluations failed, the first at index 1: " Z_OUT_OF_RANGE) == 0);
+    }
+
+    try {
+        xrlpp::CS_Total_CP("NotACompound", energies);
+        abort();
+    }
+    catch (xrlpp::batch_error &e) {
+        assert(e.failures().size() == energies.size());
+        assert(e.failures()[0].message == UNKNOWN_COMPOUND);
+    }
+
+    std::vector<double> out(Z.size(), -1.0);
+    xrlpp::batch_status status;
+    xrlpp::FluorYield(out, status, Z, K_SHELL);
+    assert(status.size() == 2);
+    assert(status[0].index == 1 && status[1].index == 3);
+    assert(out[0] == xrlpp::FluorYield(26, K_SHELL));
+    assert(out[1] == 0.0 && out[3] == 0.0);
+    assert(out[2] == xrlpp::FluorYield(29, K_SHELL));
+
+    /* spans over memory owned by the caller, and the status is cleared by every batch */
+    double E[] = {10.0, 20.0};
+    xrlpp::CS_Photo(xrlpp::span<double>(out.data(), 2), status, 26, xrlpp::span<const double>(E, 2));
+    assert(status.empty());
+    assert(out[1] == xrlpp::CS_Photo(26, 20.0));
+
+    /* the arrays must have the same length */
+    try {
+        xrlpp::CS_Total(Z, energies);
+        abort();
+    }
+    catch (std::invalid_argument &e) {
+    }
+    try {
+        xrlpp::CS_Total(out, status, 26, energies);
+        abort();
+    }
+    catch (std::invalid_argument &e) {
+    }
+
+    /* scalar calls are unchanged */
+    try {
+        xrlpp::CS_Total(0, 10.0);
+        abort();
+    }
+    catch (std::invalid_argument &e) {
+        assert(strcmp(e.what(), Z_OUT_OF_RANGE) == 0);
+    }
+
+    return 0;
+}
+
+#else
+
+int main(int argc, char **argv) {
+    assert(test_batch_other_unit() > 0.0);
+    /* skipped: the batch overloads need C++17 */
+    return 77;
+}
+
+#endif
@@ -81,5 +81,96 @@ int main(int argc, char *argv[]) {
     double dSpacing = cs.dSpacing(1, 1, 1);
     assert(fabs(dSpacing - 2.0592870875248344) < 1E-6);
 
+    // moving a Struct takes over its atoms instead of copying them
+    const xrlpp::Crystal::Atom *atoms = cs_copy.atom.data();
+    auto cs_moved(std::move(cs_copy));
+    assert(cs_moved.name == "Diamond");
+    assert(cs_moved.atom.data() == atoms);
+    assert(fabs(cs_moved.dSpacing(1, 1, 1) - dSpacing) < 1E-12);
+
+    // shared crystals
+    auto shared = xrlpp::Crystal::GetCrystalShared("Diamond");
+    assert(strcmp(shared.name(), "Diamond") == 0);
+    assert(shared.n_atom() == cs.n_atom);
+    assert(fabs(shared.Bragg_angle(10.0, 1, 1, 1) - angle) < 1E-12);
+    assert(fabs(shared.dSpacing(1, 1, 1) - dSpacing) < 1E-12);
+    assert(xrlpp::Crystal::GetCrystalShared(std::string("Diamond")).get() == shared.get());
+
+    {
+        xrlpp::Crystal::SharedStruct shared_copy(cs);
+        assert(shared_copy.get() != shared.get());
+        auto shared_copy2 = shared_copy;
+        assert(shared_copy2.get() == shared_copy.get());
+        auto shared_moved = std::move(shared_copy);
+        assert(shared_moved.get() == shared_copy2.get());
+        shared_copy2 = shared;
+        assert(shared_copy2.get() == shared.get());
+        assert(fabs(shared_moved.F_H_StructureFactor(10.0, 1, 1, 1, 1.0, 1.0).real() - cs.F_H_StructureFactor(10.0, 1, 1, 1, 1.0, 1.0).real()) < 1E-12);
+    }
+
+    try {
+        xrlpp::Crystal::GetCrystalShared("non-existent-crystal");
+        abort();
+    }
+    catch (std::invalid_argument &e) {
+    }
+
+#ifdef XRLPP_HAVE_BATCH
+    // many reflections at once
+    {
+        const int miller[] = {1, 1, 1, 2, 2, 0, 3, 1, 1};
+        std::vector<std::complex<double>> F_H(3);
+        cs.F_H_StructureFactor(10.0, miller, 1.0, 1.0, xrlpp::span<std::complex<double>>(F_H));
+        for (int i = 0 ; i < 3 ; i++)
+            assert(std::abs(F_H[i] - cs.F_H_StructureFactor(10.0, miller[3 * i], miller[3 * i + 1], miller[3 * i + 2], 1.0, 1.0)) < 1E-9 * std::abs(F_H[i]));
+        shared.F_H_StructureFactor_Partial(10.0, miller, 1.0, 1.0, 2, 0, 2, xrlpp::span<std::complex<double>>(F_H));
+        for (int i = 0 ; i < 3 ; i++)
+            assert(std::abs(F_H[i] - shared.F_H_StructureFactor_Partial(10.0, miller[3 * i], miller[3 * i + 1], miller[3 * i + 2], 1.0, 1.0, 2, 0, 2)) < 1E-9 * std::abs(F_H[i]));
+
+        try {
+            cs.F_H_StructureFactor(10.0, xrlpp::span<const int>(miller, 8), 1.0, 1.0, xrlpp::span<std::complex<double>>(F_H));
+            abort();
+        }
+        catch (std::invalid_argument &e) {
+        }
+
+        try {
+            cs.F_H_StructureFactor_Partial(10.0, miller, 1.0, 1.0, 3, 0, 0, xrlpp::span<std::complex<double>>(F_H));
+            abort();
+        }
+        catch (std::invalid_argument &e) {
+        }
+    }
+
+    // a prepared reflection at many energies
+    {
+        xrlpp::Crystal::Reflection reflection(shared, 2, 2, 0, 1.0, 1.0);
+        std::vector<double> energies {8.0, 8.5, 9.0, 10.0};
+        std::vector<std::complex<double>> F_H = reflection.F_H(energies);
+        assert(F_H.size() == energies.size());
+        for (size_t i = 0 ; i < energies.size() ; i++) {
+            assert(F_H[i] == reflection.F_H(energies[i]));
+            assert(std::abs(F_H[i] - shared.F_H_StructureFactor(energies[i], 2, 2, 0, 1.0, 1.0)) < 1E-9 * std::abs(F_H[i]));
+        }
+
+        auto moved = std::move(reflection);
+        assert(moved.F_H(10.0) == F_H[3]);
+
+        try {
+            moved.F_H(energies, xrlpp::span<std::complex<double>>(F_H.data(), 2));
+            abort();
+        }
+        catch (std::invalid_argument &e) {
+        }
+
+        try {
+            moved.F_H(-1.0);
+            abort();
+        }
+        catch (std::invalid_argument &e) {
+        }
+    }
+#endif
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,160 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+#include "xraylib++.h"
+#include "xraylib-error-private.h"
+#include <cassert>
+#include <cstring>
+
+using xrlpp::Line;
+using xrlpp::Shell;
+using xrlpp::Transition;
+
+/* the metadata is available in constant expressions, also in C++11 */
+static_assert(static_cast<int>(Line::KL3) == KL3_LINE && Line::KA1 == Line::KL3, "");
+static_assert(xrlpp::parent_shell(Line::KL3) == Shell::K, "");
+static_assert(xrlpp::parent_shell(Line::KA) == Shell::K && xrlpp::parent_shell(Line::KB) == Shell::K, "");
+static_assert(xrlpp::parent_shell(Line::LA) == Shell::L3, "");
+static_assert(xrlpp::parent_shell(Line::LB1) == Shell::L2 && xrlpp::parent_shell(Line::LB3) == Shell::L1, "");
+static_assert(xrlpp::parent_shell(Line::M5N7) == Shell::M5 && xrlpp::parent_shell(Line::P3P5) == Shell::P3, "");
+static_assert(xrlpp::is_group(Line::LB) && !xrlpp::is_group(Line::LB1), "");
+static_assert(xrlpp::in_group(Line::KA, Line::KA2) && !xrlpp::in_group(Line::KA, Line::KB1), "");
+static_assert(xrlpp::in_group(Line::KB, Line::KB1) && xrlpp::in_group(Line::KB, Line::KP4), "");
+static_assert(xrlpp::in_group(Line::LA, Line::LA1) && xrlpp::in_group(Line::LB, Line::LB17), "");
+static_assert(!xrlpp::in_group(Line::LB, Line::LA1) && !xrlpp::in_group(Line::KL1, Line::KL1), "");
+
+#ifdef XRLPP_HAVE_CXX17
+
+static const double energies[] = {-1.0, 1.0, 5.0, 7.2, 15.0, 20.0, 100.0};
+
+/* the kernel returns the same value as the checked function, or throws the same error */
+template<typename F, typename G>
+static void assert_same(F kernel, G checked) {
+    double expected;
+    try {
+        expected = checked();
+    }
+    catch (std::invalid_argument &e) {
+        try {
+            kernel();
+            abort();
+        }
+        catch (std::invalid_argument &e2) {
+            assert(strcmp(e.what(), e2.what()) == 0);
+        }
+        return;
+    }
+    assert(kernel() == expected);
+}
+
+template<Line L>
+static void test_line_energy(void) {
+    for (int Z = 0 ; Z <= ZMAX + 1 ; Z++)
+        assert_same([=]() { return xrlpp::LineEnergy<L>(Z); }, [=]() { return xrlpp::LineEnergy(Z, L); });
+}
+
+template<Line L>
+static void test_rad_rate(void) {
+    for (int Z = 0 ; Z <= ZMAX + 1 ; Z++)
+        assert_same([=]() { return xrlpp::RadRate<L>(Z); }, [=]() { return xrlpp::RadRate(Z, L); });
+}
+
+template<Line L>
+static void test_cs_fluor_line(void) {
+    for (int Z = 0 ; Z <= ZMAX + 1 ; Z++) {
+        for (double E : energies) {
+            assert_same([=]() { return xrlpp::CS_FluorLine<L>(Z, E); }, [=]() { return xrlpp::CS_FluorLine(Z, L, E); });
+            assert_same([=]() { return xrlpp::CSb_FluorLine<L>(Z, E); }, [=]() { return xrlpp::CSb_FluorLine(Z, L, E); });
+        }
+    }
+}
+
+template<Line L>
+static void test_cs_fluor_line_kissel(void) {
+    for (int Z = 0 ; Z <= ZMAX + 1 ; Z++) {
+        for (double E : energies) {
+            assert_same([=]() { return xrlpp::CS_FluorLine_Kissel<L>(Z, E); }, [=]() { return xrlpp::CS_FluorLine_Kissel(Z, L, E); });
+            assert_same([=]() { return xrlpp::CSb_FluorLine_Kissel_Cascade<L>(Z, E); }, [=]() { return xrlpp::CSb_FluorLine_Kissel_Cascade(Z, L, E); });
+            assert_same([=]() { return xrlpp::CS_FluorLine_Kissel_no_Cascade<L>(Z, E); }, [=]() { return xrlpp::CS_FluorLine_Kissel_no_Cascade(Z, L, E); });
+            assert_same([=]() { return xrlpp::CS_FluorLine_Kissel_Radiative_Cascade<L>(Z, E); }, [=]() { return xrlpp::CS_FluorLine_Kissel_Radiative_Cascade(Z, L, E); });
+            assert_same([=]() { return xrlpp::CSb_FluorLine_Kissel_Nonradiative_Cascade<L>(Z, E); }, [=]() { return xrlpp::CSb_FluorLine_Kissel_Nonradiative_Cascade(Z, L, E); });
+        }
+    }
+}
+
+template<Line... L>
+static void test_lines(void) {
+    (test_line_energy<L>(), ...);
+}
+
+int main(int argc, char **argv) {
+    /* the typed identifiers are accepted wherever the macros are */
+    assert(xrlpp::LineEnergy(26, Line::KL3) == LineEnergy(26, KL3_LINE, NULL));
+    assert(xrlpp::EdgeEnergy(26, Shell::K) == EdgeEnergy(26, K_SHELL, NULL));
+    assert(xrlpp::CosKronTransProb(82, Transition::FL12) == CosKronTransProb(82, FL12_TRANS, NULL));
+    assert(xrlpp::CS_FluorLine_Kissel_Cascade(82, Line::LA, 20.0) == CS_FluorLine_Kissel_Cascade(82, LA_LINE, 20.0, NULL));
+    try {
+        xrlpp::RadRate(26, Line::LB);
+        abort();
+    }
+    catch (std::invalid_argument &e) {
+        assert(strcmp(e.what(), INVALID_LINE) == 0);
+    }
+    std::vector<double> rv = xrlpp::CS_FluorLine(26, Line::KA, std::vector<double>{10.0, 20.0});
+    assert(rv.size() == 2 && rv[1] == CS_FluorLine(26, KA_LINE, 20.0, NULL));
+
+    /* the kernels agree with the checked functions: groups, composed lines and single lines */
+    test_lines<Line::KA, Line::KB, Line::LA, Line::LB, Line::KO, Line::KP, Line::KL3, Line::KM3, Line::L3M5,
+        Line::L1N67, Line::L1O45, Line::L1P23, Line::L2P23, Line::L3O45, Line::L3P23, Line::L3P45, Line::M5N7, Line::P3P5>();
+
+    test_rad_rate<Line::KA>();
+    test_rad_rate<Line::KB>();
+    test_rad_rate<Line::LA>();
+    test_rad_rate<Line::KL3>();
+    test_rad_rate<Line::M5N7>();
+
+    test_cs_fluor_line<Line::KA>();
+    test_cs_fluor_line<Line::KB>();
+    test_cs_fluor_line<Line::LA>();
+    test_cs_fluor_line<Line::LB>();
+    test_cs_fluor_line<Line::KL2>();
+    test_cs_fluor_line<Line::L1M3>();
+    test_cs_fluor_line<Line::L2M4>();
+    test_cs_fluor_line<Line::L3O45>();
+
+    test_cs_fluor_line_kissel<Line::KA>();
+    test_cs_fluor_line_kissel<Line::KB>();
+    test_cs_fluor_line_kissel<Line::LA>();
+    test_cs_fluor_line_kissel<Line::LB>();
+    test_cs_fluor_line_kissel<Line::KL3>();
+    test_cs_fluor_line_kissel<Line::L2M4>();
+    test_cs_fluor_line_kissel<Line::M1N2>();
+    test_cs_fluor_line_kissel<Line::M5N7>();
+
+    /* L3P23 is composed of L3P2 and L3P3 */
+    assert(xrlpp::LineEnergy<Line::L3P23>(92) != xrlpp::LineEnergy<Line::L3O45>(92));
+
+    return 0;
+}
+
+#else
+
+int main(int argc, char **argv) {
+    /* skipped: the line kernels need C++17 */
+    return 77;
+}
+
+#endif
@@ -0,0 +1,151 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+#include "xraylib++.h"
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#ifdef XRLPP_HAVE_CXX17
+
+namespace nx = xrlpp::noexcept_api;
+
+int main(int argc, char **argv) {
+    /* the same values as the throwing functions */
+    nx::result<double> rv = nx::CS_Total(26, 10.0);
+    assert(rv && rv.has_value() && *rv == xrlpp::CS_Total(26, 10.0));
+    assert(*nx::AtomicWeight(26) == xrlpp::AtomicWeight(26));
+    assert(*nx::CS_FluorLine(26, KA_LINE, 10.0) == xrlpp::CS_FluorLine(26, KA_LINE, 10.0));
+    assert(*nx::CS_FluorLine(26, xrlpp::Line::KA, 10.0) == xrlpp::CS_FluorLine(26, KA_LINE, 10.0));
+    assert(*nx::CS_Total_CP("H2O", 10.0) == xrlpp::CS_Total_CP("H2O", 10.0));
+    assert(*nx::CS_Total_CP(std::string("Uranium Oxide"), 10.0) == xrlpp::CS_Total_CP("Uranium Oxide", 10.0));
+    assert(*nx::DCSP_Rayl(26, 10.0, M_PI / 4, M_PI / 4) == xrlpp::DCSP_Rayl(26, 10.0, M_PI / 4, M_PI / 4));
+    assert(*nx::LineEnergy<xrlpp::Line::KA>(26) == xrlpp::LineEnergy(26, KA_LINE));
+    assert(*nx::CS_FluorLine_Kissel<xrlpp::Line::LB>(82, 20.0) == xrlpp::CS_FluorLine_Kissel(82, LB_LINE, 20.0));
+
+    /* errors become codes */
+    rv = nx::CS_FluorLine(26, KA_LINE, 5.0);
+    assert(!rv && rv.error() == XRL_ERROR_INVALID_ARGUMENT);
+    assert(rv.value_or(-1.0) == -1.0);
+    assert(!nx::CS_Total(0, 10.0));
+    assert(!nx::CS_Total_CP("auau", 10.0));
+    assert(!nx::LineEnergy<xrlpp::Line::KA>(0));
+    assert(nx::RadRate<xrlpp::Line::KL3>(0).error() == XRL_ERROR_INVALID_ARGUMENT);
+    assert(!nx::CS_FluorLine<xrlpp::Line::KA>(26, 5.0));
+
+    /* also in a scan across an edge, where the throwing functions raise on every energy below it */
+    int failures = 0;
+    for (double E = 1.0 ; E < 10.0 ; E += 0.01)
+        if (!nx::CS_FluorLine_Kissel(26, KL3_LINE, E))
+            failures++;
+    assert(failures > 0 && failures < 900);
+
+    /* the other functions */
+    nx::result<std::complex<double>> n = nx::Refractive_Index("H2O", 1.0, 1.0);
+    assert(n && *n == xrlpp::Refractive_Index("H2O", 1.0, 1.0));
+    assert(!nx::Refractive_Index("H2O", 1.0, -1.0));
+
+    /* a compound resolved once */
+    nx::result<nx::compound> water = nx::ResolveCompound("H2O");
+    assert(water);
+    assert(*nx::CS_Total_CP(*water, 10.0) == xrlpp::CS_Total_CP("H2O", 10.0));
+    assert(*nx::DCSP_Rayl_CP(*nx::ResolveCompound("FeSO4"), 10.0, M_PI / 4, M_PI / 4) == xrlpp::DCSP_Rayl_CP("FeSO4", 10.0, M_PI / 4, M_PI / 4));
+    assert(!nx::CS_Total_CP(*water, -10.0));
+    assert(nx::ResolveCompound("auau").error() == XRL_ERROR_INVALID_ARGUMENT);
+    assert(std::fabs(*nx::Refractive_Index_Re(*water, 1.0, 1.0) / xrlpp::Refractive_Index_Re("H2O", 1.0, 1.0) - 1.0) < 1E-14);
+    assert(std::fabs(*nx::Refractive_Index_Im(*water, 1.0, 1.0) / xrlpp::Refractive_Index_Im("H2O", 1.0, 1.0) - 1.0) < 1E-14);
+    n = nx::Refractive_Index(*water, 1.0, 1.0);
+    assert(std::abs(*n - xrlpp::Refractive_Index("H2O", 1.0, 1.0)) < 1E-14);
+    assert(nx::Refractive_Index_Re(*water, 1.0, 0.0).error() == XRL_ERROR_INVALID_ARGUMENT);
+    assert(!nx::Refractive_Index(*water, 0.0, 1.0));
+    /* NIST compounds bring their density */
+    nx::result<nx::compound> liquid = nx::ResolveCompound("Water, Liquid");
+    assert(std::fabs(*nx::Refractive_Index_Im(*liquid, 1.0, 0.0) / xrlpp::Refractive_Index_Im("Water, Liquid", 1.0, 0.0) - 1.0) < 1E-14);
+
+    double energies[] = {1.0, 10.0};
+    xrlOpticalConstants constants[2];
+    assert(nx::Refractive_Index_Batch("H2O", energies, 1.0, 0.0, constants));
+    assert(constants[1].delta == xrlpp::Refractive_Index_Batch("H2O", energies, 1.0, 0.0)[1].delta);
+    assert(nx::Refractive_Index_Batch("H2O", energies, 1.0, 0.0, xrlpp::span<xrlOpticalConstants>(constants, 1)).error() == XRL_ERROR_INVALID_ARGUMENT);
+
+    assert(*nx::SymbolToAtomicNumber("Fe") == 26);
+    assert(!nx::SymbolToAtomicNumber("Xx"));
+    nx::result<nx::c_string> symbol = nx::AtomicNumberToSymbol(26);
+    assert(symbol && strcmp(symbol->get(), "Fe") == 0);
+    assert(!nx::AtomicNumberToSymbol(0));
+
+    nx::result<nx::compoundData> cd = nx::CompoundParser("H2O");
+    assert(cd && (*cd)->nElements == 2);
+    assert(nx::CompoundParser("H2O)").error() == XRL_ERROR_INVALID_ARGUMENT);
+    nx::result<nx::compoundDataNIST> cdn = nx::GetCompoundDataNISTByName("Water, Liquid");
+    assert(cdn && (*cdn)->nElements == 2);
+    assert(nx::GetCompoundDataNISTByIndex(0));
+    assert(!nx::GetCompoundDataNISTByIndex(-1));
+    nx::result<nx::radioNuclideData> rnd = nx::GetRadioNuclideDataByName("55Fe");
+    assert(rnd && (*rnd)->Z == 26);
+    assert(nx::GetRadioNuclideDataByIndex(0));
+    assert(!nx::GetRadioNuclideDataByName("auau"));
+
+    /* the lists */
+    nx::result<nx::string_list> names = nx::GetCompoundDataNISTList();
+    assert(names && names->size() == xrlpp::GetCompoundDataNISTList().size());
+    assert(strcmp((*names)[0], xrlpp::GetCompoundDataNISTList()[0].c_str()) == 0);
+    names = nx::GetRadioNuclideDataList();
+    assert(names && names->size() == xrlpp::GetRadioNuclideDataList().size());
+    std::size_t n_names = 0;
+    for (const char *name : *names)
+        n_names += name != nullptr;
+    assert(n_names == names->size());
+
+    /* crystals, shared or not */
+    nx::result<xrlpp::Crystal::SharedStruct> si = nx::Crystal::GetCrystalShared("Si");
+    assert(si && strcmp(si->name(), "Si") == 0);
+    assert(!nx::Crystal::GetCrystalShared("auau"));
+    xrlpp::Crystal::Struct cs = xrlpp::Crystal::GetCrystal("Si");
+    assert(*nx::Crystal::Bragg_angle(*si, 10.0, 1, 1, 1) == cs.Bragg_angle(10.0, 1, 1, 1));
+    assert(*nx::Crystal::Bragg_angle(cs, 10.0, 1, 1, 1) == cs.Bragg_angle(10.0, 1, 1, 1));
+    assert(!nx::Crystal::Bragg_angle(cs, -10.0, 1, 1, 1));
+    assert(*nx::Crystal::Q_scattering_amplitude(*si, 10.0, 1, 1, 1, M_PI / 4) == cs.Q_scattering_amplitude(10.0, 1, 1, 1, M_PI / 4));
+    assert(*nx::Crystal::F_H_StructureFactor(*si, 10.0, 1, 1, 1, 1.0, 1.0) == cs.F_H_StructureFactor(10.0, 1, 1, 1, 1.0, 1.0));
+    assert(*nx::Crystal::F_H_StructureFactor_Partial(cs, 10.0, 1, 1, 1, 1.0, 1.0, 2, 2, 0) == cs.F_H_StructureFactor_Partial(10.0, 1, 1, 1, 1.0, 1.0, 2, 2, 0));
+    assert(*nx::Crystal::UnitCellVolume(*si) == cs.UnitCellVolume());
+    assert(*nx::Crystal::dSpacing(*si, 1, 1, 1) == cs.dSpacing(1, 1, 1));
+    assert(!nx::Crystal::AddCrystal(cs));
+    assert(nx::Crystal::F_H_StructureFactor_Partial(cs, 10.0, 1, 1, 1, 1.0, 1.0, 3, 2, 0).error() == XRL_ERROR_INVALID_ARGUMENT);
+    assert(!nx::Crystal::F_H_StructureFactor_Partial(*si, 10.0, 1, 1, 1, 1.0, 1.0, 2, 1, 0));
+
+    nx::result<nx::Crystal::Struct> copy = nx::Crystal::GetCrystal("Si");
+    assert(copy && strcmp((*copy)->name, "Si") == 0 && (*copy)->n_atom == cs.n_atom);
+    assert(*nx::Crystal::dSpacing(*copy, 1, 1, 1) == cs.dSpacing(1, 1, 1));
+    assert(nx::Crystal::GetCrystal("auau").error() == XRL_ERROR_INVALID_ARGUMENT);
+    nx::result<nx::string_list> crystals = nx::Crystal::GetCrystalsList();
+    assert(crystals && crystals->size() == xrlpp::Crystal::GetCrystalsList().size());
+
+    double f0, f_prime, f_prime2;
+    assert(nx::Crystal::Atomic_Factors(14, 10.0, 1.0, 1.0, &f0, &f_prime, &f_prime2));
+    assert(!nx::Crystal::Atomic_Factors(0, 10.0, 1.0, 1.0, &f0, &f_prime, &f_prime2));
+
+    return 0;
+}
+
+#else
+
+int main(int argc, char **argv) {
+    /* skipped: the noexcept API needs C++17 */
+    return 77;
+}
+
+#endif
@@ -0,0 +1,157 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+#include "xraylib++.h"
+#include <cassert>
+#include <cmath>
+
+#ifdef XRLPP_HAVE_CXX17
+
+// libstdc++ before 11 fails to compile <execution> against oneTBB
+#if __has_include(<execution>) && (!defined(__GLIBCXX__) || _GLIBCXX_RELEASE >= 11)
+#include <execution>
+#endif
+
+static std::vector<double> energy_grid(std::size_t n) {
+    std::vector<double> E(n);
+    for (std::size_t i = 0 ; i < n ; i++)
+        E[i] = 1.0 * std::pow(100.0, static_cast<double>(i) / (n - 1));
+    return E;
+}
+
+// the tabulation must be identical to the scalar functions
+static void check_elements(const std::vector<int> &Zs, const std::vector<double> &E, const std::vector<double> &table) {
+    assert(table.size() == Zs.size() * E.size());
+    for (std::size_t i = 0 ; i < Zs.size() ; i++)
+        for (std::size_t j = 0 ; j < E.size() ; j++)
+            assert(table[i * E.size() + j] == xrlpp::CS_Total(Zs[i], E[j]));
+}
+
+int main(int argc, char **argv) {
+    /* more energies than a tile, and a remainder */
+    std::vector<double> E = energy_grid(1300);
+    std::vector<int> Zs;
+    for (int Z = 1 ; Z <= 94 ; Z += 3)
+        Zs.push_back(Z);
+
+    check_elements(Zs, E, xrlpp::tabulate(XRLPP_BATCH(CS_Total), Zs, E));
+    check_elements(Zs, E, xrlpp::tabulate(XRLPP_BATCH(CS_Total), Zs, E, xrlpp::threads{1}));
+    check_elements(Zs, E, xrlpp::tabulate(XRLPP_BATCH(CS_Total), Zs, E, xrlpp::threads{4}));
+    check_elements(Zs, E, xrlpp::tabulate(XRLPP_BATCH(CS_Total), Zs, E, xrlpp::threads{}));
+#ifdef __cpp_lib_execution
+    check_elements(Zs, E, xrlpp::tabulate(XRLPP_BATCH(CS_Total), Zs, E, std::execution::seq));
+#endif
+
+    /* more threads than tiles, and arrays of other kinds */
+    int few[] = {26, 82};
+    double E_few[] = {10.0, 20.0, 30.0};
+    std::vector<double> table = xrlpp::tabulate(XRLPP_BATCH(CS_Total), few, E_few, xrlpp::threads{16});
+    check_elements({26, 82}, {10.0, 20.0, 30.0}, table);
+
+    /* compounds */
+    std::vector<std::string> compounds = {"H2O", "SiO2", "Uranium Oxide"};
+    table = xrlpp::tabulate(XRLPP_BATCH(CS_Total_CP), compounds, E, xrlpp::threads{3});
+    for (std::size_t i = 0 ; i < compounds.size() ; i++)
+        for (std::size_t j = 0 ; j < E.size() ; j += 7)
+            assert(table[i * E.size() + j] == xrlpp::CS_Total_CP(compounds[i], E[j]));
+
+    /* lines of one element */
+    std::vector<xrlpp::Line> lines = {xrlpp::Line::KL3, xrlpp::Line::KA, xrlpp::Line::KB};
+    std::vector<double> E_lines = {10.0, 20.0, 50.0};
+    table = xrlpp::tabulate([](auto out, auto &status, xrlpp::Line line, auto E) {
+        xrlpp::CS_FluorLine_Kissel(out, status, 26, line, E);
+    }, lines, E_lines, xrlpp::threads{2});
+    for (std::size_t i = 0 ; i < lines.size() ; i++)
+        for (std::size_t j = 0 ; j < E_lines.size() ; j++)
+            assert(table[i * E_lines.size() + j] == xrlpp::CS_FluorLine_Kissel(26, lines[i], E_lines[j]));
+
+    /* failures are reported with their index in the table */
+    std::vector<int> invalid = {26, 0, 82};
+    std::vector<double> out(invalid.size() * E.size(), -1.0);
+    xrlpp::batch_status status;
+    status.push_back({0, XRL_ERROR_RUNTIME, "stale"});
+    xrlpp::tabulate(XRLPP_BATCH(CS_Total), invalid, E, xrlpp::span<double>(out), status, xrlpp::threads{4});
+    assert(status.size() == E.size());
+    for (std::size_t j = 0 ; j < E.size() ; j++) {
+        assert(status[j].index == E.size() + j);
+        assert(status[j].code == XRL_ERROR_INVALID_ARGUMENT);
+        assert(out[E.size() + j] == 0.0);
+        assert(out[j] == xrlpp::CS_Total(26, E[j]));
+        assert(out[2 * E.size() + j] == xrlpp::CS_Total(82, E[j]));
+    }
+    try {
+        xrlpp::tabulate(XRLPP_BATCH(CS_Total), invalid, E, xrlpp::threads{4});
+        abort();
+    }
+    catch (const xrlpp::batch_error &e) {
+        assert(e.failures().size() == E.size());
+        assert(e.failures()[0].index == E.size());
+    }
+
+    /* the output must fit the table */
+    try {
+        xrlpp::tabulate(XRLPP_BATCH(CS_Total), Zs, E, xrlpp::span<double>(out), status);
+        abort();
+    }
+    catch (const std::invalid_argument &) {
+    }
+
+    /* exceptions thrown by the function reach the caller */
+    try {
+        xrlpp::tabulate([](auto out, auto &status, int Z, auto E) {
+            if (Z == 40)
+                throw std::runtime_error("Z = 40");
+            xrlpp::CS_Total(out, status, Z, E);
+        }, Zs, E, xrlpp::threads{4});
+        abort();
+    }
+    catch (const std::runtime_error &e) {
+        assert(std::string(e.what()) == "Z = 40");
+    }
+
+    /* the pool is busy with the outer call: the inner ones run on their calling thread */
+    table = xrlpp::tabulate([](auto out, auto & /*status*/, int Z, auto E_tile) {
+        std::vector<double> inner = xrlpp::tabulate(XRLPP_BATCH(CS_Total), std::vector<int>{Z}, E_tile, xrlpp::threads{4});
+        std::copy(inner.begin(), inner.end(), out.begin());
+    }, Zs, E, xrlpp::threads{4});
+    check_elements(Zs, E, table);
+
+    /* concurrent calls: those that find the pool busy run on their calling thread, with the same results */
+    std::vector<std::thread> callers;
+    for (int i = 0 ; i < 4 ; i++)
+        callers.emplace_back([&]() {
+            for (int j = 0 ; j < 5 ; j++)
+                check_elements(Zs, E, xrlpp::tabulate(XRLPP_BATCH(CS_Total), Zs, E, xrlpp::threads{3}));
+        });
+    for (auto &caller : callers)
+        caller.join();
+
+    /* empty tables */
+    std::vector<double> no_energies;
+    assert(xrlpp::tabulate(XRLPP_BATCH(CS_Total), std::vector<int>(), E, xrlpp::threads{4}).empty());
+    assert(xrlpp::tabulate(XRLPP_BATCH(CS_Total), Zs, no_energies, xrlpp::threads{4}).empty());
+
+    return 0;
+}
+
+#else
+
+int main(int argc, char **argv) {
+    /* skipped: tabulate needs C++17 */
+    return 77;
+}
+
+#endif
@@ -0,0 +1,570 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef XRAYLIB_PLUSPLUS_IDENTIFIERS_H
+#define XRAYLIB_PLUSPLUS_IDENTIFIERS_H
+
+#include <xraylib.h>
+#include <stdexcept>
+
+namespace xrlpp {
+    /*
+     * Typed identifiers for shells, lines and Coster-Kronig transitions.
+     *
+     * Their values are those of the K_SHELL, KL3_LINE and FL12_TRANS macros, and the functions of xraylib++.h
+     * accept them wherever the macros are expected. Unlike the macros, they do not convert to int or to each other,
+     * so a shell cannot be passed where a line is expected.
+     */
+    enum class Shell : int {
+        K = K_SHELL,
+        L1 = L1_SHELL,
+        L2 = L2_SHELL,
+        L3 = L3_SHELL,
+        M1 = M1_SHELL,
+        M2 = M2_SHELL,
+        M3 = M3_SHELL,
+        M4 = M4_SHELL,
+        M5 = M5_SHELL,
+        N1 = N1_SHELL,
+        N2 = N2_SHELL,
+        N3 = N3_SHELL,
+        N4 = N4_SHELL,
+        N5 = N5_SHELL,
+        N6 = N6_SHELL,
+        N7 = N7_SHELL,
+        O1 = O1_SHELL,
+        O2 = O2_SHELL,
+        O3 = O3_SHELL,
+        O4 = O4_SHELL,
+        O5 = O5_SHELL,
+        O6 = O6_SHELL,
+        O7 = O7_SHELL,
+        P1 = P1_SHELL,
+        P2 = P2_SHELL,
+        P3 = P3_SHELL,
+        P4 = P4_SHELL,
+        P5 = P5_SHELL,
+        Q1 = Q1_SHELL,
+        Q2 = Q2_SHELL,
+        Q3 = Q3_SHELL,
+    };
+
+    enum class Line : int {
+        // line groups
+        KA = KA_LINE,
+        KB = KB_LINE,
+        LA = LA_LINE,
+        LB = LB_LINE,
+
+        // IUPAC notation
+        KL1 = KL1_LINE,
+        KL2 = KL2_LINE,
+        KL3 = KL3_LINE,
+        KM1 = KM1_LINE,
+        KM2 = KM2_LINE,
+        KM3 = KM3_LINE,
+        KM4 = KM4_LINE,
+        KM5 = KM5_LINE,
+        KN1 = KN1_LINE,
+        KN2 = KN2_LINE,
+        KN3 = KN3_LINE,
+        KN4 = KN4_LINE,
+        KN5 = KN5_LINE,
+        KN6 = KN6_LINE,
+        KN7 = KN7_LINE,
+        KO = KO_LINE,
+        KO1 = KO1_LINE,
+        KO2 = KO2_LINE,
+        KO3 = KO3_LINE,
+        KO4 = KO4_LINE,
+        KO5 = KO5_LINE,
+        KO6 = KO6_LINE,
+        KO7 = KO7_LINE,
+        KP = KP_LINE,
+        KP1 = KP1_LINE,
+        KP2 = KP2_LINE,
+        KP3 = KP3_LINE,
+        KP4 = KP4_LINE,
+        KP5 = KP5_LINE,
+        L1L2 = L1L2_LINE,
+        L1L3 = L1L3_LINE,
+        L1M1 = L1M1_LINE,
+        L1M2 = L1M2_LINE,
+        L1M3 = L1M3_LINE,
+        L1M4 = L1M4_LINE,
+        L1M5 = L1M5_LINE,
+        L1N1 = L1N1_LINE,
+        L1N2 = L1N2_LINE,
+        L1N3 = L1N3_LINE,
+        L1N4 = L1N4_LINE,
+        L1N5 = L1N5_LINE,
+        L1N6 = L1N6_LINE,
+        L1N67 = L1N67_LINE,
+        L1N7 = L1N7_LINE,
+        L1O1 = L1O1_LINE,
+        L1O2 = L1O2_LINE,
+        L1O3 = L1O3_LINE,
+        L1O4 = L1O4_LINE,
+        L1O45 = L1O45_LINE,
+        L1O5 = L1O5_LINE,
+        L1O6 = L1O6_LINE,
+        L1O7 = L1O7_LINE,
+        L1P1 = L1P1_LINE,
+        L1P2 = L1P2_LINE,
+        L1P23 = L1P23_LINE,
+        L1P3 = L1P3_LINE,
+        L1P4 = L1P4_LINE,
+        L1P5 = L1P5_LINE,
+        L2L3 = L2L3_LINE,
+        L2M1 = L2M1_LINE,
+        L2M2 = L2M2_LINE,
+        L2M3 = L2M3_LINE,
+        L2M4 = L2M4_LINE,
+        L2M5 = L2M5_LINE,
+        L2N1 = L2N1_LINE,
+        L2N2 = L2N2_LINE,
+        L2N3 = L2N3_LINE,
+        L2N4 = L2N4_LINE,
+        L2N5 = L2N5_LINE,
+        L2N6 = L2N6_LINE,
+        L2N7 = L2N7_LINE,
+        L2O1 = L2O1_LINE,
+        L2O2 = L2O2_LINE,
+        L2O3 = L2O3_LINE,
+        L2O4 = L2O4_LINE,
+        L2O5 = L2O5_LINE,
+        L2O6 = L2O6_LINE,
+        L2O7 = L2O7_LINE,
+        L2P1 = L2P1_LINE,
+        L2P2 = L2P2_LINE,
+        L2P23 = L2P23_LINE,
+        L2P3 = L2P3_LINE,
+        L2P4 = L2P4_LINE,
+        L2P5 = L2P5_LINE,
+        L2Q1 = L2Q1_LINE,
+        L3M1 = L3M1_LINE,
+        L3M2 = L3M2_LINE,
+        L3M3 = L3M3_LINE,
+        L3M4 = L3M4_LINE,
+        L3M5 = L3M5_LINE,
+        L3N1 = L3N1_LINE,
+        L3N2 = L3N2_LINE,
+        L3N3 = L3N3_LINE,
+        L3N4 = L3N4_LINE,
+        L3N5 = L3N5_LINE,
+        L3N6 = L3N6_LINE,
+        L3N7 = L3N7_LINE,
+        L3O1 = L3O1_LINE,
+        L3O2 = L3O2_LINE,
+        L3O3 = L3O3_LINE,
+        L3O4 = L3O4_LINE,
+        L3O45 = L3O45_LINE,
+        L3O5 = L3O5_LINE,
+        L3O6 = L3O6_LINE,
+        L3O7 = L3O7_LINE,
+        L3P1 = L3P1_LINE,
+        L3P2 = L3P2_LINE,
+        L3P23 = L3P23_LINE,
+        L3P3 = L3P3_LINE,
+        L3P4 = L3P4_LINE,
+        L3P45 = L3P45_LINE,
+        L3P5 = L3P5_LINE,
+        L3Q1 = L3Q1_LINE,
+        M1M2 = M1M2_LINE,
+        M1M3 = M1M3_LINE,
+        M1M4 = M1M4_LINE,
+        M1M5 = M1M5_LINE,
+        M1N1 = M1N1_LINE,
+        M1N2 = M1N2_LINE,
+        M1N3 = M1N3_LINE,
+        M1N4 = M1N4_LINE,
+        M1N5 = M1N5_LINE,
+        M1N6 = M1N6_LINE,
+        M1N7 = M1N7_LINE,
+        M1O1 = M1O1_LINE,
+        M1O2 = M1O2_LINE,
+        M1O3 = M1O3_LINE,
+        M1O4 = M1O4_LINE,
+        M1O5 = M1O5_LINE,
+        M1O6 = M1O6_LINE,
+        M1O7 = M1O7_LINE,
+        M1P1 = M1P1_LINE,
+        M1P2 = M1P2_LINE,
+        M1P3 = M1P3_LINE,
+        M1P4 = M1P4_LINE,
+        M1P5 = M1P5_LINE,
+        M2M3 = M2M3_LINE,
+        M2M4 = M2M4_LINE,
+        M2M5 = M2M5_LINE,
+        M2N1 = M2N1_LINE,
+        M2N2 = M2N2_LINE,
+        M2N3 = M2N3_LINE,
+        M2N4 = M2N4_LINE,
+        M2N5 = M2N5_LINE,
+        M2N6 = M2N6_LINE,
+        M2N7 = M2N7_LINE,
+        M2O1 = M2O1_LINE,
+        M2O2 = M2O2_LINE,
+        M2O3 = M2O3_LINE,
+        M2O4 = M2O4_LINE,
+        M2O5 = M2O5_LINE,
+        M2O6 = M2O6_LINE,
+        M2O7 = M2O7_LINE,
+        M2P1 = M2P1_LINE,
+        M2P2 = M2P2_LINE,
+        M2P3 = M2P3_LINE,
+        M2P4 = M2P4_LINE,
+        M2P5 = M2P5_LINE,
+        M3M4 = M3M4_LINE,
+        M3M5 = M3M5_LINE,
+        M3N1 = M3N1_LINE,
+        M3N2 = M3N2_LINE,
+        M3N3 = M3N3_LINE,
+        M3N4 = M3N4_LINE,
+        M3N5 = M3N5_LINE,
+        M3N6 = M3N6_LINE,
+        M3N7 = M3N7_LINE,
+        M3O1 = M3O1_LINE,
+        M3O2 = M3O2_LINE,
+        M3O3 = M3O3_LINE,
+        M3O4 = M3O4_LINE,
+        M3O5 = M3O5_LINE,
+        M3O6 = M3O6_LINE,
+        M3O7 = M3O7_LINE,
+        M3P1 = M3P1_LINE,
+        M3P2 = M3P2_LINE,
+        M3P3 = M3P3_LINE,
+        M3P4 = M3P4_LINE,
+        M3P5 = M3P5_LINE,
+        M3Q1 = M3Q1_LINE,
+        M4M5 = M4M5_LINE,
+        M4N1 = M4N1_LINE,
+        M4N2 = M4N2_LINE,
+        M4N3 = M4N3_LINE,
+        M4N4 = M4N4_LINE,
+        M4N5 = M4N5_LINE,
+        M4N6 = M4N6_LINE,
+        M4N7 = M4N7_LINE,
+        M4O1 = M4O1_LINE,
+        M4O2 = M4O2_LINE,
+        M4O3 = M4O3_LINE,
+        M4O4 = M4O4_LINE,
+        M4O5 = M4O5_LINE,
+        M4O6 = M4O6_LINE,
+        M4O7 = M4O7_LINE,
+        M4P1 = M4P1_LINE,
+        M4P2 = M4P2_LINE,
+        M4P3 = M4P3_LINE,
+        M4P4 = M4P4_LINE,
+        M4P5 = M4P5_LINE,
+        M5N1 = M5N1_LINE,
+        M5N2 = M5N2_LINE,
+        M5N3 = M5N3_LINE,
+        M5N4 = M5N4_LINE,
+        M5N5 = M5N5_LINE,
+        M5N6 = M5N6_LINE,
+        M5N7 = M5N7_LINE,
+        M5O1 = M5O1_LINE,
+        M5O2 = M5O2_LINE,
+        M5O3 = M5O3_LINE,
+        M5O4 = M5O4_LINE,
+        M5O5 = M5O5_LINE,
+        M5O6 = M5O6_LINE,
+        M5O7 = M5O7_LINE,
+        M5P1 = M5P1_LINE,
+        M5P2 = M5P2_LINE,
+        M5P3 = M5P3_LINE,
+        M5P4 = M5P4_LINE,
+        M5P5 = M5P5_LINE,
+        N1N2 = N1N2_LINE,
+        N1N3 = N1N3_LINE,
+        N1N4 = N1N4_LINE,
+        N1N5 = N1N5_LINE,
+        N1N6 = N1N6_LINE,
+        N1N7 = N1N7_LINE,
+        N1O1 = N1O1_LINE,
+        N1O2 = N1O2_LINE,
+        N1O3 = N1O3_LINE,
+        N1O4 = N1O4_LINE,
+        N1O5 = N1O5_LINE,
+        N1O6 = N1O6_LINE,
+        N1O7 = N1O7_LINE,
+        N1P1 = N1P1_LINE,
+        N1P2 = N1P2_LINE,
+        N1P3 = N1P3_LINE,
+        N1P4 = N1P4_LINE,
+        N1P5 = N1P5_LINE,
+        N2N3 = N2N3_LINE,
+        N2N4 = N2N4_LINE,
+        N2N5 = N2N5_LINE,
+        N2N6 = N2N6_LINE,
+        N2N7 = N2N7_LINE,
+        N2O1 = N2O1_LINE,
+        N2O2 = N2O2_LINE,
+        N2O3 = N2O3_LINE,
+        N2O4 = N2O4_LINE,
+        N2O5 = N2O5_LINE,
+        N2O6 = N2O6_LINE,
+        N2O7 = N2O7_LINE,
+        N2P1 = N2P1_LINE,
+        N2P2 = N2P2_LINE,
+        N2P3 = N2P3_LINE,
+        N2P4 = N2P4_LINE,
+        N2P5 = N2P5_LINE,
+        N3N4 = N3N4_LINE,
+        N3N5 = N3N5_LINE,
+        N3N6 = N3N6_LINE,
+        N3N7 = N3N7_LINE,
+        N3O1 = N3O1_LINE,
+        N3O2 = N3O2_LINE,
+        N3O3 = N3O3_LINE,
+        N3O4 = N3O4_LINE,
+        N3O5 = N3O5_LINE,
+        N3O6 = N3O6_LINE,
+        N3O7 = N3O7_LINE,
+        N3P1 = N3P1_LINE,
+        N3P2 = N3P2_LINE,
+        N3P3 = N3P3_LINE,
+        N3P4 = N3P4_LINE,
+        N3P5 = N3P5_LINE,
+        N4N5 = N4N5_LINE,
+        N4N6 = N4N6_LINE,
+        N4N7 = N4N7_LINE,
+        N4O1 = N4O1_LINE,
+        N4O2 = N4O2_LINE,
+        N4O3 = N4O3_LINE,
+        N4O4 = N4O4_LINE,
+        N4O5 = N4O5_LINE,
+        N4O6 = N4O6_LINE,
+        N4O7 = N4O7_LINE,
+        N4P1 = N4P1_LINE,
+        N4P2 = N4P2_LINE,
+        N4P3 = N4P3_LINE,
+        N4P4 = N4P4_LINE,
+        N4P5 = N4P5_LINE,
+        N5N6 = N5N6_LINE,
+        N5N7 = N5N7_LINE,
+        N5O1 = N5O1_LINE,
+        N5O2 = N5O2_LINE,
+        N5O3 = N5O3_LINE,
+        N5O4 = N5O4_LINE,
+        N5O5 = N5O5_LINE,
+        N5O6 = N5O6_LINE,
+        N5O7 = N5O7_LINE,
+        N5P1 = N5P1_LINE,
+        N5P2 = N5P2_LINE,
+        N5P3 = N5P3_LINE,
+        N5P4 = N5P4_LINE,
+        N5P5 = N5P5_LINE,
+        N6N7 = N6N7_LINE,
+        N6O1 = N6O1_LINE,
+        N6O2 = N6O2_LINE,
+        N6O3 = N6O3_LINE,
+        N6O4 = N6O4_LINE,
+        N6O5 = N6O5_LINE,
+        N6O6 = N6O6_LINE,
+        N6O7 = N6O7_LINE,
+        N6P1 = N6P1_LINE,
+        N6P2 = N6P2_LINE,
+        N6P3 = N6P3_LINE,
+        N6P4 = N6P4_LINE,
+        N6P5 = N6P5_LINE,
+        N7O1 = N7O1_LINE,
+        N7O2 = N7O2_LINE,
+        N7O3 = N7O3_LINE,
+        N7O4 = N7O4_LINE,
+        N7O5 = N7O5_LINE,
+        N7O6 = N7O6_LINE,
+        N7O7 = N7O7_LINE,
+        N7P1 = N7P1_LINE,
+        N7P2 = N7P2_LINE,
+        N7P3 = N7P3_LINE,
+        N7P4 = N7P4_LINE,
+        N7P5 = N7P5_LINE,
+        O1O2 = O1O2_LINE,
+        O1O3 = O1O3_LINE,
+        O1O4 = O1O4_LINE,
+        O1O5 = O1O5_LINE,
+        O1O6 = O1O6_LINE,
+        O1O7 = O1O7_LINE,
+        O1P1 = O1P1_LINE,
+        O1P2 = O1P2_LINE,
+        O1P3 = O1P3_LINE,
+        O1P4 = O1P4_LINE,
+        O1P5 = O1P5_LINE,
+        O2O3 = O2O3_LINE,
+        O2O4 = O2O4_LINE,
+        O2O5 = O2O5_LINE,
+        O2O6 = O2O6_LINE,
+        O2O7 = O2O7_LINE,
+        O2P1 = O2P1_LINE,
+        O2P2 = O2P2_LINE,
+        O2P3 = O2P3_LINE,
+        O2P4 = O2P4_LINE,
+        O2P5 = O2P5_LINE,
+        O3O4 = O3O4_LINE,
+        O3O5 = O3O5_LINE,
+        O3O6 = O3O6_LINE,
+        O3O7 = O3O7_LINE,
+        O3P1 = O3P1_LINE,
+        O3P2 = O3P2_LINE,
+        O3P3 = O3P3_LINE,
+        O3P4 = O3P4_LINE,
+        O3P5 = O3P5_LINE,
+        O4O5 = O4O5_LINE,
+        O4O6 = O4O6_LINE,
+        O4O7 = O4O7_LINE,
+        O4P1 = O4P1_LINE,
+        O4P2 = O4P2_LINE,
+        O4P3 = O4P3_LINE,
+        O4P4 = O4P4_LINE,
+        O4P5 = O4P5_LINE,
+        O5O6 = O5O6_LINE,
+        O5O7 = O5O7_LINE,
+        O5P1 = O5P1_LINE,
+        O5P2 = O5P2_LINE,
+        O5P3 = O5P3_LINE,
+        O5P4 = O5P4_LINE,
+        O5P5 = O5P5_LINE,
+        O6O7 = O6O7_LINE,
+        O6P4 = O6P4_LINE,
+        O6P5 = O6P5_LINE,
+        O7P4 = O7P4_LINE,
+        O7P5 = O7P5_LINE,
+        P1P2 = P1P2_LINE,
+        P1P3 = P1P3_LINE,
+        P1P4 = P1P4_LINE,
+        P1P5 = P1P5_LINE,
+        P2P3 = P2P3_LINE,
+        P2P4 = P2P4_LINE,
+        P2P5 = P2P5_LINE,
+        P3P4 = P3P4_LINE,
+        P3P5 = P3P5_LINE,
+
+        // Siegbahn notation
+        KA1 = KA1_LINE,
+        KA2 = KA2_LINE,
+        KA3 = KA3_LINE,
+        KB1 = KB1_LINE,
+        KB2 = KB2_LINE,
+        KB3 = KB3_LINE,
+        KB4 = KB4_LINE,
+        KB5 = KB5_LINE,
+        LA1 = LA1_LINE,
+        LA2 = LA2_LINE,
+        LB1 = LB1_LINE,
+        LB2 = LB2_LINE,
+        LB3 = LB3_LINE,
+        LB4 = LB4_LINE,
+        LB5 = LB5_LINE,
+        LB6 = LB6_LINE,
+        LB7 = LB7_LINE,
+        LB9 = LB9_LINE,
+        LB10 = LB10_LINE,
+        LB15 = LB15_LINE,
+        LB17 = LB17_LINE,
+        LG1 = LG1_LINE,
+        LG2 = LG2_LINE,
+        LG3 = LG3_LINE,
+        LG4 = LG4_LINE,
+        LG5 = LG5_LINE,
+        LG6 = LG6_LINE,
+        LG8 = LG8_LINE,
+        LE = LE_LINE,
+        LH = LH_LINE,
+        LL = LL_LINE,
+        LS = LS_LINE,
+        LT = LT_LINE,
+        LU = LU_LINE,
+        LV = LV_LINE,
+        MA1 = MA1_LINE,
+        MA2 = MA2_LINE,
+        MB = MB_LINE,
+        MG = MG_LINE,
+    };
+
+    enum class Transition : int {
+        FL12 = FL12_TRANS,
+        FL13 = FL13_TRANS,
+        FLP13 = FLP13_TRANS,
+        FL23 = FL23_TRANS,
+        FM12 = FM12_TRANS,
+        FM13 = FM13_TRANS,
+        FM14 = FM14_TRANS,
+        FM15 = FM15_TRANS,
+        FM23 = FM23_TRANS,
+        FM24 = FM24_TRANS,
+        FM25 = FM25_TRANS,
+        FM34 = FM34_TRANS,
+        FM35 = FM35_TRANS,
+        FM45 = FM45_TRANS,
+    };
+
+    // KA, KB, LA and LB
+    constexpr bool is_group(Line line) noexcept {
+        return static_cast<int>(line) >= KA_LINE && static_cast<int>(line) <= LB_LINE;
+    }
+
+    // the lines of a group, which LineEnergy averages, weighted by their intensity
+    constexpr bool in_group(Line group, Line line) noexcept {
+        return group == Line::KA ? static_cast<int>(line) <= KL1_LINE && static_cast<int>(line) >= KL3_LINE :
+            group == Line::KB ? static_cast<int>(line) <= KM1_LINE && static_cast<int>(line) >= KP4_LINE :
+            group == Line::LA ? line == Line::L3M4 || line == Line::L3M5 :
+            group == Line::LB ?
+                line == Line::LB1 || line == Line::LB2 || line == Line::LB3 || line == Line::LB4 ||
+                line == Line::LB5 || line == Line::LB6 || line == Line::LB7 || line == Line::LB9 ||
+                line == Line::LB10 || line == Line::LB15 || line == Line::LB17 || line == Line::L3N6 ||
+                line == Line::L3N7 :
+            false;
+    }
+
+    constexpr Shell _parent_shell(int line) {
+        return line > LB_LINE || line < P3P5_LINE ? throw std::invalid_argument("Unknown line macro provided") :
+            line == LB_LINE ? throw std::invalid_argument("LB_LINE combines lines of the L1, L2 and L3 shells") :
+            line == LA_LINE ? Shell::L3 :
+            line >= KP5_LINE ? Shell::K :
+            line >= L1P5_LINE ? Shell::L1 :
+            line >= L2Q1_LINE ? Shell::L2 :
+            line >= L3Q1_LINE ? Shell::L3 :
+            line >= M1P5_LINE ? Shell::M1 :
+            line >= M2P5_LINE ? Shell::M2 :
+            line >= M3Q1_LINE ? Shell::M3 :
+            line >= M4P5_LINE ? Shell::M4 :
+            line >= M5P5_LINE ? Shell::M5 :
+            line >= N1P5_LINE ? Shell::N1 :
+            line >= N2P5_LINE ? Shell::N2 :
+            line >= N3P5_LINE ? Shell::N3 :
+            line >= N4P5_LINE ? Shell::N4 :
+            line >= N5P5_LINE ? Shell::N5 :
+            line >= N6P5_LINE ? Shell::N6 :
+            line >= N7P5_LINE ? Shell::N7 :
+            line >= O1P5_LINE ? Shell::O1 :
+            line >= O2P5_LINE ? Shell::O2 :
+            line >= O3P5_LINE ? Shell::O3 :
+            line >= O4P5_LINE ? Shell::O4 :
+            line >= O5P5_LINE ? Shell::O5 :
+            line >= O6P5_LINE ? Shell::O6 :
+            line >= O7P5_LINE ? Shell::O7 :
+            line >= P1P5_LINE ? Shell::P1 :
+            line >= P2P5_LINE ? Shell::P2 :
+            line >= P3P5_LINE ? Shell::P3 :
+            throw std::invalid_argument("Unknown line macro provided");
+    }
+
+    // the shell with the vacancy that a line fills: that of all of its lines for KA, KB and LA.
+    // Used in a constant expression, an unknown line or LB does not compile.
+    constexpr Shell parent_shell(Line line) {
+        return _parent_shell(static_cast<int>(line));
+    }
+}
+
+#endif
@@ -17,32 +17,131 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 #include <xraylib.h>
 #include <stdexcept>
 #include <complex>
+#include <type_traits>
 #include <vector>
+#include "xraylib++-identifiers.h"
+
+// the batch overloads and the line kernels need C++17
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define XRLPP_HAVE_CXX17 1
+#define XRLPP_HAVE_BATCH 1
+#include <xraylib-fast.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#endif
 
 using _compoundDataPod = struct compoundData;
 using _radioNuclideDataPod = struct radioNuclideData;
 using _compoundDataNISTPod = struct compoundDataNIST;
 
 
-#define _XRL_FUNCTION(_name) \
-    template<typename... T> \
+// the scalar overloads step aside when one of the arguments is an array
+#ifdef XRLPP_HAVE_BATCH
+#define _XRL_SCALAR_ONLY(T) , std::enable_if_t<!_any_array_v<T...>, int> = 0
+#define _XRL_BATCH_ONLY(T) , std::enable_if_t<_is_batch_call_v<T...>, int> = 0
+#else
+#define _XRL_SCALAR_ONLY(T)
+#endif
+
+#define _XRL_SCALAR_FUNCTION(_name) \
+    template<typename... T _XRL_SCALAR_ONLY(T)> \
     double _name(const std::string &compound, const T... args) { \
         xrl_error *error = nullptr; \
-        double rv = ::_name(compound.c_str(), args..., &error); \
+        double rv = ::_name(compound.c_str(), _c_arg(args)..., &error); \
         _process_error(error); \
         return rv; \
     } \
-    template<typename ...T> \
+    template<typename ...T _XRL_SCALAR_ONLY(T)> \
     double _name(const T... args) { \
         xrl_error *error = nullptr; \
-        double rv = ::_name(args..., &error); \
+        double rv = ::_name(_c_arg(args)..., &error); \
         _process_error(error); \
         return rv; \
+    } \
+    _XRL_NOEXCEPT_FUNCTION(_name)
+
+#ifdef XRLPP_HAVE_CXX17
+#define _XRL_NOEXCEPT_FUNCTION(_name) \
+    namespace noexcept_api { \
+        template<typename... T _XRL_SCALAR_ONLY(T)> \
+        result<double> _name(const T&... args) noexcept { \
+            xrl_error *error = nullptr; \
+            double rv = ::_name(_c_arg(args)..., &error); \
+            return _result(rv, error); \
+        } \
+    }
+#else
+#define _XRL_NOEXCEPT_FUNCTION(_name)
+#endif
+
+#ifdef XRLPP_HAVE_BATCH
+
+// _kernel evaluates one element, from the error slot (which converts to xrl_error **) and the elements a of the arguments;
+// _compound is either empty or _XRL_COMPOUND_PARAMETER
+#define _XRL_COMPOUND_PARAMETER const std::string &compound,
+#define _XRL_BATCH_FUNCTION(_name, _compound, _setup, _kernel) \
+    template<typename... T _XRL_BATCH_ONLY(T)> \
+    std::vector<double> _name(_compound const T&... args) { \
+        _setup \
+        return _batch_vector([&](_batch_error_slot &error, auto... a) { return _kernel; }, args...); \
+    } \
+    template<typename... T _XRL_BATCH_ONLY(T)> \
+    void _name(span<double> out, batch_status &status, _compound const T&... args) { \
+        _setup \
+        _batch_span(out, status, [&](_batch_error_slot &error, auto... a) { return _kernel; }, args...); \
+    }
+
+#define _XRL_FUNCTION(_name) \
+    _XRL_SCALAR_FUNCTION(_name) \
+    _XRL_BATCH_FUNCTION(_name, , , ::_name(_c_arg(a)..., error)) \
+    _XRL_BATCH_FUNCTION(_name, _XRL_COMPOUND_PARAMETER, , ::_name(compound.c_str(), _c_arg(a)..., error))
+
+// functions of Z and E with a _ctx counterpart, which remembers the last interval of every table
+#define _XRL_CONTEXT_FUNCTION(_name) \
+    _XRL_SCALAR_FUNCTION(_name) \
+    _XRL_BATCH_FUNCTION(_name, , _batch_context context;, context.evaluate(::_name##_ctx, error, a...))
+
+// compound versions of elemental functions: the compound is resolved once for the whole batch,
+// unless it is invalid, in which case every element reports the error.
+// The noexcept_api functions also take a compound resolved beforehand by noexcept_api::ResolveCompound.
+#define _XRL_COMPOUND_FUNCTION(_name) \
+    _XRL_SCALAR_FUNCTION(_name##_CP) \
+    _XRL_BATCH_FUNCTION(_name##_CP, _XRL_COMPOUND_PARAMETER, _batch_compound resolved(compound.c_str());, \
+        resolved ? resolved.evaluate([](auto... b) { return ::_name(b...); }, error, a...) : ::_name##_CP(compound.c_str(), a..., error)) \
+    namespace noexcept_api { \
+        template<typename... T _XRL_SCALAR_ONLY(T)> \
+        result<double> _name##_CP(const compound &resolved, const T&... args) noexcept { \
+            xrl_error *error = nullptr; \
+            double rv = resolved._get().evaluate([](auto... b) { return ::_name(b...); }, &error, _c_arg(args)...); \
+            return _result(rv, error); \
+        } \
     }
 
+// the batch form of an xrlpp function, as a callable for xrlpp::tabulate
+#define XRLPP_BATCH(_name) \
+    [](xrlpp::span<double> out, xrlpp::batch_status &status, const auto &... args) { xrlpp::_name(out, status, args...); }
+
+#else
+
+#define _XRL_FUNCTION(_name) _XRL_SCALAR_FUNCTION(_name)
+#define _XRL_CONTEXT_FUNCTION(_name) _XRL_SCALAR_FUNCTION(_name)
+#define _XRL_COMPOUND_FUNCTION(_name) _XRL_SCALAR_FUNCTION(_name##_CP)
+
+#endif
+
 
 namespace xrlpp {
-    void _process_error(xrl_error *error) {
+    inline void _process_error(xrl_error *error) {
         if (!error)
             return;
         switch (error->code) {
@@ -55,25 +154,586 @@ namespace xrlpp {
         }
     }
 
-    void XrayInit(void) {
+    // typed identifiers are passed to the C functions as the values of their macros
+    template<typename T>
+    constexpr typename std::enable_if<!std::is_enum<T>::value, T>::type _c_arg(const T arg) noexcept {
+        return arg;
+    }
+
+    template<typename T>
+    constexpr typename std::underlying_type<typename std::enable_if<std::is_enum<T>::value, T>::type>::type _c_arg(const T arg) noexcept {
+        return static_cast<typename std::underlying_type<T>::type>(arg);
+    }
+
+#ifdef XRLPP_HAVE_CXX17
+    inline const char *_c_arg(const std::string &arg) noexcept {
+        return arg.c_str();
+    }
+
+    /*
+     * Error codes instead of exceptions.
+     *
+     * xrlpp::noexcept_api has the functions of xrlpp, returning a result that holds either the value
+     * or the code of the error:
+     *
+     *     auto cs = xrlpp::noexcept_api::CS_FluorLine(26, KA_LINE, E);
+     *     if (cs)
+     *         total += *cs;
+     *
+     * They do not throw. The functions of elements, shells and lines do not allocate memory either, since the errors
+     * with fixed messages, such as an energy below an edge, are shared. Given the name of a compound, the _CP functions
+     * and the refractive indices resolve it with CompoundParser (or look up the NIST compound) on every call.
+     * Resolving it once instead keeps the allocation out of the loop:
+     *
+     *     auto water = xrlpp::noexcept_api::ResolveCompound("H2O");
+     *     for (double E : energies)
+     *         total += xrlpp::noexcept_api::CS_Total_CP(*water, E).value_or(0.0);
+     *
+     * The crystal functions take xrlpp::Crystal::Struct, xrlpp::Crystal::SharedStruct or the copy returned by
+     * xrlpp::noexcept_api::Crystal::GetCrystal, and do not allocate on failure either.
+     * The messages are left out, as most callers only check for success: the xrlpp functions report them.
+     * Functions that return data, including the lists, return the structs of the C API, owned by a std::unique_ptr
+     * or xrlpp::noexcept_api::string_list.
+     */
+    namespace noexcept_api {
+        template<typename T>
+        class result {
+            public:
+            result(T value) noexcept(std::is_nothrow_move_constructible_v<T>) : _value(std::move(value)) {}
+
+            static result failure(xrl_error_code code) noexcept {
+                result rv;
+                rv._code = code;
+                return rv;
+            }
+
+            bool has_value() const noexcept { return _value.has_value(); }
+            explicit operator bool() const noexcept { return _value.has_value(); }
+
+            // only valid with a value
+            const T &operator*() const & noexcept { return *_value; }
+            T &operator*() & noexcept { return *_value; }
+            T &&operator*() && noexcept { return std::move(*_value); }
+            const T *operator->() const noexcept { return &*_value; }
+            T *operator->() noexcept { return &*_value; }
+
+            template<typename U>
+            T value_or(U &&default_value) const & { return _value.value_or(std::forward<U>(default_value)); }
+
+            // only valid without a value
+            xrl_error_code error() const noexcept { return _code; }
+
+            private:
+            result() noexcept = default;
+
+            std::optional<T> _value;
+            xrl_error_code _code = XRL_ERROR_RUNTIME;
+        };
+
+        template<typename T>
+        result<T> _result(T value, xrl_error *error) noexcept {
+            if (!error)
+                return result<T>(std::move(value));
+            xrl_error_code code = error->code;
+            ::xrl_error_free(error);
+            return result<T>::failure(code);
+        }
+    }
+#endif
+
+#ifdef XRLPP_HAVE_BATCH
+    /*
+     * Batch evaluation.
+     *
+     * Every function of two or more numbers also accepts arrays: std::vector, std::array, C arrays
+     * and xrlpp::span, mixed with scalars, which apply to every element. All arrays must have the same length.
+     * There are two forms:
+     *
+     *     std::vector<double> mu = xrlpp::CS_Total(26, energies);
+     *     xrlpp::CS_Total(xrlpp::span<double>(mu), status, 26, energies);
+     *
+     * The first throws an xrlpp::batch_error listing the failed elements, after evaluating all of them.
+     * The second writes to an existing array and stores the failures in status, without throwing.
+     * Failed elements are set to 0.0.
+     */
+
+    // a view on contiguous memory, owned by someone else
+    template<typename T>
+    class span {
+        public:
+        constexpr span() noexcept : _data(nullptr), _size(0) {}
+        constexpr span(T *data, std::size_t size) noexcept : _data(data), _size(size) {}
+        template<std::size_t N>
+        constexpr span(T (&array)[N]) noexcept : _data(array), _size(N) {}
+        template<typename Container, typename = std::enable_if_t<
+            std::is_convertible_v<decltype(std::data(std::declval<Container&>())), T*> &&
+            !std::is_same_v<std::remove_cv_t<Container>, span>>>
+        constexpr span(Container &container) noexcept : _data(std::data(container)), _size(std::size(container)) {}
+
+        constexpr T *data() const noexcept { return _data; }
+        constexpr std::size_t size() const noexcept { return _size; }
+        constexpr bool empty() const noexcept { return _size == 0; }
+        constexpr T *begin() const noexcept { return _data; }
+        constexpr T *end() const noexcept { return _data + _size; }
+        constexpr T &operator[](std::size_t i) const noexcept { return _data[i]; }
+
+        private:
+        T *_data;
+        std::size_t _size;
+    };
+
+    struct batch_failure {
+        std::size_t index;
+        xrl_error_code code;
+        std::string message;
+    };
+
+    using batch_status = std::vector<batch_failure>;
+
+    class batch_error : public std::runtime_error {
+        public:
+        batch_error(batch_status failures, std::size_t size) :
+            std::runtime_error(_message(failures, size)),
+            _failures(std::move(failures))
+        {}
+
+        const batch_status &failures() const noexcept { return _failures; }
+
+        private:
+        batch_status _failures;
+
+        static std::string _message(const batch_status &failures, std::size_t size) {
+            return std::to_string(failures.size()) + " of " + std::to_string(size) +
+                " evaluations failed, the first at index " + std::to_string(failures[0].index) + ": " + failures[0].message;
+        }
+    };
+
+    // arrays of numbers are batches; strings are not
+    template<typename T, typename = void>
+    struct _is_batch : std::false_type {};
+
+    template<typename T>
+    struct _is_batch<T, std::void_t<decltype(std::data(std::declval<const T&>())), decltype(std::size(std::declval<const T&>()))>> {
+        using element = std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<const T&>()))>>;
+        static constexpr bool value = std::is_arithmetic_v<element> && !std::is_same_v<element, char>;
+    };
+
+    template<typename T>
+    constexpr bool _is_batch_v = _is_batch<T>::value;
+
+    template<typename T>
+    constexpr bool _is_batch_scalar_v = std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_pointer_v<std::decay_t<T>>;
+
+    template<typename... T>
+    constexpr bool _any_batch_v = (_is_batch_v<T> || ...);
+
+    // the scalar overloads take their arguments by value, which turns C arrays into pointers
+    template<typename T>
+    constexpr bool _is_array_v = _is_batch_v<T> || (std::is_pointer_v<T> && _is_batch_v<std::remove_pointer_t<T>[1]>);
+
+    template<typename... T>
+    constexpr bool _any_array_v = (_is_array_v<T> || ...);
+
+    template<typename... T>
+    constexpr bool _is_batch_call_v = _any_batch_v<T...> && ((_is_batch_v<T> || _is_batch_scalar_v<T>) && ...);
+
+    template<typename T>
+    decltype(auto) _batch_at(const T &arg, std::size_t i) {
+        if constexpr (_is_batch_v<T>)
+            return std::data(arg)[i];
+        else
+            return (arg);
+    }
+
+    template<typename... T>
+    std::size_t _batch_length(const T&... args) {
+        std::size_t length = 0;
+        bool found = false;
+        auto check = [&](const auto &arg) {
+            if constexpr (_is_batch_v<std::remove_cv_t<std::remove_reference_t<decltype(arg)>>>) {
+                if (!found) {
+                    length = std::size(arg);
+                    found = true;
+                }
+                else if (std::size(arg) != length)
+                    throw std::invalid_argument("Batch arguments must have the same length");
+            }
+        };
+        (check(args), ...);
+        return length;
+    }
+
+    // where a kernel reports the failure of one element: an error of the C API, which is freed afterwards,
+    // or one that is only borrowed, such as the error of a context
+    class _batch_error_slot {
+        public:
+        _batch_error_slot() = default;
+        _batch_error_slot(const _batch_error_slot &) = delete;
+        _batch_error_slot& operator=(const _batch_error_slot &) = delete;
+
+        ~_batch_error_slot() {
+            clear();
+        }
+
+        operator xrl_error **() noexcept { return &_owned; }
+
+        void borrow(const xrl_error *error) noexcept { _borrowed = error; }
+
+        const xrl_error *get() const noexcept { return _owned ? _owned : _borrowed; }
+
+        void clear() noexcept {
+            if (_owned)
+                ::xrl_error_free(_owned);
+            _owned = nullptr;
+            _borrowed = nullptr;
+        }
+
+        private:
+        xrl_error *_owned = nullptr;
+        const xrl_error *_borrowed = nullptr;
+    };
+
+    template<typename F, typename... T>
+    void _batch_evaluate(double *out, std::size_t length, batch_status &status, F kernel, const T&... args) {
+        _batch_error_slot slot;
+        for (std::size_t i = 0 ; i < length ; i++) {
+            out[i] = kernel(slot, _batch_at(args, i)...);
+            if (const xrl_error *error = slot.get()) {
+                status.push_back({i, error->code, error->message});
+                slot.clear();
+                out[i] = 0.0;
+            }
+        }
+    }
+
+    template<typename F, typename... T>
+    std::vector<double> _batch_vector(F kernel, const T&... args) {
+        std::size_t length = _batch_length(args...);
+        std::vector<double> rv(length);
+        batch_status status;
+        _batch_evaluate(rv.data(), length, status, kernel, args...);
+        if (!status.empty())
+            throw batch_error(std::move(status), length);
+        return rv;
+    }
+
+    template<typename F, typename... T>
+    void _batch_span(span<double> out, batch_status &status, F kernel, const T&... args) {
+        std::size_t length = _batch_length(args...);
+        if (out.size() != length)
+            throw std::invalid_argument("Batch arguments must have the same length");
+        status.clear();
+        _batch_evaluate(out.data(), length, status, kernel, args...);
+    }
+
+    // the context of a batch of _ctx function calls
+    class _batch_context {
+        public:
+        _batch_context() {
+            xrl_error *error = nullptr;
+            _ctx = ::xrl_context_new(&error);
+            _process_error(error);
+        }
+
+        _batch_context(const _batch_context &) = delete;
+        _batch_context& operator=(const _batch_context &) = delete;
+
+        ~_batch_context() {
+            ::xrl_context_free(_ctx);
+        }
+
+        // the error stays with the context until the next element is evaluated, so it is only lent to the slot
+        double evaluate(double (*function)(xrl_context *, int, double), _batch_error_slot &error, int Z, double E) {
+            ::xrl_context_clear_error(_ctx);
+            double rv = function(_ctx, Z, E);
+            error.borrow(::xrl_context_get_error(_ctx));
+            return rv;
+        }
+
+        private:
+        xrl_context *_ctx;
+    };
+
+    // a compound resolved as the _CP functions do: as a chemical formula, or else as a NIST compound
+    class _batch_compound {
+        public:
+        explicit _batch_compound(const char *compound) :
+            _cd(::CompoundParser(compound, nullptr), ::FreeCompoundData),
+            _cdn(nullptr, ::FreeCompoundDataNIST)
+        {
+            if (!_cd)
+                _cdn.reset(::GetCompoundDataNISTByName(compound, nullptr));
+            if (_cd) {
+                _nElements = _cd->nElements;
+                _Elements = _cd->Elements;
+                _massFractions = _cd->massFractions;
+            }
+            else if (_cdn) {
+                _nElements = _cdn->nElements;
+                _Elements = _cdn->Elements;
+                _massFractions = _cdn->massFractions;
+                _density = _cdn->density;
+            }
+        }
+
+        explicit operator bool() const noexcept { return _Elements != nullptr; }
+
+        // the density of a NIST compound, which the refractive indices fall back on; 0.0 for a chemical formula
+        double density() const noexcept { return _density; }
+
+        // identical to the sums of the _CP functions
+        template<typename F, typename... T>
+        double evaluate(F function, xrl_error **error, const T... args) const {
+            double rv = 0.0;
+            for (int i = 0 ; i < _nElements ; i++) {
+                double tmp = function(_Elements[i], args..., error) * _massFractions[i];
+                if (tmp == 0.0) {
+                    rv = 0.0;
+                    break;
+                }
+                rv += tmp;
+            }
+            return rv;
+        }
+
+        private:
+        std::unique_ptr<_compoundDataPod, void (*)(_compoundDataPod *)> _cd;
+        std::unique_ptr<_compoundDataNISTPod, void (*)(_compoundDataNISTPod *)> _cdn;
+        int _nElements = 0;
+        const int *_Elements = nullptr;
+        const double *_massFractions = nullptr;
+        double _density = 0.0;
+    };
+
+    /*
+     * Tabulation.
+     *
+     * tabulate evaluates the batch form of a function on a grid of rows (elements, compounds, lines...)
+     * and energies, into a row-major table: out[i * size(E) + j] belongs to rows[i] and E[j].
+     * Every row is split into tiles of consecutive energies, each of them a single batch call,
+     * so a tile walks one table in order and writes contiguous memory. The tiles are spread over
+     * the threads of the policy: xrlpp::threads (by default, on every processor), or a standard
+     * execution policy from <execution>.
+     *
+     *     std::vector<double> mu = xrlpp::tabulate(XRLPP_BATCH(CS_Total), Zs, energies, xrlpp::threads{});
+     *     xrlpp::tabulate([](auto out, auto &status, xrlpp::Line line, auto E) {
+     *         xrlpp::CS_FluorLine(out, status, 26, line, E);
+     *     }, lines, energies, xrlpp::span<double>(table), status, std::execution::par);
+     *
+     * func is called as func(out, status, row, E) from several threads at once. As with the batch functions,
+     * the first form throws an xrlpp::batch_error and the second stores the failures in status,
+     * with their index in the table. Exceptions thrown by func are rethrown with xrlpp::threads;
+     * the standard policies call std::terminate instead.
+     *
+     * The pool of xrlpp::threads serves one call at a time: a call made while it is busy, from another thread
+     * or from within func, runs all of its tiles on the calling thread. Programs that tabulate from several
+     * threads at once should pass a standard execution policy, or split the rows over a single call.
+     */
+
+    // runs the tiles on count threads, including the calling one: 0 is std::thread::hardware_concurrency().
+    // The other threads come from a pool, which starts them on first use and keeps them for later calls.
+    struct threads {
+        unsigned count = 0;
+    };
+
+    class _thread_pool {
+        public:
+        _thread_pool() = default;
+        _thread_pool(const _thread_pool &) = delete;
+        _thread_pool& operator=(const _thread_pool &) = delete;
+
+        ~_thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _wake.notify_all();
+            for (auto &worker : _workers)
+                worker.join();
+        }
+
+        // runs job on the calling thread and on up to helpers threads of the pool, until all of them return.
+        // A call made while the pool is busy, e.g. from within a job, runs job on the calling thread only.
+        void run(std::size_t helpers, const std::function<void()> &job) {
+            std::unique_lock<std::mutex> run_lock(_run_mutex, std::try_to_lock);
+            if (!run_lock || helpers == 0) {
+                job();
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                try {
+                    while (_workers.size() < helpers)
+                        _workers.emplace_back([this]() { _work(); });
+                }
+                catch (const std::system_error &) {
+                    // carry on with the threads that did start
+                }
+                _job = &job;
+                _pending = std::min(helpers, _workers.size());
+                _generation++;
+            }
+            _wake.notify_all();
+            job();
+            // the job is done once it returns on one thread: the helpers that did not pick it up yet are not needed
+            std::unique_lock<std::mutex> lock(_mutex);
+            _pending = 0;
+            _done.wait(lock, [this]() { return _running == 0; });
+            _job = nullptr;
+        }
+
+        private:
+        std::mutex _run_mutex;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _done;
+        std::vector<std::thread> _workers;
+        const std::function<void()> *_job = nullptr;
+        std::size_t _pending = 0;
+        std::size_t _running = 0;
+        std::size_t _generation = 0;
+        bool _stop = false;
+
+        void _work() {
+            std::size_t generation = 0;
+            std::unique_lock<std::mutex> lock(_mutex);
+            for (;;) {
+                _wake.wait(lock, [&]() { return _stop || (_generation != generation && _pending > 0); });
+                if (_stop)
+                    return;
+                generation = _generation;
+                _pending--;
+                _running++;
+                const std::function<void()> &job = *_job;
+                lock.unlock();
+                job();
+                lock.lock();
+                if (--_running == 0)
+                    _done.notify_all();
+            }
+        }
+    };
+
+    inline _thread_pool &_tabulate_pool() {
+        static _thread_pool pool;
+        return pool;
+    }
+
+    // the number of energies of a tile
+    constexpr std::size_t _tabulate_tile_size = 512;
+
+    struct _tabulate_tile {
+        std::size_t row;
+        std::size_t first;
+        std::size_t last;
+        batch_status status;
+    };
+
+    inline std::vector<_tabulate_tile> _tabulate_tiles(std::size_t rows, std::size_t energies) {
+        std::vector<_tabulate_tile> tiles;
+        tiles.reserve(rows * ((energies + _tabulate_tile_size - 1) / _tabulate_tile_size));
+        for (std::size_t row = 0 ; row < rows ; row++) {
+            for (std::size_t first = 0 ; first < energies ; first += _tabulate_tile_size)
+                tiles.push_back({row, first, std::min(first + _tabulate_tile_size, energies), {}});
+        }
+        return tiles;
+    }
+
+    template<typename F>
+    void _tabulate_run(threads policy, std::vector<_tabulate_tile> &tiles, F evaluate) {
+        std::size_t count = policy.count ? policy.count : std::max(1u, std::thread::hardware_concurrency());
+        count = std::min(count, tiles.size());
+        std::atomic<std::size_t> next(0);
+        std::exception_ptr exception;
+        std::mutex exception_mutex;
+        auto worker = [&]() {
+            try {
+                for (std::size_t i ; (i = next.fetch_add(1)) < tiles.size() ; )
+                    evaluate(tiles[i]);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(exception_mutex);
+                if (!exception)
+                    exception = std::current_exception();
+                next = tiles.size();
+            }
+        };
+        if (count > 1)
+            _tabulate_pool().run(count - 1, worker);
+        else
+            worker();
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+    // the parallel overloads of std::for_each are declared in <algorithm>, the policies in <execution>
+    template<typename Policy, typename F>
+    auto _tabulate_run(Policy &&policy, std::vector<_tabulate_tile> &tiles, F evaluate) ->
+        decltype(std::for_each(std::forward<Policy>(policy), tiles.begin(), tiles.end(), evaluate), void()) {
+        std::for_each(std::forward<Policy>(policy), tiles.begin(), tiles.end(), evaluate);
+    }
+
+    template<typename F, typename Rows, typename Policy = threads>
+    void tabulate(F func, const Rows &rows, span<const double> E, span<double> out, batch_status &status, Policy &&policy = threads{}) {
+        std::size_t n_rows = std::size(rows);
+        if (out.size() != n_rows * E.size())
+            throw std::invalid_argument("The output of tabulate must have a value for every row and energy");
+        status.clear();
+        std::vector<_tabulate_tile> tiles = _tabulate_tiles(n_rows, E.size());
+        _tabulate_run(std::forward<Policy>(policy), tiles, [&](_tabulate_tile &tile) {
+            std::size_t length = tile.last - tile.first;
+            func(span<double>(out.data() + tile.row * E.size() + tile.first, length), tile.status,
+                std::data(rows)[tile.row], span<const double>(E.data() + tile.first, length));
+        });
+        for (auto &tile : tiles) {
+            for (auto &failure : tile.status) {
+                failure.index += tile.row * E.size() + tile.first;
+                status.push_back(std::move(failure));
+            }
+        }
+    }
+
+    template<typename F, typename Rows, typename Policy = threads>
+    std::vector<double> tabulate(F func, const Rows &rows, span<const double> E, Policy &&policy = threads{}) {
+        std::vector<double> rv(std::size(rows) * E.size());
+        batch_status status;
+        tabulate(func, rows, E, span<double>(rv), status, std::forward<Policy>(policy));
+        if (!status.empty())
+            throw batch_error(std::move(status), rv.size());
+        return rv;
+    }
+#endif
+
+    inline void XrayInit(void) {
         ::XRayInit();
     }
 
-    std::complex<double> Refractive_Index(const std::string &compound, double E, double density) {
+    inline std::complex<double> Refractive_Index(const std::string &compound, double E, double density) {
         xrl_error *error = nullptr;
         xrlComplex rv = ::Refractive_Index(compound.c_str(), E, density, &error);
         _process_error(error);
         return std::complex<double>(rv.re, rv.im);
     }
 
-    int SymbolToAtomicNumber(const std::string &symbol) {
+#ifdef XRLPP_HAVE_BATCH
+    // the optical constants of a compound at many energies, resolving the compound only once
+    inline std::vector<xrlOpticalConstants> Refractive_Index_Batch(const std::string &compound, span<const double> E, double density, double theta) {
+        xrl_error *error = nullptr;
+        std::vector<xrlOpticalConstants> rv(E.size());
+        ::Refractive_Index_Batch(compound.c_str(), E.data(), static_cast<int>(E.size()), density, theta, rv.data(), &error);
+        _process_error(error);
+        return rv;
+    }
+#endif
+
+    inline int SymbolToAtomicNumber(const std::string &symbol) {
         xrl_error *error = nullptr;
         int rv = ::SymbolToAtomicNumber(symbol.c_str(), &error);
         _process_error(error);
         return rv;
     }
 
-    std::string AtomicNumberToSymbol(int Z) {
+    inline std::string AtomicNumberToSymbol(int Z) {
         xrl_error *error = nullptr;
         char *rv = ::AtomicNumberToSymbol(Z, &error);
         _process_error(error);
@@ -159,6 +819,23 @@ namespace xrlpp {
     };
 
     namespace Crystal {
+#ifdef XRLPP_HAVE_BATCH
+        static_assert(sizeof(std::complex<double>) == sizeof(xrlComplex), "std::complex<double> must have the layout of xrlComplex");
+
+        // miller holds the h, k and l of every reflection in turn, out the structure factor of every reflection
+        inline void _F_H_StructureFactor_Batch(Crystal_Struct *cs, double energy, span<const int> miller, double debye_factor, double rel_angle,
+            int f0_flag, int f_prime_flag, int f_prime2_flag, span<std::complex<double>> out) {
+            if (miller.size() != 3 * out.size())
+                throw std::invalid_argument("Batch arguments must have the same length");
+            if (out.empty())
+                return;
+            xrl_error *error = nullptr;
+            ::Crystal_F_H_StructureFactor_Partial_Batch(cs, energy, miller.data(), static_cast<int>(out.size()), debye_factor, rel_angle,
+                f0_flag, f_prime_flag, f_prime2_flag, reinterpret_cast<xrlComplex *>(out.data()), &error);
+            _process_error(error);
+        }
+#endif
+
         class Atom {
             public:
             const int Zatom;
@@ -177,7 +854,7 @@ namespace xrlpp {
             {}
         };
 
-        std::vector<Atom> _create_atom_vector(Crystal_Atom *atoms, int n_atom) {
+        inline std::vector<Atom> _create_atom_vector(Crystal_Atom *atoms, int n_atom) {
             std::vector<Atom> rv;
 
             for (int i = 0 ; i < n_atom ; i++)
@@ -188,12 +865,12 @@ namespace xrlpp {
 
         class Struct {
             public:
-            const std::string name;
+            std::string name; // not const, so that the move constructor can move it
             const double a, b, c;
             const double alpha, beta, gamma;
             const double volume;
             const int n_atom;
-            const std::vector<Atom> atom;
+            std::vector<Atom> atom; // not const, so that the move constructor can move it
 
             double Bragg_angle(double energy, int i_miller, int j_miller, int k_miller) {
                 xrl_error *error = nullptr;
@@ -223,6 +900,17 @@ namespace xrlpp {
                 return std::complex<double>(rv.re, rv.im);
             }
 
+#ifdef XRLPP_HAVE_BATCH
+            // the reflections of miller (h, k and l of each in turn) at once, through the batch functions
+            void F_H_StructureFactor(double energy, span<const int> miller, double debye_factor, double rel_angle, span<std::complex<double>> out) {
+                _F_H_StructureFactor_Batch(cs, energy, miller, debye_factor, rel_angle, 2, 2, 2, out);
+            }
+
+            void F_H_StructureFactor_Partial(double energy, span<const int> miller, double debye_factor, double rel_angle, int f0_flag, int f_prime_flag, int f_prime2_flag, span<std::complex<double>> out) {
+                _F_H_StructureFactor_Batch(cs, energy, miller, debye_factor, rel_angle, f0_flag, f_prime_flag, f_prime2_flag, out);
+            }
+#endif
+
             double UnitCellVolume(void) {
                 xrl_error *error = nullptr;
                 double rv = ::Crystal_UnitCellVolume(cs, &error);
@@ -244,6 +932,8 @@ namespace xrlpp {
                 return rv;
             }
 
+            const Crystal_Struct *get() const { return cs; }
+
             // constructor -> this needs to generate the underlying cs pointer!
             Struct(const std::string &name, double a, double b, double c, double alpha, double beta, double gamma, double volume, const std::vector<Atom> &atoms) :
                 name(name),
@@ -295,12 +985,29 @@ namespace xrlpp {
                 _process_error(error);
             }
 
+            // move constructor: takes over the underlying cs pointer
+            Struct(Struct &&_struct) :
+                name(std::move(_struct.name)),
+                a(_struct.a),
+                b(_struct.b),
+                c(_struct.c),
+                alpha(_struct.alpha),
+                beta(_struct.beta),
+                gamma(_struct.gamma),
+                volume(_struct.volume),
+                n_atom(_struct.n_atom),
+                atom(std::move(_struct.atom)),
+                cs(_struct.cs) {
+                _struct.cs = nullptr;
+            }
+
             // destructor
             ~Struct() {
                 ::Crystal_Free(cs);
             }
 
             friend Struct GetCrystal(const std::string &material);
+            friend class SharedStruct;
 
             private:
             Crystal_Struct *cs;
@@ -321,7 +1028,7 @@ namespace xrlpp {
 
         };
 
-        Struct GetCrystal(const std::string &material) {
+        inline Struct GetCrystal(const std::string &material) {
             xrl_error *error = nullptr;
             Crystal_Struct *cs = ::Crystal_GetCrystal(material.c_str(), nullptr, &error);
             _process_error(error);
@@ -329,38 +1036,232 @@ namespace xrlpp {
             return rv;
         }
 
-        double Bragg_angle(Struct &cs, double energy, int i_miller, int j_miller, int k_miller) {
+        // Reference counted handle to an immutable crystal. Copying only updates the reference count,
+        // and crystals from the official array are looked up without allocating memory.
+        class SharedStruct {
+            public:
+            const char *name() const { return cs->name; }
+            double a() const { return cs->a; }
+            double b() const { return cs->b; }
+            double c() const { return cs->c; }
+            double alpha() const { return cs->alpha; }
+            double beta() const { return cs->beta; }
+            double gamma() const { return cs->gamma; }
+            double volume() const { return cs->volume; }
+            int n_atom() const { return cs->n_atom; }
+            const Crystal_Atom &atom(int i) const { return cs->atom[i]; }
+            const Crystal_Struct *get() const { return cs; }
+
+            double Bragg_angle(double energy, int i_miller, int j_miller, int k_miller) const {
+                xrl_error *error = nullptr;
+                double rv = ::Bragg_angle(cs, energy, i_miller, j_miller, k_miller, &error);
+                _process_error(error);
+                return rv;
+            }
+
+            double Q_scattering_amplitude(double energy, int i_miller, int j_miller, int k_miller, double rel_angle) const {
+                xrl_error *error = nullptr;
+                double rv = ::Q_scattering_amplitude(cs, energy, i_miller, j_miller, k_miller, rel_angle, &error);
+                _process_error(error);
+                return rv;
+            }
+
+            std::complex<double> F_H_StructureFactor(double energy, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle) const {
+                xrl_error *error = nullptr;
+                xrlComplex rv = ::Crystal_F_H_StructureFactor(cs, energy, i_miller, j_miller, k_miller, debye_factor, rel_angle, &error);
+                _process_error(error);
+                return std::complex<double>(rv.re, rv.im);
+            }
+
+            std::complex<double> F_H_StructureFactor_Partial(double energy, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle, int f0_flag, int f_prime_flag, int f_prime2_flag) const {
+                xrl_error *error = nullptr;
+                xrlComplex rv = ::Crystal_F_H_StructureFactor_Partial(cs, energy, i_miller, j_miller, k_miller, debye_factor, rel_angle, f0_flag, f_prime_flag, f_prime2_flag, &error);
+                _process_error(error);
+                return std::complex<double>(rv.re, rv.im);
+            }
+
+#ifdef XRLPP_HAVE_BATCH
+            // the reflections of miller (h, k and l of each in turn) at once, through the batch functions
+            void F_H_StructureFactor(double energy, span<const int> miller, double debye_factor, double rel_angle, span<std::complex<double>> out) const {
+                _F_H_StructureFactor_Batch(cs, energy, miller, debye_factor, rel_angle, 2, 2, 2, out);
+            }
+
+            void F_H_StructureFactor_Partial(double energy, span<const int> miller, double debye_factor, double rel_angle, int f0_flag, int f_prime_flag, int f_prime2_flag, span<std::complex<double>> out) const {
+                _F_H_StructureFactor_Batch(cs, energy, miller, debye_factor, rel_angle, f0_flag, f_prime_flag, f_prime2_flag, out);
+            }
+#endif
+
+            double UnitCellVolume(void) const {
+                xrl_error *error = nullptr;
+                double rv = ::Crystal_UnitCellVolume(cs, &error);
+                _process_error(error);
+                return rv;
+            }
+
+            double dSpacing(int i_miller, int j_miller, int k_miller) const {
+                xrl_error *error = nullptr;
+                double rv = ::Crystal_dSpacing(cs, i_miller, j_miller, k_miller, &error);
+                _process_error(error);
+                return rv;
+            }
+
+            // shared copy of a Struct
+            explicit SharedStruct(const Struct &_struct) {
+                xrl_error *error = nullptr;
+                cs = ::Crystal_MakeShared(_struct.cs, &error);
+                _process_error(error);
+            }
+
+            SharedStruct(const SharedStruct &_struct) noexcept :
+                cs(::Crystal_Retain(_struct.cs))
+            {}
+
+            SharedStruct(SharedStruct &&_struct) noexcept :
+                cs(_struct.cs) {
+                _struct.cs = nullptr;
+            }
+
+            SharedStruct& operator=(const SharedStruct &_struct) noexcept {
+                Crystal_Struct *old = cs;
+                cs = ::Crystal_Retain(_struct.cs);
+                ::Crystal_Release(old);
+                return *this;
+            }
+
+            SharedStruct& operator=(SharedStruct &&_struct) noexcept {
+                if (this != &_struct) {
+                    ::Crystal_Release(cs);
+                    cs = _struct.cs;
+                    _struct.cs = nullptr;
+                }
+                return *this;
+            }
+
+            ~SharedStruct() {
+                ::Crystal_Release(cs);
+            }
+
+            // takes over a reference from the C API, e.g. from Crystal_GetCrystalShared
+            explicit SharedStruct(Crystal_Struct *_struct) noexcept :
+                cs(_struct)
+            {}
+
+            private:
+            Crystal_Struct *cs;
+        };
+
+        inline SharedStruct GetCrystalShared(const char *material) {
+            xrl_error *error = nullptr;
+            Crystal_Struct *cs = ::Crystal_GetCrystalShared(material, &error);
+            _process_error(error);
+            return SharedStruct(cs);
+        }
+
+        inline SharedStruct GetCrystalShared(const std::string &material) {
+            return GetCrystalShared(material.c_str());
+        }
+
+#ifdef XRLPP_HAVE_BATCH
+        // A reflection of a crystal prepared for evaluating F_H at many energies, e.g. across an absorption edge.
+        // The crystal is not referenced after construction.
+        class Reflection {
+            public:
+            Reflection(const Struct &crystal, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle) :
+                Reflection(crystal.get(), i_miller, j_miller, k_miller, debye_factor, rel_angle)
+            {}
+
+            Reflection(const SharedStruct &crystal, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle) :
+                Reflection(crystal.get(), i_miller, j_miller, k_miller, debye_factor, rel_angle)
+            {}
+
+            Reflection(const Reflection &) = delete;
+            Reflection& operator=(const Reflection &) = delete;
+
+            Reflection(Reflection &&reflection) noexcept :
+                _reflection(reflection._reflection) {
+                reflection._reflection = nullptr;
+            }
+
+            Reflection& operator=(Reflection &&reflection) noexcept {
+                if (this != &reflection) {
+                    ::Crystal_Reflection_Free(_reflection);
+                    _reflection = reflection._reflection;
+                    reflection._reflection = nullptr;
+                }
+                return *this;
+            }
+
+            ~Reflection() {
+                ::Crystal_Reflection_Free(_reflection);
+            }
+
+            std::complex<double> F_H(double energy) const {
+                xrl_error *error = nullptr;
+                xrlComplex rv = ::Crystal_Reflection_F_H(_reflection, energy, &error);
+                _process_error(error);
+                return std::complex<double>(rv.re, rv.im);
+            }
+
+            void F_H(span<const double> energies, span<std::complex<double>> out) const {
+                if (energies.size() != out.size())
+                    throw std::invalid_argument("Batch arguments must have the same length");
+                if (out.empty())
+                    return;
+                xrl_error *error = nullptr;
+                ::Crystal_Reflection_F_H_Batch(_reflection, energies.data(), static_cast<int>(energies.size()), reinterpret_cast<xrlComplex *>(out.data()), &error);
+                _process_error(error);
+            }
+
+            std::vector<std::complex<double>> F_H(span<const double> energies) const {
+                std::vector<std::complex<double>> rv(energies.size());
+                F_H(energies, span<std::complex<double>>(rv));
+                return rv;
+            }
+
+            private:
+            Crystal_Reflection *_reflection;
+
+            Reflection(const Crystal_Struct *crystal, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle) {
+                xrl_error *error = nullptr;
+                // the C API takes a mutable pointer, but does not modify the crystal
+                _reflection = ::Crystal_Reflection_New(const_cast<Crystal_Struct *>(crystal), i_miller, j_miller, k_miller, debye_factor, rel_angle, &error);
+                _process_error(error);
+            }
+        };
+#endif
+
+        inline double Bragg_angle(Struct &cs, double energy, int i_miller, int j_miller, int k_miller) {
             return cs.Bragg_angle(energy, i_miller, j_miller, k_miller);
         }
 
-        double Q_scattering_amplitude(Struct &cs, double energy, int i_miller, int j_miller, int k_miller, double rel_angle) {
+        inline double Q_scattering_amplitude(Struct &cs, double energy, int i_miller, int j_miller, int k_miller, double rel_angle) {
             return cs.Q_scattering_amplitude(energy, i_miller, j_miller, k_miller, rel_angle);
         }
 
-        int Atomic_Factors(int Z, double energy, double q, double debye_factor, double *f0, double *f_prime, double *f_prime2) {
+        inline int Atomic_Factors(int Z, double energy, double q, double debye_factor, double *f0, double *f_prime, double *f_prime2) {
             xrl_error *error = nullptr;
             int rv = ::Atomic_Factors(Z, energy, q, debye_factor, f0, f_prime, f_prime2, &error);
             _process_error(error);
             return rv;
         }
 
-        std::complex<double> F_H_StructureFactor(Struct &cs, double energy, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle) {
+        inline std::complex<double> F_H_StructureFactor(Struct &cs, double energy, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle) {
             return cs.F_H_StructureFactor(energy, i_miller, j_miller, k_miller, debye_factor, rel_angle);
         }
 
-        std::complex<double> F_H_StructureFactor_Partial(Struct &cs, double energy, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle, int f0_flag, int f_prime_flag, int f_prime2_flag) {
+        inline std::complex<double> F_H_StructureFactor_Partial(Struct &cs, double energy, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle, int f0_flag, int f_prime_flag, int f_prime2_flag) {
             return cs.F_H_StructureFactor_Partial(energy, i_miller, j_miller, k_miller, debye_factor, rel_angle, f0_flag, f_prime_flag, f_prime2_flag);
         }
 
-        double UnitCellVolume(Struct &cs) {
+        inline double UnitCellVolume(Struct &cs) {
             return cs.UnitCellVolume();
         }
             
-        double dSpacing(Struct &cs, int i_miller, int j_miller, int k_miller) {
+        inline double dSpacing(Struct &cs, int i_miller, int j_miller, int k_miller) {
             return cs.dSpacing(i_miller, j_miller, k_miller);
         }
 
-        std::vector<std::string> GetCrystalsList(void) {
+        inline std::vector<std::string> GetCrystalsList(void) {
             std::vector<std::string> rv;
             xrl_error *error = nullptr;
             int nCrystals;
@@ -374,12 +1275,12 @@ namespace xrlpp {
             return rv;
         }
 
-        int AddCrystal(Struct &cs) {
+        inline int AddCrystal(Struct &cs) {
             return cs.AddCrystal();
         }
     } // end namespace Crystal
 
-    compoundData CompoundParser(const std::string &compoundString) {
+    inline compoundData CompoundParser(const std::string &compoundString) {
         xrl_error *error = nullptr;
         _compoundDataPod *cd = ::CompoundParser(compoundString.c_str(), &error);
         _process_error(error);
@@ -388,7 +1289,7 @@ namespace xrlpp {
         return rv;
     }
 
-    radioNuclideData GetRadioNuclideDataByName(const std::string &radioNuclideString) {
+    inline radioNuclideData GetRadioNuclideDataByName(const std::string &radioNuclideString) {
         xrl_error *error = nullptr;
         _radioNuclideDataPod *rnd = ::GetRadioNuclideDataByName(radioNuclideString.c_str(), &error);
         _process_error(error);
@@ -397,7 +1298,7 @@ namespace xrlpp {
         return rv;
     }
     
-    radioNuclideData GetRadioNuclideDataByIndex(int radioNuclideIndex) {
+    inline radioNuclideData GetRadioNuclideDataByIndex(int radioNuclideIndex) {
         xrl_error *error = nullptr;
         _radioNuclideDataPod *rnd = ::GetRadioNuclideDataByIndex(radioNuclideIndex, &error);
         _process_error(error);
@@ -406,7 +1307,7 @@ namespace xrlpp {
         return rv;
     }
 
-    std::vector<std::string> GetRadioNuclideDataList(void) {
+    inline std::vector<std::string> GetRadioNuclideDataList(void) {
         std::vector<std::string> rv;
         xrl_error *error = nullptr;
         int nRadioNuclides;
@@ -420,7 +1321,7 @@ namespace xrlpp {
         return rv;
     }
 
-    compoundDataNIST GetCompoundDataNISTByName(const std::string &compoundString) {
+    inline compoundDataNIST GetCompoundDataNISTByName(const std::string &compoundString) {
         xrl_error *error = nullptr;
         _compoundDataNISTPod *cdn = ::GetCompoundDataNISTByName(compoundString.c_str(), &error);
         _process_error(error);
@@ -429,7 +1330,7 @@ namespace xrlpp {
         return rv;
     }
     
-    compoundDataNIST GetCompoundDataNISTByIndex(int compoundIndex) {
+    inline compoundDataNIST GetCompoundDataNISTByIndex(int compoundIndex) {
         xrl_error *error = nullptr;
         _compoundDataNISTPod *cdn = ::GetCompoundDataNISTByIndex(compoundIndex, &error);
         _process_error(error);
@@ -438,7 +1339,7 @@ namespace xrlpp {
         return rv;
     }
 
-    std::vector<std::string> GetCompoundDataNISTList(void) {
+    inline std::vector<std::string> GetCompoundDataNISTList(void) {
         std::vector<std::string> rv;
         xrl_error *error = nullptr;
         int nCompounds;
@@ -452,6 +1353,303 @@ namespace xrlpp {
         return rv;
     }
 
+#ifdef XRLPP_HAVE_CXX17
+    namespace noexcept_api {
+        // a C string, or the contents of a std::string
+        class _c_string {
+            public:
+            _c_string(const char *string) noexcept : _string(string) {}
+            _c_string(const std::string &string) noexcept : _string(string.c_str()) {}
+
+            const char *c_str() const noexcept { return _string; }
+
+            private:
+            const char *_string;
+        };
+
+        template<typename T, void (*Free)(T *)>
+        struct _deleter {
+            void operator()(T *pointer) const noexcept { Free(pointer); }
+        };
+
+        using compoundData = std::unique_ptr<_compoundDataPod, _deleter<_compoundDataPod, ::FreeCompoundData>>;
+        using radioNuclideData = std::unique_ptr<_radioNuclideDataPod, _deleter<_radioNuclideDataPod, ::FreeRadioNuclideData>>;
+        using compoundDataNIST = std::unique_ptr<_compoundDataNISTPod, _deleter<_compoundDataNISTPod, ::FreeCompoundDataNIST>>;
+        using c_string = std::unique_ptr<char, _deleter<void, ::xrlFree>>;
+
+        // the names returned by the list functions, freed together
+        class string_list {
+            public:
+            string_list(char **list, int size) noexcept : _list(list), _size(list ? size : 0) {}
+            string_list(string_list &&other) noexcept : _list(other._list), _size(other._size) {
+                other._list = nullptr;
+                other._size = 0;
+            }
+            string_list& operator=(string_list &&other) noexcept {
+                std::swap(_list, other._list);
+                std::swap(_size, other._size);
+                return *this;
+            }
+            string_list(const string_list &) = delete;
+            string_list& operator=(const string_list &) = delete;
+            ~string_list() {
+                for (std::size_t i = 0 ; i < _size ; i++)
+                    ::xrlFree(_list[i]);
+                ::xrlFree(_list);
+            }
+
+            std::size_t size() const noexcept { return _size; }
+            const char *operator[](std::size_t i) const noexcept { return _list[i]; }
+            const char *const *begin() const noexcept { return _list; }
+            const char *const *end() const noexcept { return _list + _size; }
+
+            private:
+            char **_list;
+            std::size_t _size;
+        };
+
+        template<char **(*List)(int *, xrl_error **)>
+        result<string_list> _list(void) noexcept {
+            xrl_error *error = nullptr;
+            int size = 0;
+            char **list = List(&size, &error);
+            return _result(string_list(list, size), error);
+        }
+
+        inline result<string_list> GetRadioNuclideDataList(void) noexcept {
+            return _list<::GetRadioNuclideDataList>();
+        }
+
+        inline result<string_list> GetCompoundDataNISTList(void) noexcept {
+            return _list<::GetCompoundDataNISTList>();
+        }
+
+        // a compound resolved once, as the _CP functions and the refractive indices do: as a chemical formula,
+        // or else as a NIST compound. Only ResolveCompound allocates memory: the functions that take
+        // the result do not, which makes them suited to loops over energies.
+        class compound {
+            public:
+            const xrlpp::_batch_compound &_get() const noexcept { return _compound; }
+
+            private:
+            explicit compound(const char *string) noexcept : _compound(string) {}
+
+            xrlpp::_batch_compound _compound;
+
+            friend result<compound> ResolveCompound(_c_string string) noexcept;
+        };
+
+        inline result<compound> ResolveCompound(_c_string string) noexcept {
+            compound rv(string.c_str());
+            if (!rv._compound)
+                return result<compound>::failure(XRL_ERROR_INVALID_ARGUMENT);
+            return result<compound>(std::move(rv));
+        }
+
+        // the sums of refractive_indices.c, which also takes the density of a NIST compound if none is given
+        template<typename F>
+        result<double> _refractive_sum(const compound &resolved, F function, double E, double &density) noexcept {
+            if (density <= 0.0)
+                density = resolved._get().density();
+            if (density <= 0.0 || E <= 0.0)
+                return result<double>::failure(XRL_ERROR_INVALID_ARGUMENT);
+            xrl_error *error = nullptr;
+            double rv = resolved._get().evaluate(function, &error, E);
+            return _result(rv, error);
+        }
+
+        inline double _refractive_delta(int Z, double E, xrl_error **error) noexcept {
+            double fi = ::Fi(Z, E, error);
+            if (fi == 0.0)
+                return 0.0;
+            double atomic_weight = ::AtomicWeight(Z, error);
+            if (atomic_weight == 0.0)
+                return 0.0;
+            return 4.15179082788e-4 * (Z + fi) / atomic_weight / E / E;
+        }
+
+        inline result<double> Refractive_Index_Re(const compound &resolved, double E, double density) noexcept {
+            result<double> delta = _refractive_sum(resolved, _refractive_delta, E, density);
+            return delta ? result<double>(1.0 - *delta * density) : delta;
+        }
+
+        inline result<double> Refractive_Index_Im(const compound &resolved, double E, double density) noexcept {
+            // 9.8663479e-9 is Planck's constant * speed of light / 4 pi
+            result<double> im = _refractive_sum(resolved, ::CS_Total, E, density);
+            return im ? result<double>(*im * density * 9.8663479e-9 / E) : im;
+        }
+
+        inline result<std::complex<double>> Refractive_Index(const compound &resolved, double E, double density) noexcept {
+            result<double> delta = _refractive_sum(resolved, _refractive_delta, E, density);
+            if (!delta)
+                return result<std::complex<double>>::failure(delta.error());
+            result<double> im = _refractive_sum(resolved, ::CS_Total, E, density);
+            if (!im)
+                return result<std::complex<double>>::failure(im.error());
+            return std::complex<double>(1.0 - *delta * density, *im * density * 9.8663479e-9 / E);
+        }
+
+        inline result<std::complex<double>> Refractive_Index(_c_string compound, double E, double density) noexcept {
+            xrl_error *error = nullptr;
+            xrlComplex rv = ::Refractive_Index(compound.c_str(), E, density, &error);
+            return _result(std::complex<double>(rv.re, rv.im), error);
+        }
+
+        // writes the optical constants at the energies E to out, which must have the same length
+        inline result<int> Refractive_Index_Batch(_c_string compound, span<const double> E, double density, double theta, span<xrlOpticalConstants> out) noexcept {
+            if (out.size() != E.size())
+                return result<int>::failure(XRL_ERROR_INVALID_ARGUMENT);
+            xrl_error *error = nullptr;
+            int rv = ::Refractive_Index_Batch(compound.c_str(), E.data(), static_cast<int>(E.size()), density, theta, out.data(), &error);
+            return _result(rv, error);
+        }
+
+        inline result<int> SymbolToAtomicNumber(_c_string symbol) noexcept {
+            xrl_error *error = nullptr;
+            int rv = ::SymbolToAtomicNumber(symbol.c_str(), &error);
+            return _result(rv, error);
+        }
+
+        inline result<c_string> AtomicNumberToSymbol(int Z) noexcept {
+            xrl_error *error = nullptr;
+            c_string rv(::AtomicNumberToSymbol(Z, &error));
+            return _result(std::move(rv), error);
+        }
+
+        inline result<compoundData> CompoundParser(_c_string compoundString) noexcept {
+            xrl_error *error = nullptr;
+            compoundData rv(::CompoundParser(compoundString.c_str(), &error));
+            return _result(std::move(rv), error);
+        }
+
+        inline result<radioNuclideData> GetRadioNuclideDataByName(_c_string radioNuclideString) noexcept {
+            xrl_error *error = nullptr;
+            radioNuclideData rv(::GetRadioNuclideDataByName(radioNuclideString.c_str(), &error));
+            return _result(std::move(rv), error);
+        }
+
+        inline result<radioNuclideData> GetRadioNuclideDataByIndex(int radioNuclideIndex) noexcept {
+            xrl_error *error = nullptr;
+            radioNuclideData rv(::GetRadioNuclideDataByIndex(radioNuclideIndex, &error));
+            return _result(std::move(rv), error);
+        }
+
+        inline result<compoundDataNIST> GetCompoundDataNISTByName(_c_string compoundString) noexcept {
+            xrl_error *error = nullptr;
+            compoundDataNIST rv(::GetCompoundDataNISTByName(compoundString.c_str(), &error));
+            return _result(std::move(rv), error);
+        }
+
+        inline result<compoundDataNIST> GetCompoundDataNISTByIndex(int compoundIndex) noexcept {
+            xrl_error *error = nullptr;
+            compoundDataNIST rv(::GetCompoundDataNISTByIndex(compoundIndex, &error));
+            return _result(std::move(rv), error);
+        }
+
+        namespace Crystal {
+            // the C functions do not modify the crystal, although they take a non-const pointer
+            inline Crystal_Struct *_crystal_pointer(const xrlpp::Crystal::Struct &crystal) noexcept {
+                return const_cast<Crystal_Struct *>(crystal.get());
+            }
+
+            inline Crystal_Struct *_crystal_pointer(const xrlpp::Crystal::SharedStruct &crystal) noexcept {
+                return const_cast<Crystal_Struct *>(crystal.get());
+            }
+
+            // The C functions report a crystal that is not present with a formatted message, which is allocated:
+            // they are called without an error here, and the failure is reported as XRL_ERROR_INVALID_ARGUMENT.
+            // Apart from an invalid name, the lookup can only fail when memory runs out as the crystals are first indexed.
+            inline result<xrlpp::Crystal::SharedStruct> GetCrystalShared(_c_string material) noexcept {
+                Crystal_Struct *crystal = ::Crystal_GetCrystalShared(material.c_str(), nullptr);
+                if (!crystal)
+                    return result<xrlpp::Crystal::SharedStruct>::failure(XRL_ERROR_INVALID_ARGUMENT);
+                return xrlpp::Crystal::SharedStruct(crystal);
+            }
+
+            // a copy of a crystal, owned by the caller
+            using Struct = std::unique_ptr<Crystal_Struct, _deleter<Crystal_Struct, ::Crystal_Free>>;
+
+            inline Crystal_Struct *_crystal_pointer(const Struct &crystal) noexcept {
+                return crystal.get();
+            }
+
+            inline result<Struct> GetCrystal(_c_string material) noexcept {
+                Crystal_Struct *crystal = ::Crystal_GetCrystalShared(material.c_str(), nullptr);
+                if (!crystal)
+                    return result<Struct>::failure(XRL_ERROR_INVALID_ARGUMENT);
+                xrl_error *error = nullptr;
+                Struct rv(::Crystal_MakeCopy(crystal, &error));
+                return _result(std::move(rv), error);
+            }
+
+            inline result<string_list> GetCrystalsList(void) noexcept {
+                xrl_error *error = nullptr;
+                int size = 0;
+                char **list = ::Crystal_GetCrystalsList(nullptr, &size, &error);
+                return _result(string_list(list, size), error);
+            }
+
+            template<typename S>
+            result<double> Bragg_angle(const S &crystal, double energy, int i_miller, int j_miller, int k_miller) noexcept {
+                xrl_error *error = nullptr;
+                double rv = ::Bragg_angle(_crystal_pointer(crystal), energy, i_miller, j_miller, k_miller, &error);
+                return _result(rv, error);
+            }
+
+            template<typename S>
+            result<double> Q_scattering_amplitude(const S &crystal, double energy, int i_miller, int j_miller, int k_miller, double rel_angle) noexcept {
+                xrl_error *error = nullptr;
+                double rv = ::Q_scattering_amplitude(_crystal_pointer(crystal), energy, i_miller, j_miller, k_miller, rel_angle, &error);
+                return _result(rv, error);
+            }
+
+            inline result<int> Atomic_Factors(int Z, double energy, double q, double debye_factor, double *f0, double *f_prime, double *f_prime2) noexcept {
+                xrl_error *error = nullptr;
+                int rv = ::Atomic_Factors(Z, energy, q, debye_factor, f0, f_prime, f_prime2, &error);
+                return _result(rv, error);
+            }
+
+            template<typename S>
+            result<std::complex<double>> F_H_StructureFactor(const S &crystal, double energy, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle) noexcept {
+                xrl_error *error = nullptr;
+                xrlComplex rv = ::Crystal_F_H_StructureFactor(_crystal_pointer(crystal), energy, i_miller, j_miller, k_miller, debye_factor, rel_angle, &error);
+                return _result(std::complex<double>(rv.re, rv.im), error);
+            }
+
+            // the flags are checked here, since the C function reports them with a formatted message
+            template<typename S>
+            result<std::complex<double>> F_H_StructureFactor_Partial(const S &crystal, double energy, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle, int f0_flag, int f_prime_flag, int f_prime2_flag) noexcept {
+                if (f0_flag < 0 || f0_flag > 2 || (f_prime_flag != 0 && f_prime_flag != 2) || (f_prime2_flag != 0 && f_prime2_flag != 2))
+                    return result<std::complex<double>>::failure(XRL_ERROR_INVALID_ARGUMENT);
+                xrl_error *error = nullptr;
+                xrlComplex rv = ::Crystal_F_H_StructureFactor_Partial(_crystal_pointer(crystal), energy, i_miller, j_miller, k_miller, debye_factor, rel_angle, f0_flag, f_prime_flag, f_prime2_flag, &error);
+                return _result(std::complex<double>(rv.re, rv.im), error);
+            }
+
+            template<typename S>
+            result<double> UnitCellVolume(const S &crystal) noexcept {
+                xrl_error *error = nullptr;
+                double rv = ::Crystal_UnitCellVolume(_crystal_pointer(crystal), &error);
+                return _result(rv, error);
+            }
+
+            template<typename S>
+            result<double> dSpacing(const S &crystal, int i_miller, int j_miller, int k_miller) noexcept {
+                xrl_error *error = nullptr;
+                double rv = ::Crystal_dSpacing(_crystal_pointer(crystal), i_miller, j_miller, k_miller, &error);
+                return _result(rv, error);
+            }
+
+            template<typename S>
+            result<int> AddCrystal(const S &crystal) noexcept {
+                xrl_error *error = nullptr;
+                int rv = ::Crystal_AddCrystal(_crystal_pointer(crystal), nullptr, &error);
+                return _result(rv, error);
+            }
+        }
+    }
+#endif
+
     /* the macros below are sorted by number and types of input arguments */
     /* 1 int */
     _XRL_FUNCTION(AtomicWeight)
@@ -477,23 +1675,23 @@ namespace xrlpp {
     _XRL_FUNCTION(MomentTransf)
     /* 1 int, 1 double*/
     _XRL_FUNCTION(ComptonProfile)
-    _XRL_FUNCTION(CS_Compt)
-    _XRL_FUNCTION(CS_Energy)
-    _XRL_FUNCTION(CS_Photo)
+    _XRL_CONTEXT_FUNCTION(CS_Compt)
+    _XRL_CONTEXT_FUNCTION(CS_Energy)
+    _XRL_CONTEXT_FUNCTION(CS_Photo)
     _XRL_FUNCTION(CS_Photo_Total)
-    _XRL_FUNCTION(CS_Rayl)
-    _XRL_FUNCTION(CS_Total)
+    _XRL_CONTEXT_FUNCTION(CS_Rayl)
+    _XRL_CONTEXT_FUNCTION(CS_Total)
     _XRL_FUNCTION(CS_Total_Kissel)
-    _XRL_FUNCTION(CSb_Compt)
-    _XRL_FUNCTION(CSb_Photo)
+    _XRL_CONTEXT_FUNCTION(CSb_Compt)
+    _XRL_CONTEXT_FUNCTION(CSb_Photo)
     _XRL_FUNCTION(CSb_Photo_Total)
-    _XRL_FUNCTION(CSb_Rayl)
-    _XRL_FUNCTION(CSb_Total)
+    _XRL_CONTEXT_FUNCTION(CSb_Rayl)
+    _XRL_CONTEXT_FUNCTION(CSb_Total)
     _XRL_FUNCTION(CSb_Total_Kissel)
-    _XRL_FUNCTION(FF_Rayl)
-    _XRL_FUNCTION(SF_Compt)
-    _XRL_FUNCTION(Fi)
-    _XRL_FUNCTION(Fii)
+    _XRL_CONTEXT_FUNCTION(FF_Rayl)
+    _XRL_CONTEXT_FUNCTION(SF_Compt)
+    _XRL_CONTEXT_FUNCTION(Fi)
+    _XRL_CONTEXT_FUNCTION(Fii)
     /* 2 int, 1 double */
     _XRL_FUNCTION(ComptonProfile_Partial)
     _XRL_FUNCTION(CS_FluorLine_Kissel)
@@ -535,31 +1733,283 @@ namespace xrlpp {
     /* 3 double args */
     _XRL_FUNCTION(DCSP_KN)
     /* 1 string, 1 double */
-    _XRL_FUNCTION(CS_Total_CP)
-    _XRL_FUNCTION(CS_Photo_CP)
-    _XRL_FUNCTION(CS_Rayl_CP)
-    _XRL_FUNCTION(CS_Compt_CP)
-    _XRL_FUNCTION(CS_Energy_CP)
-    _XRL_FUNCTION(CS_Photo_Total_CP)
-    _XRL_FUNCTION(CS_Total_Kissel_CP)
-    _XRL_FUNCTION(CSb_Total_CP)
-    _XRL_FUNCTION(CSb_Photo_CP)
-    _XRL_FUNCTION(CSb_Rayl_CP)
-    _XRL_FUNCTION(CSb_Compt_CP)
-    _XRL_FUNCTION(CSb_Photo_Total_CP)
-    _XRL_FUNCTION(CSb_Total_Kissel_CP)
+    _XRL_COMPOUND_FUNCTION(CS_Total)
+    _XRL_COMPOUND_FUNCTION(CS_Photo)
+    _XRL_COMPOUND_FUNCTION(CS_Rayl)
+    _XRL_COMPOUND_FUNCTION(CS_Compt)
+    _XRL_COMPOUND_FUNCTION(CS_Energy)
+    _XRL_COMPOUND_FUNCTION(CS_Photo_Total)
+    _XRL_COMPOUND_FUNCTION(CS_Total_Kissel)
+    _XRL_COMPOUND_FUNCTION(CSb_Total)
+    _XRL_COMPOUND_FUNCTION(CSb_Photo)
+    _XRL_COMPOUND_FUNCTION(CSb_Rayl)
+    _XRL_COMPOUND_FUNCTION(CSb_Compt)
+    _XRL_COMPOUND_FUNCTION(CSb_Photo_Total)
+    _XRL_COMPOUND_FUNCTION(CSb_Total_Kissel)
     /* 1 string, 2 double */
-    _XRL_FUNCTION(DCS_Rayl_CP)
-    _XRL_FUNCTION(DCS_Compt_CP)
-    _XRL_FUNCTION(DCSb_Rayl_CP)
-    _XRL_FUNCTION(DCSb_Compt_CP)
+    _XRL_COMPOUND_FUNCTION(DCS_Rayl)
+    _XRL_COMPOUND_FUNCTION(DCS_Compt)
+    _XRL_COMPOUND_FUNCTION(DCSb_Rayl)
+    _XRL_COMPOUND_FUNCTION(DCSb_Compt)
     _XRL_FUNCTION(Refractive_Index_Re)
     _XRL_FUNCTION(Refractive_Index_Im)
      /* 1 string, 3 double */
-    _XRL_FUNCTION(DCSP_Rayl_CP)
-    _XRL_FUNCTION(DCSP_Compt_CP)
-    _XRL_FUNCTION(DCSPb_Rayl_CP)
-    _XRL_FUNCTION(DCSPb_Compt_CP)
+    _XRL_COMPOUND_FUNCTION(DCSP_Rayl)
+    _XRL_COMPOUND_FUNCTION(DCSP_Compt)
+    _XRL_COMPOUND_FUNCTION(DCSPb_Rayl)
+    _XRL_COMPOUND_FUNCTION(DCSPb_Compt)
+
+#ifdef XRLPP_HAVE_CXX17
+    /*
+     * Line kernels.
+     *
+     * With the line as a template argument, LineEnergy, RadRate and the CS_FluorLine functions skip the dispatch
+     * on the line of their C counterparts: the compiler resolves the shell of the line and the lines of a group,
+     * and the tables are read directly.
+     *
+     *     double E = xrlpp::LineEnergy<xrlpp::Line::KA>(26);
+     *     double cs = xrlpp::CS_FluorLine_Kissel<xrlpp::Line::LB>(82, 20.0);
+     *
+     * They return the same values as the C functions. When a kernel fails, the C function is called
+     * to report the error. Lines that a function never accepts, such as M lines in CS_FluorLine, do not compile.
+     * xrlpp::noexcept_api has them as well.
+     */
+
+    template<Line... L>
+    struct _line_list {};
+
+    // the lines of LB_LINE, as in LineEnergy and the CS_FluorLine_Kissel functions
+    using _lb_lines = _line_list<Line::LB1, Line::LB2, Line::LB3, Line::LB4, Line::LB5, Line::LB6, Line::LB7,
+        Line::LB9, Line::LB10, Line::LB15, Line::LB17, Line::L3N6, Line::L3N7>;
+
+    // calls f with each line of the list in order, as a std::integral_constant
+    template<Line... L, typename F>
+    void _for_each_line(_line_list<L...>, F f) {
+        (f(std::integral_constant<Line, L>()), ...);
+    }
+
+    // the index of a single line in the tables
+    constexpr int _line_index(Line line) noexcept {
+        return -static_cast<int>(line) - 1;
+    }
+
+    // the lines whose energy LineEnergy derives from a pair of lines
+    template<Line L>
+    struct _line_pair : std::false_type {};
+
+#define _XRL_LINE_PAIR(_line, _first, _second) \
+    template<> \
+    struct _line_pair<Line::_line> : std::true_type { \
+        static constexpr Line first = Line::_first; \
+        static constexpr Line second = Line::_second; \
+    };
+
+    _XRL_LINE_PAIR(LA, L3M4, L3M5)
+    _XRL_LINE_PAIR(L1N67, L1N6, L1N7)
+    _XRL_LINE_PAIR(L1O45, L1O4, L1O5)
+    _XRL_LINE_PAIR(L1P23, L1P2, L1P3)
+    _XRL_LINE_PAIR(L2P23, L2P2, L2P3)
+    _XRL_LINE_PAIR(L3O45, L3O4, L3O5)
+    _XRL_LINE_PAIR(L3P23, L3P2, L3P3)
+    _XRL_LINE_PAIR(L3P45, L3P4, L3P5)
+
+    constexpr bool _line_between(Line line, int lower, int upper) noexcept {
+        return static_cast<int>(line) >= lower && static_cast<int>(line) <= upper;
+    }
+
+    // the shell that CS_FluorLine uses for a line, or -1 if it does not accept it
+    constexpr int _fluor_line_shell(Line line) noexcept {
+        return _line_between(line, KP5_LINE, KB_LINE) ? K_SHELL :
+            _line_between(line, L1P5_LINE, L1L2_LINE) ? L1_SHELL :
+            _line_between(line, L2Q1_LINE, L2L3_LINE) ? L2_SHELL :
+            _line_between(line, L3Q1_LINE, L3M1_LINE) || line == Line::LA ? L3_SHELL :
+            -1;
+    }
+
+    // the shell that the CS_FluorLine_Kissel functions use for a line, or -1 if they do not accept it
+    constexpr int _kissel_line_shell(Line line) noexcept {
+        return _fluor_line_shell(line) >= 0 ? _fluor_line_shell(line) :
+            _line_between(line, M1P5_LINE, M1N1_LINE) ? M1_SHELL :
+            _line_between(line, M2P5_LINE, M2N1_LINE) ? M2_SHELL :
+            _line_between(line, M3Q1_LINE, M3N1_LINE) ? M3_SHELL :
+            _line_between(line, M4P5_LINE, M4N1_LINE) ? M4_SHELL :
+            _line_between(line, M5P5_LINE, M5N1_LINE) ? M5_SHELL :
+            -1;
+    }
+
+    // the kernels below expect a valid Z and E, and return 0.0 where the C function fails
+
+    template<Line L>
+    double _rad_rate(int Z) noexcept {
+        static_assert(L != Line::LB, "RadRate does not support LB");
+        if constexpr (L == Line::KA) {
+            double rr = 0.0;
+            for (int i = _line_index(Line::KL1) ; i <= _line_index(Line::KL3) ; i++)
+                rr += ::xrl_fast_rad_rate[Z][i];
+            return rr;
+        }
+        else if constexpr (L == Line::KB) {
+            // RR(KA) + RR(KB) = 1.0
+            double rr = _rad_rate<Line::KA>(Z);
+            return rr == 1.0 ? 0.0 : rr == 0.0 ? 0.0 : 1.0 - rr;
+        }
+        else if constexpr (L == Line::LA) {
+            return ::xrl_fast_rad_rate[Z][_line_index(Line::L3M5)] + ::xrl_fast_rad_rate[Z][_line_index(Line::L3M4)];
+        }
+        else {
+            return ::RadRate_unchecked(Z, static_cast<int>(L));
+        }
+    }
+
+    template<Line L>
+    double _cs_fluor_line(int Z, double E) noexcept {
+        static_assert(L == Line::LB || _fluor_line_shell(L) >= 0, "CS_FluorLine supports K and L lines only");
+        // the C function combines the jump factors of the L shells
+        if constexpr (L == Line::LB) {
+            return 0.0;
+        }
+        else {
+            double rr = _rad_rate<L>(Z);
+            if (rr == 0.0)
+                return 0.0;
+            double factor = ::CS_FluorShell(Z, _fluor_line_shell(L), E, nullptr);
+            if (factor == 0.0)
+                return 0.0;
+            return rr * factor;
+        }
+    }
+
+    template<Line L, double (*ShellFunction)(int, int, double, xrl_error **)>
+    double _cs_fluor_line_kissel(int Z, double E) noexcept {
+        static_assert(L == Line::LB || _kissel_line_shell(L) >= 0, "the CS_FluorLine_Kissel functions support K, L and M lines only");
+        if constexpr (L == Line::LB) {
+            double rv = 0.0;
+            _for_each_line(_lb_lines(), [&](auto line) {
+                rv += _cs_fluor_line_kissel<decltype(line)::value, ShellFunction>(Z, E);
+            });
+            return rv;
+        }
+        else {
+            double rr = _rad_rate<L>(Z);
+            if (rr == 0.0)
+                return 0.0;
+            double factor = ShellFunction(Z, _kissel_line_shell(L), E, nullptr);
+            if (factor == 0.0)
+                return 0.0;
+            return factor * rr;
+        }
+    }
+
+    inline double _cs_to_csb(int Z, double cs) noexcept {
+        return cs * ::AtomicWeight_unchecked(Z) / AVOGNUM;
+    }
+
+    template<Line L>
+    double _line_energy(int Z) noexcept {
+        if constexpr (L == Line::KA || L == Line::KB) {
+            constexpr int first = _line_index(L == Line::KA ? Line::KL1 : Line::KM1);
+            constexpr int last = _line_index(L == Line::KA ? Line::KL3 : Line::KP4);
+            double tmp = 0.0, tmp1 = 0.0;
+            for (int i = first ; i <= last ; i++) {
+                double rr = ::xrl_fast_rad_rate[Z][i];
+                tmp1 += rr;
+                tmp += ::xrl_fast_line_energy[Z][i] * rr;
+            }
+            return tmp1 > 0 ? tmp / tmp1 : 0.0;
+        }
+        else if constexpr (L == Line::LB) {
+            // weighted by the fluorescence of each line just above its edge
+            double tmp = 0.0, tmp2 = 0.0;
+            _for_each_line(_lb_lines(), [&](auto line) {
+                constexpr Line M = decltype(line)::value;
+                double tmp1 = _cs_fluor_line<M>(Z, ::EdgeEnergy_unchecked(Z, static_cast<int>(parent_shell(M))) + 0.1);
+                tmp2 += tmp1;
+                tmp += _line_energy<M>(Z) * tmp1;
+            });
+            return tmp2 > 0 ? tmp / tmp2 : 0.0;
+        }
+        else if constexpr (_line_pair<L>::value) {
+            // weighted by the radiative rates, or else the plain average
+            double line_tmp1 = _line_energy<_line_pair<L>::first>(Z);
+            double line_tmp2 = _line_energy<_line_pair<L>::second>(Z);
+            double rate_tmp1 = _rad_rate<_line_pair<L>::first>(Z);
+            double rate_tmp2 = _rad_rate<_line_pair<L>::second>(Z);
+            double rv = line_tmp1 * rate_tmp1 + line_tmp2 * rate_tmp2;
+            if (rv > 0.0)
+                return rv / (rate_tmp1 + rate_tmp2);
+            return (line_tmp1 + line_tmp2) / 2.0;
+        }
+        else if constexpr (L == Line::KO || L == Line::KP) {
+            // only in the radiative rate tables
+            return _line_energy<L == Line::KO ? Line::KO1 : Line::KP1>(Z);
+        }
+        else {
+            return ::LineEnergy_unchecked(Z, static_cast<int>(L));
+        }
+    }
+
+// the kernel of a function of Z, and its noexcept_api counterpart;
+// the calls are qualified, since Line brings in xrlpp by argument-dependent lookup
+#define _XRL_Z_LINE_KERNEL(_name, _kernel) \
+    template<Line L> \
+    double _name(int Z) { \
+        if (Z >= 1 && Z <= ZMAX) { \
+            double rv = _kernel; \
+            if (rv != 0.0) \
+                return rv; \
+        } \
+        return _name(Z, L); \
+    } \
+    namespace noexcept_api { \
+        template<Line L> \
+        result<double> _name(int Z) noexcept { \
+            if (Z >= 1 && Z <= ZMAX) { \
+                double rv = _kernel; \
+                if (rv != 0.0) \
+                    return rv; \
+            } \
+            return noexcept_api::_name(Z, L); \
+        } \
+    }
+
+// the same for a function of Z and E
+#define _XRL_LINE_KERNEL(_name, _kernel) \
+    template<Line L> \
+    double _name(int Z, double E) { \
+        if (Z >= 1 && Z <= ZMAX && E > 0.0) { \
+            double rv = _kernel; \
+            if (rv != 0.0) \
+                return rv; \
+        } \
+        return _name(Z, L, E); \
+    } \
+    namespace noexcept_api { \
+        template<Line L> \
+        result<double> _name(int Z, double E) noexcept { \
+            if (Z >= 1 && Z <= ZMAX && E > 0.0) { \
+                double rv = _kernel; \
+                if (rv != 0.0) \
+                    return rv; \
+            } \
+            return noexcept_api::_name(Z, L, E); \
+        } \
+    }
+
+    _XRL_Z_LINE_KERNEL(LineEnergy, _line_energy<L>(Z))
+    _XRL_Z_LINE_KERNEL(RadRate, _rad_rate<L>(Z))
+
+#define _XRL_KISSEL_LINE_KERNEL(_suffix, _shell_function) \
+    _XRL_LINE_KERNEL(CS_FluorLine_Kissel##_suffix, (_cs_fluor_line_kissel<L, ::_shell_function>(Z, E))) \
+    _XRL_LINE_KERNEL(CSb_FluorLine_Kissel##_suffix, _cs_to_csb(Z, _cs_fluor_line_kissel<L, ::_shell_function>(Z, E)))
+
+    _XRL_LINE_KERNEL(CS_FluorLine, _cs_fluor_line<L>(Z, E))
+    _XRL_LINE_KERNEL(CSb_FluorLine, _cs_to_csb(Z, _cs_fluor_line<L>(Z, E)))
+    _XRL_KISSEL_LINE_KERNEL(, CS_FluorShell_Kissel_Cascade)
+    _XRL_KISSEL_LINE_KERNEL(_Cascade, CS_FluorShell_Kissel_Cascade)
+    _XRL_KISSEL_LINE_KERNEL(_no_Cascade, CS_FluorShell_Kissel_no_Cascade)
+    _XRL_KISSEL_LINE_KERNEL(_Radiative_Cascade, CS_FluorShell_Kissel_Radiative_Cascade)
+    _XRL_KISSEL_LINE_KERNEL(_Nonradiative_Cascade, CS_FluorShell_Kissel_Nonradiative_Cascade)
+#endif
 }
 
 #endif
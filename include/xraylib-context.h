@@ -0,0 +1,124 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef XRAYLIB_CONTEXT_H
+#define XRAYLIB_CONTEXT_H
+
+#include "xraylib-error.h"
+
+#ifndef SWIG
+
+/*
+ * An evaluation context, to be used by one thread at a time.
+ *
+ * A context holds its own error slot, evaluation options and caches, which lets
+ * the _ctx functions run without allocating memory or touching shared state.
+ * Threads that evaluate the same tables concurrently should each create their own context.
+ */
+typedef struct _xrl_context xrl_context;
+
+/* Precision of the logarithms and exponentials around the log-log interpolated tables */
+typedef enum {
+  XRL_PRECISION_DOUBLE, /* default: identical results to the functions without context */
+  XRL_PRECISION_SINGLE  /* single precision: relative errors below 1E-4 (median 1E-7), except within */
+                        /* 1E-7 of absorption edges, where energies may end up on the other side of the edge */
+} xrl_precision;
+
+/* Interpolation between the tabulated values */
+typedef enum {
+  XRL_INTERPOLATION_SPLINE, /* default: cubic splines, as the functions without context */
+  XRL_INTERPOLATION_LINEAR  /* linear interpolation (in log-log space for the cross sections): */
+                            /* median relative errors of 1E-3, up to 0.5 for the scattering functions */
+                            /* where they vanish */
+} xrl_interpolation;
+
+XRL_EXTERN
+xrl_context* xrl_context_new(xrl_error **error);
+
+XRL_EXTERN
+void xrl_context_free(xrl_context *ctx);
+
+XRL_EXTERN
+int xrl_context_set_precision(xrl_context *ctx, xrl_precision precision, xrl_error **error);
+
+XRL_EXTERN
+xrl_precision xrl_context_get_precision(const xrl_context *ctx);
+
+XRL_EXTERN
+int xrl_context_set_interpolation(xrl_context *ctx, xrl_interpolation interpolation, xrl_error **error);
+
+XRL_EXTERN
+xrl_interpolation xrl_context_get_interpolation(const xrl_context *ctx);
+
+/*
+ * Turn the validation of the arguments on (default) or off.
+ * Without validation, the caller must guarantee that energies and momentum transfers are strictly positive.
+ * Atomic numbers without data and values outside the range of a table are still reported.
+ */
+XRL_EXTERN
+void xrl_context_set_validation(xrl_context *ctx, int validation);
+
+XRL_EXTERN
+int xrl_context_get_validation(const xrl_context *ctx);
+
+/*
+ * The error of the last _ctx function that failed, or NULL. Successful calls leave it untouched.
+ * The error is owned by the context and remains valid until the next failure or until it is cleared:
+ * do not pass it to xrl_error_free.
+ */
+XRL_EXTERN
+const xrl_error* xrl_context_get_error(const xrl_context *ctx);
+
+XRL_EXTERN
+void xrl_context_clear_error(xrl_context *ctx);
+
+/*
+ * Counterparts of the functions with the same name without _ctx.
+ * They remember the last interval that was used in every table, which makes scans
+ * over energy or momentum transfer cheaper than repeated bisections.
+ * A NULL context evaluates the function without context and ignores errors.
+ * Return 0.0 on error, which is stored in the context.
+ */
+XRL_EXTERN
+double CS_Total_ctx(xrl_context *ctx, int Z, double E);
+XRL_EXTERN
+double CS_Photo_ctx(xrl_context *ctx, int Z, double E);
+XRL_EXTERN
+double CS_Rayl_ctx(xrl_context *ctx, int Z, double E);
+XRL_EXTERN
+double CS_Compt_ctx(xrl_context *ctx, int Z, double E);
+XRL_EXTERN
+double CS_Energy_ctx(xrl_context *ctx, int Z, double E);
+
+XRL_EXTERN
+double CSb_Total_ctx(xrl_context *ctx, int Z, double E);
+XRL_EXTERN
+double CSb_Photo_ctx(xrl_context *ctx, int Z, double E);
+XRL_EXTERN
+double CSb_Rayl_ctx(xrl_context *ctx, int Z, double E);
+XRL_EXTERN
+double CSb_Compt_ctx(xrl_context *ctx, int Z, double E);
+
+XRL_EXTERN
+double FF_Rayl_ctx(xrl_context *ctx, int Z, double q);
+XRL_EXTERN
+double SF_Compt_ctx(xrl_context *ctx, int Z, double q);
+
+XRL_EXTERN
+double Fi_ctx(xrl_context *ctx, int Z, double E);
+XRL_EXTERN
+double Fii_ctx(xrl_context *ctx, int Z, double E);
+
+#endif
+
+#endif
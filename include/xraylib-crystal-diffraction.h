@@ -19,8 +19,10 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 #include "xraylib-error.h"
 
 /* Note for multithreaded programs:
- * The routines Crystal_ReadCrystals and CrystalAddCrystalStruct are not thread safe if crystals are
- * added to the official array. In this case, locking will have to be used.
+ * The official array of crystals may be queried and extended from multiple threads:
+ * Crystal_AddCrystal and Crystal_ReadFile publish a new immutable snapshot of the array,
+ * and lookups never block. Crystal_Array structs created by the user are not protected,
+ * in this case locking will have to be used.
  *
  * Parameters:
  * energy    -- KeV
@@ -67,6 +69,41 @@ void Crystal_Free (Crystal_Struct* crystal);
 XRL_EXTERN
 Crystal_Struct* Crystal_GetCrystal(const char* material, Crystal_Array* c_array, xrl_error **error);
 
+/*--------------------------------------------------------------------------------
+ * Shared crystals: reference counted, immutable CrystalStructs.
+ * They can be passed to all functions accepting a CrystalStruct, but must never be modified,
+ * nor be freed with Crystal_Free.
+ *
+ * Crystal_GetCrystalShared returns the shared CrystalStruct of a material from the official
+ * array of crystals, without copying or allocating memory.
+ * These crystals live until the program exits: releasing them is allowed but not required.
+ * If not found, NULL is returned.
+ */
+
+XRL_EXTERN
+Crystal_Struct* Crystal_GetCrystalShared(const char* material, xrl_error **error);
+
+/*--------------------------------------------------------------------------------
+ * Create a shared copy of a CrystalStruct, with a reference count of 1.
+ */
+
+XRL_EXTERN
+Crystal_Struct* Crystal_MakeShared(Crystal_Struct* crystal, xrl_error **error);
+
+/*--------------------------------------------------------------------------------
+ * Increase the reference count of a shared CrystalStruct. Returns crystal.
+ */
+
+XRL_EXTERN
+Crystal_Struct* Crystal_Retain(Crystal_Struct* crystal);
+
+/*--------------------------------------------------------------------------------
+ * Decrease the reference count of a shared CrystalStruct, freeing it when it drops to zero.
+ */
+
+XRL_EXTERN
+void Crystal_Release(Crystal_Struct* crystal);
+
 /*--------------------------------------------------------------------------------------------------
  * Bragg angle in radians.
  */
@@ -113,6 +150,141 @@ xrlComplex Crystal_F_H_StructureFactor_Partial (Crystal_Struct* crystal, double
                       int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle,
                       int f0_flag, int f_prime_flag, int f_prime2_flag, xrl_error **error);
 
+/*--------------------------------------------------------------------------------------------------
+ * Compute F_H for n_miller reflections at once.
+ * miller holds the Miller indices as consecutive (h, k, l) triplets and must be 3 * n_miller long.
+ * The structure factors are written to F_H, which must be n_miller long.
+ * The *_flag arguments have the same meaning as for Crystal_F_H_StructureFactor_Partial.
+ * Return: 1 on success and 0 on error.
+ */
+
+XRL_EXTERN
+int Crystal_F_H_StructureFactor_Batch (Crystal_Struct* crystal, double energy,
+                      const int miller[], int n_miller, double debye_factor, double rel_angle,
+                      xrlComplex F_H[], xrl_error **error);
+
+XRL_EXTERN
+int Crystal_F_H_StructureFactor_Partial_Batch (Crystal_Struct* crystal, double energy,
+                      const int miller[], int n_miller, double debye_factor, double rel_angle,
+                      int f0_flag, int f_prime_flag, int f_prime2_flag, xrlComplex F_H[], xrl_error **error);
+
+/*--------------------------------------------------------------------------------------------------
+ * Prepared reflection: caches the phase factors of a (crystal, h, k, l) combination,
+ * summed per atomic number, for fast evaluation of F_H at many energies,
+ * e.g. when scanning across an absorption edge.
+ * The crystal is not referenced after Crystal_Reflection_New returns.
+ * Free the returned reflection with Crystal_Reflection_Free.
+ */
+
+typedef struct _Crystal_Reflection Crystal_Reflection;
+
+XRL_EXTERN
+Crystal_Reflection* Crystal_Reflection_New (Crystal_Struct* crystal, int i_miller, int j_miller, int k_miller,
+                      double debye_factor, double rel_angle, xrl_error **error);
+
+XRL_EXTERN
+void Crystal_Reflection_Free (Crystal_Reflection* reflection);
+
+/*--------------------------------------------------------------------------------------------------
+ * Compute F_H of a prepared reflection. Identical to Crystal_F_H_StructureFactor.
+ */
+
+XRL_EXTERN
+xrlComplex Crystal_Reflection_F_H (Crystal_Reflection* reflection, double energy, xrl_error **error);
+
+/*--------------------------------------------------------------------------------------------------
+ * Compute F_H of a prepared reflection for n_energies energies.
+ * Sorted energies are evaluated fastest.
+ * Return: 1 on success and 0 on error.
+ */
+
+XRL_EXTERN
+int Crystal_Reflection_F_H_Batch (Crystal_Reflection* reflection, const double energies[], int n_energies,
+                      xrlComplex F_H[], xrl_error **error);
+
+/*--------------------------------------------------------------------------------------------------
+ * Dynamical diffraction by a perfect crystal plate (two-beam theory of Zachariasen).
+ *
+ * geometry           -- CRYSTAL_GEOMETRY_BRAGG (reflection) or CRYSTAL_GEOMETRY_LAUE (transmission)
+ * polarization       -- CRYSTAL_POLARIZATION_SIGMA or CRYSTAL_POLARIZATION_PI
+ * asymmetry_angle    -- angle between the reflecting planes and the crystal surface (Bragg),
+ *                       or the surface normal (Laue), in radians. 0 for symmetric reflections.
+ * thickness          -- cm. For a semi-infinite crystal in Bragg geometry use INFINITY or a large value.
+ *
+ * Crystal_DarwinWidth returns the width in radians of the region of total reflection of a thick, non-absorbing crystal
+ * in Bragg geometry, and the corresponding angular acceptance in Laue geometry.
+ */
+
+#define CRYSTAL_GEOMETRY_BRAGG 0
+#define CRYSTAL_GEOMETRY_LAUE 1
+#define CRYSTAL_POLARIZATION_SIGMA 0
+#define CRYSTAL_POLARIZATION_PI 1
+
+XRL_EXTERN
+double Crystal_DarwinWidth (Crystal_Struct* crystal, double energy, int i_miller, int j_miller, int k_miller,
+                      double asymmetry_angle, int geometry, int polarization, double debye_factor, xrl_error **error);
+
+/*--------------------------------------------------------------------------------------------------
+ * Rocking curve: reflectivity for n_delta_theta angles of incidence delta_theta (radians),
+ * relative to the Bragg angle. The structure factors are evaluated once.
+ * Return: 1 on success and 0 on error.
+ */
+
+XRL_EXTERN
+int Crystal_RockingCurve (Crystal_Struct* crystal, double energy, int i_miller, int j_miller, int k_miller,
+                      double asymmetry_angle, double thickness, int geometry, int polarization, double debye_factor,
+                      const double delta_theta[], int n_delta_theta, double R[], xrl_error **error);
+
+/*--------------------------------------------------------------------------------------------------
+ * Reflectivity for n_energies energies, at a fixed glancing angle theta (radians) to the reflecting planes,
+ * e.g. to compute the bandpass of a monochromator. Energies for which the reflection cannot be excited
+ * have zero reflectivity. Sorted energies are evaluated fastest.
+ * Return: 1 on success and 0 on error.
+ */
+
+XRL_EXTERN
+int Crystal_RockingCurve_Energy (Crystal_Struct* crystal, const double energies[], int n_energies,
+                      int i_miller, int j_miller, int k_miller, double theta,
+                      double asymmetry_angle, double thickness, int geometry, int polarization, double debye_factor,
+                      double R[], xrl_error **error);
+
+/*--------------------------------------------------------------------------------------------------
+ * Powder diffraction.
+ *
+ * Crystal_PowderReflections enumerates all reflections with d-spacing >= d_min (Angstrom)
+ * that can be excited at the given energy, sorted by increasing 2 theta.
+ * The space group operations are found from the positions of the atoms: every set of reflections
+ * that are equivalent under the Laue class is reported once, with its multiplicity, and the
+ * reflections forbidden by centering, screw axes and glide planes are skipped before any structure
+ * factor is computed. Reflections that vanish because of the positions of the atoms are dropped.
+ * Reflections that are not equivalent are reported separately, even if their d-spacings are equal.
+ * The number of reflections is written to n_reflections. Free the returned array with xrlFree.
+ */
+
+typedef struct {
+  int h, k, l;              /* Miller indices of the largest equivalent reflection */
+  int multiplicity;         /* Number of equivalent reflections */
+  double d_spacing;         /* Angstrom */
+  double two_theta;         /* Scattering angle in radians */
+  double F2;                /* |F_H|^2, averaged over the Friedel pair */
+  double intensity;         /* multiplicity * |F_H|^2 * Lorentz-polarization factor for an unpolarized beam */
+} Crystal_PowderReflection;
+
+XRL_EXTERN
+Crystal_PowderReflection* Crystal_PowderReflections (Crystal_Struct* crystal, double energy, double d_min,
+                      double debye_factor, int *n_reflections, xrl_error **error);
+
+/*--------------------------------------------------------------------------------------------------
+ * Render powder reflections on a grid of n_two_theta scattering angles (radians, sorted in ascending order),
+ * using pseudo-Voigt peaks of unit area with full width at half maximum fwhm (radians),
+ * and Lorentzian fraction eta (0: Gaussian, 1: Lorentzian). Each peak is scaled with its intensity.
+ * Return: 1 on success and 0 on error.
+ */
+
+XRL_EXTERN
+int Crystal_PowderProfile (const Crystal_PowderReflection reflections[], int n_reflections, double fwhm, double eta,
+                      const double two_theta[], int n_two_theta, double profile[], xrl_error **error);
+
 /*--------------------------------------------------------------------------------
  * Compute unit cell volume.
  * Note: Structures obtained from crystal array will have their volume in .volume.
@@ -151,6 +323,52 @@ int Crystal_AddCrystal (Crystal_Struct* crystal, Crystal_Array* c_array, xrl_err
 XRL_EXTERN
 int Crystal_ReadFile (const char* file_name, Crystal_Array* c_array, xrl_error **error);
 
+/*--------------------------------------------------------------------------------
+ * Read in the crystal structures of a CIF file to crystal_array.
+ * Every data block with atom sites yields a crystal named after the block.
+ * Only the unit cell, the symmetry operators (_symmetry_equiv_pos_as_xyz or
+ * _space_group_symop_operation_xyz) and the fractional coordinates and occupancies
+ * of the atom sites are used: the symmetry operators are applied to all sites,
+ * and equivalent positions are merged.
+ * If a material already exists in the array then the existing material data is overwitten.
+ * If crystal_array is NULL then the crystals are added to the official array of crystals.
+ * Return: 1 on success and 0 on error.
+ */
+
+XRL_EXTERN
+int Crystal_ReadCIF (const char* file_name, Crystal_Array* c_array, xrl_error **error);
+
+/*--------------------------------------------------------------------------------
+ * Write the crystals of crystal_array to a binary crystal library,
+ * which can be loaded instantly with Crystal_ArrayMapBinary.
+ * If crystal_array is NULL then the official array of crystals is written.
+ * The library uses the native byte order and is not portable across platforms.
+ * Return: 1 on success and 0 on error.
+ */
+
+XRL_EXTERN
+int Crystal_ArrayWriteBinary (Crystal_Array* c_array, const char* file_name, xrl_error **error);
+
+/*--------------------------------------------------------------------------------
+ * Memory-map a binary crystal library written by Crystal_ArrayWriteBinary.
+ * The names and atoms of the crystals point directly into the mapped file:
+ * the returned array is read-only, and Crystal_AddCrystal, Crystal_ReadFile and Crystal_ReadCIF
+ * fail on it with XRL_ERROR_INVALID_ARGUMENT. It can be used with all other functions that take
+ * a crystal array, and must be released with Crystal_ArrayUnmapBinary (or Crystal_ArrayFree).
+ * Return: the crystal array, or NULL on error.
+ */
+
+XRL_EXTERN
+Crystal_Array* Crystal_ArrayMapBinary (const char* file_name, xrl_error **error);
+
+/*--------------------------------------------------------------------------------
+ * Release a crystal array returned by Crystal_ArrayMapBinary.
+ * Crystals obtained from this array must no longer be used afterwards.
+ */
+
+XRL_EXTERN
+void Crystal_ArrayUnmapBinary (Crystal_Array* c_array);
+
 /*--------------------------------------------------------------------------------
  * Returns a NULL-terminated array of strings containing the names of the crystals
  * in c_array. If c_array is NULL, then the builtin array of crystals will be used instead
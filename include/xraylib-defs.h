@@ -39,6 +39,16 @@ typedef struct {
   double re;               /* Real part */
   double im;               /* Imaginary part */
 } xrlComplex;
+
+/* Optical constants of a material at one energy */
+
+typedef struct {
+  double delta;              /* Decrement of the real part of the refractive index: 1 - delta */
+  double beta;               /* Imaginary part of the refractive index */
+  double critical_angle;     /* Critical angle for total external reflection (rad) */
+  double attenuation_length; /* Distance over which the intensity drops by 1/e (cm) */
+  double reflectivity;       /* Fresnel reflectivity at the requested grazing angle */
+} xrlOpticalConstants;
 #ifndef c_abs
 /* this is giving a lot of trouble with python */
 XRL_EXTERN
@@ -72,6 +82,7 @@ typedef struct {
   int n_crystal;          /* Number of defined crystals. */
   int n_alloc;            /* Size of .crystal array malloc'd */
   Crystal_Struct* crystal;
+  int mapped;             /* Nonzero for the read-only arrays of Crystal_ArrayMapBinary. */
 } Crystal_Array;
 
 #endif
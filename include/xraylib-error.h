@@ -36,6 +36,8 @@ typedef enum {
  *
  * The `xrl_error` structure contains information about
  * an error that has occurred.
+ * Errors may be shared between calls: do not modify them,
+ * and release them with xrl_error_free or xrl_clear_error only.
  */
 typedef struct _xrl_error xrl_error;
 
@@ -0,0 +1,121 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef XRAYLIB_FAST_H
+#define XRAYLIB_FAST_H
+
+#include "xraylib.h"
+
+/*
+ * Unchecked accessors for the scalar tables, which can be inlined into tight loops.
+ *
+ * This header is not included by xraylib.h: include it explicitly to opt in.
+ * The accessors read the tables directly, without validating their arguments:
+ * Z must be between 1 and ZMAX, and shell, line, transition and Auger macros must
+ * be valid single values (line groups such as KA_LINE are not supported).
+ * For valid arguments they return the same values as their checked counterparts,
+ * including 0.0 where no data is available.
+ *
+ * The accessors read the tables through read-only pointers, which XRayLoadDataImage and
+ * XRayUnloadDataImage redirect along with the library's own tables.
+ */
+
+#ifndef SWIG
+
+#if defined(_MSC_VER) && !defined(__cplusplus)
+  #define XRL_INLINE static __inline
+#else
+  #define XRL_INLINE static inline
+#endif
+
+/* data symbols have to be imported explicitly from a DLL */
+#ifndef XRL_EXTERN_DATA
+  #if defined(_WIN32) && !defined(XRL_STATIC)
+    #define XRL_EXTERN_DATA __declspec(dllimport) extern
+  #else
+    #define XRL_EXTERN_DATA extern
+  #endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* do not assign to these pointers */
+XRL_EXTERN_DATA const double *xrl_fast_atomic_weight;
+XRL_EXTERN_DATA const double *xrl_fast_element_density;
+XRL_EXTERN_DATA const double (*xrl_fast_edge_energy)[SHELLNUM];
+XRL_EXTERN_DATA const double (*xrl_fast_fluor_yield)[SHELLNUM];
+XRL_EXTERN_DATA const double (*xrl_fast_jump_factor)[SHELLNUM];
+XRL_EXTERN_DATA const double (*xrl_fast_atomic_level_width)[SHELLNUM];
+XRL_EXTERN_DATA const double (*xrl_fast_line_energy)[LINENUM];
+XRL_EXTERN_DATA const double (*xrl_fast_rad_rate)[LINENUM];
+XRL_EXTERN_DATA const double (*xrl_fast_cos_kron)[TRANSNUM];
+XRL_EXTERN_DATA const double (*xrl_fast_auger_rates)[AUGERNUM];
+
+#ifdef __cplusplus
+}
+#endif
+
+/* missing data is stored as zero or as a negative value */
+#define XRL_FAST_VALUE(value) ((value) > 0.0 ? (value) : 0.0)
+
+XRL_INLINE double AtomicWeight_unchecked(int Z) {
+  return XRL_FAST_VALUE(xrl_fast_atomic_weight[Z]);
+}
+
+XRL_INLINE double ElementDensity_unchecked(int Z) {
+  return XRL_FAST_VALUE(xrl_fast_element_density[Z]);
+}
+
+XRL_INLINE double EdgeEnergy_unchecked(int Z, int shell) {
+  return XRL_FAST_VALUE(xrl_fast_edge_energy[Z][shell]);
+}
+
+XRL_INLINE double FluorYield_unchecked(int Z, int shell) {
+  return XRL_FAST_VALUE(xrl_fast_fluor_yield[Z][shell]);
+}
+
+XRL_INLINE double JumpFactor_unchecked(int Z, int shell) {
+  return XRL_FAST_VALUE(xrl_fast_jump_factor[Z][shell]);
+}
+
+XRL_INLINE double AtomicLevelWidth_unchecked(int Z, int shell) {
+  return XRL_FAST_VALUE(xrl_fast_atomic_level_width[Z][shell]);
+}
+
+/*
+ * line is a single line macro such as KL3_LINE.
+ * KO_LINE, KP_LINE and the composed lines such as L3O45_LINE have no energy of their own:
+ * LineEnergy derives theirs from other lines.
+ */
+XRL_INLINE double LineEnergy_unchecked(int Z, int line) {
+  return XRL_FAST_VALUE(xrl_fast_line_energy[Z][-line - 1]);
+}
+
+/* line is a single line macro such as KL3_LINE */
+XRL_INLINE double RadRate_unchecked(int Z, int line) {
+  return XRL_FAST_VALUE(xrl_fast_rad_rate[Z][-line - 1]);
+}
+
+XRL_INLINE double CosKronTransProb_unchecked(int Z, int trans) {
+  return XRL_FAST_VALUE(xrl_fast_cos_kron[Z][trans]);
+}
+
+XRL_INLINE double AugerRate_unchecked(int Z, int auger_trans) {
+  return XRL_FAST_VALUE(xrl_fast_auger_rates[Z][auger_trans]);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,55 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef XRAYLIB_MULTILAYER_H
+#define XRAYLIB_MULTILAYER_H
+
+#include "xraylib-error.h"
+
+/*
+ * A layer of a multilayer stack.
+ *
+ * material: chemical formula or NIST compound name
+ * density: density (g/cm3). For NIST compounds, a density that is not positive
+ *   selects the density from the NIST database
+ * thickness: thickness of the layer (cm). Ignored for the substrate
+ * roughness: rms roughness of the top interface of the layer (cm)
+ */
+
+typedef struct {
+  const char *material;
+  double density;
+  double thickness;
+  double roughness;
+} xrlLayer;
+
+/*--------------------------------------------------------------------------------
+ * Specular reflectivity of a stack of layers in vacuum, calculated with the
+ * Parratt recursion. Interface roughness is taken into account with the
+ * Nevot-Croce factor.
+ *
+ * layers[0] is the top layer and layers[n_layers - 1] the semi-infinite substrate.
+ * R must hold nE * n_theta values, and receives the reflectivity for energy E[i] and
+ * grazing angle theta[j] (rad) in R[i * n_theta + j].
+ *
+ * The refractive index of every layer is evaluated once per energy, and all
+ * angles are processed together. If xraylib was built with OpenMP support,
+ * the energies are distributed over multiple threads.
+ *
+ * Return: 1 on success and 0 on error.
+ */
+
+XRL_EXTERN
+int Multilayer_Reflectivity(const xrlLayer layers[], int n_layers, const double E[], int nE, const double theta[], int n_theta, double R[], xrl_error **error);
+
+#endif
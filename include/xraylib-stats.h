@@ -0,0 +1,90 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef XRAYLIB_STATS_H
+#define XRAYLIB_STATS_H
+
+#include "xraylib-error.h"
+#include <stdint.h>
+
+#ifndef SWIG
+
+/*
+ * Call statistics, for finding out which functions dominate the time spent in xraylib.
+ *
+ * Statistics are only gathered when xraylib was configured with --enable-stats (meson: -Dstats=true),
+ * otherwise the functions below report XRL_ERROR_UNSUPPORTED and the library pays nothing for them.
+ * Every exported function is counted, except for those that manage memory, errors and contexts,
+ * and the inline accessors of xraylib-fast.h.
+ * Calls that xraylib makes itself are counted too, such as the CompoundParser calls of the _CP functions,
+ * and are reported separately as internal calls.
+ * Every thread counts in its own shard, so the counters do not slow down concurrent callers;
+ * the counts of threads that have exited are kept.
+ */
+
+#define XRL_STATS_ERROR_CODES (XRL_ERROR_RUNTIME + 1)
+#define XRL_STATS_HISTOGRAM_BUCKETS 32
+
+typedef struct {
+  const char *name;
+  uint64_t calls;
+  uint64_t internal_calls;                 /* calls made by other xraylib functions */
+  uint64_t errors[XRL_STATS_ERROR_CODES];  /* indexed by xrl_error_code, counted in the function that raised them */
+  uint64_t timed_calls;                    /* calls that were sampled for timing */
+  uint64_t time_ns;                        /* total duration of the timed calls, including the functions they call */
+  uint64_t histogram[XRL_STATS_HISTOGRAM_BUCKETS]; /* bucket i counts timed calls that took [2^i, 2^(i+1)) ns */
+} xrl_stats_function;
+
+typedef struct {
+  int n_functions;
+  xrl_stats_function *functions;           /* every function that was called at least once since xraylib was loaded */
+  uint64_t errors[XRL_STATS_ERROR_CODES];  /* all errors, including those raised when no error was requested */
+  uint64_t compound_parses;                /* CompoundParser invocations */
+  uint64_t nist_lookups;                   /* NIST compound lookups, by name or by index */
+} xrl_stats;
+
+XRL_EXTERN
+int xrl_stats_enabled(void);
+
+/*
+ * Sum of the counters of all threads since the last reset.
+ * Free the snapshot with xrl_stats_free.
+ */
+XRL_EXTERN
+xrl_stats* xrl_stats_snapshot(xrl_error **error);
+
+XRL_EXTERN
+void xrl_stats_free(xrl_stats *stats);
+
+XRL_EXTERN
+int xrl_stats_reset(xrl_error **error);
+
+/*
+ * Time one in every interval calls of each function, in each thread (default 0: no timing).
+ * Timing costs two clock readings per sampled call.
+ */
+XRL_EXTERN
+int xrl_stats_set_timing(int interval, xrl_error **error);
+
+XRL_EXTERN
+int xrl_stats_get_timing(void);
+
+/*
+ * The snapshot as a JSON document, to be freed with xrlFree.
+ */
+XRL_EXTERN
+char* xrl_stats_to_json(const xrl_stats *stats, xrl_error **error);
+
+#endif
+
+#endif
@@ -0,0 +1,61 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef XRAYLIB_TABLES_H
+#define XRAYLIB_TABLES_H
+
+#include "xraylib-error.h"
+
+#ifndef SWIG
+
+/*
+ * Read-only access to the tables that xraylib interpolates, for resampling or fitting them
+ * without reconstructing them one function call at a time.
+ *
+ * Tables are named after the variables that hold them, as in a data image written by prdata --image:
+ * - fixed size tables of doubles, such as AtomicWeight_arr, EdgeEnergy_arr, RadRate_arr and EdgeEnergy_Kissel
+ * - tables with one array per element, such as E_Photo_arr, CS_Photo_arr, q_Rayl_arr and FF_Rayl_arr
+ * - tables with one array per element and shell: E_Photo_Partial_Kissel and Photo_Partial_Kissel (Kissel shells),
+ *   Partial_ComptonProfiles (occupied shells)
+ * The values are stored as they are interpolated: the cross section tables hold the natural logarithms
+ * of the energies (in eV, but in keV for the Kissel tables) and of the cross sections,
+ * and the tables ending in 2 hold the second derivatives of the splines through the others.
+ *
+ * No copies are made: the pointers refer to the memory of the library and must not be written to.
+ * They remain valid until XRayLoadDataImage or XRayUnloadDataImage is called.
+ */
+
+/*
+ * A fixed size table, as rows x columns doubles in row-major order, with a row for every Z from 0 to ZMAX.
+ * The tables indexed by two macros, such as xrf_cross_sections_constants_full, have them flattened into the columns.
+ */
+XRL_EXTERN
+int xrl_table_fixed(const char *name, const double **data, int *rows, int *columns, xrl_error **error);
+
+/*
+ * The array of an element, of length values.
+ * Elements without data give a NULL array of length 0, which is not an error.
+ */
+XRL_EXTERN
+int xrl_table_element(const char *name, int Z, const double **data, int *length, xrl_error **error);
+
+/*
+ * The array of an element and shell, of length values.
+ * Shells without data give a NULL array of length 0, which is not an error.
+ */
+XRL_EXTERN
+int xrl_table_element_shell(const char *name, int Z, int shell, const double **data, int *length, xrl_error **error);
+
+#endif
+
+#endif
@@ -62,9 +62,26 @@ extern "C" {
 #include "xraylib-crystal-diffraction.h"
 #include "xraylib-nist-compounds.h"
 #include "xraylib-radionuclides.h"
+#include "xraylib-multilayer.h"
+#include "xraylib-context.h"
+#include "xraylib-stats.h"
+#include "xraylib-tables.h"
 #include "xraylib-deprecated.h"
 #include "xraylib-aux.h"
 
+/*
+ * Thread safety
+ *
+ * All functions may be called concurrently from multiple threads, without external locking,
+ * with the following exceptions:
+ *  - XRayLoadDataImage and XRayUnloadDataImage replace the tables: no other xraylib functions may be running.
+ *  - Crystal_Array structs and xrl_context objects created by the user are not protected:
+ *    they may be shared by threads that only read them, or used by one thread at a time.
+ * The official array of crystals is protected: it may be extended while other threads look up crystals.
+ * Chemical formulas and crystal files are parsed in the C locale without calling setlocale,
+ * so the locale of the process is never changed.
+ */
+
 /*
  * Siegbahn notation
  * according to Table VIII.2 from Nomenclature system for X-ray spectroscopy
@@ -139,6 +156,45 @@ extern "C" {
 XRL_EXTERN
 void XRayInit(void);
 
+/*
+ * Replace the compiled-in tables with those of a binary data image, written by prdata --image.
+ * The image is memory-mapped read-only, which lets processes that load the same image share its pages.
+ * Loading another image replaces the current one.
+ * Not thread-safe: no other xraylib functions may be running while an image is (un)loaded.
+ */
+XRL_EXTERN
+int XRayLoadDataImage(const char *file_name, xrl_error **error);
+
+/* Restore the compiled-in tables and unmap the data image */
+XRL_EXTERN
+void XRayUnloadDataImage(void);
+
+/* Sections of the tables, which can be combined with | */
+#define XRL_DATA_SECTION_ATOMIC (1 << 0)             /* weights, densities, edges, level widths, line energies, yields, rates */
+#define XRL_DATA_SECTION_CROSS_SECTIONS (1 << 1)     /* photoionization, Rayleigh, Compton and energy absorption */
+#define XRL_DATA_SECTION_SCATTERING_FACTORS (1 << 2) /* form factors and incoherent scattering functions */
+#define XRL_DATA_SECTION_ANOMALOUS (1 << 3)          /* anomalous scattering factors Fi and Fii */
+#define XRL_DATA_SECTION_KISSEL (1 << 4)             /* Kissel photoionization cross sections */
+#define XRL_DATA_SECTION_COMPTON_PROFILES (1 << 5)
+#define XRL_DATA_SECTION_AUGER (1 << 6)              /* Auger rates and yields, cascade constants */
+#define XRL_DATA_SECTION_ALL ((1 << 7) - 1)
+
+/*
+ * Page in the tables of the given sections ahead of their first use, which takes the latency of
+ * reading a memory-mapped data image out of the functions that are called first.
+ * With a data image loaded, the pages of a section are reused by all processes that map the same image.
+ */
+XRL_EXTERN
+int XRayPreloadDataSections(int sections, xrl_error **error);
+
+/*
+ * Drop the memory held by the tables of the given sections of a loaded data image.
+ * The pages are read from the image again on their next use, so functions keep working as before.
+ * Has no effect on the compiled-in tables.
+ */
+XRL_EXTERN
+void XRayReleaseDataSections(int sections);
+
 /* Atomic weights */
 XRL_EXTERN
 double AtomicWeight(int Z, xrl_error **error);
@@ -371,12 +427,30 @@ double Refractive_Index_Im(const char compound[], double E, double density, xrl_
 XRL_EXTERN
 xrlComplex Refractive_Index(const char compound[], double E, double density, xrl_error **error);
 
+/* Fill constants with the optical constants of compound for each of the nE energies in E.
+ * The compound is resolved only once, which makes this much faster than calling
+ * Refractive_Index_Re and Refractive_Index_Im for every energy.
+ * theta is the grazing angle (rad) at which the Fresnel reflectivity is evaluated.
+ * Return 1 on success and 0 on error. */
+XRL_EXTERN
+int Refractive_Index_Batch(const char compound[], const double E[], int nE, double density, double theta, xrlOpticalConstants constants[], xrl_error **error);
+
 /* ComptonProfiles */
 XRL_EXTERN
 double ComptonProfile(int Z, double pz, xrl_error **error);
 XRL_EXTERN
 double ComptonProfile_Partial(int Z, int shell, double pz, xrl_error **error);
 
+/* Doppler broadened Compton scattering spectra (impulse approximation)
+ * Fill ddcs with the doubly differential cross section for each of the nE
+ * scattered photon energies in E. Return 1 on success and 0 on error. */
+XRL_EXTERN
+int DDCS_Compt(int Z, double E0, double theta, const double E[], int nE, double ddcs[], xrl_error **error);
+XRL_EXTERN
+int DDCSb_Compt(int Z, double E0, double theta, const double E[], int nE, double ddcs[], xrl_error **error);
+XRL_EXTERN
+int DDCS_Compt_CP(const char compound[], double E0, double theta, const double E[], int nE, double ddcs[], xrl_error **error);
+
 /* Atomic level widths */
 XRL_EXTERN
 double AtomicLevelWidth(int Z, int shell, xrl_error **error);
@@ -34,11 +34,12 @@ void XRayInit(void);
 void XRayInitFromPath(char *path);
 FILE *f;
 
+/* the tables are pointers to their rows */
 #define PR_MATD(ARRNAME) \
-	fwrite(ARRNAME, sizeof(double), sizeof(ARRNAME) / sizeof(double), f);
+	fwrite(ARRNAME, sizeof(double), (ZMAX+1) * sizeof(*ARRNAME) / sizeof(double), f);
 
 #define PR_MATI(ARRNAME) \
-	fwrite(ARRNAME, sizeof(int), sizeof(ARRNAME) / sizeof(int), f);
+	fwrite(ARRNAME, sizeof(int), (ZMAX+1) * sizeof(*ARRNAME) / sizeof(int), f);
 
 #define PR_DYNMATD(NVAR, EVAR, ENAME) \
   for(j = 0; j < ZMAX+1; j++) { \
@@ -1018,7 +1019,7 @@ int main(int argc, char *argv[])
 
   fprintf (f, "};\n\n");
 
-  fprintf(f, "Crystal_Array Crystal_arr = {%i, %i, __Crystal_arr};\n\n", Crystal_arr.n_crystal, Crystal_arr.n_alloc);
+  fprintf(f, "Crystal_Array Crystal_arr = {%i, %i, __Crystal_arr, 0};\n\n", Crystal_arr.n_crystal, Crystal_arr.n_alloc);
   */
 
   print_doublevec(ZMAX+1, AtomicWeight_arr);
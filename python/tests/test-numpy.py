@@ -1,6 +1,20 @@
+import os
+# more than one thread, so that the prange loops of xraylib_np run in parallel
+os.environ['OMP_NUM_THREADS'] = '4'
 import unittest
 import xraylib
 import numpy as np
+try:
+    import xraylib_np
+except ImportError:
+    xraylib_np = None
+
+def _scalar(function, *args):
+    # the numpy functions return 0 where the scalar ones raise
+    try:
+        return function(*args)
+    except ValueError:
+        return 0.0
 
 class TestNumpy(unittest.TestCase):
     def _test_np(self, dtype):
@@ -16,5 +30,230 @@ class TestNumpy(unittest.TestCase):
     def test_np_i64(self):
         self._test_np(np.int64)
 
+@unittest.skipIf(xraylib_np is None, "xraylib_np is not available")
+class TestNumpyCompounds(unittest.TestCase):
+    # more energies than fit in one block of the refractive index functions, with some that fail in the middle
+    E = np.linspace(0.5, 120.0, 1000)
+    E[[300, 301, 650]] = [0.0, -5.0, 1E7]
+
+    def test_compound(self):
+        c = xraylib_np.Compound("H2O")
+        self.assertEqual(c.name, "H2O")
+        self.assertEqual(repr(c), "Compound('H2O')")
+        np.testing.assert_array_equal(c.elements, [1, 8])
+        self.assertAlmostEqual(c.mass_fractions.sum(), 1.0)
+        self.assertIsNone(c.density)
+        self.assertEqual(xraylib_np.Compound("Water, Liquid").density, 1.0)
+        for compound in ("H2O)", "Auu1", "", "Non-existent NIST compound"):
+            with self.assertRaises(ValueError):
+                xraylib_np.Compound(compound)
+            with self.assertRaises(ValueError):
+                xraylib_np.CS_Total_CP(compound, self.E)
+        with self.assertRaises(TypeError):
+            xraylib_np.Compound(None)
+
+    def test_CP(self):
+        E = np.linspace(1.0, 50.0, 20)
+        theta = np.linspace(0.1, np.pi, 5)
+        phi = np.linspace(0.0, np.pi, 3)
+        for compound in ("SiO2", "Ca5(PO4)3F", "Water, Liquid"):
+            c = xraylib_np.Compound(compound)
+            for function in ("CS_Total_CP", "CSb_Photo_CP", "CS_Energy_CP"):
+                expected = [getattr(xraylib, function)(compound, e) for e in E]
+                np.testing.assert_allclose(getattr(xraylib_np, function)(compound, E), expected, rtol=1E-12)
+                np.testing.assert_allclose(getattr(xraylib_np, function)(c, E), expected, rtol=1E-12)
+            for function in ("DCS_Rayl_CP", "DCSb_Compt_CP"):
+                expected = [[getattr(xraylib, function)(compound, e, t) for t in theta] for e in E]
+                np.testing.assert_allclose(getattr(xraylib_np, function)(c, E, theta), expected, rtol=1E-12)
+            expected = [[[xraylib.DCSP_Compt_CP(compound, e, t, p) for p in phi] for t in theta] for e in E]
+            np.testing.assert_allclose(xraylib_np.DCSP_Compt_CP(c, E, theta, phi), expected, rtol=1E-12)
+        # failing energies give 0
+        np.testing.assert_array_equal(xraylib_np.CS_Total_CP("SiO2", np.array([0.0, -1.0])), [0.0, 0.0])
+
+    def test_refractive_index(self):
+        for compound, density in (("H2O", 1.0), ("SiO2", 2.65), ("Water, Liquid", 0.0), ("Water, Liquid", 1.2)):
+            for c in (compound, xraylib_np.Compound(compound)):
+                re = xraylib_np.Refractive_Index_Re(c, self.E, density)
+                im = xraylib_np.Refractive_Index_Im(c, self.E, density)
+                z = xraylib_np.Refractive_Index(c, self.E, density)
+                self.assertEqual(re.shape, self.E.shape)
+                self.assertEqual(z.dtype, np.complex128)
+                np.testing.assert_allclose(re, [_scalar(xraylib.Refractive_Index_Re, compound, e, density) for e in self.E], rtol=1E-12)
+                np.testing.assert_allclose(im, [_scalar(xraylib.Refractive_Index_Im, compound, e, density) for e in self.E], rtol=1E-12)
+                np.testing.assert_allclose(z, [_scalar(xraylib.Refractive_Index, compound, e, density) for e in self.E], rtol=1E-12)
+                self.assertEqual(re[300], 0.0)
+                self.assertEqual(z[301], 0.0)
+        self.assertEqual(xraylib_np.Refractive_Index_Re("H2O", np.empty(0), 1.0).shape, (0,))
+        with self.assertRaises(ValueError):
+            xraylib_np.Refractive_Index_Re("H2O", self.E, 0.0)
+        with self.assertRaises(ValueError):
+            xraylib_np.Refractive_Index("SiO2", self.E, -1.0)
+        with self.assertRaises(ValueError):
+            xraylib_np.Refractive_Index_Im("H2O)", self.E, 1.0)
+
+    def test_crystal(self):
+        E = np.array([8.0, 8.04778, 10.0, 0.0, 17.4, 30.0])
+        miller = np.array([[1, 1, 1], [2, 2, 0], [0, 0, 0], [-1, -1, -1], [4, 0, 0]])
+        cs = xraylib.Crystal_GetCrystal("Si")
+        F_H = xraylib_np.Crystal_F_H_StructureFactor("Si", E, miller, 1.0, 1.0)
+        self.assertEqual(F_H.shape, (len(E), len(miller)))
+        self.assertEqual(F_H.dtype, np.complex128)
+        self.assertTrue(F_H.flags.c_contiguous)
+        expected = [[_scalar(xraylib.Crystal_F_H_StructureFactor, cs, e, h, k, l, 1.0, 1.0) for h, k, l in miller] for e in E]
+        np.testing.assert_allclose(F_H, expected, rtol=1E-9)
+        np.testing.assert_array_equal(F_H[3], 0.0)
+        F_H = xraylib_np.Crystal_F_H_StructureFactor_Partial("Si", E, miller, 1.0, 1.0, 2, 0, 2)
+        expected = [[_scalar(xraylib.Crystal_F_H_StructureFactor_Partial, cs, e, h, k, l, 1.0, 1.0, 2, 0, 2) for h, k, l in miller] for e in E]
+        np.testing.assert_allclose(F_H, expected, rtol=1E-9)
+        self.assertEqual(xraylib_np.Crystal_F_H_StructureFactor("Si", E, np.empty((0, 3)), 1.0, 1.0).shape, (len(E), 0))
+        with self.assertRaises(ValueError):
+            xraylib_np.Crystal_F_H_StructureFactor("non-existent-crystal", E, miller, 1.0, 1.0)
+        with self.assertRaises(ValueError):
+            xraylib_np.Crystal_F_H_StructureFactor("Si", E, [1, 1, 1], 1.0, 1.0)
+
+@unittest.skipIf(xraylib_np is None, "xraylib_np is not available")
+class TestNumpyUfuncs(unittest.TestCase):
+    def test_broadcasting(self):
+        Z = np.arange(1, 95).reshape(-1, 1)
+        E = np.linspace(1.0, 100.0, 60)
+        rv = xraylib_np.ufuncs.CS_Total(Z, E)
+        self.assertEqual(rv.shape, (94, 60))
+        self.assertEqual(rv.dtype, np.float64)
+        np.testing.assert_array_equal(rv, [[xraylib.CS_Total(int(z), e) for e in E] for z in Z[:, 0]])
+        # pairs of the same length, more than one chunk of the ufunc loop
+        Z = np.random.default_rng(0).integers(1, 95, 10000)
+        E = np.random.default_rng(1).uniform(1.0, 100.0, 10000)
+        rv = xraylib_np.ufuncs.CS_Total(Z, E)
+        self.assertEqual(rv.shape, (10000,))
+        for i in range(0, 10000, 97):
+            self.assertEqual(rv[i], xraylib.CS_Total(int(Z[i]), E[i]))
+        # strided arguments
+        np.testing.assert_array_equal(xraylib_np.ufuncs.CS_Total(Z[::2], E[::-2]), xraylib_np.ufuncs.CS_Total(Z[::2].copy(), E[::-2].copy()))
+        # scalars
+        self.assertEqual(xraylib_np.ufuncs.LineEnergy(26, xraylib.KL3_LINE), xraylib.LineEnergy(26, xraylib.KL3_LINE))
+        # four arguments
+        Z, E, theta, phi = np.ix_([26, 82], [10.0, 20.0, 30.0], [0.5, 1.0], [0.0, 1.0])
+        rv = xraylib_np.ufuncs.DCSP_Rayl(Z, E, theta, phi)
+        self.assertEqual(rv.shape, (2, 3, 2, 2))
+        self.assertEqual(rv[1, 2, 0, 1], xraylib.DCSP_Rayl(82, 30.0, 0.5, 1.0))
+
+    def test_outer(self):
+        Z = np.array([26, 29, 82])
+        lines = np.array([xraylib.KL3_LINE, xraylib.KL2_LINE, xraylib.L3M5_LINE])
+        rv = xraylib_np.ufuncs.LineEnergy.outer(Z, lines)
+        self.assertEqual(rv.shape, (3, 3))
+        np.testing.assert_array_equal(rv, [[_scalar(xraylib.LineEnergy, int(z), int(line)) for line in lines] for z in Z])
+        E = np.linspace(1.0, 100.0, 10)
+        np.testing.assert_array_equal(xraylib_np.ufuncs.CS_Total.outer(Z, E), xraylib_np.CS_Total(Z, E))
+
+    def test_failures(self):
+        # errors and out of range integers give 0
+        rv = xraylib_np.ufuncs.CS_Total(np.array([26, 0, 26, 2**40, -2**40]), np.array([10.0, 10.0, -1.0, 10.0, 10.0]))
+        np.testing.assert_array_equal(rv, [xraylib.CS_Total(26, 10.0), 0.0, 0.0, 0.0, 0.0])
+
+    def test_out_where(self):
+        Z = np.arange(10, 20)
+        E = np.full(10, 20.0)
+        out = np.full(10, -1.0)
+        rv = xraylib_np.ufuncs.CS_Photo(Z, E, out=out)
+        self.assertIs(rv, out)
+        np.testing.assert_array_equal(out, [xraylib.CS_Photo(int(z), 20.0) for z in Z])
+        out[:] = -1.0
+        where = Z % 2 == 0
+        xraylib_np.ufuncs.CS_Photo(Z, E, out=out, where=where)
+        np.testing.assert_array_equal(out[where], [xraylib.CS_Photo(int(z), 20.0) for z in Z[where]])
+        np.testing.assert_array_equal(out[~where], -1.0)
+
+    def test_float32(self):
+        Z = np.arange(10, 20)
+        E = np.linspace(5.0, 50.0, 10, dtype=np.float32)
+        rv = xraylib_np.ufuncs.CS_Total(Z, E)
+        self.assertEqual(rv.dtype, np.float32)
+        np.testing.assert_allclose(rv, [xraylib.CS_Total(int(z), float(e)) for z, e in zip(Z, E)], rtol=1E-6)
+        out = np.empty(10, dtype=np.float32)
+        self.assertIs(xraylib_np.ufuncs.CS_Total(Z, E, out=out), out)
+        np.testing.assert_array_equal(out, rv)
+        # the integer functions have no float32 loop
+        self.assertEqual(xraylib_np.ufuncs.LineEnergy(np.int32(26), np.int16(xraylib.KL3_LINE)).dtype, np.float64)
+
+@unittest.skipIf(xraylib_np is None, "xraylib_np is not available")
+class TestNumpyTables(unittest.TestCase):
+    # from xraylib-defs.h, which the SWIG module does not export
+    ZMAX = 120
+    LINENUM = 383
+    SHELLNUM_K = 31
+
+    def assertReadOnly(self, table):
+        self.assertFalse(table.flags.writeable)
+        with self.assertRaises(ValueError):
+            table[...] = 0.0
+        with self.assertRaises(ValueError):
+            table.flags.writeable = True
+
+    def test_fixed(self):
+        table = xraylib_np.table_fixed("AtomicWeight_arr")
+        self.assertEqual(table.shape, (self.ZMAX + 1, 1))
+        self.assertEqual(table.dtype, np.float64)
+        self.assertReadOnly(table)
+        self.assertEqual(table[26, 0], xraylib.AtomicWeight(26))
+
+        table = xraylib_np.table_fixed("RadRate_arr")
+        self.assertEqual(table.shape, (self.ZMAX + 1, self.LINENUM))
+        self.assertReadOnly(table)
+        self.assertEqual(table[26, -xraylib.KL3_LINE - 1], xraylib.RadRate(26, xraylib.KL3_LINE))
+        self.assertEqual(table[82, -xraylib.L3M5_LINE - 1], xraylib.RadRate(82, xraylib.L3M5_LINE))
+        # no copies: both views share the memory of the library
+        self.assertEqual(table.__array_interface__['data'][0], xraylib_np.table_fixed("RadRate_arr").__array_interface__['data'][0])
+
+    def test_element(self):
+        energies = xraylib_np.table_element("E_Photo_arr", 26)
+        table = xraylib_np.table_element("CS_Photo_arr", 26)
+        self.assertEqual(table.ndim, 1)
+        self.assertGreater(len(table), 0)
+        self.assertEqual(table.shape, energies.shape)
+        self.assertReadOnly(table)
+        for i in range(0, len(table), 10):
+            self.assertAlmostEqual(np.exp(table[i]) / xraylib.CS_Photo(26, np.exp(energies[i]) / 1000.0), 1.0, places=6)
+
+        q = xraylib_np.table_element("q_Rayl_arr", 82)
+        table = xraylib_np.table_element("FF_Rayl_arr", 82)
+        self.assertEqual(table.shape, q.shape)
+        for i in range(1, len(table), 10):
+            self.assertAlmostEqual(table[i] / xraylib.FF_Rayl(82, q[i]), 1.0, places=6)
+
+    def test_element_shell(self):
+        energies = xraylib_np.table_element_shell("E_Photo_Partial_Kissel", 26, xraylib.K_SHELL)
+        table = xraylib_np.table_element_shell("Photo_Partial_Kissel", 26, xraylib.K_SHELL)
+        self.assertGreater(len(table), 0)
+        self.assertEqual(table.shape, energies.shape)
+        self.assertReadOnly(table)
+        # the Kissel energies start below the edge
+        for i in range(0, len(table), 10):
+            if np.exp(energies[i]) > xraylib.EdgeEnergy(26, xraylib.K_SHELL):
+                self.assertAlmostEqual(np.exp(table[i]) / xraylib.CSb_Photo_Partial(26, xraylib.K_SHELL, np.exp(energies[i])), 1.0, places=6)
+
+        # no data
+        for name in ("Photo_Partial_Kissel", "Partial_ComptonProfiles"):
+            table = xraylib_np.table_element_shell(name, 1, xraylib.M5_SHELL)
+            self.assertEqual(table.shape, (0,))
+            self.assertFalse(table.flags.writeable)
+        self.assertGreater(len(xraylib_np.table_element_shell("Partial_ComptonProfiles", 26, xraylib.K_SHELL)), 0)
+
+    def test_errors(self):
+        with self.assertRaises(ValueError):
+            xraylib_np.table_fixed("NE_Photo")
+        with self.assertRaises(ValueError):
+            xraylib_np.table_fixed("E_Photo_arr")
+        with self.assertRaises(ValueError):
+            xraylib_np.table_element("E_Photo_Partial_Kissel", 26)
+        for Z in (0, -1, self.ZMAX + 1):
+            with self.assertRaises(ValueError):
+                xraylib_np.table_element("E_Photo_arr", Z)
+        for shell in (-1, self.SHELLNUM_K):
+            with self.assertRaises(ValueError):
+                xraylib_np.table_element_shell("Photo_Partial_Kissel", 26, shell)
+        with self.assertRaises(ValueError):
+            xraylib_np.table_element_shell("Photo_Partial_Kissel", self.ZMAX + 1, xraylib.K_SHELL)
+
 if __name__ == '__main__':
     unittest.main(verbosity=2)
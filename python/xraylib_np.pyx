@@ -2514,3 +2514,587 @@ ElectronConfig = XRL_2II(_ElectronConfig)
 AtomicLevelWidth = XRL_2II(_AtomicLevelWidth)
 AugerRate = XRL_2II(_AugerRate)
 AugerYield = XRL_2II(_AugerYield)
+
+
+from libc.stdlib cimport malloc, free
+
+cdef class Compound:
+    """
+    A chemical formula or a NIST compound, resolved once.
+
+    The compound functions accept either a string, which they resolve on every call,
+    or a Compound, which is resolved only when it is created.
+    """
+    cdef xrl.compoundData *_cd
+    cdef xrl.compoundDataNIST *_cdn
+    cdef int _nElements
+    cdef int *_Elements
+    cdef double *_massFractions
+    cdef readonly str name
+
+    def __cinit__(self, str compound not None):
+        cdef bytes _compound = compound.encode('utf-8')
+        self.name = compound
+        self._cd = xrl.CompoundParser(_compound, NULL)
+        if self._cd != NULL:
+            self._nElements = self._cd.nElements
+            self._Elements = self._cd.Elements
+            self._massFractions = self._cd.massFractions
+            return
+        self._cdn = xrl.GetCompoundDataNISTByName(_compound, NULL)
+        if self._cdn != NULL:
+            self._nElements = self._cdn.nElements
+            self._Elements = self._cdn.Elements
+            self._massFractions = self._cdn.massFractions
+            return
+        raise ValueError("Compound is not a valid chemical formula and is not present in the NIST compound database")
+
+    def __dealloc__(self):
+        if self._cd != NULL:
+            xrl.FreeCompoundData(self._cd)
+        if self._cdn != NULL:
+            xrl.FreeCompoundDataNIST(self._cdn)
+
+    @property
+    def elements(self):
+        return np.array(<int[:self._nElements]> self._Elements)
+
+    @property
+    def mass_fractions(self):
+        return np.array(<double[:self._nElements]> self._massFractions)
+
+    @property
+    def density(self):
+        """The density of a NIST compound (g/cm3), or None for a chemical formula."""
+        return self._cdn.density if self._cdn != NULL else None
+
+    def __repr__(self):
+        return "Compound({!r})".format(self.name)
+
+cdef Compound _compound(compound):
+    if isinstance(compound, Compound):
+        return compound
+    return Compound(compound)
+
+# the C functions of one element, summed over the elements of a compound exactly as the _CP functions do
+ctypedef double (*_xrl_1F)(int, double, xrl.xrl_error **) noexcept nogil
+ctypedef double (*_xrl_2F)(int, double, double, xrl.xrl_error **) noexcept nogil
+ctypedef double (*_xrl_3F)(int, double, double, double, xrl.xrl_error **) noexcept nogil
+
+cdef double _CP_1F(_xrl_1F fun, int n, const int *Z, const double *w, double E) noexcept nogil:
+    cdef int i
+    cdef double tmp, rv = 0.0
+    for i in range(n):
+        tmp = fun(Z[i], E, NULL) * w[i]
+        if tmp == 0.0:
+            return 0.0
+        rv += tmp
+    return rv
+
+cdef double _CP_2F(_xrl_2F fun, int n, const int *Z, const double *w, double E, double theta) noexcept nogil:
+    cdef int i
+    cdef double tmp, rv = 0.0
+    for i in range(n):
+        tmp = fun(Z[i], E, theta, NULL) * w[i]
+        if tmp == 0.0:
+            return 0.0
+        rv += tmp
+    return rv
+
+cdef double _CP_3F(_xrl_3F fun, int n, const int *Z, const double *w, double E, double theta, double phi) noexcept nogil:
+    cdef int i
+    cdef double tmp, rv = 0.0
+    for i in range(n):
+        tmp = fun(Z[i], E, theta, phi, NULL) * w[i]
+        if tmp == 0.0:
+            return 0.0
+        rv += tmp
+    return rv
+
+cdef np.ndarray _CP_1(_xrl_1F fun, compound, np.ndarray[double, ndim=1] arg1):
+    cdef Compound c = _compound(compound)
+    cdef int n = c._nElements
+    cdef const int *Z = c._Elements
+    cdef const double *w = c._massFractions
+    cdef int i
+    cdef int i_max = arg1.shape[0]
+    cdef np.ndarray[double, ndim=1, mode='c'] rv = np.empty((i_max))
+    for i in prange(i_max, nogil=True):
+        rv[i] = _CP_1F(fun, n, Z, w, arg1[i])
+    return rv
+
+cdef np.ndarray _CP_2(_xrl_2F fun, compound, np.ndarray[double, ndim=1] arg1, np.ndarray[double, ndim=1] arg2):
+    cdef Compound c = _compound(compound)
+    cdef int n = c._nElements
+    cdef const int *Z = c._Elements
+    cdef const double *w = c._massFractions
+    cdef int i, j
+    cdef int ij
+    cdef int i_max = arg1.shape[0], j_max = arg2.shape[0]
+    cdef np.ndarray[double, ndim=2, mode='c'] rv = np.empty((i_max, j_max))
+    for ij in prange(i_max * j_max, nogil=True):
+        j = ij % j_max
+        i = ij // j_max
+        rv[i,j] = _CP_2F(fun, n, Z, w, arg1[i], arg2[j])
+    return rv
+
+cdef np.ndarray _CP_3(_xrl_3F fun, compound, np.ndarray[double, ndim=1] arg1, np.ndarray[double, ndim=1] arg2, np.ndarray[double, ndim=1] arg3):
+    cdef Compound c = _compound(compound)
+    cdef int n = c._nElements
+    cdef const int *Z = c._Elements
+    cdef const double *w = c._massFractions
+    cdef int i, j, k
+    cdef int ijk
+    cdef int i_max = arg1.shape[0], j_max = arg2.shape[0], k_max = arg3.shape[0]
+    cdef np.ndarray[double, ndim=3, mode='c'] rv = np.empty((i_max, j_max, k_max))
+    for ijk in prange(i_max * j_max * k_max, nogil=True):
+        k = ijk % k_max
+        j = ijk // k_max % j_max
+        i = ijk // k_max // j_max
+        rv[i,j,k] = _CP_3F(fun, n, Z, w, arg1[i], arg2[j], arg3[k])
+    return rv
+
+def CS_Total_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CS_Total, compound, arg1)
+def CS_Photo_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CS_Photo, compound, arg1)
+def CS_Rayl_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CS_Rayl, compound, arg1)
+def CS_Compt_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CS_Compt, compound, arg1)
+def CS_Energy_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CS_Energy, compound, arg1)
+def CSb_Total_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CSb_Total, compound, arg1)
+def CSb_Photo_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CSb_Photo, compound, arg1)
+def CSb_Rayl_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CSb_Rayl, compound, arg1)
+def CSb_Compt_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CSb_Compt, compound, arg1)
+def CS_Photo_Total_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CS_Photo_Total, compound, arg1)
+def CSb_Photo_Total_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CSb_Photo_Total, compound, arg1)
+def CS_Total_Kissel_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CS_Total_Kissel, compound, arg1)
+def CSb_Total_Kissel_CP(compound, np.ndarray[double, ndim=1] arg1 not None):
+    return _CP_1(xrl.CSb_Total_Kissel, compound, arg1)
+def DCS_Rayl_CP(compound, np.ndarray[double, ndim=1] arg1 not None, np.ndarray[double, ndim=1] arg2 not None):
+    return _CP_2(xrl.DCS_Rayl, compound, arg1, arg2)
+def DCS_Compt_CP(compound, np.ndarray[double, ndim=1] arg1 not None, np.ndarray[double, ndim=1] arg2 not None):
+    return _CP_2(xrl.DCS_Compt, compound, arg1, arg2)
+def DCSb_Rayl_CP(compound, np.ndarray[double, ndim=1] arg1 not None, np.ndarray[double, ndim=1] arg2 not None):
+    return _CP_2(xrl.DCSb_Rayl, compound, arg1, arg2)
+def DCSb_Compt_CP(compound, np.ndarray[double, ndim=1] arg1 not None, np.ndarray[double, ndim=1] arg2 not None):
+    return _CP_2(xrl.DCSb_Compt, compound, arg1, arg2)
+def DCSP_Rayl_CP(compound, np.ndarray[double, ndim=1] arg1 not None, np.ndarray[double, ndim=1] arg2 not None, np.ndarray[double, ndim=1] arg3 not None):
+    return _CP_3(xrl.DCSP_Rayl, compound, arg1, arg2, arg3)
+def DCSP_Compt_CP(compound, np.ndarray[double, ndim=1] arg1 not None, np.ndarray[double, ndim=1] arg2 not None, np.ndarray[double, ndim=1] arg3 not None):
+    return _CP_3(xrl.DCSP_Compt, compound, arg1, arg2, arg3)
+def DCSPb_Rayl_CP(compound, np.ndarray[double, ndim=1] arg1 not None, np.ndarray[double, ndim=1] arg2 not None, np.ndarray[double, ndim=1] arg3 not None):
+    return _CP_3(xrl.DCSPb_Rayl, compound, arg1, arg2, arg3)
+def DCSPb_Compt_CP(compound, np.ndarray[double, ndim=1] arg1 not None, np.ndarray[double, ndim=1] arg2 not None, np.ndarray[double, ndim=1] arg3 not None):
+    return _CP_3(xrl.DCSPb_Compt, compound, arg1, arg2, arg3)
+
+# refractive indices, from the optical constants of Refractive_Index_Batch
+cdef double _refractive_density(Compound c, double density) except -1.0:
+    if density <= 0.0 and c._cdn != NULL:
+        density = c._cdn.density
+    if density <= 0.0:
+        raise ValueError("Density must be strictly positive")
+    return density
+
+# the energies are split in blocks of _REFRACTIVE_BLOCK, one batch each
+cdef enum:
+    _REFRACTIVE_BLOCK = 256
+
+cdef enum:
+    _REFRACTIVE_RE
+    _REFRACTIVE_IM
+    _REFRACTIVE_COMPLEX
+
+# the batch stops at the first failed energy, and needs both parts where Refractive_Index_Re and Refractive_Index_Im need one:
+# after a failure, the block is filled from the scalar C function instead
+cdef void _Refractive_Index_block(const char *compound, const double *E, int n_E, double density, int kind, xrl.xrlOpticalConstants *constants) noexcept nogil:
+    cdef int i
+    cdef xrl.xrlComplex z
+    if xrl.Refractive_Index_Batch(compound, E, n_E, density, 0.0, constants, NULL):
+        return
+    for i in range(n_E):
+        if kind == _REFRACTIVE_RE:
+            constants[i].delta = 1.0 - xrl.Refractive_Index_Re(compound, E[i], density, NULL)
+        elif kind == _REFRACTIVE_IM:
+            constants[i].beta = xrl.Refractive_Index_Im(compound, E[i], density, NULL)
+        else:
+            z = xrl.Refractive_Index(compound, E[i], density, NULL)
+            constants[i].delta = 1.0 - z.re
+            constants[i].beta = z.im
+
+cdef np.ndarray _Refractive_Index_constants(compound, np.ndarray[double, ndim=1] arg1, double density, int kind):
+    cdef Compound c = _compound(compound)
+    cdef double _density = _refractive_density(c, density)
+    cdef bytes _name = c.name.encode('utf-8')
+    cdef const char *name = _name
+    cdef double[::1] E = np.ascontiguousarray(arg1)
+    cdef int k
+    cdef int i_max = E.shape[0]
+    cdef int k_max = (i_max + _REFRACTIVE_BLOCK - 1) // _REFRACTIVE_BLOCK
+    rv = np.zeros((i_max, sizeof(xrl.xrlOpticalConstants) // sizeof(double)))
+    cdef double[:, ::1] _rv = rv
+    for k in prange(k_max, nogil=True):
+        _Refractive_Index_block(name, &E[k * _REFRACTIVE_BLOCK], min(_REFRACTIVE_BLOCK, i_max - k * _REFRACTIVE_BLOCK), _density, kind, <xrl.xrlOpticalConstants *> &_rv[k * _REFRACTIVE_BLOCK, 0])
+    return rv
+
+def Refractive_Index_Re(compound, np.ndarray[double, ndim=1] arg1 not None, double density):
+    return 1.0 - _Refractive_Index_constants(compound, arg1, density, _REFRACTIVE_RE)[:, 0]
+
+def Refractive_Index_Im(compound, np.ndarray[double, ndim=1] arg1 not None, double density):
+    return np.ascontiguousarray(_Refractive_Index_constants(compound, arg1, density, _REFRACTIVE_IM)[:, 1])
+
+def Refractive_Index(compound, np.ndarray[double, ndim=1] arg1 not None, double density):
+    constants = _Refractive_Index_constants(compound, arg1, density, _REFRACTIVE_COMPLEX)
+    rv = np.empty((arg1.shape[0]), dtype=np.complex128)
+    rv.real = 1.0 - constants[:, 0]
+    rv.imag = constants[:, 1]
+    return rv
+
+# crystal structure factors: energies × reflections, with the Miller indices as an (n, 3) array
+cdef xrl.Crystal_Struct *_crystal(str crystal) except NULL:
+    cdef xrl.xrl_error *error = NULL
+    cdef xrl.Crystal_Struct *rv = xrl.Crystal_GetCrystalShared(crystal.encode('utf-8'), &error)
+    if rv == NULL:
+        message = error.message.decode('utf-8')
+        xrl.xrl_error_free(error)
+        raise ValueError(message)
+    return rv
+
+cdef np.ndarray _miller(miller):
+    rv = np.ascontiguousarray(miller, dtype=np.intc)
+    if rv.ndim != 2 or rv.shape[1] != 3:
+        raise ValueError("Miller indices must be an array of shape (n, 3)")
+    return rv
+
+# one reflection at all energies, prepared once, into a contiguous block of F_H
+cdef void _F_H_reflection(xrl.Crystal_Struct *crystal, const int *hkl, double debye_factor, double rel_angle, const double *E, int n_E, xrl.xrlComplex *F_H) noexcept nogil:
+    cdef int i
+    cdef xrl.Crystal_Reflection *reflection = xrl.Crystal_Reflection_New(crystal, hkl[0], hkl[1], hkl[2], debye_factor, rel_angle, NULL)
+    if reflection == NULL:
+        return
+    if not xrl.Crystal_Reflection_F_H_Batch(reflection, E, n_E, F_H, NULL):
+        # the batch stops at the first failed energy
+        for i in range(n_E):
+            F_H[i] = xrl.Crystal_Reflection_F_H(reflection, E[i], NULL)
+    xrl.Crystal_Reflection_Free(reflection)
+
+def Crystal_F_H_StructureFactor(str crystal not None, np.ndarray[double, ndim=1] arg1 not None, miller not None, double debye_factor, double rel_angle):
+    cdef xrl.Crystal_Struct *cs = _crystal(crystal)
+    cdef int[:, ::1] hkl = _miller(miller)
+    cdef double[::1] E = np.ascontiguousarray(arg1)
+    cdef int j
+    cdef int i_max = E.shape[0], j_max = hkl.shape[0]
+    # reflections × energies, transposed at the end
+    rv = np.zeros((j_max, i_max), dtype=np.complex128)
+    cdef double[:, :, ::1] _rv = rv.view(np.float64).reshape((j_max, i_max, 2))
+    if i_max == 0 or j_max == 0:
+        return rv.T.copy()
+    for j in prange(j_max, nogil=True):
+        _F_H_reflection(cs, &hkl[j, 0], debye_factor, rel_angle, &E[0], i_max, <xrl.xrlComplex *> &_rv[j, 0, 0])
+    return rv.T.copy()
+
+def Crystal_F_H_StructureFactor_Partial(str crystal not None, np.ndarray[double, ndim=1] arg1 not None, miller not None, double debye_factor, double rel_angle, int f0_flag, int f_prime_flag, int f_prime2_flag):
+    cdef xrl.Crystal_Struct *cs = _crystal(crystal)
+    cdef int[:, ::1] hkl = _miller(miller)
+    cdef int i, j
+    cdef int i_max = arg1.shape[0], j_max = hkl.shape[0]
+    cdef xrl.xrlComplex z
+    rv = np.zeros((i_max, j_max), dtype=np.complex128)
+    cdef double[:, :, ::1] _rv = rv.view(np.float64).reshape((i_max, j_max, 2))
+    if i_max == 0 or j_max == 0:
+        return rv
+    for i in prange(i_max, nogil=True):
+        if not xrl.Crystal_F_H_StructureFactor_Partial_Batch(cs, arg1[i], &hkl[0, 0], j_max, debye_factor, rel_angle, f0_flag, f_prime_flag, f_prime2_flag, <xrl.xrlComplex *> &_rv[i, 0, 0], NULL):
+            # the batch stops at the first failed reflection
+            for j in range(j_max):
+                z = xrl.Crystal_F_H_StructureFactor_Partial(cs, arg1[i], hkl[j, 0], hkl[j, 1], hkl[j, 2], debye_factor, rel_angle, f0_flag, f_prime_flag, f_prime2_flag, NULL)
+                _rv[i, j, 0] = z.re
+                _rv[i, j, 1] = z.im
+    return rv
+
+
+# numpy ufuncs: broadcasting, out=, where= and float32, instead of the outer products of the functions above.
+# Those are recovered with .outer for two arguments, and by broadcasting np.ix_(...) otherwise.
+import types
+from libc.limits cimport INT_MAX, INT_MIN
+from libc.string cimport strdup
+
+np.import_ufunc()
+
+# the argument lists of the C functions: I for int, R for double
+cdef enum:
+    _K_I
+    _K_II
+    _K_R
+    _K_RR
+    _K_IR
+    _K_IRR
+    _K_RRR
+    _K_IIR
+    _K_IRRR
+
+ctypedef double (*_xrl_I)(int, xrl.xrl_error **) noexcept nogil
+ctypedef double (*_xrl_II)(int, int, xrl.xrl_error **) noexcept nogil
+ctypedef double (*_xrl_R)(double, xrl.xrl_error **) noexcept nogil
+ctypedef double (*_xrl_RR)(double, double, xrl.xrl_error **) noexcept nogil
+ctypedef double (*_xrl_IR)(int, double, xrl.xrl_error **) noexcept nogil
+ctypedef double (*_xrl_IRR)(int, double, double, xrl.xrl_error **) noexcept nogil
+ctypedef double (*_xrl_RRR)(double, double, double, xrl.xrl_error **) noexcept nogil
+ctypedef double (*_xrl_IIR)(int, int, double, xrl.xrl_error **) noexcept nogil
+ctypedef double (*_xrl_IRRR)(int, double, double, double, xrl.xrl_error **) noexcept nogil
+
+ctypedef struct _ufunc_spec:
+    int kind
+    void *function
+
+ctypedef fused _real:
+    float
+    double
+
+# every thread gets whole chunks, so threads only share the cache lines at the borders of the chunks
+cdef np.npy_intp _UFUNC_CHUNK = 4096
+
+# out of range integers become invalid arguments, instead of wrapping around to valid ones
+cdef inline int _ufunc_int(char **args, np.npy_intp *steps, int k, np.npy_intp i) noexcept nogil:
+    cdef np.int64_t v = (<np.int64_t *> (args[k] + i * steps[k]))[0]
+    if v > INT_MAX:
+        return INT_MAX
+    if v < INT_MIN:
+        return INT_MIN
+    return <int> v
+
+cdef inline double _ufunc_real(char **args, np.npy_intp *steps, int k, np.npy_intp i, _real *tag) noexcept nogil:
+    return (<_real *> (args[k] + i * steps[k]))[0]
+
+cdef void _ufunc_range(char **args, np.npy_intp *steps, _ufunc_spec *spec, np.npy_intp first, np.npy_intp last, _real *tag) noexcept nogil:
+    cdef np.npy_intp i
+    cdef double rv
+    cdef int k = spec.kind
+    cdef int nin = 1 if k == _K_I or k == _K_R else 2 if k == _K_II or k == _K_RR or k == _K_IR else 3 if k != _K_IRRR else 4
+    for i in range(first, last):
+        if k == _K_I:
+            rv = (<_xrl_I> spec.function)(_ufunc_int(args, steps, 0, i), NULL)
+        elif k == _K_II:
+            rv = (<_xrl_II> spec.function)(_ufunc_int(args, steps, 0, i), _ufunc_int(args, steps, 1, i), NULL)
+        elif k == _K_R:
+            rv = (<_xrl_R> spec.function)(_ufunc_real(args, steps, 0, i, tag), NULL)
+        elif k == _K_RR:
+            rv = (<_xrl_RR> spec.function)(_ufunc_real(args, steps, 0, i, tag), _ufunc_real(args, steps, 1, i, tag), NULL)
+        elif k == _K_IR:
+            rv = (<_xrl_IR> spec.function)(_ufunc_int(args, steps, 0, i), _ufunc_real(args, steps, 1, i, tag), NULL)
+        elif k == _K_IRR:
+            rv = (<_xrl_IRR> spec.function)(_ufunc_int(args, steps, 0, i), _ufunc_real(args, steps, 1, i, tag),
+                _ufunc_real(args, steps, 2, i, tag), NULL)
+        elif k == _K_RRR:
+            rv = (<_xrl_RRR> spec.function)(_ufunc_real(args, steps, 0, i, tag), _ufunc_real(args, steps, 1, i, tag),
+                _ufunc_real(args, steps, 2, i, tag), NULL)
+        elif k == _K_IIR:
+            rv = (<_xrl_IIR> spec.function)(_ufunc_int(args, steps, 0, i), _ufunc_int(args, steps, 1, i),
+                _ufunc_real(args, steps, 2, i, tag), NULL)
+        else:
+            rv = (<_xrl_IRRR> spec.function)(_ufunc_int(args, steps, 0, i), _ufunc_real(args, steps, 1, i, tag),
+                _ufunc_real(args, steps, 2, i, tag), _ufunc_real(args, steps, 3, i, tag), NULL)
+        (<_real *> (args[nin] + i * steps[nin]))[0] = <_real> rv
+
+cdef void _ufunc_loop(char **args, np.npy_intp *dimensions, np.npy_intp *steps, void *data, _real *tag) noexcept nogil:
+    cdef np.npy_intp c, n = dimensions[0]
+    cdef np.npy_intp n_chunks = (n + _UFUNC_CHUNK - 1) // _UFUNC_CHUNK
+    if n_chunks <= 1:
+        _ufunc_range(args, steps, <_ufunc_spec *> data, 0, n, tag)
+        return
+    for c in prange(n_chunks, schedule='static'):
+        _ufunc_range(args, steps, <_ufunc_spec *> data, c * _UFUNC_CHUNK, min((c + 1) * _UFUNC_CHUNK, n), tag)
+
+cdef void _ufunc_loop_float(char **args, np.npy_intp *dimensions, np.npy_intp *steps, void *data) noexcept nogil:
+    _ufunc_loop(args, dimensions, steps, data, <float *> NULL)
+
+cdef void _ufunc_loop_double(char **args, np.npy_intp *dimensions, np.npy_intp *steps, void *data) noexcept nogil:
+    _ufunc_loop(args, dimensions, steps, data, <double *> NULL)
+
+# numpy keeps pointers to all of these for the lifetime of the ufunc, which is that of the module
+cdef object _ufunc(str name, int kind, void *function):
+    cdef str layout = ['I', 'II', 'R', 'RR', 'IR', 'IRR', 'RRR', 'IIR', 'IRRR'][kind]
+    cdef int nin = len(layout)
+    # the single precision loop comes first, so numpy only picks it for float32 arguments
+    cdef int ntypes = 1 if 'R' not in layout else 2
+    cdef _ufunc_spec *spec = <_ufunc_spec *> malloc(sizeof(_ufunc_spec))
+    cdef np.PyUFuncGenericFunction *loops = <np.PyUFuncGenericFunction *> malloc(ntypes * sizeof(np.PyUFuncGenericFunction))
+    cdef void **data = <void **> malloc(ntypes * sizeof(void *))
+    cdef char *types = <char *> malloc(ntypes * (nin + 1))
+    cdef int t, k
+    if spec == NULL or loops == NULL or data == NULL or types == NULL:
+        raise MemoryError()
+    spec.kind = kind
+    spec.function = function
+    for t in range(ntypes):
+        loops[t] = <np.PyUFuncGenericFunction> (_ufunc_loop_float if t == 0 and ntypes == 2 else _ufunc_loop_double)
+        data[t] = spec
+        for k in range(nin):
+            types[t * (nin + 1) + k] = np.NPY_INT64 if layout[k] == 'I' else np.NPY_FLOAT if t == 0 and ntypes == 2 else np.NPY_DOUBLE
+        types[t * (nin + 1) + nin] = np.NPY_FLOAT if t == 0 and ntypes == 2 else np.NPY_DOUBLE
+    doc = "Broadcasting version of xraylib.{}: elements that fail are set to 0.".format(name)
+    return np.PyUFunc_FromFuncAndData(loops, data, types, ntypes, nin, 1, np.PyUFunc_None,
+        strdup(name.encode('utf-8')), strdup(doc.encode('utf-8')), 0)
+
+ufuncs = types.SimpleNamespace()
+
+cdef _add_ufunc(str name, int kind, void *function):
+    setattr(ufuncs, name, _ufunc(name, kind, function))
+
+_add_ufunc('AtomicWeight', _K_I, <void *> xrl.AtomicWeight)
+_add_ufunc('ElementDensity', _K_I, <void *> xrl.ElementDensity)
+_add_ufunc('LineEnergy', _K_II, <void *> xrl.LineEnergy)
+_add_ufunc('FluorYield', _K_II, <void *> xrl.FluorYield)
+_add_ufunc('CosKronTransProb', _K_II, <void *> xrl.CosKronTransProb)
+_add_ufunc('EdgeEnergy', _K_II, <void *> xrl.EdgeEnergy)
+_add_ufunc('JumpFactor', _K_II, <void *> xrl.JumpFactor)
+_add_ufunc('RadRate', _K_II, <void *> xrl.RadRate)
+_add_ufunc('ElectronConfig', _K_II, <void *> xrl.ElectronConfig)
+_add_ufunc('AtomicLevelWidth', _K_II, <void *> xrl.AtomicLevelWidth)
+_add_ufunc('AugerRate', _K_II, <void *> xrl.AugerRate)
+_add_ufunc('AugerYield', _K_II, <void *> xrl.AugerYield)
+_add_ufunc('CS_KN', _K_R, <void *> xrl.CS_KN)
+_add_ufunc('DCS_Thoms', _K_R, <void *> xrl.DCS_Thoms)
+_add_ufunc('DCS_KN', _K_RR, <void *> xrl.DCS_KN)
+_add_ufunc('DCSP_Thoms', _K_RR, <void *> xrl.DCSP_Thoms)
+_add_ufunc('MomentTransf', _K_RR, <void *> xrl.MomentTransf)
+_add_ufunc('ComptonEnergy', _K_RR, <void *> xrl.ComptonEnergy)
+_add_ufunc('CS_Total', _K_IR, <void *> xrl.CS_Total)
+_add_ufunc('CS_Photo', _K_IR, <void *> xrl.CS_Photo)
+_add_ufunc('CS_Rayl', _K_IR, <void *> xrl.CS_Rayl)
+_add_ufunc('CS_Compt', _K_IR, <void *> xrl.CS_Compt)
+_add_ufunc('CS_Energy', _K_IR, <void *> xrl.CS_Energy)
+_add_ufunc('CSb_Total', _K_IR, <void *> xrl.CSb_Total)
+_add_ufunc('CSb_Photo', _K_IR, <void *> xrl.CSb_Photo)
+_add_ufunc('CSb_Rayl', _K_IR, <void *> xrl.CSb_Rayl)
+_add_ufunc('CSb_Compt', _K_IR, <void *> xrl.CSb_Compt)
+_add_ufunc('CS_Photo_Total', _K_IR, <void *> xrl.CS_Photo_Total)
+_add_ufunc('CSb_Photo_Total', _K_IR, <void *> xrl.CSb_Photo_Total)
+_add_ufunc('CS_Total_Kissel', _K_IR, <void *> xrl.CS_Total_Kissel)
+_add_ufunc('CSb_Total_Kissel', _K_IR, <void *> xrl.CSb_Total_Kissel)
+_add_ufunc('FF_Rayl', _K_IR, <void *> xrl.FF_Rayl)
+_add_ufunc('SF_Compt', _K_IR, <void *> xrl.SF_Compt)
+_add_ufunc('Fi', _K_IR, <void *> xrl.Fi)
+_add_ufunc('Fii', _K_IR, <void *> xrl.Fii)
+_add_ufunc('ComptonProfile', _K_IR, <void *> xrl.ComptonProfile)
+_add_ufunc('DCS_Rayl', _K_IRR, <void *> xrl.DCS_Rayl)
+_add_ufunc('DCS_Compt', _K_IRR, <void *> xrl.DCS_Compt)
+_add_ufunc('DCSb_Rayl', _K_IRR, <void *> xrl.DCSb_Rayl)
+_add_ufunc('DCSb_Compt', _K_IRR, <void *> xrl.DCSb_Compt)
+_add_ufunc('DCSP_KN', _K_RRR, <void *> xrl.DCSP_KN)
+_add_ufunc('CS_FluorLine', _K_IIR, <void *> xrl.CS_FluorLine)
+_add_ufunc('CSb_FluorLine', _K_IIR, <void *> xrl.CSb_FluorLine)
+_add_ufunc('CS_FluorShell', _K_IIR, <void *> xrl.CS_FluorShell)
+_add_ufunc('CSb_FluorShell', _K_IIR, <void *> xrl.CSb_FluorShell)
+_add_ufunc('CS_Photo_Partial', _K_IIR, <void *> xrl.CS_Photo_Partial)
+_add_ufunc('CSb_Photo_Partial', _K_IIR, <void *> xrl.CSb_Photo_Partial)
+_add_ufunc('ComptonProfile_Partial', _K_IIR, <void *> xrl.ComptonProfile_Partial)
+_add_ufunc('CS_FluorLine_Kissel', _K_IIR, <void *> xrl.CS_FluorLine_Kissel)
+_add_ufunc('CSb_FluorLine_Kissel', _K_IIR, <void *> xrl.CSb_FluorLine_Kissel)
+_add_ufunc('CS_FluorLine_Kissel_Cascade', _K_IIR, <void *> xrl.CS_FluorLine_Kissel_Cascade)
+_add_ufunc('CSb_FluorLine_Kissel_Cascade', _K_IIR, <void *> xrl.CSb_FluorLine_Kissel_Cascade)
+_add_ufunc('CS_FluorLine_Kissel_no_Cascade', _K_IIR, <void *> xrl.CS_FluorLine_Kissel_no_Cascade)
+_add_ufunc('CSb_FluorLine_Kissel_no_Cascade', _K_IIR, <void *> xrl.CSb_FluorLine_Kissel_no_Cascade)
+_add_ufunc('CS_FluorLine_Kissel_Nonradiative_Cascade', _K_IIR, <void *> xrl.CS_FluorLine_Kissel_Nonradiative_Cascade)
+_add_ufunc('CSb_FluorLine_Kissel_Nonradiative_Cascade', _K_IIR, <void *> xrl.CSb_FluorLine_Kissel_Nonradiative_Cascade)
+_add_ufunc('CS_FluorLine_Kissel_Radiative_Cascade', _K_IIR, <void *> xrl.CS_FluorLine_Kissel_Radiative_Cascade)
+_add_ufunc('CSb_FluorLine_Kissel_Radiative_Cascade', _K_IIR, <void *> xrl.CSb_FluorLine_Kissel_Radiative_Cascade)
+_add_ufunc('CS_FluorShell_Kissel', _K_IIR, <void *> xrl.CS_FluorShell_Kissel)
+_add_ufunc('CSb_FluorShell_Kissel', _K_IIR, <void *> xrl.CSb_FluorShell_Kissel)
+_add_ufunc('CS_FluorShell_Kissel_Cascade', _K_IIR, <void *> xrl.CS_FluorShell_Kissel_Cascade)
+_add_ufunc('CSb_FluorShell_Kissel_Cascade', _K_IIR, <void *> xrl.CSb_FluorShell_Kissel_Cascade)
+_add_ufunc('CS_FluorShell_Kissel_no_Cascade', _K_IIR, <void *> xrl.CS_FluorShell_Kissel_no_Cascade)
+_add_ufunc('CSb_FluorShell_Kissel_no_Cascade', _K_IIR, <void *> xrl.CSb_FluorShell_Kissel_no_Cascade)
+_add_ufunc('CS_FluorShell_Kissel_Nonradiative_Cascade', _K_IIR, <void *> xrl.CS_FluorShell_Kissel_Nonradiative_Cascade)
+_add_ufunc('CSb_FluorShell_Kissel_Nonradiative_Cascade', _K_IIR, <void *> xrl.CSb_FluorShell_Kissel_Nonradiative_Cascade)
+_add_ufunc('CS_FluorShell_Kissel_Radiative_Cascade', _K_IIR, <void *> xrl.CS_FluorShell_Kissel_Radiative_Cascade)
+_add_ufunc('CSb_FluorShell_Kissel_Radiative_Cascade', _K_IIR, <void *> xrl.CSb_FluorShell_Kissel_Radiative_Cascade)
+_add_ufunc('DCSP_Rayl', _K_IRRR, <void *> xrl.DCSP_Rayl)
+_add_ufunc('DCSP_Compt', _K_IRRR, <void *> xrl.DCSP_Compt)
+_add_ufunc('DCSPb_Rayl', _K_IRRR, <void *> xrl.DCSPb_Rayl)
+_add_ufunc('DCSPb_Compt', _K_IRRR, <void *> xrl.DCSPb_Compt)
+
+
+# Read-only views of the tables of the library, see xraylib-tables.h.
+# The arrays share the memory of the library: they remain valid until a data image is (un)loaded.
+from cpython.buffer cimport PyBUF_WRITABLE, PyBUF_FORMAT
+
+cdef double _table_empty = 0.0
+
+cdef class _Table:
+    """Buffer over a table of the library, without copying it."""
+    cdef const double *data
+    cdef Py_ssize_t shape[2]
+    cdef Py_ssize_t strides[2]
+    cdef int ndim
+
+    def __getbuffer__(self, Py_buffer *buffer, int flags):
+        if flags & PyBUF_WRITABLE:
+            raise BufferError("xraylib tables are read-only")
+        buffer.buf = <void *> (self.data if self.data != NULL else &_table_empty)
+        buffer.obj = self
+        buffer.len = self.shape[0] * self.shape[1] * sizeof(double)
+        buffer.readonly = 1
+        buffer.itemsize = sizeof(double)
+        buffer.format = NULL
+        if flags & PyBUF_FORMAT:
+            buffer.format = 'd'
+        buffer.ndim = self.ndim
+        buffer.shape = self.shape
+        buffer.strides = self.strides
+        buffer.suboffsets = NULL
+        buffer.internal = NULL
+
+    def __releasebuffer__(self, Py_buffer *buffer):
+        pass
+
+cdef np.ndarray _table(const double *data, int rows, int columns, int ndim):
+    cdef _Table table = _Table.__new__(_Table)
+    table.data = data
+    table.ndim = ndim
+    table.shape[0] = rows
+    table.shape[1] = columns
+    table.strides[0] = columns * sizeof(double)
+    table.strides[1] = sizeof(double)
+    return np.asarray(table)
+
+cdef _table_error(xrl.xrl_error *error):
+    message = error.message.decode('utf-8')
+    xrl.xrl_error_free(error)
+    raise ValueError(message)
+
+def table_fixed(str name):
+    """A fixed size table such as RadRate_arr, as a read-only array with a row for every Z from 0 to ZMAX."""
+    cdef xrl.xrl_error *error = NULL
+    cdef const double *data
+    cdef int rows, columns
+    if not xrl.xrl_table_fixed(name.encode('utf-8'), &data, &rows, &columns, &error):
+        _table_error(error)
+    return _table(data, rows, columns, 2)
+
+def table_element(str name, int Z):
+    """The array of an element in a table such as E_Photo_arr or FF_Rayl_arr, read-only and empty without data."""
+    cdef xrl.xrl_error *error = NULL
+    cdef const double *data
+    cdef int length
+    if not xrl.xrl_table_element(name.encode('utf-8'), Z, &data, &length, &error):
+        _table_error(error)
+    return _table(data, length, 1, 1)
+
+def table_element_shell(str name, int Z, int shell):
+    """The array of an element and shell in a table such as Photo_Partial_Kissel, read-only and empty without data."""
+    cdef xrl.xrl_error *error = NULL
+    cdef const double *data
+    cdef int length
+    if not xrl.xrl_table_element_shell(name.encode('utf-8'), Z, shell, &data, &length, &error):
+        _table_error(error)
+    return _table(data, length, 1, 1)
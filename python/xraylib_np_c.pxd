@@ -25,6 +25,8 @@ cdef extern from "xraylib-error.h" nogil:
         xrl_error_code code
         char *message
 
+    void xrl_error_free(xrl_error *error)
+
 cdef extern from "xraylib.h" nogil:
     void XRayInit()
     void SetHardExit(int hard_exit)
@@ -105,6 +107,59 @@ cdef extern from "xraylib.h" nogil:
     double DCSPb_Rayl(int arg1, double arg2, double arg3, double arg4, xrl_error **error)
     double DCSPb_Compt(int arg1, double arg2, double arg3, double arg4, xrl_error **error)
 
+    ctypedef struct xrlComplex:
+        double re
+        double im
+
+    struct compoundData:
+        int nElements
+        double nAtomsAll
+        int *Elements
+        double *massFractions
+        double *nAtoms
+        double molarMass
+
+    struct compoundDataNIST:
+        char *name
+        int nElements
+        int *Elements
+        double *massFractions
+        double density
+
+    ctypedef struct xrlOpticalConstants:
+        double delta
+        double beta
+        double critical_angle
+        double attenuation_length
+        double reflectivity
+
+    double Refractive_Index_Re(const char *compound, double E, double density, xrl_error **error)
+    double Refractive_Index_Im(const char *compound, double E, double density, xrl_error **error)
+    xrlComplex Refractive_Index(const char *compound, double E, double density, xrl_error **error)
+    int Refractive_Index_Batch(const char *compound, const double *E, int nE, double density, double theta, xrlOpticalConstants *constants, xrl_error **error)
+
+    compoundData *CompoundParser(const char *compoundString, xrl_error **error)
+    void FreeCompoundData(compoundData *cd)
+    compoundDataNIST *GetCompoundDataNISTByName(const char *compoundString, xrl_error **error)
+    void FreeCompoundDataNIST(compoundDataNIST *cdn)
+
+    ctypedef struct Crystal_Struct:
+        pass
+    ctypedef struct Crystal_Reflection:
+        pass
+
+    Crystal_Struct *Crystal_GetCrystalShared(const char *material, xrl_error **error)
+    xrlComplex Crystal_F_H_StructureFactor_Partial(Crystal_Struct *crystal, double energy, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle, int f0_flag, int f_prime_flag, int f_prime2_flag, xrl_error **error)
+    int Crystal_F_H_StructureFactor_Partial_Batch(Crystal_Struct *crystal, double energy, const int *miller, int n_miller, double debye_factor, double rel_angle, int f0_flag, int f_prime_flag, int f_prime2_flag, xrlComplex *F_H, xrl_error **error)
+    Crystal_Reflection *Crystal_Reflection_New(Crystal_Struct *crystal, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle, xrl_error **error)
+    void Crystal_Reflection_Free(Crystal_Reflection *reflection)
+    xrlComplex Crystal_Reflection_F_H(Crystal_Reflection *reflection, double energy, xrl_error **error)
+    int Crystal_Reflection_F_H_Batch(Crystal_Reflection *reflection, const double *energies, int n_energies, xrlComplex *F_H, xrl_error **error)
+
+    int xrl_table_fixed(const char *name, const double **data, int *rows, int *columns, xrl_error **error)
+    int xrl_table_element(const char *name, int Z, const double **data, int *length, xrl_error **error)
+    int xrl_table_element_shell(const char *name, int Z, int shell, const double **data, int *length, xrl_error **error)
+
 
     int XRAYLIB_MAJOR "XRAYLIB_MAJOR"
     int XRAYLIB_MINOR "XRAYLIB_MINOR"
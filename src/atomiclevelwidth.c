@@ -15,6 +15,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 
 /*////////////////////////////////////////////////////////////////////
 //                                                                  //
@@ -37,6 +38,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 
 double AtomicLevelWidth(int Z, int shell, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double atomic_level_width;
 
   if (Z < 1 || Z > ZMAX) {
@@ -15,6 +15,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 
 /*////////////////////////////////////////////////////////////////////
 //                                                                  //
@@ -25,6 +26,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 /////////////////////////////////////////////////////////////////// */
 double AtomicWeight(int Z, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double atomic_weight;
 
   if (Z < 1 || Z > ZMAX) {
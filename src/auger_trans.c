@@ -16,6 +16,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 #include "xrayvars.h"
 #include "xrayglob.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 
 
 /*////////////////////////////////////////////////////////////////////
@@ -30,6 +31,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 /////////////////////////////////////////////////////////////////// */
 
 double AugerRate(int Z, int auger_trans, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double rv;
 
 	if (Z > ZMAX || Z < 1) {
@@ -62,6 +64,7 @@ double AugerRate(int Z, int auger_trans, xrl_error **error) {
 /////////////////////////////////////////////////////////////////// */
 
 double AugerYield(int Z, int shell, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double rv;
 
 	if (Z > ZMAX || Z < 1) {
@@ -18,6 +18,13 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 #include "xraylib.h"
 #include "math.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/* inverse fine structure constant: electron rest mass momentum in atomic units */
+#define MEC_AU 137.035999084
 
 /*////////////////////////////////////////////////////////////////////
 //                                                                  //
@@ -30,6 +37,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 
 
 double ComptonProfile(int Z, double pz, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double q, ln_q;
 	double ln_pz;
 	int splint_rv;
@@ -66,6 +74,7 @@ double ComptonProfile(int Z, double pz, xrl_error **error) {
 //                                                                  //
 /////////////////////////////////////////////////////////////////// */
 double ComptonProfile_Partial(int Z, int shell, double pz, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double q, ln_q;
 	double ln_pz;
 	int splint_rv;
@@ -115,3 +124,215 @@ double ElectronConfig_Biggs(int Z, int shell, xrl_error **error) {
   	return UOCCUP_ComptonProfiles[Z][shell]; 
 }
 
+/*
+ * Projection of the electron momentum on the scattering vector (atomic units)
+ * for a photon with energy E0 scattered over theta into energy E. Stores the
+ * Klein-Nishina cross section times |dpz/dE| in jac[i], or 0.0 when the channel
+ * cannot be reached.
+ */
+static void compton_pz_grid(double E0, double theta, const double E[], int nE, double ln_pz[], double jac[]) {
+	int i;
+	double cos_theta = cos(theta);
+	double dcs_kn = DCS_KN(E0, theta, NULL);
+
+	for (i = 0 ; i < nE ; i++) {
+		double D, N, pz, dpz;
+
+		if (E[i] <= 0.0 || E[i] >= E0) {
+			ln_pz[i] = 0.0;
+			jac[i] = 0.0;
+			continue;
+		}
+		D = sqrt(E0 * E0 + E[i] * E[i] - 2.0 * E0 * E[i] * cos_theta);
+		N = E0 * E[i] * (1.0 - cos_theta) - MEC2 * (E0 - E[i]);
+		pz = MEC_AU * N / (MEC2 * D);
+		dpz = MEC_AU / MEC2 * ((E0 * (1.0 - cos_theta) + MEC2) / D - N * (E[i] - E0 * cos_theta) / (D * D * D));
+		ln_pz[i] = log(fabs(pz) + 1.0);
+		jac[i] = dcs_kn * fabs(dpz);
+	}
+}
+
+/*
+ * Adds weight times the impulse approximation spectrum of element Z to ddcs,
+ * summing the subshell profiles of all shells that can be ionized. The partial
+ * profiles are tabulated per electron, hence the occupation numbers.
+ */
+static void ddcsb_compt_accumulate(int Z, double E0, const double E[], int nE, const double ln_pz[], const double jac[], double weight, double ddcs[]) {
+	int shell, i;
+
+	for (shell = 0 ; shell < NShells_ComptonProfiles[Z] ; shell++) {
+		int klo = 0;
+		double binding = 0.0;
+		double occupation = UOCCUP_ComptonProfiles[Z][shell];
+
+		if (occupation == 0.0)
+			continue;
+
+		if (shell < SHELLNUM)
+			binding = EdgeEnergy_arr[Z][shell];
+
+		for (i = 0 ; i < nE ; i++) {
+			double ln_q;
+
+			if (jac[i] == 0.0 || E0 - E[i] < binding)
+				continue;
+
+			if (!splint_hunt(pz_ComptonProfiles[Z]-1, Partial_ComptonProfiles[Z][shell]-1, Partial_ComptonProfiles2[Z][shell]-1, Npz_ComptonProfiles[Z], ln_pz[i], Sorted_arr[Z][COMPTON_PROFILES_GRID], &klo, &ln_q))
+				continue;
+
+			ddcs[i] += weight * occupation * jac[i] * exp(ln_q);
+		}
+	}
+}
+
+static int ddcs_compt_check(double E0, const double E[], int nE, double ddcs[], xrl_error **error) {
+	if (E0 <= 0.0) {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_ENERGY);
+		return 0;
+	}
+
+	if (E == NULL || ddcs == NULL) {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NULL_ARRAY);
+		return 0;
+	}
+
+	if (nE <= 0) {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_ARRAY_LENGTH);
+		return 0;
+	}
+
+	return 1;
+}
+
+/*////////////////////////////////////////////////////////////////////
+//                                                                  //
+//        Doppler broadened Compton scattering spectrum             //
+//        in the impulse approximation (barn/atom/sterad/keV)       //
+//                                                                  //
+//          Z : atomic number                                       //
+//          E0 : energy of the incident photon (keV)                //
+//          theta : scattering polar angle (rad)                    //
+//          E : energies of the scattered photon (keV)              //
+//          nE : number of energies                                 //
+//          ddcs : output array, at least nE long                   //
+//                                                                  //
+/////////////////////////////////////////////////////////////////// */
+int DDCSb_Compt(int Z, double E0, double theta, const double E[], int nE, double ddcs[], xrl_error **error) {
+	XRL_STATS_FUNCTION
+	double *work;
+
+	if (Z < 1 || Z > ZMAX || NShells_ComptonProfiles[Z] < 1) {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE);
+		return 0;
+	}
+
+	if (!ddcs_compt_check(E0, E, nE, ddcs, error))
+		return 0;
+
+	work = malloc(2 * nE * sizeof(double));
+	if (work == NULL) {
+		xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+		return 0;
+	}
+
+	memset(ddcs, 0, nE * sizeof(double));
+	compton_pz_grid(E0, theta, E, nE, work, work + nE);
+	ddcsb_compt_accumulate(Z, E0, E, nE, work, work + nE, 1.0, ddcs);
+	free(work);
+
+	return 1;
+}
+
+/*////////////////////////////////////////////////////////////////////
+//                                                                  //
+//        Doppler broadened Compton scattering spectrum             //
+//        in the impulse approximation (cm2/g/sterad/keV)           //
+//                                                                  //
+/////////////////////////////////////////////////////////////////// */
+int DDCS_Compt(int Z, double E0, double theta, const double E[], int nE, double ddcs[], xrl_error **error) {
+	XRL_STATS_FUNCTION
+	int i;
+	double atomic_weight;
+
+	if (!DDCSb_Compt(Z, E0, theta, E, nE, ddcs, error))
+		return 0;
+
+	atomic_weight = AtomicWeight(Z, error);
+	if (atomic_weight == 0.0)
+		return 0;
+
+	for (i = 0 ; i < nE ; i++)
+		ddcs[i] *= AVOGNUM / atomic_weight;
+
+	return 1;
+}
+
+/*////////////////////////////////////////////////////////////////////
+//                                                                  //
+//        Doppler broadened Compton scattering spectrum             //
+//        of a compound (cm2/g/sterad/keV)                          //
+//                                                                  //
+//          compound : chemical formula or NIST compound name       //
+//                                                                  //
+/////////////////////////////////////////////////////////////////// */
+int DDCS_Compt_CP(const char compound[], double E0, double theta, const double E[], int nE, double ddcs[], xrl_error **error) {
+	XRL_STATS_FUNCTION
+	struct compoundData *cd = NULL;
+	struct compoundDataNIST *cdn = NULL;
+	int nElements = 0;
+	int *Elements = NULL;
+	double *massFractions = NULL;
+	double *work = NULL;
+	int i, rv = 0;
+
+	if (!ddcs_compt_check(E0, E, nE, ddcs, error))
+		return 0;
+
+	if ((cd = CompoundParser(compound, NULL)) != NULL) {
+		nElements = cd->nElements;
+		Elements = cd->Elements;
+		massFractions = cd->massFractions;
+	}
+	else if ((cdn = GetCompoundDataNISTByName(compound, NULL)) != NULL) {
+		nElements = cdn->nElements;
+		Elements = cdn->Elements;
+		massFractions = cdn->massFractions;
+	}
+	else {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, UNKNOWN_COMPOUND);
+		return 0;
+	}
+
+	for (i = 0 ; i < nElements ; i++) {
+		if (NShells_ComptonProfiles[Elements[i]] < 1) {
+			xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE);
+			goto end;
+		}
+	}
+
+	work = malloc(2 * nE * sizeof(double));
+	if (work == NULL) {
+		xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+		goto end;
+	}
+
+	memset(ddcs, 0, nE * sizeof(double));
+	/* the momentum grid only depends on the kinematics: share it between all elements */
+	compton_pz_grid(E0, theta, E, nE, work, work + nE);
+	for (i = 0 ; i < nElements ; i++) {
+		double atomic_weight = AtomicWeight(Elements[i], error);
+		if (atomic_weight == 0.0)
+			goto end;
+		ddcsb_compt_accumulate(Elements[i], E0, E, nE, work, work + nE, massFractions[i] * AVOGNUM / atomic_weight, ddcs);
+	}
+	rv = 1;
+
+end:
+	free(work);
+	if (cd)
+		FreeCompoundData(cd);
+	else if (cdn)
+		FreeCompoundDataNIST(cdn);
+
+	return rv;
+}
@@ -15,6 +15,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 
 /*////////////////////////////////////////////////////////////////////
 //                                                                  //
@@ -30,6 +31,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
       
 double CosKronTransProb(int Z, int trans, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double trans_prob;
 
   if (Z < 1 || Z > ZMAX){
@@ -18,6 +18,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 
 
 /*////////////////////////////////////////////////////////////////////
@@ -31,6 +32,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 /////////////////////////////////////////////////////////////////// */
 double CS_Total(int Z, double E, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double photo = 0.0;
   double rayleigh = 0.0;
   double compton = 0.0;
@@ -70,6 +72,7 @@ double CS_Total(int Z, double E, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double CS_Photo(int Z, double E, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double ln_E, ln_sigma, sigma;
   int splint_rv;
 
@@ -105,6 +108,7 @@ double CS_Photo(int Z, double E, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double CS_Rayl(int Z, double E, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double ln_E, ln_sigma, sigma;
   int splint_rv;
 
@@ -140,6 +144,7 @@ double CS_Rayl(int Z, double E, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double CS_Compt(int Z, double E, xrl_error **error) 
 {
+  XRL_STATS_FUNCTION
   double ln_E, ln_sigma, sigma;
   int splint_rv;
 
@@ -176,6 +181,7 @@ double CS_Compt(int Z, double E, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double CS_Energy(int Z, double E, xrl_error **error)
 {
+	XRL_STATS_FUNCTION
 	double ln_E, ln_sigma, sigma;
 	int splint_rv;
 
@@ -13,12 +13,18 @@ THIS SOFTWARE IS PROVIDED BY David Sagan AND Tom Schoonjans ''AS IS'' AND ANY EX
 
 #include "config.h"
 #include "xraylib-aux.h"
+#include "xraylib-aux-private.h"
 #include "xraylib-crystal-diffraction.h"
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
+#include "xraylib-atomic-private.h"
+#include "xraylib-crystal-diffraction-private.h"
+#include "splint.h"
 
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <math.h>
 #include <stdlib.h>
@@ -28,12 +34,20 @@ THIS SOFTWARE IS PROVIDED BY David Sagan AND Tom Schoonjans ''AS IS'' AND ANY EX
 #define cosd(x)  cos(x * DEGRAD)
 #define tand(x)  tan(x * DEGRAD)
 #define pow2(x)  pow(x, 2)
+
+/* sin and cos of the same phase in a single call where the C library has sincos (a GNU extension) */
+#ifdef HAVE_SINCOS
+  #define SINCOS(x, s, c)  sincos(x, s, c)
+#else
+  #define SINCOS(x, s, c)  (*(s) = sin(x), *(c) = cos(x))
+#endif
 #define FALSE 0
 #define TRUE 1
 
 /*-------------------------------------------------------------------------------------------------- */
 
 double c_abs(xrlComplex x) {
+  XRL_STATS_FUNCTION
   double ans = x.re * x.re + x.im * x.im;
   ans = sqrt(ans);
   return ans;
@@ -42,6 +56,7 @@ double c_abs(xrlComplex x) {
 /*-------------------------------------------------------------------------------------------------- */
 
 xrlComplex c_mul(xrlComplex x, xrlComplex y) {
+  XRL_STATS_FUNCTION
   xrlComplex ans;
   ans.re = x.re * y.re - x.im * y.im;
   ans.im = x.re * y.im + x.im * y.re;
@@ -51,41 +66,36 @@ xrlComplex c_mul(xrlComplex x, xrlComplex y) {
 /*-------------------------------------------------------------------------------------------------- */
 /* Private function to extend the crystal array size. */
 
-static int Crystal_ExtendArray(Crystal_Array** c_array, int n_new, xrl_error **error) {
+int Crystal_ExtendArray(Crystal_Array* c_array, int n_new, xrl_error **error) {
   int i;
+  Crystal_Struct *crystal;
 
-  /* Special case */
-
-  /* Transfer data to a temp. */
-
-  Crystal_Array *temp_array = malloc(sizeof(Crystal_Array));
-  if (temp_array == NULL) {
-    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+  if (c_array->mapped) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CRYSTAL_ARRAY_MAPPED);
     return 0;
   }
-  temp_array->n_crystal = (*c_array)->n_crystal;
-  temp_array->n_alloc = (*c_array)->n_alloc + n_new;
-  temp_array->crystal = malloc(temp_array->n_alloc * sizeof(Crystal_Struct));
-  if (temp_array->crystal == NULL) {
+
+  crystal = malloc((c_array->n_alloc + n_new) * sizeof(Crystal_Struct));
+  if (crystal == NULL) {
     xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
-    free(temp_array);
     return 0;
   }
 
-  for (i = 0; i < (*c_array)->n_crystal; i++) {
-    temp_array->crystal[i] = (*c_array)->crystal[i];
+  /* We do reuse c_array->crystal[i].atom and c_array->crystal[i].name memory. */
+
+  for (i = 0; i < c_array->n_crystal; i++) {
+    crystal[i] = c_array->crystal[i];
   }
 
-  /* Free memory but we do reuse c_array->crystal[i].atom and c_array->crystal[i].name memory.
-   * Note: If c_array->crystal is pointing to the original Crystal_arr defined in xrayglob_inline.c
+  /* Note: If c_array->crystal is pointing to the original Crystal_arr defined in xrayglob_inline.c
    * then we cannot free memory.
    */
 
+  if (c_array->crystal != Crystal_arr.crystal)
+    free(c_array->crystal);
 
-  if ((*c_array)->crystal != Crystal_arr.crystal)
-    free((*c_array)->crystal);
-
-  *c_array = temp_array;
+  c_array->crystal = crystal;
+  c_array->n_alloc += n_new;
 
   return 1;
 }
@@ -102,6 +112,7 @@ Crystal_Array* Crystal_ArrayInit(int n_crystal_alloc, xrl_error **error) {
 
   c_array->n_crystal = 0;
   c_array->n_alloc = n_crystal_alloc;
+  c_array->mapped = 0;
 
   if (n_crystal_alloc == 0) {
     c_array->crystal = NULL;
@@ -127,6 +138,12 @@ void Crystal_ArrayFree(Crystal_Array *c_array) {
   int i;
   if (c_array == NULL)
     return;
+  /* the names and atoms of a mapped array live in the mapped file */
+  if (c_array->mapped) {
+    Crystal_MappedArray *mapped = (Crystal_MappedArray *) ((char *) c_array - offsetof(Crystal_MappedArray, array));
+    mapped->unmap(c_array);
+    return;
+  }
   for (i = 0; i < c_array->n_crystal; i++) {
     if (c_array->crystal[i].name)
       free(c_array->crystal[i].name);
@@ -141,6 +158,7 @@ void Crystal_ArrayFree(Crystal_Array *c_array) {
 /*-------------------------------------------------------------------------------------------------- */
 
 Crystal_Struct* Crystal_MakeCopy (Crystal_Struct *crystal, xrl_error **error) {
+  XRL_STATS_FUNCTION
   int n;
   Crystal_Struct *crystal_out = NULL;
 
@@ -180,15 +198,282 @@ void Crystal_Free(Crystal_Struct* crystal) {
   free(crystal);
 }
 
+/*-------------------------------------------------------------------------------------------------- */
+/*
+ * Shared crystals and the registry of official crystals.
+ *
+ * A shared crystal is an immutable Crystal_Struct preceded by a reference count.
+ * The official crystals are kept in an immutable, sorted snapshot of shared crystals.
+ * Readers only load the current snapshot pointer, and never block or allocate.
+ * Writers serialize on a lock, publish a new snapshot and retire the previous one.
+ * Readers announce themselves in crystal_registry_readers while they search a snapshot:
+ * retired snapshots are freed by the first writer that finds no readers.
+ * Replaced crystals are never freed, since Crystal_GetCrystalShared hands them out without a reference.
+ */
+
+#define CRYSTAL_SHARED_IMMORTAL -1
+
+typedef struct {
+  int ref_count;               /* CRYSTAL_SHARED_IMMORTAL for crystals owned by the registry */
+  Crystal_Struct crystal;
+} Crystal_Shared;
+
+typedef struct _Crystal_Registry {
+  struct _Crystal_Registry *retired;  /* The next snapshot waiting to be freed */
+  int n_crystal;
+  Crystal_Struct *crystal[1];         /* n_crystal pointers, sorted by name */
+} Crystal_Registry;
+
+static Crystal_Registry *crystal_registry = NULL;
+static Crystal_Registry *crystal_registry_retired = NULL; /* protected by crystal_registry_lock */
+static int crystal_registry_lock = 0;
+static int crystal_registry_readers = 0;
+
+#define CRYSTAL_SHARED(cs) ((Crystal_Shared *) ((char *) (cs) - offsetof(Crystal_Shared, crystal)))
+
+static Crystal_Registry* Crystal_RegistryAlloc(int n_crystal, xrl_error **error) {
+  Crystal_Registry *registry = malloc(sizeof(Crystal_Registry) + n_crystal * sizeof(Crystal_Struct *));
+  if (registry == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    return NULL;
+  }
+  registry->retired = NULL;
+  registry->n_crystal = n_crystal;
+  return registry;
+}
+
+/* Private function returning the current snapshot, creating it from Crystal_arr on first use. */
+
+static Crystal_Registry* Crystal_RegistryGet(xrl_error **error) {
+  Crystal_Registry *registry = xrl_atomic_load_ptr(&crystal_registry);
+  Crystal_Shared *builtin;
+  int i;
+
+  if (registry != NULL)
+    return registry;
+
+  /* The builtin crystals are static data: only the reference count headers need to be allocated. */
+  registry = Crystal_RegistryAlloc(Crystal_arr.n_crystal, error);
+  if (registry == NULL)
+    return NULL;
+  builtin = malloc(Crystal_arr.n_crystal * sizeof(Crystal_Shared) + 1);
+  if (builtin == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    free(registry);
+    return NULL;
+  }
+
+  for (i = 0; i < Crystal_arr.n_crystal; i++) {
+    builtin[i].ref_count = CRYSTAL_SHARED_IMMORTAL;
+    builtin[i].crystal = Crystal_arr.crystal[i];
+    registry->crystal[i] = &builtin[i].crystal;
+  }
+
+  if (!xrl_atomic_cas_ptr(&crystal_registry, NULL, registry)) {
+    /* another thread beat us to it */
+    free(builtin);
+    free(registry);
+    registry = xrl_atomic_load_ptr(&crystal_registry);
+  }
+
+  return registry;
+}
+
+static int matchCrystalPointer(const void *key, const void *crystal) {
+  return strcmp((const char *) key, (*(Crystal_Struct * const *) crystal)->name);
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+Crystal_Struct* Crystal_MakeShared(Crystal_Struct *crystal, xrl_error **error) {
+  XRL_STATS_FUNCTION
+  Crystal_Shared *shared;
+  size_t name_len;
+
+  if (crystal == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CRYSTAL_NULL);
+    return NULL;
+  }
+
+  /* header, atoms and name share a single allocation */
+  name_len = strlen(crystal->name) + 1;
+  shared = malloc(sizeof(Crystal_Shared) + crystal->n_atom * sizeof(Crystal_Atom) + name_len);
+  if (shared == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    return NULL;
+  }
+
+  shared->ref_count = 1;
+  shared->crystal = *crystal;
+  shared->crystal.atom = (Crystal_Atom *) (shared + 1);
+  memcpy(shared->crystal.atom, crystal->atom, crystal->n_atom * sizeof(Crystal_Atom));
+  shared->crystal.name = (char *) (shared->crystal.atom + crystal->n_atom);
+  memcpy(shared->crystal.name, crystal->name, name_len);
+
+  return &shared->crystal;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+Crystal_Struct* Crystal_Retain(Crystal_Struct *crystal) {
+  if (crystal != NULL && xrl_atomic_load_int(&CRYSTAL_SHARED(crystal)->ref_count) != CRYSTAL_SHARED_IMMORTAL)
+    xrl_atomic_inc_int(&CRYSTAL_SHARED(crystal)->ref_count);
+  return crystal;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+void Crystal_Release(Crystal_Struct *crystal) {
+  if (crystal == NULL || xrl_atomic_load_int(&CRYSTAL_SHARED(crystal)->ref_count) == CRYSTAL_SHARED_IMMORTAL)
+    return;
+  if (xrl_atomic_dec_int(&CRYSTAL_SHARED(crystal)->ref_count) == 0)
+    free(CRYSTAL_SHARED(crystal));
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+Crystal_Struct* Crystal_GetCrystalShared(const char* material, xrl_error **error) {
+  XRL_STATS_FUNCTION
+  Crystal_Registry *registry;
+  Crystal_Struct **rv, *crystal = NULL;
+
+  if (material == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CRYSTAL_NULL);
+    return NULL;
+  }
+
+  /* the snapshot is loaded after announcing the reader, so that writers cannot free it while it is searched */
+  xrl_atomic_inc_int(&crystal_registry_readers);
+  if ((registry = Crystal_RegistryGet(error)) != NULL) {
+    rv = bsearch(material, registry->crystal, registry->n_crystal, sizeof(Crystal_Struct *), matchCrystalPointer);
+    if (rv != NULL)
+      crystal = *rv;
+    else
+      xrl_set_error(error, XRL_ERROR_INVALID_ARGUMENT, "Crystal %s is not present in array", material);
+  }
+  xrl_atomic_dec_int(&crystal_registry_readers);
+
+  return crystal;
+}
+
+/* Private function adding the crystals of c_array to the registry.
+ * If replace is FALSE, an error is returned if one of the crystals is already present.
+ */
+
+int Crystal_RegistryAdd(Crystal_Array *c_array, int replace, xrl_error **error) {
+  Crystal_Registry *registry, *new_registry, *retired;
+  Crystal_Struct **crystals;
+  int i, j, n_new = 0, rv = 0;
+
+  /* the current snapshot is only read under the lock, where it cannot be freed */
+  if (Crystal_RegistryGet(error) == NULL)
+    return 0;
+
+  /* everything is allocated and computed before taking the lock */
+  if ((crystals = malloc((c_array->n_crystal + 1) * sizeof(Crystal_Struct *))) == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    return 0;
+  }
+  for (n_new = 0; n_new < c_array->n_crystal; n_new++) {
+    if ((crystals[n_new] = Crystal_MakeShared(&c_array->crystal[n_new], error)) == NULL)
+      goto end;
+    CRYSTAL_SHARED(crystals[n_new])->ref_count = CRYSTAL_SHARED_IMMORTAL;
+    crystals[n_new]->volume = Crystal_UnitCellVolume(crystals[n_new], NULL);
+  }
+  /* the registry never holds more than CRYSTALARRAY_MAX crystals */
+  if ((new_registry = Crystal_RegistryAlloc(CRYSTALARRAY_MAX, error)) == NULL)
+    goto end;
+
+  xrl_lock_acquire(&crystal_registry_lock);
+
+  registry = xrl_atomic_load_ptr(&crystal_registry);
+  new_registry->n_crystal = registry->n_crystal;
+  memcpy(new_registry->crystal, registry->crystal, registry->n_crystal * sizeof(Crystal_Struct *));
+
+  for (i = 0; i < n_new; i++) {
+    Crystal_Struct *crystal = crystals[i], **found;
+
+    found = bsearch(crystal->name, new_registry->crystal, new_registry->n_crystal, sizeof(Crystal_Struct *), matchCrystalPointer);
+    if (found != NULL && !replace) {
+      xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, "Crystal already present in array");
+      break;
+    }
+    else if (found == NULL && new_registry->n_crystal >= CRYSTALARRAY_MAX) {
+      xrl_set_error_literal(error, XRL_ERROR_RUNTIME, "Extending internal is crystal array is not allowed");
+      break;
+    }
+
+    if (found != NULL) {
+      /* the replaced crystal is leaked on purpose: readers may still be using it */
+      *found = crystal;
+      continue;
+    }
+
+    /* insert, keeping the snapshot sorted */
+    for (j = new_registry->n_crystal; j > 0 && strcmp(new_registry->crystal[j - 1]->name, crystal->name) > 0; j--)
+      new_registry->crystal[j] = new_registry->crystal[j - 1];
+    new_registry->crystal[j] = crystal;
+    new_registry->n_crystal++;
+  }
+
+  if (i < n_new) {
+    /* nothing was published: the new crystals are still private */
+    xrl_lock_release(&crystal_registry_lock);
+    free(new_registry);
+    goto end;
+  }
+
+  /*
+   * A reader that is not counted after the new snapshot has been published can only load the new snapshot.
+   * Both are sequentially consistent read-modify-write operations, which keeps them in order.
+   */
+  xrl_atomic_cas_ptr(&crystal_registry, registry, new_registry);
+  registry->retired = crystal_registry_retired;
+  crystal_registry_retired = registry;
+  if (xrl_atomic_cas_int(&crystal_registry_readers, 0, 0)) {
+    while ((retired = crystal_registry_retired) != NULL) {
+      crystal_registry_retired = retired->retired;
+      free(retired);
+    }
+  }
+  xrl_lock_release(&crystal_registry_lock);
+  n_new = 0;
+  rv = 1;
+
+end:
+  for (i = 0; i < n_new; i++)
+    free(CRYSTAL_SHARED(crystals[i]));
+  free(crystals);
+  return rv;
+}
+
 /*-------------------------------------------------------------------------------------------------- */
 
 char** Crystal_GetCrystalsList(Crystal_Array *c_array, int *nCrystals, xrl_error **error) {
+  XRL_STATS_FUNCTION
   char **rv = NULL;
   int i;
 
   if (c_array == NULL) {
-  	c_array = &Crystal_arr;
+    Crystal_Registry *registry;
+    xrl_atomic_inc_int(&crystal_registry_readers);
+    if ((registry = Crystal_RegistryGet(error)) != NULL) {
+      rv = malloc(sizeof(char *) * (registry->n_crystal + 1));
+      if (rv == NULL) {
+        xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+      }
+      else {
+        for (i = 0 ; i < registry->n_crystal ; i++)
+          rv[i] = xrl_strdup(registry->crystal[i]->name);
+        rv[registry->n_crystal] = NULL;
+        if (nCrystals != NULL)
+          *nCrystals = registry->n_crystal;
+      }
+    }
+    xrl_atomic_dec_int(&crystal_registry_readers);
+    return rv;
   }
+
   rv = malloc(sizeof(char *) * (c_array->n_crystal + 1));
   if (rv == NULL) {
     xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
@@ -208,6 +493,7 @@ char** Crystal_GetCrystalsList(Crystal_Array *c_array, int *nCrystals, xrl_error
 /*-------------------------------------------------------------------------------------------------- */
 
 Crystal_Struct* Crystal_GetCrystal (const char* material, Crystal_Array* c_array, xrl_error **error) {
+  XRL_STATS_FUNCTION
   Crystal_Struct *rv, *rv_copy;
   if (material == NULL) {
     xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, "Crystal cannot be NULL");
@@ -215,7 +501,8 @@ Crystal_Struct* Crystal_GetCrystal (const char* material, Crystal_Array* c_array
   }
 
   if (c_array == NULL) {
-    c_array = &Crystal_arr;
+    rv = Crystal_GetCrystalShared(material, error);
+    return rv == NULL ? NULL : Crystal_MakeCopy(rv, error);
   }
 
   rv = bsearch(material, c_array->crystal, c_array->n_crystal, sizeof(Crystal_Struct), matchCrystalStruct);
@@ -236,6 +523,7 @@ Crystal_Struct* Crystal_GetCrystal (const char* material, Crystal_Array* c_array
  */
 
 double Bragg_angle(Crystal_Struct* crystal, double energy, int i_miller, int j_miller, int k_miller, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double d_spacing, wavelength;
 
   if (energy <= 0.0) {
@@ -259,6 +547,7 @@ double Bragg_angle(Crystal_Struct* crystal, double energy, int i_miller, int j_m
  */
 
 double Q_scattering_amplitude(Crystal_Struct* crystal, double energy, int i_miller, int j_miller, int k_miller, double rel_angle, xrl_error **error) {
+	XRL_STATS_FUNCTION
 
   if (energy <= 0.0) {
     xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_ENERGY);
@@ -278,6 +567,7 @@ double Q_scattering_amplitude(Crystal_Struct* crystal, double energy, int i_mill
  */
 
 int Atomic_Factors (int Z, double energy, double q, double debye_factor, double *f0, double *f_prime, double *f_prime2, xrl_error **error) {
+	XRL_STATS_FUNCTION
 
   if (debye_factor <= 0.0) {
     xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_DEBYE_FACTOR);
@@ -311,6 +601,7 @@ int Atomic_Factors (int Z, double energy, double q, double debye_factor, double
  */
 
 xrlComplex Crystal_F_H_StructureFactor(Crystal_Struct* crystal, double energy, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle, xrl_error **error) {
+  XRL_STATS_FUNCTION
   return Crystal_F_H_StructureFactor_Partial(crystal, energy, i_miller, j_miller, k_miller, debye_factor, rel_angle, 2, 2, 2, error);
 }
 
@@ -331,6 +622,7 @@ void Crystal_F_H_StructureFactor2(Crystal_Struct* crystal, double energy, int i_
  */
 
 xrlComplex Crystal_F_H_StructureFactor_Partial (Crystal_Struct* crystal, double energy, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle, int f0_flag, int f_prime_flag, int f_prime2_flag, xrl_error **error) {
+	XRL_STATS_FUNCTION
 
   double f0, f_prime, f_prime2, q;
   double f_re[120], f_im[120], H_dot_r;
@@ -427,6 +719,388 @@ void Crystal_F_H_StructureFactor_Partial2(Crystal_Struct* crystal, double energy
 	result->im = z.im;
 }
 
+/*-------------------------------------------------------------------------------------------------- */
+/* Private function to assign each atom to a group of atoms sharing the same atomic number.
+ * Returns the number of groups, or -1 on error.
+ */
+
+static int Crystal_GroupAtoms(Crystal_Struct* crystal, int group[], int Z_unique[], xrl_error **error) {
+  int z_group[ZMAX + 1];
+  int i, n_z = 0;
+
+  for (i = 0; i <= ZMAX; i++)
+    z_group[i] = -1;
+
+  for (i = 0; i < crystal->n_atom; i++) {
+    int Z = crystal->atom[i].Zatom;
+    if (Z < 1 || Z > ZMAX || NE_Fi[Z] <= 0 || NE_Fii[Z] <= 0 || Nq_Rayl[Z] <= 0) {
+      xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE);
+      return -1;
+    }
+    if (z_group[Z] < 0) {
+      Z_unique[n_z] = Z;
+      z_group[Z] = n_z++;
+    }
+    group[i] = z_group[Z];
+  }
+
+  return n_z;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+/*
+ * Compute F_H for a list of reflections
+ *
+ * The atoms are regrouped per atomic number in structure-of-arrays form, so the phase factors
+ * can be evaluated in tight loops and summed per element. The anomalous scattering factors
+ * only depend on the energy and are therefore evaluated once for all reflections.
+ */
+
+int Crystal_F_H_StructureFactor_Partial_Batch(Crystal_Struct* crystal, double energy, const int miller[], int n_miller, double debye_factor, double rel_angle, int f0_flag, int f_prime_flag, int f_prime2_flag, xrlComplex F_H[], xrl_error **error) {
+	XRL_STATS_FUNCTION
+
+  Crystal_Struct* cc = crystal;  /* Just for an abbreviation. */
+  int Z_unique[ZMAX + 1];
+  double f_prime[ZMAX + 1], f_prime2[ZMAX + 1];
+  double S_re[ZMAX + 1], S_im[ZMAX + 1];
+  double *x, *y, *z, *fraction, *phase, *work = NULL;
+  int *group;
+  double sa, sb, sg, ca, cb, cg, wavelength;
+  int i, j, g, n_z;
+
+  if (cc == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CRYSTAL_NULL);
+    return 0;
+  }
+
+  if (energy <= 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_ENERGY);
+    return 0;
+  }
+
+  if (debye_factor <= 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_DEBYE_FACTOR);
+    return 0;
+  }
+
+  if (miller == NULL || F_H == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NULL_ARRAY);
+    return 0;
+  }
+
+  if (n_miller <= 0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_ARRAY_LENGTH);
+    return 0;
+  }
+
+  if (f0_flag < 0 || f0_flag > 2) {
+    xrl_set_error(error, XRL_ERROR_INVALID_ARGUMENT, "Invalid f0_flag argument: %d", f0_flag);
+    return 0;
+  }
+
+  if (f_prime_flag != 0 && f_prime_flag != 2) {
+    xrl_set_error(error, XRL_ERROR_INVALID_ARGUMENT, "Invalid f_prime_flag argument: %d", f_prime_flag);
+    return 0;
+  }
+
+  if (f_prime2_flag != 0 && f_prime2_flag != 2) {
+    xrl_set_error(error, XRL_ERROR_INVALID_ARGUMENT, "Invalid f_prime2_flag argument: %d", f_prime2_flag);
+    return 0;
+  }
+
+  /* Structure of arrays copy of the atoms, grouped by atomic number */
+
+  work = malloc(cc->n_atom * (5 * sizeof(double) + sizeof(int)) + 1);
+  if (work == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    return 0;
+  }
+  x = work;
+  y = x + cc->n_atom;
+  z = y + cc->n_atom;
+  fraction = z + cc->n_atom;
+  phase = fraction + cc->n_atom;
+  group = (int *) (phase + cc->n_atom);
+
+  if ((n_z = Crystal_GroupAtoms(cc, group, Z_unique, error)) < 0) {
+    free(work);
+    return 0;
+  }
+
+  for (i = 0; i < cc->n_atom; i++) {
+    x[i] = TWOPI * cc->atom[i].x;
+    y[i] = TWOPI * cc->atom[i].y;
+    z[i] = TWOPI * cc->atom[i].z;
+    fraction[i] = cc->atom[i].fraction;
+  }
+
+  /* f' and f'' only depend on the energy: share them between all reflections */
+
+  for (g = 0; g < n_z; g++) {
+    if ((f_prime[g] = Fi(Z_unique[g], energy, error) * debye_factor) == 0.0 ||
+        (f_prime2[g] = -Fii(Z_unique[g], energy, error) * debye_factor) == 0.0) {
+      free(work);
+      return 0;
+    }
+  }
+
+  /* Unit cell geometry for the d-spacings */
+
+  sa = sind(cc->alpha);
+  sb = sind(cc->beta);
+  sg = sind(cc->gamma);
+  ca = cosd(cc->alpha);
+  cb = cosd(cc->beta);
+  cg = cosd(cc->gamma);
+  wavelength = KEV2ANGST / energy;
+
+  for (j = 0; j < n_miller; j++) {
+    int h = miller[3 * j], k = miller[3 * j + 1], l = miller[3 * j + 2];
+    double q = 0.0;
+
+    if (h != 0 || k != 0 || l != 0) {
+      double d_spacing = (cc->volume / (cc->a * cc->b * cc->c)) * sqrt(1 / (
+          pow2(h * sa / cc->a) + pow2(k * sb / cc->b) + pow2(l * sg / cc->c) +
+          2 * h * k * (ca * cb - cg) / (cc->a * cc->b) +
+          2 * h * l * (ca * cg - cb) / (cc->a * cc->c) +
+          2 * k * l * (cb * cg - ca) / (cc->b * cc->c)));
+      q = energy * sin(rel_angle * asin(wavelength / (2 * d_spacing))) / KEV2ANGST;
+    }
+
+    /* Phase factors, summed per atomic number */
+
+    for (i = 0; i < cc->n_atom; i++)
+      phase[i] = h * x[i] + k * y[i] + l * z[i];
+
+    for (g = 0; g < n_z; g++)
+      S_re[g] = S_im[g] = 0.0;
+
+    for (i = 0; i < cc->n_atom; i++) {
+      double sin_phase, cos_phase;
+      SINCOS(phase[i], &sin_phase, &cos_phase);
+      S_re[group[i]] += fraction[i] * cos_phase;
+      S_im[group[i]] += fraction[i] * sin_phase;
+    }
+
+    F_H[j].re = F_H[j].im = 0.0;
+
+    for (g = 0; g < n_z; g++) {
+      double f_re, f_im;
+
+      switch (f0_flag) {
+      case 0:
+        f_re = 0;
+        break;
+      case 1:
+        f_re = 1;
+        break;
+      default:
+        if ((f_re = FF_Rayl(Z_unique[g], q, error) * debye_factor) == 0.0) {
+          free(work);
+          return 0;
+        }
+      }
+      if (f_prime_flag == 2)
+        f_re += f_prime[g];
+      f_im = f_prime2_flag == 2 ? f_prime2[g] : 0.0;
+
+      F_H[j].re += f_re * S_re[g] - f_im * S_im[g];
+      F_H[j].im += f_re * S_im[g] + f_im * S_re[g];
+    }
+  }
+
+  free(work);
+
+  return 1;
+}
+
+int Crystal_F_H_StructureFactor_Batch(Crystal_Struct* crystal, double energy, const int miller[], int n_miller, double debye_factor, double rel_angle, xrlComplex F_H[], xrl_error **error) {
+  XRL_STATS_FUNCTION
+  return Crystal_F_H_StructureFactor_Partial_Batch(crystal, energy, miller, n_miller, debye_factor, rel_angle, 2, 2, 2, F_H, error);
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+/*
+ * Prepared reflections
+ *
+ * For a fixed crystal and reflection, the geometric part of F_H reduces to a sum of phase factors
+ * per atomic number, which is computed once. Evaluating F_H at a given energy then only requires
+ * f0, f' and f'' for each distinct atomic number.
+ */
+
+struct _Crystal_Reflection {
+  double d_spacing;            /* 0 for the (0, 0, 0) reflection */
+  double debye_factor;
+  double rel_angle;
+  int n_z;                     /* Number of distinct atomic numbers */
+  int Z[ZMAX + 1];
+  double S_re[ZMAX + 1];       /* Sum of fraction * exp(i H.r) over all atoms with atomic number Z */
+  double S_im[ZMAX + 1];
+};
+
+Crystal_Reflection* Crystal_Reflection_New(Crystal_Struct* crystal, int i_miller, int j_miller, int k_miller, double debye_factor, double rel_angle, xrl_error **error) {
+  XRL_STATS_FUNCTION
+  Crystal_Reflection *reflection;
+  int *group;
+  int i;
+
+  if (crystal == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CRYSTAL_NULL);
+    return NULL;
+  }
+
+  if (debye_factor <= 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_DEBYE_FACTOR);
+    return NULL;
+  }
+
+  reflection = malloc(sizeof(Crystal_Reflection));
+  group = malloc(crystal->n_atom * sizeof(int) + 1);
+  if (reflection == NULL || group == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    free(reflection);
+    free(group);
+    return NULL;
+  }
+
+  if ((reflection->n_z = Crystal_GroupAtoms(crystal, group, reflection->Z, error)) < 0) {
+    free(reflection);
+    free(group);
+    return NULL;
+  }
+
+  reflection->d_spacing = 0.0;
+  if (i_miller != 0 || j_miller != 0 || k_miller != 0)
+    reflection->d_spacing = Crystal_dSpacing(crystal, i_miller, j_miller, k_miller, NULL);
+  reflection->debye_factor = debye_factor;
+  reflection->rel_angle = rel_angle;
+
+  for (i = 0; i < reflection->n_z; i++)
+    reflection->S_re[i] = reflection->S_im[i] = 0.0;
+
+  for (i = 0; i < crystal->n_atom; i++) {
+    double H_dot_r = TWOPI * (i_miller * crystal->atom[i].x + j_miller * crystal->atom[i].y + k_miller * crystal->atom[i].z);
+    reflection->S_re[group[i]] += crystal->atom[i].fraction * cos(H_dot_r);
+    reflection->S_im[group[i]] += crystal->atom[i].fraction * sin(H_dot_r);
+  }
+
+  free(group);
+
+  return reflection;
+}
+
+void Crystal_Reflection_Free(Crystal_Reflection *reflection) {
+  free(reflection);
+}
+
+/* Private wrapper around splint_hunt that reports extrapolation errors like splint does. */
+
+static int Crystal_Reflection_splint(double xa[], double ya[], double y2a[], int n, double x, int sorted, int *cursor, double *y, xrl_error **error) {
+  if (!splint_hunt(xa, ya, y2a, n, x, sorted, cursor, y)) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, x < xa[1] ? SPLINT_X_TOO_LOW : SPLINT_X_TOO_HIGH);
+    return 0;
+  }
+  return 1;
+}
+
+/* Private function evaluating F_H, with one spline cursor per table and atomic number.
+ * When scanning the energy, the cursors turn the table lookups into short walks.
+ * Without cursors (NULL), every lookup is a bisection.
+ */
+
+static int Crystal_Reflection_Evaluate(Crystal_Reflection *reflection, double energy, int cursors[][3], xrlComplex *F_H, xrl_error **error) {
+  double q = 0.0;
+  int g;
+
+  F_H->re = F_H->im = 0.0;
+
+  if (energy <= 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_ENERGY);
+    return 0;
+  }
+
+  if (reflection->d_spacing != 0.0)
+    q = energy * sin(reflection->rel_angle * asin(KEV2ANGST / energy / (2 * reflection->d_spacing))) / KEV2ANGST;
+
+  if (q < 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_Q);
+    return 0;
+  }
+
+  for (g = 0; g < reflection->n_z; g++) {
+    int Z = reflection->Z[g];
+    int bisect[3] = {0, 0, 0};
+    int *cursor = cursors != NULL ? cursors[g] : bisect;
+    double f0, f_prime, f_prime2;
+
+    if (q == 0.0)
+      f0 = Z;
+    else if (!Crystal_Reflection_splint(q_Rayl_arr[Z]-1, FF_Rayl_arr[Z]-1, FF_Rayl_arr2[Z]-1, Nq_Rayl[Z], q, Sorted_arr[Z][Q_RAYL_GRID], &cursor[0], &f0, error))
+      return 0;
+
+    if (!Crystal_Reflection_splint(E_Fi_arr[Z]-1, Fi_arr[Z]-1, Fi_arr2[Z]-1, NE_Fi[Z], energy, Sorted_arr[Z][FI_GRID], &cursor[1], &f_prime, error) ||
+        !Crystal_Reflection_splint(E_Fii_arr[Z]-1, Fii_arr[Z]-1, Fii_arr2[Z]-1, NE_Fii[Z], energy, Sorted_arr[Z][FII_GRID], &cursor[2], &f_prime2, error))
+      return 0;
+
+    f0 *= reflection->debye_factor;
+    f_prime *= reflection->debye_factor;
+    f_prime2 *= -reflection->debye_factor;
+
+    /* same convention as Atomic_Factors */
+    if (f0 == 0.0 || f_prime == 0.0 || f_prime2 == 0.0) {
+      F_H->re = F_H->im = 0.0;
+      return 0;
+    }
+
+    F_H->re += (f0 + f_prime) * reflection->S_re[g] - f_prime2 * reflection->S_im[g];
+    F_H->im += (f0 + f_prime) * reflection->S_im[g] + f_prime2 * reflection->S_re[g];
+  }
+
+  return 1;
+}
+
+xrlComplex Crystal_Reflection_F_H(Crystal_Reflection *reflection, double energy, xrl_error **error) {
+  XRL_STATS_FUNCTION
+  xrlComplex F_H = {0, 0};
+
+  if (reflection == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, REFLECTION_NULL);
+    return F_H;
+  }
+
+  Crystal_Reflection_Evaluate(reflection, energy, NULL, &F_H, error);
+
+  return F_H;
+}
+
+int Crystal_Reflection_F_H_Batch(Crystal_Reflection *reflection, const double energies[], int n_energies, xrlComplex F_H[], xrl_error **error) {
+  XRL_STATS_FUNCTION
+  int cursors[ZMAX + 1][3] = {{0}};
+  int i;
+
+  if (reflection == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, REFLECTION_NULL);
+    return 0;
+  }
+
+  if (energies == NULL || F_H == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NULL_ARRAY);
+    return 0;
+  }
+
+  if (n_energies <= 0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_ARRAY_LENGTH);
+    return 0;
+  }
+
+  for (i = 0; i < n_energies; i++) {
+    if (!Crystal_Reflection_Evaluate(reflection, energies[i], cursors, &F_H[i], error))
+      return 0;
+  }
+
+  return 1;
+}
+
 /*-------------------------------------------------------------------------------------------------- */
 /*
  * Compute unit cell volume
@@ -434,6 +1108,7 @@ void Crystal_F_H_StructureFactor_Partial2(Crystal_Struct* crystal, double energy
  */
 
 double Crystal_UnitCellVolume(Crystal_Struct* crystal, xrl_error **error) {
+	XRL_STATS_FUNCTION
 
   Crystal_Struct* cc = crystal;  /* Just for an abbreviation. */
 
@@ -454,6 +1129,7 @@ double Crystal_UnitCellVolume(Crystal_Struct* crystal, xrl_error **error) {
  */
 
 double Crystal_dSpacing(Crystal_Struct* crystal, int i_miller, int j_miller, int k_miller, xrl_error **error) {
+  XRL_STATS_FUNCTION
   Crystal_Struct* cc;
 
   if (crystal == NULL) {
@@ -484,16 +1160,24 @@ double Crystal_dSpacing(Crystal_Struct* crystal, int i_miller, int j_miller, int
  */
 
 int Crystal_AddCrystal(Crystal_Struct* crystal, Crystal_Array* c_array, xrl_error **error) {
+  XRL_STATS_FUNCTION
   Crystal_Struct* a_cryst;
 
-  if (c_array == NULL)
-    c_array = &Crystal_arr;
-
   if (crystal == NULL) {
     xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CRYSTAL_NULL);
     return 0;
   }
 
+  if (c_array == NULL) {
+    Crystal_Array single = {1, 1, crystal, 0};
+    return Crystal_RegistryAdd(&single, FALSE, error);
+  }
+
+  if (c_array->mapped) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CRYSTAL_ARRAY_MAPPED);
+    return 0;
+  }
+
   /* See if the crystal material is already present.
    * If so replace it.
    * Otherwise must be a new material...
@@ -504,11 +1188,7 @@ int Crystal_AddCrystal(Crystal_Struct* crystal, Crystal_Array* c_array, xrl_erro
   if (a_cryst == NULL) {
     Crystal_Struct *tmp = NULL;
     if (c_array->n_crystal == c_array->n_alloc) {
-      if (c_array == &Crystal_arr) {
-        xrl_set_error_literal(error, XRL_ERROR_RUNTIME, "Extending internal is crystal array is not allowed");
-	return 0;
-      }
-      else if (Crystal_ExtendArray(&c_array, N_NEW_CRYSTAL, error) == 0) {
+      if (Crystal_ExtendArray(c_array, N_NEW_CRYSTAL, error) == 0) {
         return 0;
       }
     }
@@ -517,7 +1197,7 @@ int Crystal_AddCrystal(Crystal_Struct* crystal, Crystal_Array* c_array, xrl_erro
       return 0;
     c_array->crystal[c_array->n_crystal++] = *tmp;
     free(tmp);
-    a_cryst = &c_array->crystal[c_array->n_crystal];
+    a_cryst = &c_array->crystal[c_array->n_crystal - 1];
   } else {
     xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, "Crystal already present in array");
     return 0;
@@ -531,27 +1211,108 @@ int Crystal_AddCrystal(Crystal_Struct* crystal, Crystal_Array* c_array, xrl_erro
 
 }
 
+/*-------------------------------------------------------------------------------------------------- */
+/*
+ * Private function reading a line of arbitrary length into *buffer, which is grown geometrically as needed.
+ * The trailing newline is stripped.
+ * Returns the length of the line, -1 on end of file and -2 when the buffer could not be grown.
+ */
+
+static long Crystal_ReadLine(FILE *fp, char **buffer, size_t *buffer_size) {
+  size_t len = 0;
+
+  if (*buffer == NULL) {
+    *buffer_size = 256;
+    if ((*buffer = malloc(*buffer_size)) == NULL)
+      return -2;
+  }
+
+  while (fgets(*buffer + len, (int) (*buffer_size - len), fp) != NULL) {
+    len += strlen(*buffer + len);
+    if (len > 0 && (*buffer)[len - 1] == '\n') {
+      (*buffer)[--len] = '\0';
+      if (len > 0 && (*buffer)[len - 1] == '\r')
+        (*buffer)[--len] = '\0';
+      return (long) len;
+    }
+    if (len + 1 == *buffer_size) {
+      char *tmp = realloc(*buffer, 2 * *buffer_size);
+      if (tmp == NULL)
+        return -2;
+      *buffer = tmp;
+      *buffer_size *= 2;
+    }
+  }
+
+  /* last line without newline */
+  return len > 0 ? (long) len : -1;
+}
+
+/* Private function parsing an atom line "Z fraction x y z [Biso]". */
+
+static int Crystal_ParseAtom(const char *line, Crystal_Atom *atom) {
+  char *end;
+
+  atom->Zatom = (int) strtol(line, &end, 10);
+  if (end == line)
+    return 0;
+  line = end;
+  atom->fraction = xrl_strtod_c(line, &end);
+  if (end == line)
+    return 0;
+  line = end;
+  atom->x = xrl_strtod_c(line, &end);
+  if (end == line)
+    return 0;
+  line = end;
+  atom->y = xrl_strtod_c(line, &end);
+  if (end == line)
+    return 0;
+  line = end;
+  atom->z = xrl_strtod_c(line, &end);
+  if (end == line)
+    return 0;
+  /* the optional Biso column is not used */
+  return 1;
+}
+
 /*-------------------------------------------------------------------------------------------------- */
 /*
  * Read in a set of crystal structs.
+ *
+ * The file is parsed in a single pass: lines may have any length,
+ * and both the crystal array and the atom arrays grow geometrically.
  */
 
 int Crystal_ReadFile(const char* file_name, Crystal_Array* c_array, xrl_error **error) {
+	XRL_STATS_FUNCTION
 
   FILE* fp;
-  Crystal_Struct* crystal;
-  Crystal_Atom* atom;
-  int i, n, ex, found_it;
-  char tag[21], compound[21], buffer[512];
-  long floc;
+  Crystal_Struct* crystal = NULL;
+  int i, n_atom_alloc = 0, found_it = FALSE, in_atoms = FALSE, rv = 0;
+  char *buffer = NULL;
+  size_t buffer_size = 0;
+  long len;
 
   if (file_name == NULL) {
     xrl_set_error_literal(error, XRL_ERROR_IO, "NULL filenames are not allowed");
     return 0;
   }
 
-  if (c_array == NULL)
-    c_array = &Crystal_arr;
+  if (c_array == NULL) {
+    /* read into a private array first: the official crystals are only updated if the whole file is valid */
+    Crystal_Array *c_array_tmp = Crystal_ArrayInit(N_NEW_CRYSTAL, error);
+    if (c_array_tmp == NULL)
+      return 0;
+    rv = Crystal_ReadFile(file_name, c_array_tmp, error) && Crystal_RegistryAdd(c_array_tmp, TRUE, error);
+    Crystal_ArrayFree(c_array_tmp);
+    return rv;
+  }
+
+  if (c_array->mapped) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CRYSTAL_ARRAY_MAPPED);
+    return 0;
+  }
 
 #ifdef _WIN32
   /* necesarry to avoid line-ending issues in windows, as pointed out by Matthew Wormington */
@@ -566,108 +1327,121 @@ int Crystal_ReadFile(const char* file_name, Crystal_Array* c_array, xrl_error **
 
   /* Loop over all lines of the file. */
 
-  while (!feof(fp)) {
+  while ((len = Crystal_ReadLine(fp, &buffer, &buffer_size)) >= 0) {
 
     /* Start of compound def looks like: "#S <num> <Compound>" */
 
-    char *rv = fgets (buffer, 100, fp);
+    if (buffer[0] == '#' && buffer[1] == 'S') {
+      char *name, *end;
 
-    if (buffer[0] != '#' || buffer[1] != 'S')
-      continue;
+      if (crystal != NULL && crystal->n_atom == 0) {
+        xrl_set_error(error, XRL_ERROR_IO, "No atom positions found for crystal %s", crystal->name);
+        goto end;
+      }
 
-    ex = sscanf(buffer, "%20s %d %20s", tag, &i, compound);
-    if (ex != 3) {
-      xrl_set_error_literal(error, XRL_ERROR_IO, "Malformed '#S <num> <crystal_name>' construct");
-      return 0;
-    }
+      strtol(buffer + 2, &end, 10);
+      name = end + strspn(end, " \t");
+      if (end == buffer + 2 || *name == '\0') {
+        xrl_set_error_literal(error, XRL_ERROR_IO, "Malformed '#S <num> <crystal_name>' construct");
+        goto end;
+      }
+      name[strcspn(name, " \t")] = '\0';
 
-    if (c_array->n_crystal == c_array->n_alloc) {
-      if (Crystal_ExtendArray(&c_array, N_NEW_CRYSTAL, error) == 0)
-        return 0;
+      if (c_array->n_crystal == c_array->n_alloc) {
+        if (Crystal_ExtendArray(c_array, c_array->n_alloc > N_NEW_CRYSTAL ? c_array->n_alloc : N_NEW_CRYSTAL, error) == 0)
+          goto end;
+      }
+      crystal = &(c_array->crystal[c_array->n_crystal++]);
+
+      crystal->name = xrl_strdup(name);
+      crystal->n_atom = 0;
+      crystal->atom = NULL;
+      n_atom_alloc = 0;
+      found_it = FALSE;
+      in_atoms = FALSE;
+      continue;
     }
-    crystal = &(c_array->crystal[c_array->n_crystal++]);
-
-    crystal->name = xrl_strdup(compound);
-
-    /*
-     * Parse lines of the crystal definition before list of atom positions.
-     * The only info we need to pickup here is the #UCELL unit cell parameters.
-     */
-
-    found_it = FALSE;
 
-    while (!feof(fp)) {
-
-      rv = fgets (buffer, 100, fp);
-
-      if (buffer[0] == '#' && buffer[1] == 'L') break;
+    if (crystal == NULL)
+      continue;
 
-      if (buffer[0] == '#' && buffer[1] == 'U' && buffer[2] == 'C' &&
-          buffer[3] == 'E' && buffer[4] == 'L' && buffer[5] == 'L') {
-        ex = sscanf(buffer,"%20s %lf %lf %lf %lf %lf %lf", tag, &crystal->a, &crystal->b, &crystal->c,
-                                                       &crystal->alpha, &crystal->beta, &crystal->gamma);
+    if (!in_atoms) {
+      /*
+       * Parse lines of the crystal definition before list of atom positions.
+       * The only info we need to pickup here is the #UCELL unit cell parameters.
+       */
+      if (strncmp(buffer, "#UCELL", 6) == 0) {
+        double *ucell[6] = {&crystal->a, &crystal->b, &crystal->c, &crystal->alpha, &crystal->beta, &crystal->gamma};
+        char *p = buffer + 6, *end;
+        int ex;
+        /* not sscanf: the numbers must be parsed in the C locale */
+        for (ex = 0; ex < 6; ex++, p = end) {
+          *ucell[ex] = xrl_strtod_c(p, &end);
+          if (end == p)
+            break;
+        }
         if (found_it) {
           xrl_set_error(error, XRL_ERROR_IO, "Multiple #UCELL lines found for crystal %s", crystal->name);
-          return 0;
+          goto end;
         }
-        if (ex != 7) {
+        if (ex != 6) {
           xrl_set_error(error, XRL_ERROR_IO, "Malformed #UCELL line found for crystal %s", crystal->name);
-          return 0;
+          goto end;
         }
         found_it = TRUE;
       }
-
-    }
-
-    /* Error check */
-
-    if (!found_it) {
-      xrl_set_error(error, XRL_ERROR_IO, "No #UCELL line found for crystal %s", crystal->name);
-      return 0;
+      else if (buffer[0] == '#' && buffer[1] == 'L') {
+        if (!found_it) {
+          xrl_set_error(error, XRL_ERROR_IO, "No #UCELL line found for crystal %s", crystal->name);
+          goto end;
+        }
+        in_atoms = TRUE;
+      }
+      continue;
     }
 
-    /* Now read in the atom positions.
-     * First count how many atoms there are and then backup to read in the locations.
-     */
-
-    floc = ftell(fp);  /* Memorize current location in file */
+    /* Atom positions run until the next line starting with # */
 
-    n = 0;
-    while (!feof(fp)) {
-      rv = fgets (buffer, 100, fp);
-
-      if (buffer[0] == '#') break;
-      n++;
+    if (buffer[0] == '#') {
+      if (crystal->n_atom == 0) {
+        xrl_set_error(error, XRL_ERROR_IO, "No atom positions found for crystal %s", crystal->name);
+        goto end;
+      }
+      in_atoms = FALSE;
+      crystal = NULL;
+      continue;
     }
 
-    if (n == 0 && feof(fp)) {
-      xrl_set_error_literal(error, XRL_ERROR_IO, "End of file encountered before definition was complete");
-      return 0;
-    }
+    if (buffer[strspn(buffer, " \t")] == '\0')
+      continue;
 
-    crystal->n_atom = n;
-    crystal->atom = malloc(n * sizeof(Crystal_Atom));
-    if (crystal->atom == NULL) {
-      xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
-      return 0;
+    if (crystal->n_atom == n_atom_alloc) {
+      Crystal_Atom *tmp;
+      n_atom_alloc = n_atom_alloc == 0 ? 8 : 2 * n_atom_alloc;
+      tmp = realloc(crystal->atom, n_atom_alloc * sizeof(Crystal_Atom));
+      if (tmp == NULL) {
+        xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+        goto end;
+      }
+      crystal->atom = tmp;
     }
 
-    /* Now rewind and fill in the array */
-
-    fseek(fp, floc, SEEK_SET);
-
-    for (i = 0; i < n; i++) {
-      atom = &(crystal->atom[i]);
-      ex = fscanf(fp, "%i %lf %lf %lf %lf", &atom->Zatom, &atom->fraction, &atom->x, &atom->y, &atom->z);
-      if (ex != 5) {
-	xrl_set_error(error, XRL_ERROR_IO, "Could not parse atom position on line %d for crystal %s", i, crystal->name);
-        return 0;
-      }
+    if (!Crystal_ParseAtom(buffer, &crystal->atom[crystal->n_atom])) {
+      xrl_set_error(error, XRL_ERROR_IO, "Could not parse atom position on line %d for crystal %s", crystal->n_atom, crystal->name);
+      goto end;
     }
+    crystal->n_atom++;
+  }
 
+  if (len == -2) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    goto end;
   }
 
-  fclose(fp);
+  if (crystal != NULL && crystal->n_atom == 0) {
+    xrl_set_error_literal(error, XRL_ERROR_IO, "End of file encountered before definition was complete");
+    goto end;
+  }
 
   /* Now sort */
 
@@ -679,6 +1453,11 @@ int Crystal_ReadFile(const char* file_name, Crystal_Array* c_array, xrl_error **
     c_array->crystal[i].volume = Crystal_UnitCellVolume(&c_array->crystal[i], NULL);
   }
 
-  return 1;
+  rv = 1;
+
+end:
+  free(buffer);
+  fclose(fp);
+  return rv;
 
 }
@@ -0,0 +1,358 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL ANYONE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Dynamical diffraction by perfect crystals, following the two-beam theory of Zachariasen
+ * (Theory of X-ray diffraction in crystals, 1945), as used in XOP and crystalpy.
+ */
+
+#include "config.h"
+#include "xraylib-crystal-diffraction.h"
+#include "xraylib.h"
+#include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
+
+#include <string.h>
+#include <math.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#define R_E_ANGST (R_E * 1E10)
+#define CM2ANGST 1E8
+/* beyond this, exp(-x) is negligible compared to 1 and a Bragg crystal behaves as semi-infinite */
+#define MAX_EXP_ARG 50.0
+
+static xrlComplex c_make(double re, double im) {
+  xrlComplex rv;
+  rv.re = re;
+  rv.im = im;
+  return rv;
+}
+
+static xrlComplex c_add(xrlComplex x, xrlComplex y) {
+  return c_make(x.re + y.re, x.im + y.im);
+}
+
+static xrlComplex c_sub(xrlComplex x, xrlComplex y) {
+  return c_make(x.re - y.re, x.im - y.im);
+}
+
+static xrlComplex c_scale(xrlComplex x, double s) {
+  return c_make(x.re * s, x.im * s);
+}
+
+static xrlComplex c_div(xrlComplex x, xrlComplex y) {
+  double den = y.re * y.re + y.im * y.im;
+  return c_make((x.re * y.re + x.im * y.im) / den, (x.im * y.re - x.re * y.im) / den);
+}
+
+static xrlComplex c_sqrt(xrlComplex x) {
+  double mod = sqrt(x.re * x.re + x.im * x.im);
+  double re = sqrt(0.5 * (mod + x.re));
+  double im = sqrt(0.5 * (mod - x.re));
+  return c_make(re, x.im < 0.0 ? -im : im);
+}
+
+static double c_abs2(xrlComplex x) {
+  return x.re * x.re + x.im * x.im;
+}
+
+/*
+ * Susceptibilities and geometry of a reflection at a given energy.
+ * All quantities that do not depend on the angle of incidence are gathered here,
+ * so that the angular loop only involves a handful of complex operations.
+ */
+
+typedef struct {
+  double wavelength;          /* Angstrom */
+  double d_spacing;           /* Angstrom */
+  double sin_bragg;           /* sine of the Bragg angle */
+  double gamma_0;             /* direction cosine of the incident beam */
+  double b;                   /* asymmetry factor gamma_0 / gamma_h */
+  xrlComplex psi_0;
+  xrlComplex q;               /* b * C^2 * psi_h * psi_h_bar */
+  xrlComplex c_psi_h_bar;     /* C * psi_h_bar */
+  double thickness;           /* Angstrom */
+  int geometry;
+} Crystal_Dynamical;
+
+static int Crystal_DynamicalCheck(Crystal_Struct* crystal, double thickness, int geometry, int polarization, double debye_factor, xrl_error **error) {
+  if (crystal == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CRYSTAL_NULL);
+    return 0;
+  }
+  if (thickness <= 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_THICKNESS);
+    return 0;
+  }
+  if (geometry != CRYSTAL_GEOMETRY_BRAGG && geometry != CRYSTAL_GEOMETRY_LAUE) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_GEOMETRY);
+    return 0;
+  }
+  if (polarization != CRYSTAL_POLARIZATION_SIGMA && polarization != CRYSTAL_POLARIZATION_PI) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_POLARIZATION);
+    return 0;
+  }
+  if (debye_factor <= 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_DEBYE_FACTOR);
+    return 0;
+  }
+  return 1;
+}
+
+/*
+ * Set up a reflection, given the structure factors F_0, F_H and F_-H.
+ * The direction cosines are evaluated at theta, the glancing angle to the reflecting planes.
+ * Returns 0 if the reflection cannot be excited at this energy.
+ */
+
+static int Crystal_DynamicalInit(Crystal_Dynamical *dyn, Crystal_Struct *crystal, double energy, double d_spacing, double theta, double asymmetry_angle, double thickness, int geometry, int polarization, xrlComplex F_0, xrlComplex F_H, xrlComplex F_H_bar) {
+  double gamma, gamma_h, pol_factor;
+
+  dyn->wavelength = KEV2ANGST / energy;
+  dyn->d_spacing = d_spacing;
+  dyn->sin_bragg = dyn->wavelength / (2.0 * d_spacing);
+  dyn->thickness = thickness * CM2ANGST;
+  dyn->geometry = geometry;
+
+  if (dyn->sin_bragg >= 1.0)
+    return 0;
+
+  if (geometry == CRYSTAL_GEOMETRY_BRAGG) {
+    dyn->gamma_0 = sin(theta + asymmetry_angle);
+    gamma_h = -sin(theta - asymmetry_angle);
+  }
+  else {
+    dyn->gamma_0 = cos(theta - asymmetry_angle);
+    gamma_h = cos(theta + asymmetry_angle);
+  }
+
+  /* the beams must enter the crystal, and for Bragg leave through the entrance surface */
+  if (dyn->gamma_0 <= 0.0 || (geometry == CRYSTAL_GEOMETRY_BRAGG ? gamma_h >= 0.0 : gamma_h <= 0.0))
+    return 0;
+
+  dyn->b = dyn->gamma_0 / gamma_h;
+
+  pol_factor = polarization == CRYSTAL_POLARIZATION_SIGMA ? 1.0 : fabs(cos(2.0 * theta));
+  gamma = -R_E_ANGST * dyn->wavelength * dyn->wavelength / (PI * crystal->volume);
+
+  dyn->psi_0 = c_scale(F_0, gamma);
+  dyn->c_psi_h_bar = c_scale(F_H_bar, gamma * pol_factor);
+  dyn->q = c_scale(c_mul(F_H, F_H_bar), dyn->b * gamma * gamma * pol_factor * pol_factor);
+
+  return 1;
+}
+
+/*
+ * Reflectivity for a photon incident at glancing angle theta to the reflecting planes.
+ */
+
+static double Crystal_DynamicalReflectivity(const Crystal_Dynamical *dyn, double sin_theta) {
+  double alpha, phase_factor;
+  xrlComplex z, sq, x1, x2, amplitude;
+  double dphi_re, dphi_im;
+
+  /* deviation from the exact Bragg condition */
+  alpha = 4.0 * dyn->sin_bragg * (dyn->sin_bragg - sin_theta);
+
+  z = c_add(c_scale(dyn->psi_0, 0.5 * (1.0 - dyn->b)), c_make(0.5 * dyn->b * alpha, 0.0));
+  sq = c_sqrt(c_add(dyn->q, c_mul(z, z)));
+  x1 = c_div(c_sub(sq, z), dyn->c_psi_h_bar);
+  x2 = c_div(c_scale(c_add(sq, z), -1.0), dyn->c_psi_h_bar);
+
+  /* phi_j = 2 pi delta_j / (gamma_0 lambda), with delta_1 - delta_2 = sq */
+  phase_factor = 2.0 * PI * dyn->thickness / (dyn->gamma_0 * dyn->wavelength);
+  dphi_re = sq.re * phase_factor;
+  dphi_im = sq.im * phase_factor;
+
+  if (dyn->geometry == CRYSTAL_GEOMETRY_BRAGG) {
+    /* amplitude = x1 x2 (c2 - c1) / (c2 x2 - c1 x1), with c2 / c1 = exp(i (phi_1 - phi_2) T) */
+    xrlComplex ratio;
+    if (-dphi_im > MAX_EXP_ARG)
+      return c_abs2(x1) / fabs(dyn->b);
+    else if (-dphi_im < -MAX_EXP_ARG)
+      return c_abs2(x2) / fabs(dyn->b);
+    ratio = c_scale(c_make(cos(dphi_re), sin(dphi_re)), exp(-dphi_im));
+    amplitude = c_div(c_mul(c_mul(x1, x2), c_sub(ratio, c_make(1.0, 0.0))), c_sub(c_mul(ratio, x2), x1));
+    return c_abs2(amplitude) / fabs(dyn->b);
+  }
+
+  /* Laue: amplitude = x1 x2 (c1 - c2) / (x2 - x1), with c_j = exp(-i phi_j T) */
+  {
+    double phi_2_re, phi_2_im;
+    xrlComplex c1, c2;
+
+    phi_2_re = 0.5 * (dyn->psi_0.re - z.re - sq.re) * phase_factor;
+    phi_2_im = 0.5 * (dyn->psi_0.im - z.im - sq.im) * phase_factor;
+    c1 = c_scale(c_make(cos(phi_2_re + dphi_re), -sin(phi_2_re + dphi_re)), exp(phi_2_im + dphi_im));
+    c2 = c_scale(c_make(cos(phi_2_re), -sin(phi_2_re)), exp(phi_2_im));
+    amplitude = c_div(c_mul(c_mul(x1, x2), c_sub(c1, c2)), c_sub(x2, x1));
+    return c_abs2(amplitude) / fabs(dyn->b);
+  }
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+static int Crystal_StructureFactors(Crystal_Struct* crystal, double energy, int i_miller, int j_miller, int k_miller, double debye_factor, xrlComplex *F_0, xrlComplex *F_H, xrlComplex *F_H_bar, xrl_error **error) {
+  xrl_error *tmp_error = NULL;
+
+  *F_0 = Crystal_F_H_StructureFactor(crystal, energy, 0, 0, 0, 1.0, 1.0, &tmp_error);
+  if (tmp_error == NULL)
+    *F_H = Crystal_F_H_StructureFactor(crystal, energy, i_miller, j_miller, k_miller, debye_factor, 1.0, &tmp_error);
+  if (tmp_error == NULL)
+    *F_H_bar = Crystal_F_H_StructureFactor(crystal, energy, -i_miller, -j_miller, -k_miller, debye_factor, 1.0, &tmp_error);
+  if (tmp_error != NULL) {
+    xrl_propagate_error(error, tmp_error);
+    return 0;
+  }
+  return 1;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+double Crystal_DarwinWidth(Crystal_Struct* crystal, double energy, int i_miller, int j_miller, int k_miller, double asymmetry_angle, int geometry, int polarization, double debye_factor, xrl_error **error) {
+  XRL_STATS_FUNCTION
+  Crystal_Dynamical dyn;
+  xrlComplex F_0, F_H, F_H_bar;
+  double d_spacing, theta;
+
+  if (!Crystal_DynamicalCheck(crystal, 1.0, geometry, polarization, debye_factor, error))
+    return 0.0;
+
+  if (energy <= 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_ENERGY);
+    return 0.0;
+  }
+
+  if ((d_spacing = Crystal_dSpacing(crystal, i_miller, j_miller, k_miller, error)) == 0.0)
+    return 0.0;
+
+  if (!Crystal_StructureFactors(crystal, energy, i_miller, j_miller, k_miller, debye_factor, &F_0, &F_H, &F_H_bar, error))
+    return 0.0;
+
+  theta = asin(KEV2ANGST / energy / (2.0 * d_spacing));
+  if (!Crystal_DynamicalInit(&dyn, crystal, energy, d_spacing, theta, asymmetry_angle, 1.0, geometry, polarization, F_0, F_H, F_H_bar)) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, REFLECTION_NOT_ACCESSIBLE);
+    return 0.0;
+  }
+
+  /* |z| <= sqrt(|q|), and dz/dtheta = b sin(2 theta_B) */
+  return 2.0 * sqrt(sqrt(c_abs2(dyn.q))) / (fabs(dyn.b) * sin(2.0 * theta));
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+int Crystal_RockingCurve(Crystal_Struct* crystal, double energy, int i_miller, int j_miller, int k_miller, double asymmetry_angle, double thickness, int geometry, int polarization, double debye_factor, const double delta_theta[], int n_delta_theta, double R[], xrl_error **error) {
+  XRL_STATS_FUNCTION
+  Crystal_Dynamical dyn;
+  xrlComplex F_0, F_H, F_H_bar;
+  double d_spacing, theta_bragg;
+  int i;
+
+  if (!Crystal_DynamicalCheck(crystal, thickness, geometry, polarization, debye_factor, error))
+    return 0;
+
+  if (delta_theta == NULL || R == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NULL_ARRAY);
+    return 0;
+  }
+
+  if (n_delta_theta <= 0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_ARRAY_LENGTH);
+    return 0;
+  }
+
+  if (energy <= 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_ENERGY);
+    return 0;
+  }
+
+  if ((d_spacing = Crystal_dSpacing(crystal, i_miller, j_miller, k_miller, error)) == 0.0)
+    return 0;
+
+  /* the structure factors are evaluated once for the whole curve */
+  if (!Crystal_StructureFactors(crystal, energy, i_miller, j_miller, k_miller, debye_factor, &F_0, &F_H, &F_H_bar, error))
+    return 0;
+
+  theta_bragg = asin(KEV2ANGST / energy / (2.0 * d_spacing));
+  if (!Crystal_DynamicalInit(&dyn, crystal, energy, d_spacing, theta_bragg, asymmetry_angle, thickness, geometry, polarization, F_0, F_H, F_H_bar)) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, REFLECTION_NOT_ACCESSIBLE);
+    return 0;
+  }
+
+  for (i = 0; i < n_delta_theta; i++)
+    R[i] = Crystal_DynamicalReflectivity(&dyn, sin(theta_bragg + delta_theta[i]));
+
+  return 1;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+int Crystal_RockingCurve_Energy(Crystal_Struct* crystal, const double energies[], int n_energies, int i_miller, int j_miller, int k_miller, double theta, double asymmetry_angle, double thickness, int geometry, int polarization, double debye_factor, double R[], xrl_error **error) {
+  XRL_STATS_FUNCTION
+  Crystal_Reflection *reflections[3] = {NULL, NULL, NULL};
+  xrlComplex *F = NULL;
+  double d_spacing, sin_theta;
+  int i, rv = 0;
+
+  if (!Crystal_DynamicalCheck(crystal, thickness, geometry, polarization, debye_factor, error))
+    return 0;
+
+  if (energies == NULL || R == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NULL_ARRAY);
+    return 0;
+  }
+
+  if (n_energies <= 0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_ARRAY_LENGTH);
+    return 0;
+  }
+
+  if ((d_spacing = Crystal_dSpacing(crystal, i_miller, j_miller, k_miller, error)) == 0.0)
+    return 0;
+
+  F = malloc(3 * n_energies * sizeof(xrlComplex));
+  if (F == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    return 0;
+  }
+
+  /* F_0, F_H and F_-H for all energies, using prepared reflections */
+  if ((reflections[0] = Crystal_Reflection_New(crystal, 0, 0, 0, 1.0, 1.0, error)) == NULL ||
+      (reflections[1] = Crystal_Reflection_New(crystal, i_miller, j_miller, k_miller, debye_factor, 1.0, error)) == NULL ||
+      (reflections[2] = Crystal_Reflection_New(crystal, -i_miller, -j_miller, -k_miller, debye_factor, 1.0, error)) == NULL)
+    goto end;
+
+  for (i = 0; i < 3; i++) {
+    if (!Crystal_Reflection_F_H_Batch(reflections[i], energies, n_energies, F + i * n_energies, error))
+      goto end;
+  }
+
+  sin_theta = sin(theta);
+
+  for (i = 0; i < n_energies; i++) {
+    Crystal_Dynamical dyn;
+    if (Crystal_DynamicalInit(&dyn, crystal, energies[i], d_spacing, theta, asymmetry_angle, thickness, geometry, polarization, F[i], F[n_energies + i], F[2 * n_energies + i]))
+      R[i] = Crystal_DynamicalReflectivity(&dyn, sin_theta);
+    else
+      R[i] = 0.0;
+  }
+
+  rv = 1;
+
+end:
+  for (i = 0; i < 3; i++)
+    Crystal_Reflection_Free(reflections[i]);
+  free(F);
+  return rv;
+}
@@ -0,0 +1,889 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "config.h"
+#include "xraylib.h"
+#include "xraylib-aux.h"
+#include "xraylib-aux-private.h"
+#include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
+#include "xraylib-crystal-diffraction-private.h"
+#include "xraylib-mmap-private.h"
+#include "xrayvars.h"
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <math.h>
+#include <errno.h>
+
+#define FALSE 0
+#define TRUE 1
+
+/*-------------------------------------------------------------------------------------------------- */
+/*
+ * Binary crystal libraries.
+ *
+ * Layout, in native byte order:
+ *   Crystal_BinaryHeader
+ *   Crystal_BinaryRecord[n_crystal], sorted by name
+ *   Crystal_Atom[n_atom]
+ *   char names[names_size], NULL-terminated names
+ * All sections start at a multiple of 8 bytes, which allows the atoms to be used in place.
+ */
+
+#define CRYSTAL_BINARY_MAGIC "XRLCRYS"
+#define CRYSTAL_BINARY_VERSION 1
+#define CRYSTAL_BINARY_BYTE_ORDER 0x01020304
+
+typedef struct {
+  char magic[8];
+  int version;
+  int byte_order;
+  int sizeof_atom;
+  int n_crystal;
+  int n_atom;
+  int names_size;
+} Crystal_BinaryHeader;
+
+typedef struct {
+  double a, b, c;
+  double alpha, beta, gamma;
+  double volume;
+  int n_atom;
+  int atom_offset;
+  int name_offset;
+  int padding;
+} Crystal_BinaryRecord;
+
+static int compareCrystalPointers(const void *i1, const void *i2) {
+  return strcmp((*(Crystal_Struct * const *) i1)->name, (*(Crystal_Struct * const *) i2)->name);
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+int Crystal_ArrayWriteBinary(Crystal_Array *c_array, const char *file_name, xrl_error **error) {
+  XRL_STATS_FUNCTION
+  Crystal_BinaryHeader header;
+  Crystal_Struct **crystals = NULL;
+  char **names = NULL;
+  FILE *fp = NULL;
+  int i, n_crystal, n_atom = 0, names_size = 0, rv = 0;
+
+  if (file_name == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_IO, "NULL filenames are not allowed");
+    return 0;
+  }
+
+  /* collect the crystals, sorted by name */
+  if (c_array == NULL) {
+    if ((names = Crystal_GetCrystalsList(NULL, &n_crystal, error)) == NULL)
+      return 0;
+  }
+  else {
+    n_crystal = c_array->n_crystal;
+  }
+
+  crystals = malloc((n_crystal + 1) * sizeof(Crystal_Struct *));
+  if (crystals == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    goto end;
+  }
+  for (i = 0; i < n_crystal; i++) {
+    if (c_array == NULL) {
+      if ((crystals[i] = Crystal_GetCrystalShared(names[i], error)) == NULL)
+        goto end;
+    }
+    else {
+      crystals[i] = &c_array->crystal[i];
+    }
+    n_atom += crystals[i]->n_atom;
+    names_size += strlen(crystals[i]->name) + 1;
+  }
+  qsort(crystals, n_crystal, sizeof(Crystal_Struct *), compareCrystalPointers);
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CRYSTAL_BINARY_MAGIC, sizeof(CRYSTAL_BINARY_MAGIC));
+  header.version = CRYSTAL_BINARY_VERSION;
+  header.byte_order = CRYSTAL_BINARY_BYTE_ORDER;
+  header.sizeof_atom = sizeof(Crystal_Atom);
+  header.n_crystal = n_crystal;
+  header.n_atom = n_atom;
+  header.names_size = names_size;
+
+  if ((fp = fopen(file_name, "wb")) == NULL) {
+    xrl_set_error(error, XRL_ERROR_IO, "Could not open %s for writing: %s", file_name, strerror(errno));
+    goto end;
+  }
+
+  if (fwrite(&header, sizeof(header), 1, fp) != 1)
+    goto write_error;
+
+  for (i = 0, n_atom = 0, names_size = 0; i < n_crystal; i++) {
+    Crystal_BinaryRecord record;
+    memset(&record, 0, sizeof(record));
+    record.a = crystals[i]->a;
+    record.b = crystals[i]->b;
+    record.c = crystals[i]->c;
+    record.alpha = crystals[i]->alpha;
+    record.beta = crystals[i]->beta;
+    record.gamma = crystals[i]->gamma;
+    record.volume = crystals[i]->volume;
+    record.n_atom = crystals[i]->n_atom;
+    record.atom_offset = n_atom;
+    record.name_offset = names_size;
+    if (fwrite(&record, sizeof(record), 1, fp) != 1)
+      goto write_error;
+    n_atom += crystals[i]->n_atom;
+    names_size += strlen(crystals[i]->name) + 1;
+  }
+
+  for (i = 0; i < n_crystal; i++) {
+    if (crystals[i]->n_atom > 0 && fwrite(crystals[i]->atom, sizeof(Crystal_Atom), crystals[i]->n_atom, fp) != (size_t) crystals[i]->n_atom)
+      goto write_error;
+  }
+
+  for (i = 0; i < n_crystal; i++) {
+    if (fwrite(crystals[i]->name, strlen(crystals[i]->name) + 1, 1, fp) != 1)
+      goto write_error;
+  }
+
+  if (fclose(fp) != 0) {
+    fp = NULL;
+    goto write_error;
+  }
+  fp = NULL;
+  rv = 1;
+  goto end;
+
+write_error:
+  xrl_set_error(error, XRL_ERROR_IO, "Could not write to %s: %s", file_name, strerror(errno));
+
+end:
+  if (fp != NULL)
+    fclose(fp);
+  if (names != NULL) {
+    for (i = 0; i < n_crystal; i++)
+      xrlFree(names[i]);
+    xrlFree(names);
+  }
+  free(crystals);
+  return rv;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+Crystal_Array* Crystal_ArrayMapBinary(const char *file_name, xrl_error **error) {
+  XRL_STATS_FUNCTION
+  xrl_mapped_file *file;
+  const Crystal_BinaryHeader *header;
+  const Crystal_BinaryRecord *records;
+  const Crystal_Atom *atoms;
+  const char *names;
+  Crystal_MappedArray *mapped;
+  size_t size;
+  int i;
+
+  if ((file = xrl_mapped_file_new(file_name, error)) == NULL)
+    return NULL;
+
+  header = file->data;
+  if (file->size < sizeof(Crystal_BinaryHeader) || memcmp(header->magic, CRYSTAL_BINARY_MAGIC, sizeof(CRYSTAL_BINARY_MAGIC)) != 0) {
+    xrl_set_error(error, XRL_ERROR_IO, "%s is not a binary crystal library", file_name);
+    goto error;
+  }
+  if (header->version != CRYSTAL_BINARY_VERSION || header->byte_order != CRYSTAL_BINARY_BYTE_ORDER || header->sizeof_atom != sizeof(Crystal_Atom)) {
+    xrl_set_error(error, XRL_ERROR_IO, "%s was written by an incompatible version or platform", file_name);
+    goto error;
+  }
+  size = sizeof(Crystal_BinaryHeader);
+  if (header->n_crystal < 0 || header->n_atom < 0 || header->names_size < 0 ||
+    file->size != size + header->n_crystal * sizeof(Crystal_BinaryRecord) + header->n_atom * sizeof(Crystal_Atom) + header->names_size) {
+    xrl_set_error(error, XRL_ERROR_IO, "%s is corrupt", file_name);
+    goto error;
+  }
+
+  records = (const Crystal_BinaryRecord *) (header + 1);
+  atoms = (const Crystal_Atom *) (records + header->n_crystal);
+  names = (const char *) (atoms + header->n_atom);
+
+  mapped = malloc(sizeof(Crystal_MappedArray) + header->n_crystal * sizeof(Crystal_Struct));
+  if (mapped == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    goto error;
+  }
+  mapped->file = file;
+  mapped->array.n_crystal = header->n_crystal;
+  mapped->array.n_alloc = header->n_crystal;
+  mapped->array.crystal = (Crystal_Struct *) (mapped + 1);
+  mapped->array.mapped = 1;
+  mapped->unmap = Crystal_ArrayUnmapBinary;
+
+  /* validate the records while filling in the crystals, which point into the mapped file */
+  for (i = 0; i < header->n_crystal; i++) {
+    Crystal_Struct *crystal = &mapped->array.crystal[i];
+    const Crystal_BinaryRecord *record = &records[i];
+
+    if (record->n_atom <= 0 || record->atom_offset < 0 || record->atom_offset > header->n_atom - record->n_atom ||
+      record->name_offset < 0 || record->name_offset >= header->names_size ||
+      memchr(names + record->name_offset, '\0', header->names_size - record->name_offset) == NULL ||
+      (i > 0 && strcmp(crystal[-1].name, names + record->name_offset) >= 0)) {
+      xrl_set_error(error, XRL_ERROR_IO, "%s is corrupt", file_name);
+      free(mapped);
+      goto error;
+    }
+
+    crystal->name = (char *) names + record->name_offset;
+    crystal->a = record->a;
+    crystal->b = record->b;
+    crystal->c = record->c;
+    crystal->alpha = record->alpha;
+    crystal->beta = record->beta;
+    crystal->gamma = record->gamma;
+    crystal->volume = record->volume;
+    crystal->n_atom = record->n_atom;
+    crystal->atom = (Crystal_Atom *) atoms + record->atom_offset;
+  }
+
+  return &mapped->array;
+
+error:
+  xrl_mapped_file_free(file);
+  return NULL;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+void Crystal_ArrayUnmapBinary(Crystal_Array *c_array) {
+  Crystal_MappedArray *mapped;
+
+  if (c_array == NULL)
+    return;
+  mapped = (Crystal_MappedArray *) ((char *) c_array - offsetof(Crystal_MappedArray, array));
+  xrl_mapped_file_free(mapped->file);
+  free(mapped);
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+/*
+ * CIF importer.
+ *
+ * Only the subset of CIF needed to build a Crystal_Struct is supported:
+ * the unit cell, the symmetry operators and the fractional coordinates and occupancies of the atom sites.
+ * Every data block with atom sites yields one crystal, named after the block.
+ */
+
+#define CIF_POSITION_TOLERANCE 1E-4
+
+typedef struct {
+  char *text;
+  int quoted;
+} CIF_Token;
+
+typedef struct {
+  double rot[3][3];
+  double trans[3];
+} CIF_Symop;
+
+typedef struct {
+  const char *type;
+  const char *x, *y, *z;
+  const char *occupancy;
+} CIF_Site;
+
+typedef struct {
+  const char *name;
+  double cell[6];
+  int cell_found[6];
+  const char **symops;
+  int n_symops, n_symops_alloc;
+  CIF_Site *sites;
+  int n_sites, n_sites_alloc;
+} CIF_Block;
+
+static const char *cif_cell_tags[6] = {
+  "_cell_length_a", "_cell_length_b", "_cell_length_c",
+  "_cell_angle_alpha", "_cell_angle_beta", "_cell_angle_gamma",
+};
+
+/* CIF tags are case-insensitive */
+static int cif_tag_equal(const char *tag, const char *ref) {
+  for (; *tag && *ref; tag++, ref++) {
+    if (tolower((unsigned char) *tag) != *ref)
+      return FALSE;
+  }
+  return *tag == *ref;
+}
+
+/* Reserved words, data_ and save_ are followed by a name */
+static int cif_keyword(const CIF_Token *token, const char *keyword, int prefix) {
+  size_t len = strlen(keyword);
+  int i;
+
+  if (token->quoted)
+    return FALSE;
+  for (i = 0; i < (int) len; i++) {
+    if (tolower((unsigned char) token->text[i]) != keyword[i])
+      return FALSE;
+  }
+  return prefix || token->text[len] == '\0';
+}
+
+/* A token that ends a loop or the value of a tag */
+static int cif_reserved(const CIF_Token *token) {
+  return (!token->quoted && token->text[0] == '_') || cif_keyword(token, "data_", TRUE) || cif_keyword(token, "loop_", FALSE) ||
+    cif_keyword(token, "global_", FALSE) || cif_keyword(token, "save_", TRUE) || cif_keyword(token, "stop_", FALSE);
+}
+
+static int cif_unknown(const char *value) {
+  return value == NULL || strcmp(value, "?") == 0 || strcmp(value, ".") == 0;
+}
+
+/* Parse a number, ignoring a standard uncertainty such as 5.4309(2) */
+static int cif_number(const char *value, double *number) {
+  char *end;
+
+  if (cif_unknown(value))
+    return 0;
+  *number = xrl_strtod_c(value, &end);
+  return end != value && (*end == '\0' || *end == '(');
+}
+
+static int cif_grow(void **array, int *n_alloc, size_t size) {
+  int new_alloc = *n_alloc == 0 ? 16 : 2 * *n_alloc;
+  void *tmp = realloc(*array, new_alloc * size);
+
+  if (tmp == NULL)
+    return 0;
+  *array = tmp;
+  *n_alloc = new_alloc;
+  return 1;
+}
+
+/* Split the file contents into tokens, in place. */
+static int cif_tokenize(char *p, CIF_Token **tokens_out, int *n_tokens, xrl_error **error) {
+  CIF_Token *tokens = NULL;
+  int n = 0, n_alloc = 0, line_start = TRUE;
+
+  while (*p) {
+    CIF_Token token;
+
+    if (*p == '\n' || *p == '\r') {
+      line_start = TRUE;
+      p++;
+      continue;
+    }
+    if (isspace((unsigned char) *p)) {
+      line_start = FALSE;
+      p++;
+      continue;
+    }
+    if (*p == '#') {
+      p += strcspn(p, "\r\n");
+      continue;
+    }
+
+    token.quoted = TRUE;
+    if (*p == ';' && line_start) {
+      /* text field, terminated by a line starting with a semicolon */
+      char *end = p + 1;
+      for (;;) {
+        end = strchr(end, '\n');
+        if (end == NULL || end[1] == ';')
+          break;
+        end++;
+      }
+      if (end == NULL) {
+        xrl_set_error_literal(error, XRL_ERROR_IO, "Unterminated text field in CIF file");
+        free(tokens);
+        return 0;
+      }
+      token.text = p + 1;
+      *end = '\0';
+      p = end + 2;
+    }
+    else if (*p == '\'' || *p == '"') {
+      /* a quote only terminates the string when followed by whitespace */
+      char quote = *p;
+      char *end = p + 1;
+      while (*end && !(*end == quote && (end[1] == '\0' || isspace((unsigned char) end[1]))))
+        end++;
+      if (*end == '\0') {
+        xrl_set_error_literal(error, XRL_ERROR_IO, "Unterminated quoted string in CIF file");
+        free(tokens);
+        return 0;
+      }
+      token.text = p + 1;
+      *end = '\0';
+      p = end + 1;
+    }
+    else {
+      size_t len = strcspn(p, " \t\r\n");
+      token.quoted = FALSE;
+      token.text = p;
+      p += len;
+      if (*p) {
+        if (*p == '\n' || *p == '\r')
+          line_start = TRUE;
+        *p++ = '\0';
+        if (n == n_alloc && !cif_grow((void **) &tokens, &n_alloc, sizeof(CIF_Token)))
+          goto malloc_error;
+        tokens[n++] = token;
+        continue;
+      }
+    }
+
+    line_start = FALSE;
+    if (n == n_alloc && !cif_grow((void **) &tokens, &n_alloc, sizeof(CIF_Token)))
+      goto malloc_error;
+    tokens[n++] = token;
+  }
+
+  *tokens_out = tokens;
+  *n_tokens = n;
+  return 1;
+
+malloc_error:
+  xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+  free(tokens);
+  return 0;
+}
+
+/* Parse a symmetry operator such as "-x+1/2, y, z-1/4" */
+static int cif_parse_symop(const char *text, CIF_Symop *symop) {
+  const char *p = text;
+  int row;
+
+  memset(symop, 0, sizeof(CIF_Symop));
+
+  for (row = 0; row < 3; row++) {
+    double sign = 1.0;
+    int n_terms = 0;
+
+    for (; *p && *p != ','; p++) {
+      char c = (char) tolower((unsigned char) *p);
+
+      if (isspace((unsigned char) c) || c == '\'' || c == '"')
+        continue;
+      else if (c == '+')
+        sign = 1.0;
+      else if (c == '-')
+        sign = -1.0;
+      else if (c == 'x' || c == 'y' || c == 'z') {
+        symop->rot[row][c - 'x'] += sign;
+        sign = 1.0;
+        n_terms++;
+      }
+      else if (isdigit((unsigned char) c) || c == '.') {
+        char *end;
+        double number = xrl_strtod_c(p, &end);
+        if (*end == '/') {
+          const char *denominator = end + 1;
+          double d = xrl_strtod_c(denominator, &end);
+          if (end == denominator || d == 0.0)
+            return 0;
+          number /= d;
+        }
+        p = end;
+        while (isspace((unsigned char) *p) || *p == '*')
+          p++;
+        c = (char) tolower((unsigned char) *p);
+        if (c == 'x' || c == 'y' || c == 'z')
+          symop->rot[row][c - 'x'] += sign * number;
+        else {
+          symop->trans[row] += sign * number;
+          p--;
+        }
+        sign = 1.0;
+        n_terms++;
+      }
+      else
+        return 0;
+    }
+
+    if (n_terms == 0 || (row < 2 && *p != ','))
+      return 0;
+    if (row < 2)
+      p++;
+  }
+
+  return *p == '\0';
+}
+
+/* Map an atom type such as "Fe3+" or a label such as "O1" to an atomic number */
+static int cif_atomic_number(const char *type) {
+  char symbol[3] = {0, 0, 0};
+  int Z = 0;
+
+  if (!isalpha((unsigned char) type[0]))
+    return 0;
+  symbol[0] = (char) toupper((unsigned char) type[0]);
+  if (isalpha((unsigned char) type[1])) {
+    symbol[1] = (char) tolower((unsigned char) type[1]);
+    Z = SymbolToAtomicNumber(symbol, NULL);
+    symbol[1] = '\0';
+  }
+  if (Z == 0)
+    Z = SymbolToAtomicNumber(symbol, NULL);
+  return Z;
+}
+
+static double cif_wrap(double x) {
+  x -= floor(x);
+  return x >= 1.0 ? x - 1.0 : x;
+}
+
+static int cif_same_position(double x1, double x2) {
+  double d = fabs(x1 - x2);
+  return (d < 0.5 ? d : 1.0 - d) < CIF_POSITION_TOLERANCE;
+}
+
+/* Expand the atom sites of a data block into a new crystal */
+static int cif_build_crystal(CIF_Block *block, Crystal_Struct *crystal, xrl_error **error) {
+  CIF_Symop identity = {{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}, {0, 0, 0}};
+  CIF_Symop *symops;
+  int i, j, k, n_symops = block->n_symops > 0 ? block->n_symops : 1, n_atom_alloc = 0;
+  static const double default_cell[6] = {0.0, 0.0, 0.0, 90.0, 90.0, 90.0};
+
+  for (i = 0; i < 6; i++) {
+    if (!block->cell_found[i]) {
+      if (i < 3) {
+        xrl_set_error(error, XRL_ERROR_IO, "Incomplete unit cell in data block %s", block->name);
+        return 0;
+      }
+      block->cell[i] = default_cell[i];
+    }
+  }
+
+  symops = malloc(n_symops * sizeof(CIF_Symop));
+  if (symops == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    return 0;
+  }
+  if (block->n_symops == 0)
+    symops[0] = identity;
+  for (i = 0; i < block->n_symops; i++) {
+    if (!cif_parse_symop(block->symops[i], &symops[i])) {
+      xrl_set_error(error, XRL_ERROR_IO, "Could not parse symmetry operator %s in data block %s", block->symops[i], block->name);
+      free(symops);
+      return 0;
+    }
+  }
+
+  crystal->name = xrl_strdup(block->name);
+  crystal->a = block->cell[0];
+  crystal->b = block->cell[1];
+  crystal->c = block->cell[2];
+  crystal->alpha = block->cell[3];
+  crystal->beta = block->cell[4];
+  crystal->gamma = block->cell[5];
+  crystal->n_atom = 0;
+  crystal->atom = NULL;
+
+  for (i = 0; i < block->n_sites; i++) {
+    CIF_Site *site = &block->sites[i];
+    double pos[3], occupancy = 1.0;
+    int Z = cif_atomic_number(site->type);
+
+    if (Z == 0) {
+      xrl_set_error(error, XRL_ERROR_IO, "Unknown element %s in data block %s", site->type, block->name);
+      goto error;
+    }
+    if (!cif_number(site->x, &pos[0]) || !cif_number(site->y, &pos[1]) || !cif_number(site->z, &pos[2]) ||
+      (!cif_unknown(site->occupancy) && !cif_number(site->occupancy, &occupancy))) {
+      xrl_set_error(error, XRL_ERROR_IO, "Could not parse atom site %s in data block %s", site->type, block->name);
+      goto error;
+    }
+
+    for (j = 0; j < n_symops; j++) {
+      Crystal_Atom atom;
+      double new_pos[3];
+
+      for (k = 0; k < 3; k++)
+        new_pos[k] = cif_wrap(symops[j].rot[k][0] * pos[0] + symops[j].rot[k][1] * pos[1] + symops[j].rot[k][2] * pos[2] + symops[j].trans[k]);
+
+      /* skip positions that were already generated */
+      for (k = 0; k < crystal->n_atom; k++) {
+        Crystal_Atom *other = &crystal->atom[k];
+        if (other->Zatom == Z && cif_same_position(other->x, new_pos[0]) && cif_same_position(other->y, new_pos[1]) && cif_same_position(other->z, new_pos[2]))
+          break;
+      }
+      if (k < crystal->n_atom)
+        continue;
+
+      if (crystal->n_atom == n_atom_alloc && !cif_grow((void **) &crystal->atom, &n_atom_alloc, sizeof(Crystal_Atom))) {
+        xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+        goto error;
+      }
+      atom.Zatom = Z;
+      atom.fraction = occupancy;
+      atom.x = new_pos[0];
+      atom.y = new_pos[1];
+      atom.z = new_pos[2];
+      crystal->atom[crystal->n_atom++] = atom;
+    }
+  }
+
+  crystal->volume = Crystal_UnitCellVolume(crystal, NULL);
+  free(symops);
+  return 1;
+
+error:
+  free(symops);
+  free(crystal->name);
+  free(crystal->atom);
+  return 0;
+}
+
+/* Add a finished crystal to c_array, overwriting an existing crystal with the same name */
+static int cif_add_crystal(Crystal_Struct *crystal, Crystal_Array *c_array, xrl_error **error) {
+  int i;
+
+  for (i = 0; i < c_array->n_crystal; i++) {
+    if (strcmp(c_array->crystal[i].name, crystal->name) == 0) {
+      free(c_array->crystal[i].name);
+      free(c_array->crystal[i].atom);
+      c_array->crystal[i] = *crystal;
+      return 1;
+    }
+  }
+
+  if (c_array->n_crystal == c_array->n_alloc &&
+    !Crystal_ExtendArray(c_array, c_array->n_alloc > N_NEW_CRYSTAL ? c_array->n_alloc : N_NEW_CRYSTAL, error)) {
+    free(crystal->name);
+    free(crystal->atom);
+    return 0;
+  }
+  c_array->crystal[c_array->n_crystal++] = *crystal;
+  return 1;
+}
+
+static int cif_finish_block(CIF_Block *block, Crystal_Array *c_array, int *n_crystals, xrl_error **error) {
+  Crystal_Struct crystal;
+  int rv = 1;
+
+  if (block->name != NULL && block->n_sites > 0) {
+    rv = cif_build_crystal(block, &crystal, error) && cif_add_crystal(&crystal, c_array, error);
+    if (rv)
+      (*n_crystals)++;
+  }
+
+  free(block->symops);
+  free(block->sites);
+  memset(block, 0, sizeof(CIF_Block));
+  return rv;
+}
+
+/* Handle a loop_ whose n_tags tags start at tokens[0], followed by n_values values */
+static int cif_parse_loop(CIF_Block *block, CIF_Token *tokens, int n_tags, int n_values, xrl_error **error) {
+  int i, symop = -1, type = -1, label = -1, x = -1, y = -1, z = -1, occupancy = -1;
+  CIF_Token *values = tokens + n_tags;
+
+  for (i = 0; i < n_tags; i++) {
+    const char *tag = tokens[i].text;
+    if (cif_tag_equal(tag, "_symmetry_equiv_pos_as_xyz") || cif_tag_equal(tag, "_space_group_symop_operation_xyz"))
+      symop = i;
+    else if (cif_tag_equal(tag, "_atom_site_type_symbol"))
+      type = i;
+    else if (cif_tag_equal(tag, "_atom_site_label"))
+      label = i;
+    else if (cif_tag_equal(tag, "_atom_site_fract_x"))
+      x = i;
+    else if (cif_tag_equal(tag, "_atom_site_fract_y"))
+      y = i;
+    else if (cif_tag_equal(tag, "_atom_site_fract_z"))
+      z = i;
+    else if (cif_tag_equal(tag, "_atom_site_occupancy"))
+      occupancy = i;
+  }
+
+  if (n_values % n_tags != 0) {
+    xrl_set_error(error, XRL_ERROR_IO, "Malformed loop in data block %s", block->name);
+    return 0;
+  }
+
+  if (symop >= 0) {
+    for (i = symop; i < n_values; i += n_tags) {
+      if (block->n_symops == block->n_symops_alloc && !cif_grow((void **) &block->symops, &block->n_symops_alloc, sizeof(char *)))
+        goto malloc_error;
+      block->symops[block->n_symops++] = values[i].text;
+    }
+  }
+
+  if (x >= 0 || y >= 0 || z >= 0) {
+    if (x < 0 || y < 0 || z < 0 || (type < 0 && label < 0)) {
+      xrl_set_error(error, XRL_ERROR_IO, "Incomplete atom site loop in data block %s", block->name);
+      return 0;
+    }
+    for (i = 0; i < n_values; i += n_tags) {
+      CIF_Site *site;
+      if (block->n_sites == block->n_sites_alloc && !cif_grow((void **) &block->sites, &block->n_sites_alloc, sizeof(CIF_Site)))
+        goto malloc_error;
+      site = &block->sites[block->n_sites++];
+      site->type = values[i + (type >= 0 ? type : label)].text;
+      site->x = values[i + x].text;
+      site->y = values[i + y].text;
+      site->z = values[i + z].text;
+      site->occupancy = occupancy >= 0 ? values[i + occupancy].text : NULL;
+    }
+  }
+
+  return 1;
+
+malloc_error:
+  xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+  return 0;
+}
+
+static int cif_parse_item(CIF_Block *block, const char *tag, const char *value) {
+  int i;
+
+  for (i = 0; i < 6; i++) {
+    if (cif_tag_equal(tag, cif_cell_tags[i])) {
+      block->cell_found[i] = cif_number(value, &block->cell[i]);
+      return 1;
+    }
+  }
+
+  if (cif_tag_equal(tag, "_symmetry_equiv_pos_as_xyz") || cif_tag_equal(tag, "_space_group_symop_operation_xyz")) {
+    if (block->n_symops == block->n_symops_alloc && !cif_grow((void **) &block->symops, &block->n_symops_alloc, sizeof(char *)))
+      return 0;
+    block->symops[block->n_symops++] = value;
+  }
+
+  return 1;
+}
+
+static int cif_parse(CIF_Token *tokens, int n_tokens, Crystal_Array *c_array, const char *file_name, xrl_error **error) {
+  CIF_Block block;
+  int i = 0, n_crystals = 0;
+
+  memset(&block, 0, sizeof(CIF_Block));
+
+  while (i < n_tokens) {
+    CIF_Token *token = &tokens[i];
+
+    if (cif_keyword(token, "data_", TRUE)) {
+      if (!cif_finish_block(&block, c_array, &n_crystals, error))
+        return 0;
+      block.name = token->text + 5;
+      i++;
+    }
+    else if (block.name == NULL) {
+      /* anything before the first data block is ignored */
+      i++;
+    }
+    else if (cif_keyword(token, "loop_", FALSE)) {
+      int n_tags = 0, n_values = 0;
+      i++;
+      while (i + n_tags < n_tokens && !tokens[i + n_tags].quoted && tokens[i + n_tags].text[0] == '_')
+        n_tags++;
+      while (i + n_tags + n_values < n_tokens && !cif_reserved(&tokens[i + n_tags + n_values]))
+        n_values++;
+      if (n_tags == 0) {
+        xrl_set_error(error, XRL_ERROR_IO, "Malformed loop in data block %s", block.name);
+        goto error;
+      }
+      if (!cif_parse_loop(&block, &tokens[i], n_tags, n_values, error))
+        goto error;
+      i += n_tags + n_values;
+    }
+    else if (!token->quoted && token->text[0] == '_') {
+      if (i + 1 == n_tokens || cif_reserved(&tokens[i + 1])) {
+        xrl_set_error(error, XRL_ERROR_IO, "Missing value for %s in data block %s", token->text, block.name);
+        goto error;
+      }
+      if (!cif_parse_item(&block, token->text, tokens[i + 1].text)) {
+        xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+        goto error;
+      }
+      i += 2;
+    }
+    else {
+      i++;
+    }
+  }
+
+  if (!cif_finish_block(&block, c_array, &n_crystals, error))
+    return 0;
+
+  if (n_crystals == 0) {
+    xrl_set_error(error, XRL_ERROR_IO, "No crystal structures found in %s", file_name);
+    return 0;
+  }
+
+  return 1;
+
+error:
+  free(block.symops);
+  free(block.sites);
+  return 0;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+int Crystal_ReadCIF(const char *file_name, Crystal_Array *c_array, xrl_error **error) {
+  XRL_STATS_FUNCTION
+  xrl_mapped_file *file;
+  CIF_Token *tokens = NULL;
+  char *contents;
+  int n_tokens = 0, rv;
+
+  if (file_name == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_IO, "NULL filenames are not allowed");
+    return 0;
+  }
+
+  if (c_array == NULL) {
+    /* read into a private array first: the official crystals are only updated if the whole file is valid */
+    Crystal_Array *c_array_tmp = Crystal_ArrayInit(N_NEW_CRYSTAL, error);
+    if (c_array_tmp == NULL)
+      return 0;
+    rv = Crystal_ReadCIF(file_name, c_array_tmp, error) && Crystal_RegistryAdd(c_array_tmp, TRUE, error);
+    Crystal_ArrayFree(c_array_tmp);
+    return rv;
+  }
+
+  if (c_array->mapped) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CRYSTAL_ARRAY_MAPPED);
+    return 0;
+  }
+
+  /* the tokenizer works in place, on a NULL-terminated copy */
+  if ((file = xrl_mapped_file_new(file_name, error)) == NULL)
+    return 0;
+  contents = malloc(file->size + 1);
+  if (contents == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    xrl_mapped_file_free(file);
+    return 0;
+  }
+  memcpy(contents, file->data, file->size);
+  contents[file->size] = '\0';
+  xrl_mapped_file_free(file);
+
+  if (!cif_tokenize(contents, &tokens, &n_tokens, error)) {
+    free(contents);
+    return 0;
+  }
+
+  rv = cif_parse(tokens, n_tokens, c_array, file_name, error);
+  if (rv)
+    qsort(c_array->crystal, c_array->n_crystal, sizeof(Crystal_Struct), compareCrystalStructs);
+
+  free(tokens);
+  free(contents);
+  return rv;
+}
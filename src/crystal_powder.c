@@ -0,0 +1,575 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL ANYONE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "config.h"
+#include "xraylib-crystal-diffraction.h"
+#include "xraylib.h"
+#include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
+
+#include <string.h>
+#include <math.h>
+#include <stdlib.h>
+#include <errno.h>
+
+/* reflections with a smaller |F|^2, relative to |F_000|^2, vanish because of the special positions of the atoms */
+#define POWDER_ABSENT 1E-12
+/* relative tolerance of the d-spacings, used only to order the reflections */
+#define POWDER_D_TOLERANCE 1E-9
+/* tolerance on fractional coordinates when looking for the symmetry operations of a crystal */
+#define POWDER_POSITION_TOLERANCE 2E-3
+/* tolerance on the metric tensor, relative to its largest element */
+#define POWDER_METRIC_TOLERANCE 1E-6
+/* the rotations of all point groups fit in the holohedry of the cubic or hexagonal lattice */
+#define POWDER_MAX_ROTATIONS 48
+
+/* A symmetry operation x' = R x + t of a crystal, in fractional coordinates. */
+
+typedef struct {
+  int R[3][3];
+  double t[3];
+} powder_operation;
+
+static int compare_miller(const Crystal_PowderReflection *a, const Crystal_PowderReflection *b) {
+  if (a->h != b->h)
+    return a->h - b->h;
+  if (a->k != b->k)
+    return a->k - b->k;
+  return a->l - b->l;
+}
+
+/* by increasing 2 theta, and by decreasing Miller indices for reflections with the same d-spacing that are not equivalent,
+ * whose d-spacings may differ in the last digits
+ */
+
+static int compare_d_spacing(const void *a, const void *b) {
+  const Crystal_PowderReflection *ra = a, *rb = b;
+  if (ra->d_spacing - rb->d_spacing > POWDER_D_TOLERANCE * rb->d_spacing)
+    return -1;
+  else if (rb->d_spacing - ra->d_spacing > POWDER_D_TOLERANCE * ra->d_spacing)
+    return 1;
+  return -compare_miller(ra, rb);
+}
+
+static int powder_same_position(const double x[3], const double y[3]) {
+  int i;
+  for (i = 0; i < 3; i++) {
+    double d = x[i] - y[i];
+    if (fabs(d - floor(d + 0.5)) > POWDER_POSITION_TOLERANCE)
+      return 0;
+  }
+  return 1;
+}
+
+static int powder_same_species(const Crystal_Atom *a, const Crystal_Atom *b) {
+  return a->Zatom == b->Zatom && fabs(a->fraction - b->fraction) <= POWDER_POSITION_TOLERANCE;
+}
+
+/* Private function that checks whether x' = R x + t maps every atom onto an atom of the same species. */
+
+static int powder_is_operation(const Crystal_Struct *crystal, int R[3][3], const double t[3]) {
+  int i, j, m;
+
+  for (i = 0; i < crystal->n_atom; i++) {
+    const Crystal_Atom *atom = &crystal->atom[i];
+    double x[3] = {atom->x, atom->y, atom->z}, y[3];
+
+    for (m = 0; m < 3; m++)
+      y[m] = R[m][0] * x[0] + R[m][1] * x[1] + R[m][2] * x[2] + t[m];
+    for (j = 0; j < crystal->n_atom; j++) {
+      double z[3] = {crystal->atom[j].x, crystal->atom[j].y, crystal->atom[j].z};
+      if (powder_same_species(atom, &crystal->atom[j]) && powder_same_position(y, z))
+        break;
+    }
+    if (j == crystal->n_atom)
+      return 0;
+  }
+  return 1;
+}
+
+/* Private function that finds the symmetry operations of a crystal from its atoms, as a space group is not part of Crystal_Struct.
+ * The rotations are the integer matrices with elements -1, 0 and 1 that preserve the metric of the lattice,
+ * which covers the point groups of all conventional cells. Each rotation is tried with the translations
+ * that map an atom of the least frequent species onto another one: these include the centering translations,
+ * screw axes and glide planes. The operations are returned in ops, which is allocated, or NULL on error.
+ */
+
+static powder_operation *powder_symmetry(const Crystal_Struct *crystal, int *n_ops) {
+  double G[3][3], G_max;
+  int vectors[26][3], n_vectors = 0, column[3][26], n_column[3] = {0, 0, 0};
+  int anchor = 0, n_anchor = 0, n_alloc, i, j, m, c0, c1, c2;
+  powder_operation *ops;
+
+  /* the metric tensor, from the cell in degrees */
+  G[0][0] = crystal->a * crystal->a;
+  G[1][1] = crystal->b * crystal->b;
+  G[2][2] = crystal->c * crystal->c;
+  G[0][1] = G[1][0] = crystal->a * crystal->b * cos(crystal->gamma * PI / 180.0);
+  G[0][2] = G[2][0] = crystal->a * crystal->c * cos(crystal->beta * PI / 180.0);
+  G[1][2] = G[2][1] = crystal->b * crystal->c * cos(crystal->alpha * PI / 180.0);
+  G_max = fmax(G[0][0], fmax(G[1][1], G[2][2]));
+
+  /* the columns of R are the images of the basis vectors, which keep their lengths */
+  for (i = 0; i < 27; i++) {
+    int v[3] = {i / 9 - 1, i / 3 % 3 - 1, i % 3 - 1};
+    if (i == 13)
+      continue;
+    memcpy(vectors[n_vectors], v, sizeof(v));
+    for (j = 0; j < 3; j++) {
+      double length = 0.0;
+      for (m = 0; m < 9; m++)
+        length += v[m / 3] * G[m / 3][m % 3] * v[m % 3];
+      if (fabs(length - G[j][j]) <= POWDER_METRIC_TOLERANCE * G_max)
+        column[j][n_column[j]++] = n_vectors;
+    }
+    n_vectors++;
+  }
+
+  /* the anchor is an atom of the species with the fewest atoms */
+  for (i = 0; i < crystal->n_atom; i++) {
+    int n = 0;
+    for (j = 0; j < crystal->n_atom; j++)
+      n += powder_same_species(&crystal->atom[i], &crystal->atom[j]);
+    if (n_anchor == 0 || n < n_anchor) {
+      anchor = i;
+      n_anchor = n;
+    }
+  }
+
+  n_alloc = POWDER_MAX_ROTATIONS * (n_anchor > 0 ? n_anchor : 1);
+  if ((ops = malloc(n_alloc * sizeof(powder_operation))) == NULL)
+    return NULL;
+  *n_ops = 0;
+
+  for (c0 = 0; c0 < n_column[0]; c0++) {
+    for (c1 = 0; c1 < n_column[1]; c1++) {
+      for (c2 = 0; c2 < n_column[2]; c2++) {
+        const int *col[3] = {vectors[column[0][c0]], vectors[column[1][c1]], vectors[column[2][c2]]};
+        int R[3][3], det, ok = 1;
+
+        for (i = 0; i < 3; i++)
+          for (j = 0; j < 3; j++)
+            R[i][j] = col[j][i];
+        det = R[0][0] * (R[1][1] * R[2][2] - R[1][2] * R[2][1]) - R[0][1] * (R[1][0] * R[2][2] - R[1][2] * R[2][0]) + R[0][2] * (R[1][0] * R[2][1] - R[1][1] * R[2][0]);
+        if (det != 1 && det != -1)
+          continue;
+        /* the angles between the basis vectors are kept as well */
+        for (i = 0; i < 3 && ok; i++) {
+          for (j = i + 1; j < 3 && ok; j++) {
+            double product = 0.0;
+            for (m = 0; m < 9; m++)
+              product += col[i][m / 3] * G[m / 3][m % 3] * col[j][m % 3];
+            ok = fabs(product - G[i][j]) <= POWDER_METRIC_TOLERANCE * G_max;
+          }
+        }
+        if (!ok || *n_ops + (n_anchor > 0 ? n_anchor : 1) > n_alloc)
+          continue;
+
+        if (n_anchor == 0) {
+          powder_operation *op = &ops[(*n_ops)++];
+          memcpy(op->R, R, sizeof(R));
+          op->t[0] = op->t[1] = op->t[2] = 0.0;
+          continue;
+        }
+
+        for (j = 0; j < crystal->n_atom; j++) {
+          const Crystal_Atom *from = &crystal->atom[anchor], *to = &crystal->atom[j];
+          double x[3] = {from->x, from->y, from->z}, y[3] = {to->x, to->y, to->z}, t[3];
+
+          if (!powder_same_species(from, to))
+            continue;
+          /* the translations of space groups are multiples of 1/12, which absorbs the rounding of the atom positions */
+          for (m = 0; m < 3; m++) {
+            double u = y[m] - (R[m][0] * x[0] + R[m][1] * x[1] + R[m][2] * x[2]);
+            u -= floor(u);
+            if (fabs(12.0 * u - floor(12.0 * u + 0.5)) <= 12.0 * POWDER_POSITION_TOLERANCE)
+              u = floor(12.0 * u + 0.5) / 12.0;
+            t[m] = u >= 1.0 ? u - 1.0 : u;
+          }
+          if (powder_is_operation(crystal, R, t)) {
+            powder_operation *op = &ops[(*n_ops)++];
+            memcpy(op->R, R, sizeof(R));
+            memcpy(op->t, t, sizeof(t));
+          }
+        }
+      }
+    }
+  }
+
+  return ops;
+}
+
+/* Private function that collects the rotations of the Laue class, {R} and {-R}, from the symmetry operations. */
+
+static int powder_laue_class(const powder_operation *ops, int n_ops, int laue[2 * POWDER_MAX_ROTATIONS][3][3]) {
+  int n = 0, i, j, m, sign;
+
+  for (i = 0; i < n_ops; i++) {
+    for (sign = 1; sign >= -1; sign -= 2) {
+      int R[3][3];
+      for (m = 0; m < 9; m++)
+        R[m / 3][m % 3] = sign * ops[i].R[m / 3][m % 3];
+      for (j = 0; j < n; j++) {
+        if (memcmp(laue[j], R, sizeof(R)) == 0)
+          break;
+      }
+      if (j == n && n < 2 * POWDER_MAX_ROTATIONS)
+        memcpy(laue[n++], R, sizeof(R));
+    }
+  }
+  return n;
+}
+
+/* Private function that returns 0 if (h, k, l) is not the largest reflection of its orbit under the Laue class,
+ * which is the one that represents the orbit, and otherwise its multiplicity: the number of reflections in the orbit.
+ * Reflections transform as row vectors: h' = h R.
+ */
+
+static int powder_orbit(int laue[][3][3], int n_laue, const int hkl[3]) {
+  int i, m, stabilizer = 0;
+
+  for (i = 0; i < n_laue; i++) {
+    int image[3];
+    for (m = 0; m < 3; m++)
+      image[m] = hkl[0] * laue[i][0][m] + hkl[1] * laue[i][1][m] + hkl[2] * laue[i][2][m];
+    for (m = 0; m < 3 && image[m] == hkl[m]; m++)
+      ;
+    if (m == 3)
+      stabilizer++;
+    else if (image[m] > hkl[m])
+      return 0;
+  }
+  return n_laue / stabilizer;
+}
+
+/* Private function that checks the reflection conditions of the symmetry operations:
+ * if h R = h, then F(h) = exp(2 pi i h . t) F(h), and F(h) vanishes unless h . t is an integer.
+ */
+
+static int powder_absent(const powder_operation *ops, int n_ops, const int hkl[3]) {
+  int i, m;
+
+  for (i = 0; i < n_ops; i++) {
+    double phase;
+    for (m = 0; m < 3; m++) {
+      if (hkl[0] * ops[i].R[0][m] + hkl[1] * ops[i].R[1][m] + hkl[2] * ops[i].R[2][m] != hkl[m])
+        break;
+    }
+    if (m < 3)
+      continue;
+    phase = hkl[0] * ops[i].t[0] + hkl[1] * ops[i].t[1] + hkl[2] * ops[i].t[2];
+    if (fabs(phase - floor(phase + 0.5)) > 1E-6)
+      return 1;
+  }
+  return 0;
+}
+
+/* Private function returning the range of l for which 1 / d^2 = q(h, k, l) may not exceed q_max, or 0 if there is none.
+ * q is the quadratic form of the reciprocal metric, given by its coefficients g11, g22, g33, g12, g13 and g23.
+ * The range is widened by one on each side, to be safe from rounding: the caller still checks d itself.
+ */
+
+static int powder_l_range(const double g[6], int h, int k, double q_max, int *l_lo, int *l_hi) {
+  double b = h * g[4] + k * g[5];
+  double c = h * h * g[0] + k * k * g[1] + 2.0 * h * k * g[3] - q_max;
+  double disc = b * b - g[2] * c;
+
+  if (disc < 0.0)
+    return 0;
+  *l_lo = (int) floor((-b - sqrt(disc)) / g[2]) - 1;
+  *l_hi = (int) ceil((-b + sqrt(disc)) / g[2]) + 1;
+  return 1;
+}
+
+/* Private function that appends a Friedel pair, growing the arrays when needed. */
+
+static int powder_append(int **miller, Crystal_PowderReflection **reflections, int *n, int *n_alloc, int h, int k, int l, double d) {
+  if (*n / 2 == *n_alloc) {
+    int n_alloc_new = 2 * *n_alloc;
+    int *miller_new = realloc(*miller, 6 * n_alloc_new * sizeof(int));
+    Crystal_PowderReflection *reflections_new;
+
+    if (miller_new == NULL)
+      return 0;
+    *miller = miller_new;
+    if ((reflections_new = realloc(*reflections, n_alloc_new * sizeof(Crystal_PowderReflection))) == NULL)
+      return 0;
+    *reflections = reflections_new;
+    *n_alloc = n_alloc_new;
+  }
+
+  (*miller)[3 * *n] = h;
+  (*miller)[3 * *n + 1] = k;
+  (*miller)[3 * *n + 2] = l;
+  (*miller)[3 * *n + 3] = -h;
+  (*miller)[3 * *n + 4] = -k;
+  (*miller)[3 * *n + 5] = -l;
+  (*reflections)[*n / 2].h = h;
+  (*reflections)[*n / 2].k = k;
+  (*reflections)[*n / 2].l = l;
+  (*reflections)[*n / 2].d_spacing = d;
+  *n += 2;
+  return 1;
+}
+
+/* reflections per structure factor batch, which are spread over the threads */
+#define POWDER_CHUNK 256
+
+/*-------------------------------------------------------------------------------------------------- */
+
+Crystal_PowderReflection* Crystal_PowderReflections(Crystal_Struct* crystal, double energy, double d_min, double debye_factor, int *n_reflections, xrl_error **error) {
+  XRL_STATS_FUNCTION
+  Crystal_PowderReflection *reflections = NULL;
+  xrlComplex *F_H = NULL, F_000;
+  powder_operation *ops = NULL;
+  int laue[2 * POWDER_MAX_ROTATIONS][3][3];
+  int *miller = NULL;
+  int h_max, k_max, h, k, l, l_lo, l_hi, i, j, n, n_alloc, n_ops, n_laue, n_chunks, failed = 0;
+  double wavelength, F2_000, q_max, g[6];
+
+  if (crystal == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CRYSTAL_NULL);
+    return NULL;
+  }
+
+  if (energy <= 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_ENERGY);
+    return NULL;
+  }
+
+  if (d_min <= 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_D_MIN);
+    return NULL;
+  }
+
+  if (debye_factor <= 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_DEBYE_FACTOR);
+    return NULL;
+  }
+
+  if (n_reflections == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, "n_reflections cannot be NULL");
+    return NULL;
+  }
+
+  /* reflections with d < lambda / 2 cannot be excited */
+  wavelength = KEV2ANGST / energy;
+  if (d_min < wavelength / 2.0)
+    d_min = wavelength / 2.0;
+  q_max = 1.0 / (d_min * d_min);
+
+  /* |h| = |a . G| <= a / d */
+  h_max = (int) (crystal->a / d_min);
+  k_max = (int) (crystal->b / d_min);
+
+  /* 1 / d^2 is a quadratic form in h, k and l, whose coefficients follow from a few d-spacings */
+  g[0] = 1.0 / pow(Crystal_dSpacing(crystal, 1, 0, 0, NULL), 2);
+  g[1] = 1.0 / pow(Crystal_dSpacing(crystal, 0, 1, 0, NULL), 2);
+  g[2] = 1.0 / pow(Crystal_dSpacing(crystal, 0, 0, 1, NULL), 2);
+  g[3] = 0.5 * (1.0 / pow(Crystal_dSpacing(crystal, 1, 1, 0, NULL), 2) - g[0] - g[1]);
+  g[4] = 0.5 * (1.0 / pow(Crystal_dSpacing(crystal, 1, 0, 1, NULL), 2) - g[0] - g[2]);
+  g[5] = 0.5 * (1.0 / pow(Crystal_dSpacing(crystal, 0, 1, 1, NULL), 2) - g[1] - g[2]);
+
+  if ((ops = powder_symmetry(crystal, &n_ops)) == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    return NULL;
+  }
+  n_laue = powder_laue_class(ops, n_ops, laue);
+
+  /* start from the number of orbits within the limiting sphere, of volume 4 pi / 3 / d_min^3 in units of the reciprocal cell */
+  n_alloc = (int) (4.0 * PI / 3.0 * crystal->volume / (d_min * d_min * d_min) / n_laue) + 16;
+  miller = malloc(6 * n_alloc * sizeof(int));
+  reflections = malloc(n_alloc * sizeof(Crystal_PowderReflection));
+  if (miller == NULL || reflections == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    goto fail;
+  }
+
+  /* Walk the rows of l within the limiting sphere, on the side of the Friedel pairs that holds the largest reflection
+   * of every orbit, and keep the orbits that are not systematically absent, before any structure factor is computed.
+   * Every orbit is represented by its largest reflection and the opposite one, whose structure factors differ
+   * when anomalous scattering is important.
+   */
+  n = 0;
+  for (h = 0; h <= h_max; h++) {
+    for (k = h == 0 ? 0 : -k_max; k <= k_max; k++) {
+      if (!powder_l_range(g, h, k, q_max, &l_lo, &l_hi))
+        continue;
+      if (h == 0 && k == 0 && l_lo < 1)
+        l_lo = 1;
+      for (l = l_lo; l <= l_hi; l++) {
+        int hkl[3] = {h, k, l}, multiplicity;
+        double d;
+
+        if ((multiplicity = powder_orbit(laue, n_laue, hkl)) == 0 || powder_absent(ops, n_ops, hkl))
+          continue;
+        d = Crystal_dSpacing(crystal, h, k, l, NULL);
+        if (d < d_min)
+          continue;
+        if (!powder_append(&miller, &reflections, &n, &n_alloc, h, k, l, d)) {
+          xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+          goto fail;
+        }
+        reflections[n / 2 - 1].multiplicity = multiplicity;
+      }
+    }
+  }
+
+  free(ops);
+  ops = NULL;
+
+  if (n == 0) {
+    free(miller);
+    *n_reflections = 0;
+    return reflections;
+  }
+
+  /* all structure factors in one go, sharing f' and f'' */
+  F_H = malloc(n * sizeof(xrlComplex));
+  if (F_H == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    goto fail;
+  }
+  /* the reflections are independent of each other */
+  n_chunks = (n + POWDER_CHUNK - 1) / POWDER_CHUNK;
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic) if (n_chunks > 1)
+#endif
+  for (i = 0; i < n_chunks; i++) {
+    int first = i * POWDER_CHUNK, count = n - first < POWDER_CHUNK ? n - first : POWDER_CHUNK;
+    if (!Crystal_F_H_StructureFactor_Batch(crystal, energy, miller + 3 * first, count, debye_factor, 1.0, F_H + first, NULL)) {
+#ifdef _OPENMP
+      #pragma omp atomic write
+#endif
+      failed = 1;
+    }
+  }
+  /* repeated in one go, for the error */
+  if (failed && !Crystal_F_H_StructureFactor_Batch(crystal, energy, miller, n, debye_factor, 1.0, F_H, error))
+    goto fail;
+
+  F_000 = Crystal_F_H_StructureFactor(crystal, energy, 0, 0, 0, 1.0, 1.0, NULL);
+  F2_000 = F_000.re * F_000.re + F_000.im * F_000.im;
+
+  /* average over the Friedel pair, which is the average over the orbit,
+   * and drop the reflections that vanish because of the special positions of the atoms (222 of Si)
+   */
+  n /= 2;
+  for (i = 0, j = 0; i < n; i++) {
+    double F2 = 0.5 * (F_H[2 * i].re * F_H[2 * i].re + F_H[2 * i].im * F_H[2 * i].im +
+                       F_H[2 * i + 1].re * F_H[2 * i + 1].re + F_H[2 * i + 1].im * F_H[2 * i + 1].im);
+    if (F2 <= POWDER_ABSENT * F2_000)
+      continue;
+    reflections[j] = reflections[i];
+    reflections[j].F2 = F2;
+    j++;
+  }
+  n = j;
+
+  qsort(reflections, n, sizeof(Crystal_PowderReflection), compare_d_spacing);
+
+  /* angles and intensities, including the Lorentz-polarization factor for an unpolarized beam */
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static) if (n > POWDER_CHUNK)
+#endif
+  for (i = 0; i < n; i++) {
+    Crystal_PowderReflection *r = &reflections[i];
+    double theta = asin(wavelength / (2.0 * r->d_spacing));
+    double cos_2theta = cos(2.0 * theta);
+    r->two_theta = 2.0 * theta;
+    r->intensity = r->multiplicity * r->F2 * (1.0 + cos_2theta * cos_2theta) / (sin(theta) * sin(theta) * cos(theta));
+  }
+
+  free(F_H);
+  free(miller);
+  *n_reflections = n;
+
+  return reflections;
+
+fail:
+  free(ops);
+  free(F_H);
+  free(miller);
+  free(reflections);
+  return NULL;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+int Crystal_PowderProfile(const Crystal_PowderReflection reflections[], int n_reflections, double fwhm, double eta, const double two_theta[], int n_two_theta, double profile[], xrl_error **error) {
+  XRL_STATS_FUNCTION
+  double sigma, gamma, gauss_norm, lorentz_norm, window;
+  int i, j;
+
+  if (reflections == NULL || two_theta == NULL || profile == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NULL_ARRAY);
+    return 0;
+  }
+
+  if (n_reflections < 0 || n_two_theta <= 0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_ARRAY_LENGTH);
+    return 0;
+  }
+
+  if (fwhm <= 0.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, "fwhm must be strictly positive");
+    return 0;
+  }
+
+  if (eta < 0.0 || eta > 1.0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, "eta must be between 0 and 1");
+    return 0;
+  }
+
+  for (j = 1; j < n_two_theta; j++) {
+    if (two_theta[j] < two_theta[j - 1]) {
+      xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, "two_theta must be sorted in ascending order");
+      return 0;
+    }
+  }
+
+  for (j = 0; j < n_two_theta; j++)
+    profile[j] = 0.0;
+
+  /* pseudo-Voigt, normalized to unit area */
+  sigma = fwhm / (2.0 * sqrt(2.0 * log(2.0)));
+  gamma = fwhm / 2.0;
+  gauss_norm = (1.0 - eta) / (sigma * sqrt(2.0 * PI));
+  lorentz_norm = eta / (PI * gamma);
+
+  /* without Lorentzian tails, only points within a few widths need to be evaluated */
+  window = eta > 0.0 ? HUGE_VAL : 10.0 * sigma;
+
+  for (i = 0; i < n_reflections; i++) {
+    double center = reflections[i].two_theta;
+    int lo = 0, hi = n_two_theta;
+
+    if (eta == 0.0) {
+      /* binary search for the first point inside the window */
+      while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (two_theta[mid] < center - window)
+          lo = mid + 1;
+        else
+          hi = mid;
+      }
+    }
+
+    for (j = lo; j < n_two_theta && two_theta[j] <= center + window; j++) {
+      double x = two_theta[j] - center;
+      profile[j] += reflections[i].intensity * (gauss_norm * exp(-0.5 * x * x / (sigma * sigma)) + lorentz_norm / (1.0 + x * x / (gamma * gamma)));
+    }
+  }
+
+  return 1;
+}
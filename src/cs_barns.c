@@ -15,6 +15,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 
 /*////////////////////////////////////////////////////////////////////
 //                                                                  //
@@ -31,6 +32,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 
 
 double CSb_Total(int Z, double E, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double cs = CS_Total(Z, E, error);
 	if (cs == 0.0)
 		return 0.0;
@@ -39,6 +41,7 @@ double CSb_Total(int Z, double E, xrl_error **error) {
 }
 
 double CSb_Photo(int Z, double E, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double cs = CS_Photo(Z, E, error);
 	if (cs == 0.0)
 		return 0.0;
@@ -47,6 +50,7 @@ double CSb_Photo(int Z, double E, xrl_error **error) {
 }
 
 double CSb_Rayl(int Z, double E, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double cs = CS_Rayl(Z, E, error);
 	if (cs == 0.0)
 		return 0.0;
@@ -55,6 +59,7 @@ double CSb_Rayl(int Z, double E, xrl_error **error) {
 }
 
 double CSb_Compt(int Z, double E, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double cs = CS_Compt(Z, E, error);
 	if (cs == 0.0)
 		return 0.0;
@@ -63,6 +68,7 @@ double CSb_Compt(int Z, double E, xrl_error **error) {
 }
 
 double CSb_FluorLine(int Z, int line, double E, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double cs = CS_FluorLine(Z, line, E, error);
 	if (cs == 0.0)
 		return 0.0;
@@ -71,6 +77,7 @@ double CSb_FluorLine(int Z, int line, double E, xrl_error **error) {
 }
 
 double CSb_FluorShell(int Z, int shell, double E, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double cs = CS_FluorShell(Z, shell, E, error);
 	if (cs == 0.0)
 		return 0.0;
@@ -79,6 +86,7 @@ double CSb_FluorShell(int Z, int shell, double E, xrl_error **error) {
 }
 
 double DCSb_Rayl(int Z, double E, double theta, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double cs = DCS_Rayl(Z, E, theta, error);
 	if (cs == 0.0)
 		return 0.0;
@@ -87,6 +95,7 @@ double DCSb_Rayl(int Z, double E, double theta, xrl_error **error) {
 }
 
 double DCSb_Compt(int Z, double E, double theta, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double cs = DCS_Compt(Z, E, theta, error);
 	if (cs == 0.0)
 		return 0.0;
@@ -95,6 +104,7 @@ double DCSb_Compt(int Z, double E, double theta, xrl_error **error) {
 }
 
 double DCSPb_Rayl(int Z, double E, double theta, double phi, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double cs = DCSP_Rayl(Z, E, theta, phi, error);
 	if (cs == 0.0)
 		return 0.0;
@@ -103,6 +113,7 @@ double DCSPb_Rayl(int Z, double E, double theta, double phi, xrl_error **error)
 }
 
 double DCSPb_Compt(int Z, double E, double theta, double phi, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	double cs = DCSP_Compt(Z, E, theta, phi, error);
 	if (cs == 0.0)
 		return 0.0;
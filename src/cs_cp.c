@@ -16,8 +16,10 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 #include "xrayvars.h"
 #include <stdlib.h>
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 
 #define CS_CP_BEGIN \
+		XRL_STATS_FUNCTION \
 		struct compoundData *cd = NULL; \
 		struct compoundDataNIST *cdn = NULL; \
 		int i;\
@@ -15,6 +15,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 #include <stddef.h>
 
 /*////////////////////////////////////////////////////////////////////
@@ -242,6 +243,7 @@ static double (*jumpers[])(int, double, xrl_error **) = {Jump_from_K, Jump_from_
 
 double CS_FluorShell(int Z, int shell, double E, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double cs = 0.0;
   double Factor = 0.0;
 
@@ -275,6 +277,7 @@ double CS_FluorShell(int Z, int shell, double E, xrl_error **error)
 
 double CS_FluorLine(int Z, int line, double E, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double Factor = 1.0;
   double rr;
 
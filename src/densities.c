@@ -15,6 +15,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 
 /*////////////////////////////////////////////////////////////////////
 //                                                                  //
@@ -25,6 +26,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 /////////////////////////////////////////////////////////////////// */
 double ElementDensity(int Z, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double element_density;
 
   if (Z < 1 || Z > ZMAX) {
@@ -16,6 +16,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 
 
 /*////////////////////////////////////////////////////////////////////
@@ -28,6 +29,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 /////////////////////////////////////////////////////////////////// */
 double Fi(int Z, double E, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double fi;
   int splint_rv;
 
@@ -16,6 +16,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 
 #define KL1 -(int)KL1_LINE-1
 #define KL2 -(int)KL2_LINE-1
@@ -73,6 +74,7 @@ static double LineEnergyComposed(int Z, int line1, int line2, xrl_error **error)
       
 double LineEnergy(int Z, int line, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double line_energy;
   double lE, rr;
   double tmp=0.0, tmp1=0.0, tmp2=0.0;
@@ -150,7 +152,8 @@ double LineEnergy(int Z, int line, xrl_error **error)
     return LineEnergyComposed(Z, L3O4_LINE, L3O5_LINE, error);
   }
   else if (line == L3P23_LINE) {
-    return LineEnergyComposed(Z, L3O4_LINE, L3O5_LINE, error);
+    /* composed of the P2 and P3 lines, not of the O4 and O5 lines of L3O45_LINE */
+    return LineEnergyComposed(Z, L3P2_LINE, L3P3_LINE, error);
   }
   else if (line == L3P45_LINE) {
     return LineEnergyComposed(Z, L3P4_LINE, L3P5_LINE, error);
@@ -19,6 +19,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 #include "xrf_cross_sections_aux.h"
 
 static int LB_LINE_MACROS[] = {
@@ -47,6 +48,7 @@ static int LB_LINE_MACROS[] = {
 //                                                       //
 //////////////////////////////////////////////////////// */
 double CSb_Photo_Total(int Z, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   int shell;
   double rv = 0.0;
 
@@ -83,6 +85,7 @@ double CSb_Photo_Total(int Z, double E, xrl_error **error) {
 //////////////////////////////////////////////////////// */
 
 double CS_Photo_Total(int Z, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CSb_Photo_Total(Z, E, error);
   if (cs == 0.0)
     return 0.0;
@@ -102,6 +105,7 @@ double CS_Photo_Total(int Z, double E, xrl_error **error) {
 //////////////////////////////////////////////////////// */
 
 double CSb_Photo_Partial(int Z, int shell, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double ln_E, ln_sigma, sigma;
   double x0, x1, y0, y1;
   double m;
@@ -176,6 +180,7 @@ double CSb_Photo_Partial(int Z, int shell, double E, xrl_error **error) {
 
 
 double CS_Photo_Partial(int Z, int shell, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CSb_Photo_Partial(Z, shell, E, error);
   if (cs == 0.0)
     return 0.0;
@@ -198,10 +203,12 @@ double CS_Photo_Partial(int Z, int shell, double E, xrl_error **error) {
 /////////////////////////////////////////////////////////////////// */
 
 double CS_FluorLine_Kissel(int Z, int line, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   return CS_FluorLine_Kissel_Cascade(Z, line, E, error);
 }
 
 double CS_FluorShell_Kissel(int Z, int shell, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   return CS_FluorShell_Kissel_Cascade(Z, shell, E, error);
 }
 
@@ -220,6 +227,7 @@ double CS_FluorShell_Kissel(int Z, int shell, double E, xrl_error **error) {
 /////////////////////////////////////////////////////////////////// */
 
 double CSb_FluorLine_Kissel(int Z, int line, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CS_FluorLine_Kissel_Cascade(Z, line, E, error);
   if (cs == 0.0)
     return 0.0;
@@ -227,6 +235,7 @@ double CSb_FluorLine_Kissel(int Z, int line, double E, xrl_error **error) {
 }
 
 double CSb_FluorShell_Kissel(int Z, int shell, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CS_FluorShell_Kissel_Cascade(Z, shell, E, error);
   if (cs == 0.0)
     return 0.0;
@@ -246,6 +255,7 @@ double CSb_FluorShell_Kissel(int Z, int shell, double E, xrl_error **error) {
 static double (*cs_total_kissel_components[])(int, double, xrl_error **) = {CS_Photo_Total, CS_Rayl, CS_Compt};
 
 double CS_Total_Kissel(int Z, double E, xrl_error **error) { 
+  XRL_STATS_FUNCTION
   int i;
   double rv = 0.0;
 
@@ -280,6 +290,7 @@ double CS_Total_Kissel(int Z, double E, xrl_error **error) {
 /////////////////////////////////////////////////////////////////// */
 
 double CSb_Total_Kissel(int Z, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CS_Total_Kissel(Z, E, error);
   if (cs == 0.0)
     return 0.0;
@@ -297,6 +308,7 @@ double CSb_Total_Kissel(int Z, double E, xrl_error **error) {
 /////////////////////////////////////////////////////////////////// */
 
 double ElectronConfig(int Z, int shell, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double rv = 0.0;
   if (Z < 1 || Z > ZMAX) {
     xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE);
@@ -405,10 +417,12 @@ static struct {int line_lower; int line_upper; int shell;} line_mappings[] = {
   return 0.0;
 
 double CS_FluorLine_Kissel_no_Cascade(int Z, int line, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   CS_FLUORLINE_BODY(no_Cascade)
 }
 
 double CS_FluorShell_Kissel_no_Cascade(int Z, int shell, double E, xrl_error **error) {
+	XRL_STATS_FUNCTION
 
   if (Z < 1 || Z > ZMAX) {
     xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE);
@@ -755,10 +769,12 @@ double CS_FluorShell_Kissel_no_Cascade(int Z, int shell, double E, xrl_error **e
 /////////////////////////////////////////////////////////////////// */
 
 double CS_FluorLine_Kissel_Radiative_Cascade(int Z, int line, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   CS_FLUORLINE_BODY(Radiative_Cascade)
 }
 
 double CS_FluorShell_Kissel_Radiative_Cascade(int Z, int shell, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   CS_FLUORSHELL_CASCADE_BODY(rad)
 }
 
@@ -778,10 +794,12 @@ double CS_FluorShell_Kissel_Radiative_Cascade(int Z, int shell, double E, xrl_er
 /////////////////////////////////////////////////////////////////// */
 
 double CS_FluorLine_Kissel_Nonradiative_Cascade(int Z, int line, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   CS_FLUORLINE_BODY(Nonradiative_Cascade)
 }
 
 double CS_FluorShell_Kissel_Nonradiative_Cascade(int Z, int shell, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   CS_FLUORSHELL_CASCADE_BODY(auger)
 }
 
@@ -801,10 +819,12 @@ double CS_FluorShell_Kissel_Nonradiative_Cascade(int Z, int shell, double E, xrl
 /////////////////////////////////////////////////////////////////// */
 
 double CS_FluorLine_Kissel_Cascade(int Z, int line, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   CS_FLUORLINE_BODY(Cascade)
 }
 
 double CS_FluorShell_Kissel_Cascade(int Z, int shell, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   CS_FLUORSHELL_CASCADE_BODY(full)
 }
 
@@ -824,6 +844,7 @@ double CS_FluorShell_Kissel_Cascade(int Z, int shell, double E, xrl_error **erro
 /////////////////////////////////////////////////////////////////// */
 
 double CSb_FluorLine_Kissel_Cascade(int Z, int line, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CS_FluorLine_Kissel_Cascade(Z, line, E, error);
   if (cs == 0.0)
     return 0.0;
@@ -831,6 +852,7 @@ double CSb_FluorLine_Kissel_Cascade(int Z, int line, double E, xrl_error **error
 }
 
 double CSb_FluorShell_Kissel_Cascade(int Z, int shell, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CS_FluorShell_Kissel_Cascade(Z, shell, E, error);
   if (cs == 0.0)
     return 0.0;
@@ -853,6 +875,7 @@ double CSb_FluorShell_Kissel_Cascade(int Z, int shell, double E, xrl_error **err
 /////////////////////////////////////////////////////////////////// */
 
 double CSb_FluorLine_Kissel_Nonradiative_Cascade(int Z, int line, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CS_FluorLine_Kissel_Nonradiative_Cascade(Z, line, E, error);
   if (cs == 0.0)
     return 0.0;
@@ -860,6 +883,7 @@ double CSb_FluorLine_Kissel_Nonradiative_Cascade(int Z, int line, double E, xrl_
 }
 
 double CSb_FluorShell_Kissel_Nonradiative_Cascade(int Z, int shell, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CS_FluorShell_Kissel_Nonradiative_Cascade(Z, shell, E, error);
   if (cs == 0.0)
     return 0.0;
@@ -882,6 +906,7 @@ double CSb_FluorShell_Kissel_Nonradiative_Cascade(int Z, int shell, double E, xr
 /////////////////////////////////////////////////////////////////// */
 
 double CSb_FluorLine_Kissel_Radiative_Cascade(int Z, int line, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CS_FluorLine_Kissel_Radiative_Cascade(Z, line, E, error);
   if (cs == 0.0)
     return 0.0;
@@ -889,6 +914,7 @@ double CSb_FluorLine_Kissel_Radiative_Cascade(int Z, int line, double E, xrl_err
 }
 
 double CSb_FluorShell_Kissel_Radiative_Cascade(int Z, int shell, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CS_FluorShell_Kissel_Radiative_Cascade(Z, shell, E, error);
   if (cs == 0.0)
     return 0.0;
@@ -911,6 +937,7 @@ double CSb_FluorShell_Kissel_Radiative_Cascade(int Z, int shell, double E, xrl_e
 /////////////////////////////////////////////////////////////////// */
 
 double CSb_FluorLine_Kissel_no_Cascade(int Z, int line, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CS_FluorLine_Kissel_no_Cascade(Z, line, E, error);
   if (cs == 0.0)
     return 0.0;
@@ -918,6 +945,7 @@ double CSb_FluorLine_Kissel_no_Cascade(int Z, int line, double E, xrl_error **er
 }
 
 double CSb_FluorShell_Kissel_no_Cascade(int Z, int shell, double E, xrl_error **error) {
+  XRL_STATS_FUNCTION
   double cs = CS_FluorShell_Kissel_no_Cascade(Z, shell, E, error);
   if (cs == 0.0)
     return 0.0;
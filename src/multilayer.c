@@ -0,0 +1,241 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Specular reflectivity of multilayers, following L. G. Parratt, Phys. Rev. 95 (1954) 359,
+ * with the roughness correction of L. Nevot and P. Croce, Rev. Phys. Appl. 15 (1980) 761.
+ */
+
+#include "config.h"
+#include "xraylib.h"
+#include "xraylib-multilayer.h"
+#include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+
+/* Private function returning the normal component of the wave vector in units of k,
+ * sqrt(n^2 - cos^2 theta), on the branch with positive imaginary part.
+ * The squares are arranged to stay accurate at grazing incidence.
+ */
+
+static void multilayer_kz(double delta, double beta, double sin_theta, double *kz_re, double *kz_im) {
+  double re = sin_theta * sin_theta - 2.0 * delta + delta * delta - beta * beta;
+  double im = 2.0 * (1.0 - delta) * beta;
+  double modulus = sqrt(re * re + im * im);
+
+  *kz_re = sqrt((modulus + re) / 2.0);
+  *kz_im = sqrt((modulus - re) / 2.0);
+  if (im < 0.0)
+    *kz_im = -*kz_im;
+}
+
+/* Parratt recursion for a single energy, evaluated for all angles at once.
+ * work holds 6 * n_theta doubles.
+ */
+
+static void multilayer_energy(int n_layers, const xrlLayer layers[], const double delta[], const double beta[], double k,
+  const double sin_theta[], int n_theta, double R[], double work[]) {
+  double *X_re = work, *X_im = work + n_theta;
+  double *kz_lower_re = work + 2 * n_theta, *kz_lower_im = work + 3 * n_theta;
+  double *kz_upper_re = work + 4 * n_theta, *kz_upper_im = work + 5 * n_theta;
+  int m, t;
+
+  /* nothing is reflected from below the substrate */
+  for (t = 0; t < n_theta; t++) {
+    X_re[t] = X_im[t] = 0.0;
+    multilayer_kz(delta[n_layers - 1], beta[n_layers - 1], sin_theta[t], &kz_lower_re[t], &kz_lower_im[t]);
+  }
+
+  /* walk up the interfaces: m is the medium above the interface, 0 being the vacuum and m > 0 being layers[m - 1] */
+  for (m = n_layers - 1; m >= 0; m--) {
+    double sigma2 = layers[m].roughness * layers[m].roughness * k * k;
+    /* the medium below the interface is layers[m], the substrate has no thickness */
+    double thickness = m < n_layers - 1 ? layers[m].thickness * k : 0.0;
+    double *tmp;
+
+    for (t = 0; t < n_theta; t++) {
+      double r_re, r_im, num_re, num_im, den_re, den_im, den, p_re, p_im, a, b, XP_re, XP_im;
+
+      if (m == 0) {
+        kz_upper_re[t] = sin_theta[t];
+        kz_upper_im[t] = 0.0;
+      }
+      else
+        multilayer_kz(delta[m - 1], beta[m - 1], sin_theta[t], &kz_upper_re[t], &kz_upper_im[t]);
+
+      /* Fresnel coefficient r = (kz_upper - kz_lower) / (kz_upper + kz_lower) */
+      num_re = kz_upper_re[t] - kz_lower_re[t];
+      num_im = kz_upper_im[t] - kz_lower_im[t];
+      den_re = kz_upper_re[t] + kz_lower_re[t];
+      den_im = kz_upper_im[t] + kz_lower_im[t];
+      den = den_re * den_re + den_im * den_im;
+      if (den == 0.0) {
+        r_re = 1.0;
+        r_im = 0.0;
+      }
+      else {
+        r_re = (num_re * den_re + num_im * den_im) / den;
+        r_im = (num_im * den_re - num_re * den_im) / den;
+      }
+
+      /* Nevot-Croce factor exp(-2 kz_upper kz_lower sigma^2) */
+      if (sigma2 > 0.0) {
+        double e_re = -2.0 * sigma2 * (kz_upper_re[t] * kz_lower_re[t] - kz_upper_im[t] * kz_lower_im[t]);
+        double e_im = -2.0 * sigma2 * (kz_upper_re[t] * kz_lower_im[t] + kz_upper_im[t] * kz_lower_re[t]);
+        double modulus = exp(e_re);
+        a = modulus * cos(e_im);
+        b = modulus * sin(e_im);
+        p_re = r_re * a - r_im * b;
+        r_im = r_re * b + r_im * a;
+        r_re = p_re;
+      }
+
+      /* X propagated through the layer below the interface: X exp(2 i kz_lower d) */
+      if (thickness > 0.0) {
+        double modulus = exp(-2.0 * kz_lower_im[t] * thickness);
+        double phase = 2.0 * kz_lower_re[t] * thickness;
+        p_re = modulus * cos(phase);
+        p_im = modulus * sin(phase);
+        XP_re = X_re[t] * p_re - X_im[t] * p_im;
+        XP_im = X_re[t] * p_im + X_im[t] * p_re;
+      }
+      else {
+        XP_re = X_re[t];
+        XP_im = X_im[t];
+      }
+
+      /* X = (r + XP) / (1 + r XP) */
+      num_re = r_re + XP_re;
+      num_im = r_im + XP_im;
+      den_re = 1.0 + r_re * XP_re - r_im * XP_im;
+      den_im = r_re * XP_im + r_im * XP_re;
+      den = den_re * den_re + den_im * den_im;
+      X_re[t] = (num_re * den_re + num_im * den_im) / den;
+      X_im[t] = (num_im * den_re - num_re * den_im) / den;
+    }
+
+    tmp = kz_lower_re;
+    kz_lower_re = kz_upper_re;
+    kz_upper_re = tmp;
+    tmp = kz_lower_im;
+    kz_lower_im = kz_upper_im;
+    kz_upper_im = tmp;
+  }
+
+  for (t = 0; t < n_theta; t++)
+    R[t] = X_re[t] * X_re[t] + X_im[t] * X_im[t];
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+int Multilayer_Reflectivity(const xrlLayer layers[], int n_layers, const double E[], int nE, const double theta[], int n_theta, double R[], xrl_error **error) {
+  XRL_STATS_FUNCTION
+  xrlOpticalConstants *constants = NULL;
+  double *delta = NULL, *beta = NULL, *sin_theta = NULL;
+  int i, j, failed = 0, rv = 0;
+
+  if (layers == NULL || E == NULL || theta == NULL || R == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NULL_ARRAY);
+    return 0;
+  }
+
+  if (n_layers <= 0 || nE <= 0 || n_theta <= 0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_ARRAY_LENGTH);
+    return 0;
+  }
+
+  for (i = 0; i < n_layers; i++) {
+    if (i < n_layers - 1 && layers[i].thickness <= 0.0) {
+      xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_THICKNESS);
+      return 0;
+    }
+    if (layers[i].roughness < 0.0) {
+      xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_ROUGHNESS);
+      return 0;
+    }
+  }
+
+  for (j = 0; j < n_theta; j++) {
+    if (theta[j] < 0.0 || theta[j] > PI / 2.0) {
+      xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_GRAZING_ANGLE);
+      return 0;
+    }
+  }
+
+  constants = malloc(nE * sizeof(xrlOpticalConstants));
+  delta = malloc(2 * n_layers * nE * sizeof(double));
+  sin_theta = malloc(n_theta * sizeof(double));
+  if (constants == NULL || delta == NULL || sin_theta == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    goto end;
+  }
+  beta = delta + n_layers * nE;
+
+  /* the refractive indices of each layer, for all energies: stored per energy, for all layers */
+  for (j = 0; j < n_layers; j++) {
+    if (!Refractive_Index_Batch(layers[j].material, E, nE, layers[j].density, 0.0, constants, error))
+      goto end;
+    for (i = 0; i < nE; i++) {
+      delta[i * n_layers + j] = constants[i].delta;
+      beta[i * n_layers + j] = constants[i].beta;
+    }
+  }
+
+  for (j = 0; j < n_theta; j++)
+    sin_theta[j] = sin(theta[j]);
+
+  /* the energies are independent of each other */
+#ifdef _OPENMP
+  #pragma omp parallel if (nE > 1)
+#endif
+  {
+    double *work = malloc(6 * n_theta * sizeof(double));
+    int k;
+
+    if (work == NULL) {
+#ifdef _OPENMP
+      #pragma omp atomic write
+#endif
+      failed = 1;
+    }
+
+#ifdef _OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for (k = 0; k < nE; k++) {
+      /* k = 2 pi / lambda, in cm-1 */
+      if (work != NULL)
+        multilayer_energy(n_layers, layers, delta + k * n_layers, beta + k * n_layers, 2.0 * PI * E[k] / (KEV2ANGST * 1E-8),
+          sin_theta, n_theta, R + (size_t) k * n_theta, work);
+    }
+
+    free(work);
+  }
+
+  if (failed) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(ENOMEM));
+    goto end;
+  }
+
+  rv = 1;
+
+end:
+  free(constants);
+  free(delta);
+  free(sin_theta);
+  return rv;
+}
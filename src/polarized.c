@@ -18,6 +18,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 #include <stddef.h>
 
 
@@ -34,6 +35,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 /////////////////////////////////////////////////////////////////// */
 double DCSP_Rayl(int Z, double E, double theta, double phi, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double F, q;
   xrl_error *tmp_error = NULL;
                                                         
@@ -71,6 +73,7 @@ double DCSP_Rayl(int Z, double E, double theta, double phi, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double DCSP_Compt(int Z, double E, double theta, double phi, xrl_error **error)
 { 
+  XRL_STATS_FUNCTION
   double S, q;
   xrl_error *tmp_error = NULL;
                                                         
@@ -110,6 +113,7 @@ double DCSP_Compt(int Z, double E, double theta, double phi, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double DCSP_KN(double E, double theta, double phi, xrl_error **error)
 { 
+  XRL_STATS_FUNCTION
   double k0_k, k_k0, k_k0_2, cos_th, sin_th, cos_phi;
   
   if (E <= 0.0) {
@@ -141,6 +145,7 @@ double DCSP_KN(double E, double theta, double phi, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double DCSP_Thoms(double theta, double phi, xrl_error **error)
 { 
+  XRL_STATS_FUNCTION
   double sin_th, cos_phi ;
 
   sin_th = sin(theta) ;
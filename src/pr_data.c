@@ -14,8 +14,11 @@ THIS SOFTWARE IS PROVIDED BY Teemu Ikonen and Tom Schoonjans ''AS IS'' AND ANY E
 
 #include "config.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "xraylib.h"
 #include "xrayglob.h"
+#include "xraylib-data-image-private.h"
 #include "xrf_cross_sections_aux.h"
 #include "xrf_cross_sections_aux-private.h"
 
@@ -159,9 +162,10 @@ fprintf(filePtr, "};\n\n");
   fprintf(filePtr,"\n};\n");\
 
 #define PR_NUMVEC1D(NVAR, NNAME) \
-  fprintf(filePtr, "int %s[] =\n", NNAME); \
+  fprintf(filePtr, "static int %s_static[ZMAX+1] =\n", NNAME); \
   print_intvec(ZMAX+1, NVAR); \
-  fprintf(filePtr, ";\n\n");
+  fprintf(filePtr, ";\n\n"); \
+  fprintf(filePtr, "int *%s = %s_static;\n\n", NNAME, NNAME);
 
 /* 
  * This is the AugerYield that the user will end up querying,
@@ -1092,21 +1096,204 @@ void print_intvec(int arrmax, int *arr)
 }
 
 
+/*
+ * Binary data image, laid out as described in xraylib-data-image-private.h.
+ * The values are rounded like in the generated C code, which makes the image
+ * reproduce the compiled-in tables exactly.
+ */
+
+static void image_write_double(FILE *fp, const double *arr, int arrmax)
+{
+  char buffer[32];
+  int i;
+
+  for (i = 0; i < arrmax; i++) {
+    double value;
+    sprintf(buffer, "%.10E", arr[i]);
+    value = strtod(buffer, NULL);
+    fwrite(&value, sizeof(double), 1, fp);
+  }
+}
+
+static void image_write_int(FILE *fp, const int *arr, int arrmax)
+{
+  fwrite(arr, sizeof(int), arrmax, fp);
+}
+
+static void image_align(FILE *fp, long alignment)
+{
+  long pos;
+
+  for (pos = ftell(fp); pos % alignment != 0; pos++)
+    fputc(0, fp);
+}
+
+#define IMAGE_TABLE_BEGIN(ENAME) \
+  image_align(fp, XRL_DATA_IMAGE_ALIGNMENT); \
+  strcpy(tables[n_tables].name, ENAME); \
+  tables[n_tables].offset = (int) ftell(fp);
+
+#define IMAGE_TABLE_END \
+  tables[n_tables].size = (int) ftell(fp) - tables[n_tables].offset; \
+  n_tables++;
+
+static int write_data_image(const char *file_name)
+{
+  xrl_data_image_header header;
+  xrl_data_image_table tables[XRL_DATA_IMAGE_N_TABLES];
+  const union {int i; char c[sizeof(int)];} byte_order = {XRL_DATA_IMAGE_BYTE_ORDER};
+  int n_tables = 0, failed, Z, shell, section;
+  FILE *fp;
+
+  if (byte_order.c[0] != 0x04) {
+    fprintf(stderr, "Data images can only be written on little-endian hosts\n");
+    return 1;
+  }
+
+  fp = fopen(file_name, "wb");
+  if (fp == NULL) {
+    perror("file open");
+    return 1;
+  }
+
+  /* the header and the table directory are written last */
+  memset(&header, 0, sizeof(header));
+  memset(tables, 0, sizeof(tables));
+  fseek(fp, sizeof(header) + sizeof(tables), SEEK_SET);
+
+  /* the tables are grouped by section, each section starting on a new page */
+  for (section = XRL_DATA_SECTION_ATOMIC; section <= XRL_DATA_SECTION_AUGER; section <<= 1) {
+    image_align(fp, XRL_DATA_IMAGE_SECTION_ALIGNMENT);
+
+#define X(SECTION, type, name, count) \
+    if (SECTION == section) { \
+      IMAGE_TABLE_BEGIN(#name) \
+      image_write_ ## type(fp, (const type *) name, count); \
+      IMAGE_TABLE_END \
+    }
+    XRL_DATA_IMAGE_FIXED_TABLES(X)
+#undef X
+
+#define X(SECTION, name, count) \
+    if (SECTION == section) { \
+      IMAGE_TABLE_BEGIN(#name) \
+      for (Z = 0; Z <= ZMAX; Z++) { \
+        if (count[Z] > 0) \
+          image_write_double(fp, name[Z], count[Z]); \
+      } \
+      IMAGE_TABLE_END \
+    }
+    XRL_DATA_IMAGE_ELEMENT_TABLES(X)
+#undef X
+
+#define X(SECTION, name) \
+    if (SECTION == section) { \
+      IMAGE_TABLE_BEGIN(#name) \
+      for (Z = 0; Z <= ZMAX; Z++) { \
+        for (shell = 0; shell < SHELLNUM_K; shell++) { \
+          if (NE_Photo_Partial_Kissel[Z][shell] > 0) \
+            image_write_double(fp, name[Z][shell], NE_Photo_Partial_Kissel[Z][shell]); \
+        } \
+      } \
+      IMAGE_TABLE_END \
+    }
+    XRL_DATA_IMAGE_KISSEL_TABLES(X)
+#undef X
+
+#define X(SECTION, name) \
+    if (SECTION == section) { \
+      IMAGE_TABLE_BEGIN(#name) \
+      for (Z = 0; Z <= ZMAX; Z++) { \
+        for (shell = 0; shell < NShells_ComptonProfiles[Z]; shell++) { \
+          if (UOCCUP_ComptonProfiles[Z][shell] > 0.0 && Npz_ComptonProfiles[Z] > 0) \
+            image_write_double(fp, name[Z][shell], Npz_ComptonProfiles[Z]); \
+        } \
+      } \
+      IMAGE_TABLE_END \
+    }
+    XRL_DATA_IMAGE_COMPTON_TABLES(X)
+#undef X
+  }
+
+  image_align(fp, XRL_DATA_IMAGE_ALIGNMENT);
+
+  memcpy(header.magic, XRL_DATA_IMAGE_MAGIC, sizeof(XRL_DATA_IMAGE_MAGIC));
+  header.version = XRL_DATA_IMAGE_VERSION;
+  header.byte_order = XRL_DATA_IMAGE_BYTE_ORDER;
+  header.header_size = sizeof(header);
+  header.n_tables = n_tables;
+  header.file_size = (int) ftell(fp);
+  header.sizeof_int = sizeof(int);
+
+  fseek(fp, 0, SEEK_SET);
+  fwrite(&header, sizeof(header), 1, fp);
+  fwrite(tables, sizeof(tables), 1, fp);
+
+  failed = ferror(fp);
+  if (fclose(fp) != 0 || failed) {
+    perror("file write");
+    return 1;
+  }
+
+  return 0;
+}
+
 int main(int argc, char *argv[])
 {
 
   int i,j,k, Z;
+  int image = 0;
   Crystal_Struct* crystal;
   Crystal_Atom* atom;
 
-  if (argc != 3) {
+  if (argc == 4 && strcmp(argv[1], "--image") == 0) {
+	  image = 1;
+	  argv++;
+  }
+  else if (argc != 3) {
 	  fprintf(stderr, "Invoke this program with the xraylib source root directory as first argument and destination file as second argument!\n");
+	  fprintf(stderr, "Add --image as first argument to write a binary data image instead of C code.\n");
 	  return 1;
   }
 
   XRayInit();
   XRayInitFromPath(argv[1]);
 
+  for (i = 1 ; i < ZMAX ; i++) {
+  	for (j = K_L1L1_AUGER ; j <= M4_M5Q3_AUGER ; j++)
+		Auger_Rates[i][j] = AugerRate_prdata(i, j);
+
+	for (j = K_SHELL ; j <= M5_SHELL ; j++)
+		Auger_Yields[i][j] = AugerYield_prdata(i, j);
+  }
+
+#define IF_XRF_CS(shell) \
+      if (shell1 == shell ## _SHELL) { \
+	int shell2; \
+        for (shell2 = K_SHELL ; shell2 <= L3_SHELL ; shell2++) { \
+          xrf_cross_sections_constants_full[Z][shell1][shell2] = P ## shell ## _get_cross_sections_constant_full(Z, shell2); \
+          xrf_cross_sections_constants_auger_only[Z][shell1][shell2] = P ## shell ## _get_cross_sections_constant_auger_only(Z, shell2); \
+	} \
+      }
+
+  /* precalculated xrf_cross_sections constants */
+  for (Z = 1 ; Z <= ZMAX ; Z++) {
+    int shell1;
+    for (shell1 = L1_SHELL ; shell1 <= M5_SHELL ; shell1++) {
+      IF_XRF_CS(L1)
+      else IF_XRF_CS(L2)
+      else IF_XRF_CS(L3)
+      else IF_XRF_CS(M1)
+      else IF_XRF_CS(M2)
+      else IF_XRF_CS(M3)
+      else IF_XRF_CS(M4)
+      else IF_XRF_CS(M5)
+    }
+  }
+
+  if (image)
+    return write_data_image(argv[2]);
+
   filePtr = fopen(argv[2], "w");
   if(filePtr == NULL) {
     perror("file open");
@@ -1118,6 +1305,7 @@ int main(int argc, char *argv[])
   fprintf(filePtr, "#include \"config.h\"\n\n");
   fprintf(filePtr, "#include \"xraylib.h\"\n\n");
   fprintf(filePtr, "#include \"xrayglob.h\"\n\n");
+  fprintf(filePtr, "#include \"xraylib-fast.h\"\n\n");
   fprintf(filePtr, "#include \"stddef.h\"\n\n");
 
   fprintf(filePtr, "struct MendelElement MendelArray[MENDEL_MAX] = \n");
@@ -1147,36 +1335,45 @@ int main(int argc, char *argv[])
   }
   fprintf (filePtr, "};\n\n");
 
-  fprintf(filePtr, "Crystal_Array Crystal_arr = {%i, %i, __Crystal_arr};\n\n", Crystal_arr.n_crystal, Crystal_arr.n_alloc);
+  fprintf(filePtr, "Crystal_Array Crystal_arr = {%i, %i, __Crystal_arr, 0};\n\n", Crystal_arr.n_crystal, Crystal_arr.n_alloc);
 
-  fprintf(filePtr, "double AtomicWeight_arr[ZMAX+1] =\n");
+  fprintf(filePtr, "static double AtomicWeight_arr_static[ZMAX+1] =\n");
   print_doublevec(ZMAX+1, AtomicWeight_arr);
   fprintf(filePtr, ";\n\n");
+  fprintf(filePtr, "double *AtomicWeight_arr = AtomicWeight_arr_static;\n\n");
 
-  fprintf(filePtr, "double ElementDensity_arr[ZMAX+1] =\n");
+  fprintf(filePtr, "static double ElementDensity_arr_static[ZMAX+1] =\n");
   print_doublevec(ZMAX+1, ElementDensity_arr);
   fprintf(filePtr, ";\n\n");
+  fprintf(filePtr, "double *ElementDensity_arr = ElementDensity_arr_static;\n\n");
 
-  fprintf(filePtr, "double EdgeEnergy_arr[ZMAX+1][SHELLNUM] = {\n");
+  fprintf(filePtr, "static double EdgeEnergy_arr_static[ZMAX+1][SHELLNUM] = {\n");
   PR_MATD(ZMAX+1, SHELLNUM, EdgeEnergy_arr);
+  fprintf(filePtr, "double (*EdgeEnergy_arr)[SHELLNUM] = EdgeEnergy_arr_static;\n\n");
 
-  fprintf(filePtr, "double AtomicLevelWidth_arr[ZMAX+1][SHELLNUM] = {\n");
+  fprintf(filePtr, "static double AtomicLevelWidth_arr_static[ZMAX+1][SHELLNUM] = {\n");
   PR_MATD(ZMAX+1, SHELLNUM, AtomicLevelWidth_arr);
+  fprintf(filePtr, "double (*AtomicLevelWidth_arr)[SHELLNUM] = AtomicLevelWidth_arr_static;\n\n");
 
-  fprintf(filePtr, "double LineEnergy_arr[ZMAX+1][LINENUM] = {\n");
+  fprintf(filePtr, "static double LineEnergy_arr_static[ZMAX+1][LINENUM] = {\n");
   PR_MATD(ZMAX+1, LINENUM, LineEnergy_arr);
+  fprintf(filePtr, "double (*LineEnergy_arr)[LINENUM] = LineEnergy_arr_static;\n\n");
 
-  fprintf(filePtr, "double FluorYield_arr[ZMAX+1][SHELLNUM] = {\n");
+  fprintf(filePtr, "static double FluorYield_arr_static[ZMAX+1][SHELLNUM] = {\n");
   PR_MATD(ZMAX+1, SHELLNUM, FluorYield_arr);
+  fprintf(filePtr, "double (*FluorYield_arr)[SHELLNUM] = FluorYield_arr_static;\n\n");
 
-  fprintf(filePtr, "double JumpFactor_arr[ZMAX+1][SHELLNUM] = {\n");
+  fprintf(filePtr, "static double JumpFactor_arr_static[ZMAX+1][SHELLNUM] = {\n");
   PR_MATD(ZMAX+1, SHELLNUM, JumpFactor_arr);
+  fprintf(filePtr, "double (*JumpFactor_arr)[SHELLNUM] = JumpFactor_arr_static;\n\n");
 
-  fprintf(filePtr, "double CosKron_arr[ZMAX+1][TRANSNUM] = {\n");
+  fprintf(filePtr, "static double CosKron_arr_static[ZMAX+1][TRANSNUM] = {\n");
   PR_MATD(ZMAX+1, TRANSNUM, CosKron_arr);
+  fprintf(filePtr, "double (*CosKron_arr)[TRANSNUM] = CosKron_arr_static;\n\n");
 
-  fprintf(filePtr, "double RadRate_arr[ZMAX+1][LINENUM] = {\n");
+  fprintf(filePtr, "static double RadRate_arr_static[ZMAX+1][LINENUM] = {\n");
   PR_MATD(ZMAX+1, LINENUM, RadRate_arr);
+  fprintf(filePtr, "double (*RadRate_arr)[LINENUM] = RadRate_arr_static;\n\n");
 
   PR_NUMVEC1D(NE_Photo, "NE_Photo");
   PR_DYNMATD(NE_Photo, E_Photo_arr, "E_Photo_arr");
@@ -1218,19 +1415,22 @@ int main(int argc, char *argv[])
   PR_DYNMATD(NE_Fii, Fii_arr, "Fii_arr");
   PR_DYNMATD(NE_Fii, Fii_arr2, "Fii_arr2");
 
-  fprintf(filePtr, "double Electron_Config_Kissel[ZMAX+1][SHELLNUM_K] = {\n");
+  fprintf(filePtr, "static double Electron_Config_Kissel_static[ZMAX+1][SHELLNUM_K] = {\n");
   PR_MATD(ZMAX+1, SHELLNUM_K, Electron_Config_Kissel);
+  fprintf(filePtr, "double (*Electron_Config_Kissel)[SHELLNUM_K] = Electron_Config_Kissel_static;\n\n");
 
-  fprintf(filePtr, "double EdgeEnergy_Kissel[ZMAX+1][SHELLNUM_K] = {\n");
+  fprintf(filePtr, "static double EdgeEnergy_Kissel_static[ZMAX+1][SHELLNUM_K] = {\n");
   PR_MATD(ZMAX+1, SHELLNUM_K, EdgeEnergy_Kissel);
+  fprintf(filePtr, "double (*EdgeEnergy_Kissel)[SHELLNUM_K] = EdgeEnergy_Kissel_static;\n\n");
 
   PR_NUMVEC1D(NE_Photo_Total_Kissel, "NE_Photo_Total_Kissel");
   PR_DYNMATD(NE_Photo_Total_Kissel,E_Photo_Total_Kissel,"E_Photo_Total_Kissel");
   PR_DYNMATD(NE_Photo_Total_Kissel,Photo_Total_Kissel,"Photo_Total_Kissel");
   PR_DYNMATD(NE_Photo_Total_Kissel,Photo_Total_Kissel2,"Photo_Total_Kissel2");
 
-  fprintf(filePtr, "int NE_Photo_Partial_Kissel[ZMAX+1][SHELLNUM_K] = {\n");
+  fprintf(filePtr, "static int NE_Photo_Partial_Kissel_static[ZMAX+1][SHELLNUM_K] = {\n");
   PR_MATI(ZMAX+1, SHELLNUM_K, NE_Photo_Partial_Kissel);
+  fprintf(filePtr, "int (*NE_Photo_Partial_Kissel)[SHELLNUM_K] = NE_Photo_Partial_Kissel_static;\n\n");
 
   PR_DYNMAT_3DD_K(NE_Photo_Partial_Kissel, E_Photo_Partial_Kissel, "E_Photo_Partial_Kissel");
   PR_DYNMAT_3DD_K(NE_Photo_Partial_Kissel, Photo_Partial_Kissel, "Photo_Partial_Kissel");
@@ -1245,47 +1445,35 @@ int main(int argc, char *argv[])
   PR_DYNMAT_3DD_C(Npz_ComptonProfiles, NShells_ComptonProfiles, UOCCUP_ComptonProfiles, Partial_ComptonProfiles,"Partial_ComptonProfiles");
   PR_DYNMAT_3DD_C(Npz_ComptonProfiles, NShells_ComptonProfiles, UOCCUP_ComptonProfiles, Partial_ComptonProfiles2,"Partial_ComptonProfiles2");
 
-  for (i = 1 ; i < ZMAX ; i++) {
-  	for (j = K_L1L1_AUGER ; j <= M4_M5Q3_AUGER ; j++)
-		Auger_Rates[i][j] = AugerRate_prdata(i, j);
-
-	for (j = K_SHELL ; j <= M5_SHELL ; j++)
-		Auger_Yields[i][j] = AugerYield_prdata(i, j);
-  }
-  fprintf(filePtr, "double Auger_Yields[ZMAX+1][SHELLNUM_A] = {\n");
+  fprintf(filePtr, "static double Auger_Yields_static[ZMAX+1][SHELLNUM_A] = {\n");
   PR_MATD(ZMAX+1, SHELLNUM_A, Auger_Yields);
-  fprintf(filePtr, "double Auger_Rates[ZMAX+1][AUGERNUM] = {\n");
+  fprintf(filePtr, "double (*Auger_Yields)[SHELLNUM_A] = Auger_Yields_static;\n\n");
+  fprintf(filePtr, "static double Auger_Rates_static[ZMAX+1][AUGERNUM] = {\n");
   PR_MATD(ZMAX+1, AUGERNUM, Auger_Rates);
+  fprintf(filePtr, "double (*Auger_Rates)[AUGERNUM] = Auger_Rates_static;\n\n");
 
-#define IF_XRF_CS(shell) \
-      if (shell1 == shell ## _SHELL) { \
-	int shell2; \
-        for (shell2 = K_SHELL ; shell2 <= L3_SHELL ; shell2++) { \
-          xrf_cross_sections_constants_full[Z][shell1][shell2] = P ## shell ## _get_cross_sections_constant_full(Z, shell2); \
-          xrf_cross_sections_constants_auger_only[Z][shell1][shell2] = P ## shell ## _get_cross_sections_constant_auger_only(Z, shell2); \
-	} \
-      }
-
-  /* precalculated xrf_cross_sections constants */
-  for (Z = 1 ; Z <= ZMAX ; Z++) {
-    int shell1;
-    for (shell1 = L1_SHELL ; shell1 <= M5_SHELL ; shell1++) {
-      IF_XRF_CS(L1)
-      else IF_XRF_CS(L2)
-      else IF_XRF_CS(L3)
-      else IF_XRF_CS(M1)
-      else IF_XRF_CS(M2)
-      else IF_XRF_CS(M3)
-      else IF_XRF_CS(M4)
-      else IF_XRF_CS(M5)
-    }
-  }
-
-  fprintf(filePtr, "double xrf_cross_sections_constants_full[ZMAX+1][M5_SHELL+1][L3_SHELL+1] = {\n");
+  fprintf(filePtr, "static double xrf_cross_sections_constants_full_static[ZMAX+1][M5_SHELL+1][L3_SHELL+1] = {\n");
   PR_CUBED(ZMAX+1, M5_SHELL+1, L3_SHELL+1, xrf_cross_sections_constants_full);
+  fprintf(filePtr, "double (*xrf_cross_sections_constants_full)[M5_SHELL+1][L3_SHELL+1] = xrf_cross_sections_constants_full_static;\n\n");
   
-  fprintf(filePtr, "double xrf_cross_sections_constants_auger_only[ZMAX+1][M5_SHELL+1][L3_SHELL+1] = {\n");
+  fprintf(filePtr, "static double xrf_cross_sections_constants_auger_only_static[ZMAX+1][M5_SHELL+1][L3_SHELL+1] = {\n");
   PR_CUBED(ZMAX+1, M5_SHELL+1, L3_SHELL+1, xrf_cross_sections_constants_auger_only);
+  fprintf(filePtr, "double (*xrf_cross_sections_constants_auger_only)[M5_SHELL+1][L3_SHELL+1] = xrf_cross_sections_constants_auger_only_static;\n\n");
+
+  fprintf(filePtr, "static int Sorted_arr_static[ZMAX+1][GRIDNUM] = {\n");
+  PR_MATI(ZMAX+1, GRIDNUM, Sorted_arr);
+  fprintf(filePtr, "int (*Sorted_arr)[GRIDNUM] = Sorted_arr_static;\n\n");
+
+  fprintf(filePtr, "const double *xrl_fast_atomic_weight = AtomicWeight_arr_static;\n");
+  fprintf(filePtr, "const double *xrl_fast_element_density = ElementDensity_arr_static;\n");
+  fprintf(filePtr, "const double (*xrl_fast_edge_energy)[SHELLNUM] = (const double (*)[SHELLNUM]) EdgeEnergy_arr_static;\n");
+  fprintf(filePtr, "const double (*xrl_fast_fluor_yield)[SHELLNUM] = (const double (*)[SHELLNUM]) FluorYield_arr_static;\n");
+  fprintf(filePtr, "const double (*xrl_fast_jump_factor)[SHELLNUM] = (const double (*)[SHELLNUM]) JumpFactor_arr_static;\n");
+  fprintf(filePtr, "const double (*xrl_fast_atomic_level_width)[SHELLNUM] = (const double (*)[SHELLNUM]) AtomicLevelWidth_arr_static;\n");
+  fprintf(filePtr, "const double (*xrl_fast_line_energy)[LINENUM] = (const double (*)[LINENUM]) LineEnergy_arr_static;\n");
+  fprintf(filePtr, "const double (*xrl_fast_rad_rate)[LINENUM] = (const double (*)[LINENUM]) RadRate_arr_static;\n");
+  fprintf(filePtr, "const double (*xrl_fast_cos_kron)[TRANSNUM] = (const double (*)[TRANSNUM]) CosKron_arr_static;\n");
+  fprintf(filePtr, "const double (*xrl_fast_auger_rates)[AUGERNUM] = (const double (*)[AUGERNUM]) Auger_Rates_static;\n\n");
 
   fclose(filePtr);
 
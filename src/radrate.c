@@ -15,6 +15,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 #include <stddef.h>
 
 #define KL1 -(int)KL1_LINE-1
@@ -38,6 +39,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
       
 double RadRate(int Z, int line, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double rad_rate, rr;
   int i;
 
@@ -16,8 +16,12 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans and Bruno Golosio''AS IS'' AND ANY E
 #include "xrayglob.h"
 #include "xraylib.h"
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 #include <math.h>
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
+#include "splint.h"
 
 #define REFR_BEGIN \
 	int nElements = 0; \
@@ -57,6 +61,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans and Bruno Golosio''AS IS'' AND ANY E
 		FreeCompoundDataNIST(cdn);
 
 double Refractive_Index_Re(const char compound[], double E, double density, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	struct compoundData *cd = NULL;
 	struct compoundDataNIST *cdn = NULL;
 	double rv = 0.0;
@@ -87,6 +92,7 @@ double Refractive_Index_Re(const char compound[], double E, double density, xrl_
 
 
 double Refractive_Index_Im(const char compound[], double E, double density, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	struct compoundData *cd = NULL;
 	struct compoundDataNIST *cdn = NULL;
 	int i;
@@ -109,6 +115,7 @@ double Refractive_Index_Im(const char compound[], double E, double density, xrl_
 }
 
 xrlComplex Refractive_Index(const char compound[], double E, double density, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	struct compoundData *cd = NULL;
 	struct compoundDataNIST *cdn = NULL;
 	int i;
@@ -156,3 +163,174 @@ void Refractive_Index2(const char compound[], double E, double density, xrlCompl
 	result->im = z.im;
 }
 
+
+/*
+ * Batched refractive indices.
+ *
+ * The compound is resolved once, and every element keeps one spline cursor per table.
+ * Since the tables use different energy grids, each cursor only walks its own grid,
+ * which turns the table lookups into short walks when sweeping the energy.
+ */
+
+typedef struct {
+	int Z;
+	double delta_factor;  /* mass fraction * KD / atomic weight */
+	double mass_fraction;
+	int cursor_fi, cursor_photo, cursor_rayl, cursor_compt;
+} Refr_Element;
+
+static int refr_splint(double xa[], double ya[], double y2a[], int n, double x, int sorted, int *cursor, double *y, xrl_error **error) {
+	if (!splint_hunt(xa - 1, ya - 1, y2a - 1, n, x, sorted, cursor, y)) {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, x < xa[0] ? SPLINT_X_TOO_LOW : SPLINT_X_TOO_HIGH);
+		return 0;
+	}
+	return 1;
+}
+
+/* Private function returning delta and the mass attenuation coefficient (cm2/g) of the compound */
+static int refr_evaluate(Refr_Element *elements, int nElements, double E, double *delta, double *mu, xrl_error **error) {
+	double ln_E = log(E * 1000.0);
+	int i;
+
+	*delta = 0.0;
+	*mu = 0.0;
+
+	for (i = 0 ; i < nElements ; i++) {
+		Refr_Element *el = &elements[i];
+		int Z = el->Z;
+		double fi, ln_photo, ln_rayl, ln_compt;
+
+		if (!refr_splint(E_Fi_arr[Z], Fi_arr[Z], Fi_arr2[Z], NE_Fi[Z], E, Sorted_arr[Z][FI_GRID], &el->cursor_fi, &fi, error) ||
+			!refr_splint(E_Photo_arr[Z], CS_Photo_arr[Z], CS_Photo_arr2[Z], NE_Photo[Z], ln_E, Sorted_arr[Z][PHOTO_GRID], &el->cursor_photo, &ln_photo, error) ||
+			!refr_splint(E_Rayl_arr[Z], CS_Rayl_arr[Z], CS_Rayl_arr2[Z], NE_Rayl[Z], ln_E, Sorted_arr[Z][RAYL_GRID], &el->cursor_rayl, &ln_rayl, error) ||
+			!refr_splint(E_Compt_arr[Z], CS_Compt_arr[Z], CS_Compt_arr2[Z], NE_Compt[Z], ln_E, Sorted_arr[Z][COMPT_GRID], &el->cursor_compt, &ln_compt, error))
+			return 0;
+
+		*delta += el->delta_factor * (Z + fi) / E / E;
+		*mu += el->mass_fraction * (exp(ln_photo) + exp(ln_rayl) + exp(ln_compt));
+	}
+
+	return 1;
+}
+
+/* Fresnel reflectivity of a flat surface with refractive index 1 - delta + i beta, at grazing angle theta */
+static double refr_fresnel(double delta, double beta, double theta) {
+	double kz1 = sin(theta);
+	double cos_theta = cos(theta);
+	/* kz2 = sqrt(n^2 - cos^2 theta), on the branch with positive imaginary part */
+	double re = (1.0 - delta) * (1.0 - delta) - beta * beta - cos_theta * cos_theta;
+	double im = 2.0 * (1.0 - delta) * beta;
+	double modulus = sqrt(re * re + im * im);
+	double kz2_re = sqrt((modulus + re) / 2.0);
+	double kz2_im = sqrt((modulus - re) / 2.0);
+	double num, den;
+
+	if (im < 0.0)
+		kz2_im = -kz2_im;
+
+	num = (kz1 - kz2_re) * (kz1 - kz2_re) + kz2_im * kz2_im;
+	den = (kz1 + kz2_re) * (kz1 + kz2_re) + kz2_im * kz2_im;
+
+	return den == 0.0 ? 1.0 : num / den;
+}
+
+int Refractive_Index_Batch(const char compound[], const double E[], int nE, double density, double theta, xrlOpticalConstants constants[], xrl_error **error) {
+	XRL_STATS_FUNCTION
+	struct compoundData *cd = NULL;
+	struct compoundDataNIST *cdn = NULL;
+	int nElements = 0;
+	int *Elements = NULL;
+	double *massFractions = NULL;
+	Refr_Element *elements = NULL;
+	int i, rv = 0;
+
+	if (E == NULL || constants == NULL) {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NULL_ARRAY);
+		return 0;
+	}
+
+	if (nE <= 0) {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_ARRAY_LENGTH);
+		return 0;
+	}
+
+	if (theta < 0.0 || theta > PI / 2.0) {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_GRAZING_ANGLE);
+		return 0;
+	}
+
+	if ((cd = CompoundParser(compound, NULL)) != NULL) {
+		nElements = cd->nElements;
+		Elements = cd->Elements;
+		massFractions = cd->massFractions;
+	}
+	else if ((cdn = GetCompoundDataNISTByName(compound, NULL)) != NULL) {
+		nElements = cdn->nElements;
+		Elements = cdn->Elements;
+		massFractions = cdn->massFractions;
+		if (density <= 0.0) {
+			density = cdn->density;
+		}
+	}
+	else {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, UNKNOWN_COMPOUND);
+		return 0;
+	}
+
+	if (density <= 0.0) {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_DENSITY);
+		goto end;
+	}
+
+	elements = malloc(nElements * sizeof(Refr_Element));
+	if (elements == NULL) {
+		xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+		goto end;
+	}
+
+	for (i = 0 ; i < nElements ; i++) {
+		int Z = Elements[i];
+		double atomic_weight;
+
+		if (NE_Fi[Z] < 0 || NE_Photo[Z] < 0 || NE_Rayl[Z] < 0 || NE_Compt[Z] < 0) {
+			xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE);
+			goto end;
+		}
+		atomic_weight = AtomicWeight(Z, error);
+		if (atomic_weight == 0.0)
+			goto end;
+
+		elements[i].Z = Z;
+		elements[i].delta_factor = massFractions[i] * KD / atomic_weight;
+		elements[i].mass_fraction = massFractions[i];
+		elements[i].cursor_fi = elements[i].cursor_photo = elements[i].cursor_rayl = elements[i].cursor_compt = 0;
+	}
+
+	for (i = 0 ; i < nE ; i++) {
+		double delta, mu;
+		xrlOpticalConstants *c = &constants[i];
+
+		if (E[i] <= 0.0) {
+			xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_ENERGY);
+			goto end;
+		}
+
+		if (!refr_evaluate(elements, nElements, E[i], &delta, &mu, error))
+			goto end;
+
+		c->delta = delta * density;
+		/*9.8663479e-9 is calculated as planck's constant * speed of light / 4Pi */
+		c->beta = mu * density * 9.8663479e-9 / E[i];
+		c->critical_angle = c->delta > 0.0 ? sqrt(2.0 * c->delta) : 0.0;
+		c->attenuation_length = 1.0 / (mu * density);
+		c->reflectivity = refr_fresnel(c->delta, c->beta, theta);
+	}
+
+	rv = 1;
+
+end:
+	free(elements);
+	REFR_END
+
+	return rv;
+}
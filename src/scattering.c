@@ -18,6 +18,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 #include "xrayglob.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 
 /*////////////////////////////////////////////////////////////////////
 //                                                                  //
@@ -29,6 +30,7 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 /////////////////////////////////////////////////////////////////// */
 double FF_Rayl(int Z, double q, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double FF;
   int splint_rv;
 
@@ -65,6 +67,7 @@ double FF_Rayl(int Z, double q, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double SF_Compt(int Z, double q, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   double SF;
   int splint_rv;
 
@@ -96,6 +99,7 @@ double SF_Compt(int Z, double q, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double DCS_Thoms(double theta, xrl_error **error)
 { 
+  XRL_STATS_FUNCTION
   double cos_theta;
 
   cos_theta = cos(theta);
@@ -113,6 +117,7 @@ double DCS_Thoms(double theta, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double DCS_KN(double E, double theta, xrl_error **error)
 { 
+  XRL_STATS_FUNCTION
   double cos_theta, t1, t2;
 
   if (E <= 0.) {
@@ -138,6 +143,7 @@ double DCS_KN(double E, double theta, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double DCS_Rayl(int Z, double E, double theta, xrl_error **error)
 { 
+  XRL_STATS_FUNCTION
   double F, q;
   xrl_error *tmp_error = NULL;             
 
@@ -173,6 +179,7 @@ double DCS_Rayl(int Z, double E, double theta, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double DCS_Compt(int Z, double E, double theta, xrl_error **error)
 { 
+  XRL_STATS_FUNCTION
   double S, q;
   xrl_error *tmp_error = NULL;
                                                         
@@ -207,6 +214,7 @@ double DCS_Compt(int Z, double E, double theta, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double MomentTransf(double E, double theta, xrl_error **error)
 {
+  XRL_STATS_FUNCTION
   if (E <= 0.) {
     xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_ENERGY);
     return 0;
@@ -224,6 +232,7 @@ double MomentTransf(double E, double theta, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double CS_KN(double E, xrl_error **error)
 { 
+  XRL_STATS_FUNCTION
   double a, a3, b, b2, lb;
   double sigma;
 
@@ -253,6 +262,7 @@ double CS_KN(double E, xrl_error **error)
 /////////////////////////////////////////////////////////////////// */
 double ComptonEnergy(double E0, double theta, xrl_error **error)
 { 
+  XRL_STATS_FUNCTION
   double cos_theta, alpha;
 
   if (E0 <= 0.) {
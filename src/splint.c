@@ -81,5 +81,89 @@ int splint(double xa[], double ya[], double y2a[], int n, double x, double *y, x
 	return 1;
 }
 
+/*
+ * Looks up the interval [xa[lo], xa[lo+1]] that brackets x starting from *klo,
+ * which is updated on return. Falls back to bisection if *klo is not a valid interval.
+ * Walking only finds the same interval as the bisection in splint if the nodes are in
+ * ascending order: grids that are not sorted (see Sorted_arr) are always bisected.
+ */
+static int hunt(double xa[], int n, double x, int sorted, int *klo) {
+	int lo, hi, k;
+
+	lo = *klo;
+	if (!sorted || lo < 1 || lo >= n) {
+		lo = 1;
+		hi = n;
+		while (hi-lo > 1) {
+			k = (hi + lo) >> 1;
+			if (xa[k] > x) hi = k;
+			else lo = k;
+		}
+		if (!sorted)
+			return lo;
+	}
+	else {
+		while (lo > 1 && xa[lo] > x)
+			lo--;
+		while (lo < n-1 && xa[lo+1] <= x)
+			lo++;
+	}
+	*klo = lo;
+	return lo;
+}
 
+/*
+ * Same as splint, but the bracketing interval is looked up starting from *klo,
+ * which is updated on return. This turns the bisection into a short walk when
+ * the table is evaluated for a slowly varying sequence of x values.
+ * sorted must be 0 unless the nodes are in ascending order.
+ * Returns 0 without setting an error if x lies outside the table.
+ */
+int splint_hunt(double xa[], double ya[], double y2a[], int n, double x, int sorted, int *klo, double *y) {
+	int lo, hi;
+	double h, b, a;
 
+	if (x - xa[n] > 1E-7 || x < xa[1]) {
+	  *y = 0.0;
+	  return 0;
+	}
+
+	lo = hunt(xa, n, x, sorted, klo);
+	hi = lo + 1;
+
+	h = xa[hi] - xa[lo];
+	if (h == 0.0) {
+	  *y = (ya[lo] + ya[hi])/2.0;
+	  return 1;
+	}
+	a = (xa[hi] - x) / h;
+	b = (x - xa[lo]) / h;
+	*y = a*ya[lo] + b*ya[hi] + ((a*a*a-a)*y2a[lo]
+	     + (b*b*b-b)*y2a[hi])*(h*h)/6.0;
+	return 1;
+}
+
+/*
+ * Linear interpolation between the same nodes as splint_hunt, ignoring the second derivatives.
+ * Returns 0 without setting an error if x lies outside the table.
+ */
+int lininterp_hunt(double xa[], double ya[], int n, double x, int sorted, int *klo, double *y) {
+	int lo, hi;
+	double h;
+
+	if (x - xa[n] > 1E-7 || x < xa[1]) {
+	  *y = 0.0;
+	  return 0;
+	}
+
+	lo = hunt(xa, n, x, sorted, klo);
+	hi = lo + 1;
+
+	h = xa[hi] - xa[lo];
+	if (h == 0.0) {
+	  *y = (ya[lo] + ya[hi])/2.0;
+	  return 1;
+	}
+	*y = ya[lo] + (ya[hi]-ya[lo])*(x-xa[lo])/h;
+	return 1;
+}
@@ -23,6 +23,8 @@ THIS SOFTWARE IS PROVIDED BY Bruno Golosio, Antonio Brunetti, Manuel Sanchez del
 #endif /* __GNUC__ */
 
 int splint(double xa[], double ya[], double y2a[], int n, double x, double *y, xrl_error **error) XRL_WARN_UNUSED_RESULT;
+int splint_hunt(double xa[], double ya[], double y2a[], int n, double x, int sorted, int *klo, double *y) XRL_WARN_UNUSED_RESULT;
 int lininterp(double xa[], double ya[], int n, double x, double *y, xrl_error **error) XRL_WARN_UNUSED_RESULT;
+int lininterp_hunt(double xa[], double ya[], int n, double x, int sorted, int *klo, double *y) XRL_WARN_UNUSED_RESULT;
 
 #endif
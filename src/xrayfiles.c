@@ -30,6 +30,7 @@ double Auger_Transition_Total[ZMAX+1][SHELLNUM_A];
 double Auger_Transition_Individual[ZMAX+1][AUGERNUM];
 
 void ArrayInit(void);
+static void SortedInit(void);
 
 void XRayInit(void) {
 
@@ -130,7 +131,7 @@ void XRayInitFromPath(char *path)
   strcat(file_name, "Crystals.dat");
 
   Crystal_arr.crystal = malloc(sizeof(Crystal_Struct) * CRYSTALARRAY_MAX);
-  stat = Crystal_ReadFile(file_name, NULL, NULL);
+  stat = Crystal_ReadFile(file_name, &Crystal_arr, NULL);
   if (stat == 0) {
     fprintf(stderr, "Could not read Crystals.dat");
     exit(1);
@@ -705,6 +706,41 @@ void XRayInitFromPath(char *path)
     }	
   }
   fclose(fp);
+
+  SortedInit();
+}
+
+/* Returns 1 if the n nodes of a grid are in ascending order */
+static int GridSorted(const double *xa, int n)
+{
+  int i;
+
+  for (i = 1 ; i < n ; i++) {
+    if (xa[i] < xa[i-1])
+      return 0;
+  }
+  return 1;
+}
+
+/*
+ * The interval lookups in splint_hunt can only continue from the previous interval
+ * on grids with ascending nodes, the others are always bisected.
+ */
+static void SortedInit(void)
+{
+  int Z;
+
+  for (Z = 0 ; Z <= ZMAX ; Z++) {
+    Sorted_arr[Z][PHOTO_GRID] = GridSorted(E_Photo_arr[Z], NE_Photo[Z]);
+    Sorted_arr[Z][RAYL_GRID] = GridSorted(E_Rayl_arr[Z], NE_Rayl[Z]);
+    Sorted_arr[Z][COMPT_GRID] = GridSorted(E_Compt_arr[Z], NE_Compt[Z]);
+    Sorted_arr[Z][ENERGY_GRID] = GridSorted(E_Energy_arr[Z], NE_Energy[Z]);
+    Sorted_arr[Z][Q_RAYL_GRID] = GridSorted(q_Rayl_arr[Z], Nq_Rayl[Z]);
+    Sorted_arr[Z][Q_COMPT_GRID] = GridSorted(q_Compt_arr[Z], Nq_Compt[Z]);
+    Sorted_arr[Z][FI_GRID] = GridSorted(E_Fi_arr[Z], NE_Fi[Z]);
+    Sorted_arr[Z][FII_GRID] = GridSorted(E_Fii_arr[Z], NE_Fii[Z]);
+    Sorted_arr[Z][COMPTON_PROFILES_GRID] = GridSorted(pz_ComptonProfiles[Z], Npz_ComptonProfiles[Z]);
+  }
 }
 
 void ArrayInit()
@@ -748,8 +784,8 @@ void ArrayInit()
     for (auger = 0 ; auger < AUGERNUM ; auger++)
     	Auger_Transition_Individual[Z][auger] = 0.0;
   }
-  memset(xrf_cross_sections_constants_full, 0, sizeof(xrf_cross_sections_constants_full));
-  memset(xrf_cross_sections_constants_auger_only, 0, sizeof(xrf_cross_sections_constants_auger_only));
+  memset(xrf_cross_sections_constants_full, 0, (ZMAX+1) * sizeof(*xrf_cross_sections_constants_full));
+  memset(xrf_cross_sections_constants_auger_only, 0, (ZMAX+1) * sizeof(*xrf_cross_sections_constants_auger_only));
 }
 
 
@@ -37,71 +37,93 @@ struct MendelElement MendelArraySorted[MENDEL_MAX];
 
 Crystal_Array Crystal_arr = {0, CRYSTALARRAY_MAX};
 
-double AtomicWeight_arr[ZMAX+1];
-double EdgeEnergy_arr[ZMAX+1][SHELLNUM];
-double LineEnergy_arr[ZMAX+1][LINENUM];
-double FluorYield_arr[ZMAX+1][SHELLNUM];
-double JumpFactor_arr[ZMAX+1][SHELLNUM];
-double CosKron_arr[ZMAX+1][TRANSNUM];
-double RadRate_arr[ZMAX+1][LINENUM];
-double AtomicLevelWidth_arr[ZMAX+1][SHELLNUM];
-
-int NE_Photo[ZMAX+1];
+static double AtomicWeight_arr_static[ZMAX+1];
+double *AtomicWeight_arr = AtomicWeight_arr_static;
+static double EdgeEnergy_arr_static[ZMAX+1][SHELLNUM];
+double (*EdgeEnergy_arr)[SHELLNUM] = EdgeEnergy_arr_static;
+static double LineEnergy_arr_static[ZMAX+1][LINENUM];
+double (*LineEnergy_arr)[LINENUM] = LineEnergy_arr_static;
+static double FluorYield_arr_static[ZMAX+1][SHELLNUM];
+double (*FluorYield_arr)[SHELLNUM] = FluorYield_arr_static;
+static double JumpFactor_arr_static[ZMAX+1][SHELLNUM];
+double (*JumpFactor_arr)[SHELLNUM] = JumpFactor_arr_static;
+static double CosKron_arr_static[ZMAX+1][TRANSNUM];
+double (*CosKron_arr)[TRANSNUM] = CosKron_arr_static;
+static double RadRate_arr_static[ZMAX+1][LINENUM];
+double (*RadRate_arr)[LINENUM] = RadRate_arr_static;
+static double AtomicLevelWidth_arr_static[ZMAX+1][SHELLNUM];
+double (*AtomicLevelWidth_arr)[SHELLNUM] = AtomicLevelWidth_arr_static;
+
+static int NE_Photo_static[ZMAX+1];
+int *NE_Photo = NE_Photo_static;
 double *E_Photo_arr[ZMAX+1];
 double *CS_Photo_arr[ZMAX+1];
 double *CS_Photo_arr2[ZMAX+1];
 
-int NE_Rayl[ZMAX+1];
+static int NE_Rayl_static[ZMAX+1];
+int *NE_Rayl = NE_Rayl_static;
 double *E_Rayl_arr[ZMAX+1];
 double *CS_Rayl_arr[ZMAX+1];
 double *CS_Rayl_arr2[ZMAX+1];
 
-int NE_Compt[ZMAX+1];
+static int NE_Compt_static[ZMAX+1];
+int *NE_Compt = NE_Compt_static;
 double *E_Compt_arr[ZMAX+1];
 double *CS_Compt_arr[ZMAX+1];
 double *CS_Compt_arr2[ZMAX+1];
 
-int Nq_Rayl[ZMAX+1];
+static int Nq_Rayl_static[ZMAX+1];
+int *Nq_Rayl = Nq_Rayl_static;
 double *q_Rayl_arr[ZMAX+1];
 double *FF_Rayl_arr[ZMAX+1];
 double *FF_Rayl_arr2[ZMAX+1];
 
-int Nq_Compt[ZMAX+1];
+static int Nq_Compt_static[ZMAX+1];
+int *Nq_Compt = Nq_Compt_static;
 double *q_Compt_arr[ZMAX+1];
 double *SF_Compt_arr[ZMAX+1];
 double *SF_Compt_arr2[ZMAX+1];
 
-int NE_Energy[ZMAX+1];
+static int NE_Energy_static[ZMAX+1];
+int *NE_Energy = NE_Energy_static;
 double *E_Energy_arr[ZMAX+1];
 double *CS_Energy_arr[ZMAX+1];
 double *CS_Energy_arr2[ZMAX+1];
 
 
-int NE_Fi[ZMAX+1];
+static int NE_Fi_static[ZMAX+1];
+int *NE_Fi = NE_Fi_static;
 double *E_Fi_arr[ZMAX+1];
 double *Fi_arr[ZMAX+1];
 double *Fi_arr2[ZMAX+1];
 
-int NE_Fii[ZMAX+1];
+static int NE_Fii_static[ZMAX+1];
+int *NE_Fii = NE_Fii_static;
 double *E_Fii_arr[ZMAX+1];
 double *Fii_arr[ZMAX+1];
 double *Fii_arr2[ZMAX+1];
 
-int NE_Photo_Total_Kissel[ZMAX+1];
+static int NE_Photo_Total_Kissel_static[ZMAX+1];
+int *NE_Photo_Total_Kissel = NE_Photo_Total_Kissel_static;
 double *E_Photo_Total_Kissel[ZMAX+1];
 double *Photo_Total_Kissel[ZMAX+1];
 double *Photo_Total_Kissel2[ZMAX+1];
 
-double Electron_Config_Kissel[ZMAX+1][SHELLNUM_K];
-double EdgeEnergy_Kissel[ZMAX+1][SHELLNUM_K];
+static double Electron_Config_Kissel_static[ZMAX+1][SHELLNUM_K];
+double (*Electron_Config_Kissel)[SHELLNUM_K] = Electron_Config_Kissel_static;
+static double EdgeEnergy_Kissel_static[ZMAX+1][SHELLNUM_K];
+double (*EdgeEnergy_Kissel)[SHELLNUM_K] = EdgeEnergy_Kissel_static;
 
-int NE_Photo_Partial_Kissel[ZMAX+1][SHELLNUM_K];
+static int NE_Photo_Partial_Kissel_static[ZMAX+1][SHELLNUM_K];
+int (*NE_Photo_Partial_Kissel)[SHELLNUM_K] = NE_Photo_Partial_Kissel_static;
 double *E_Photo_Partial_Kissel[ZMAX+1][SHELLNUM_K];
 double *Photo_Partial_Kissel[ZMAX+1][SHELLNUM_K];
 double *Photo_Partial_Kissel2[ZMAX+1][SHELLNUM_K];
 
-int NShells_ComptonProfiles[ZMAX+1];
-int Npz_ComptonProfiles[ZMAX+1];
+static int NShells_ComptonProfiles_static[ZMAX+1];
+int *NShells_ComptonProfiles = NShells_ComptonProfiles_static;
+static int Npz_ComptonProfiles_static[ZMAX+1];
+int *Npz_ComptonProfiles = Npz_ComptonProfiles_static;
 double *UOCCUP_ComptonProfiles[ZMAX+1];
 double *pz_ComptonProfiles[ZMAX+1];
 double *Total_ComptonProfiles[ZMAX+1];
@@ -109,10 +131,18 @@ double *Total_ComptonProfiles2[ZMAX+1];
 double *Partial_ComptonProfiles[ZMAX+1][SHELLNUM_C];
 double *Partial_ComptonProfiles2[ZMAX+1][SHELLNUM_C];
 
-double Auger_Rates[ZMAX+1][AUGERNUM];
-double Auger_Yields[ZMAX+1][SHELLNUM_A];
+static double Auger_Rates_static[ZMAX+1][AUGERNUM];
+double (*Auger_Rates)[AUGERNUM] = Auger_Rates_static;
+static double Auger_Yields_static[ZMAX+1][SHELLNUM_A];
+double (*Auger_Yields)[SHELLNUM_A] = Auger_Yields_static;
 
-double ElementDensity_arr[ZMAX+1];
+static double ElementDensity_arr_static[ZMAX+1];
+double *ElementDensity_arr = ElementDensity_arr_static;
 
-double xrf_cross_sections_constants_full[ZMAX+1][M5_SHELL+1][L3_SHELL+1];
-double xrf_cross_sections_constants_auger_only[ZMAX+1][M5_SHELL+1][L3_SHELL+1];
+static double xrf_cross_sections_constants_full_static[ZMAX+1][M5_SHELL+1][L3_SHELL+1];
+double (*xrf_cross_sections_constants_full)[M5_SHELL+1][L3_SHELL+1] = xrf_cross_sections_constants_full_static;
+static double xrf_cross_sections_constants_auger_only_static[ZMAX+1][M5_SHELL+1][L3_SHELL+1];
+double (*xrf_cross_sections_constants_auger_only)[M5_SHELL+1][L3_SHELL+1] = xrf_cross_sections_constants_auger_only_static;
+
+static int Sorted_arr_static[ZMAX+1][GRIDNUM];
+int (*Sorted_arr)[GRIDNUM] = Sorted_arr_static;
@@ -31,70 +31,75 @@ extern struct MendelElement MendelArraySorted[MENDEL_MAX];
 
 extern Crystal_Array Crystal_arr;
 
-extern double AtomicWeight_arr[ZMAX+1];
-extern double EdgeEnergy_arr[ZMAX+1][SHELLNUM];
-extern double LineEnergy_arr[ZMAX+1][LINENUM];
-extern double FluorYield_arr[ZMAX+1][SHELLNUM];
-extern double JumpFactor_arr[ZMAX+1][SHELLNUM];
-extern double CosKron_arr[ZMAX+1][TRANSNUM];
-extern double RadRate_arr[ZMAX+1][LINENUM];
-extern double AtomicLevelWidth_arr[ZMAX+1][SHELLNUM];
-
-extern int NE_Photo[ZMAX+1];
+/* The fixed size tables are reached through pointers, which XRayLoadDataImage can redirect to a data image */
+
+/* xraylib-fast.h exports read-only copies of some of these pointers, which DataImage_Apply keeps in sync */
+#define XRL_EXTERN_DATA XRL_EXTERN
+
+extern double *AtomicWeight_arr;
+extern double (*EdgeEnergy_arr)[SHELLNUM];
+extern double (*LineEnergy_arr)[LINENUM];
+extern double (*FluorYield_arr)[SHELLNUM];
+extern double (*JumpFactor_arr)[SHELLNUM];
+extern double (*CosKron_arr)[TRANSNUM];
+extern double (*RadRate_arr)[LINENUM];
+extern double (*AtomicLevelWidth_arr)[SHELLNUM];
+
+extern int *NE_Photo;
 extern double *E_Photo_arr[ZMAX+1];
 extern double *CS_Photo_arr[ZMAX+1];
 extern double *CS_Photo_arr2[ZMAX+1];
 
-extern int NE_Rayl[ZMAX+1];
+extern int *NE_Rayl;
 extern double *E_Rayl_arr[ZMAX+1];
 extern double *CS_Rayl_arr[ZMAX+1];
 extern double *CS_Rayl_arr2[ZMAX+1];
 
-extern int NE_Compt[ZMAX+1];
+extern int *NE_Compt;
 extern double *E_Compt_arr[ZMAX+1];
 extern double *CS_Compt_arr[ZMAX+1];
 extern double *CS_Compt_arr2[ZMAX+1];
 
-extern int Nq_Rayl[ZMAX+1];
+extern int *Nq_Rayl;
 extern double *q_Rayl_arr[ZMAX+1];
 extern double *FF_Rayl_arr[ZMAX+1];
 extern double *FF_Rayl_arr2[ZMAX+1];
 
-extern int Nq_Compt[ZMAX+1];
+extern int *Nq_Compt;
 extern double *q_Compt_arr[ZMAX+1];
 extern double *SF_Compt_arr[ZMAX+1];
 extern double *SF_Compt_arr2[ZMAX+1];
 
-extern int NE_Energy[ZMAX+1];
+extern int *NE_Energy;
 extern double *E_Energy_arr[ZMAX+1];
 extern double *CS_Energy_arr[ZMAX+1];
 extern double *CS_Energy_arr2[ZMAX+1];
 
-extern int NE_Fi[ZMAX+1];
+extern int *NE_Fi;
 extern double *E_Fi_arr[ZMAX+1];
 extern double *Fi_arr[ZMAX+1];
 extern double *Fi_arr2[ZMAX+1];
 
-extern int NE_Fii[ZMAX+1];
+extern int *NE_Fii;
 extern double *E_Fii_arr[ZMAX+1];
 extern double *Fii_arr[ZMAX+1];
 extern double *Fii_arr2[ZMAX+1];
 
-extern int NE_Photo_Total_Kissel[ZMAX+1];
+extern int *NE_Photo_Total_Kissel;
 extern double *E_Photo_Total_Kissel[ZMAX+1];
 extern double *Photo_Total_Kissel[ZMAX+1];
 extern double *Photo_Total_Kissel2[ZMAX+1];
 
-extern double Electron_Config_Kissel[ZMAX+1][SHELLNUM_K];
-extern double EdgeEnergy_Kissel[ZMAX+1][SHELLNUM_K];
+extern double (*Electron_Config_Kissel)[SHELLNUM_K];
+extern double (*EdgeEnergy_Kissel)[SHELLNUM_K];
 
-extern int NE_Photo_Partial_Kissel[ZMAX+1][SHELLNUM_K];
+extern int (*NE_Photo_Partial_Kissel)[SHELLNUM_K];
 extern double *E_Photo_Partial_Kissel[ZMAX+1][SHELLNUM_K];
 extern double *Photo_Partial_Kissel[ZMAX+1][SHELLNUM_K];
 extern double *Photo_Partial_Kissel2[ZMAX+1][SHELLNUM_K];
 
-extern int NShells_ComptonProfiles[ZMAX+1];
-extern int Npz_ComptonProfiles[ZMAX+1];
+extern int *NShells_ComptonProfiles;
+extern int *Npz_ComptonProfiles;
 extern double *UOCCUP_ComptonProfiles[ZMAX+1];
 extern double *pz_ComptonProfiles[ZMAX+1];
 extern double *Total_ComptonProfiles[ZMAX+1];
@@ -102,11 +107,28 @@ extern double *Total_ComptonProfiles2[ZMAX+1];
 extern double *Partial_ComptonProfiles[ZMAX+1][SHELLNUM_C];
 extern double *Partial_ComptonProfiles2[ZMAX+1][SHELLNUM_C];
 
-extern double Auger_Rates[ZMAX+1][AUGERNUM];
-extern double Auger_Yields[ZMAX+1][SHELLNUM_A];
-
-extern double ElementDensity_arr[ZMAX+1];
+extern double (*Auger_Rates)[AUGERNUM];
+extern double (*Auger_Yields)[SHELLNUM_A];
+
+extern double *ElementDensity_arr;
+
+extern double (*xrf_cross_sections_constants_full)[M5_SHELL+1][L3_SHELL+1];
+extern double (*xrf_cross_sections_constants_auger_only)[M5_SHELL+1][L3_SHELL+1];
+
+/* The interpolation grids: energies, momentum transfers and pz */
+enum {
+  PHOTO_GRID,
+  RAYL_GRID,
+  COMPT_GRID,
+  ENERGY_GRID,
+  Q_RAYL_GRID,
+  Q_COMPT_GRID,
+  FI_GRID,
+  FII_GRID,
+  COMPTON_PROFILES_GRID,
+  GRIDNUM
+};
 
-extern double xrf_cross_sections_constants_full[ZMAX+1][M5_SHELL+1][L3_SHELL+1];
-extern double xrf_cross_sections_constants_auger_only[ZMAX+1][M5_SHELL+1][L3_SHELL+1];
+/* 1 if the nodes of a grid are in ascending order, checked once when the tables are read */
+extern int (*Sorted_arr)[GRIDNUM];
 #endif
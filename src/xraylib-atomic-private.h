@@ -0,0 +1,69 @@
+/* Copyright (C) 2026 Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans 'AS IS' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef XRAYLIB_ATOMIC_PRIVATE_H
+#define XRAYLIB_ATOMIC_PRIVATE_H
+
+/*
+ * Minimal set of atomic operations, used for the lock-free parts of xraylib.
+ * Loads have acquire semantics, stores have release semantics and
+ * read-modify-write operations are sequentially consistent.
+ * The _relaxed loads and stores only guarantee that values are not torn,
+ * for counters that are read while their owner updates them.
+ */
+
+#if defined(_MSC_VER) && !defined(__clang__)
+
+#include <windows.h>
+
+#define xrl_atomic_load_ptr(p) InterlockedCompareExchangePointer((PVOID volatile *) (p), NULL, NULL)
+#define xrl_atomic_store_ptr(p, v) ((void) InterlockedExchangePointer((PVOID volatile *) (p), (v)))
+#define xrl_atomic_cas_ptr(p, oldval, newval) (InterlockedCompareExchangePointer((PVOID volatile *) (p), (newval), (oldval)) == (oldval))
+#define xrl_atomic_cas_int(p, oldval, newval) (InterlockedCompareExchange((LONG volatile *) (p), (newval), (oldval)) == (oldval))
+#define xrl_atomic_load_int(p) InterlockedCompareExchange((LONG volatile *) (p), 0, 0)
+#define xrl_atomic_store_int(p, v) ((void) InterlockedExchange((LONG volatile *) (p), (v)))
+#define xrl_atomic_inc_int(p) InterlockedIncrement((LONG volatile *) (p))
+#define xrl_atomic_dec_int(p) InterlockedDecrement((LONG volatile *) (p))
+#define xrl_atomic_load_relaxed_int(p) xrl_atomic_load_int(p)
+#define xrl_atomic_store_relaxed_int(p, v) xrl_atomic_store_int(p, v)
+#define xrl_atomic_load_relaxed_uint64(p) ((uint64_t) InterlockedCompareExchange64((LONG64 volatile *) (p), 0, 0))
+#define xrl_atomic_store_relaxed_uint64(p, v) ((void) InterlockedExchange64((LONG64 volatile *) (p), (LONG64) (v)))
+
+#else
+
+#define xrl_atomic_load_ptr(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define xrl_atomic_store_ptr(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define xrl_atomic_cas_ptr(p, oldval, newval) __extension__ ({ \
+  __typeof__(*(p)) _xrl_expected = (oldval); \
+  __atomic_compare_exchange_n((p), &_xrl_expected, (newval), 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); \
+  })
+#define xrl_atomic_cas_int(p, oldval, newval) xrl_atomic_cas_ptr(p, oldval, newval)
+#define xrl_atomic_load_int(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define xrl_atomic_store_int(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define xrl_atomic_inc_int(p) __atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define xrl_atomic_dec_int(p) __atomic_sub_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define xrl_atomic_load_relaxed_int(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define xrl_atomic_store_relaxed_int(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define xrl_atomic_load_relaxed_uint64(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define xrl_atomic_store_relaxed_uint64(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+
+#endif
+
+/*
+ * Lock for the rare writers of otherwise lock-free data, initialized to 0.
+ * Waiters spin briefly and then yield the processor until the lock is released.
+ */
+void xrl_lock_acquire(int *lock);
+
+void xrl_lock_release(int *lock);
+
+#endif
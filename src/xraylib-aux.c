@@ -13,8 +13,19 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 
 #include "config.h"
 #include "xraylib-aux.h"
+#include "xraylib-aux-private.h"
+#include "xraylib-atomic-private.h"
 #include <stdlib.h>
 #include <string.h>
+#include <locale.h>
+#ifdef _WIN32
+  #include <windows.h>
+#elif defined(HAVE_SCHED_YIELD)
+  #include <sched.h>
+#endif
+#if defined(HAVE_USELOCALE) && defined(HAVE_XLOCALE_H)
+  #include <xlocale.h>
+#endif
 
 char *xrl_strdup(const char *str) {
 #ifdef HAVE__STRDUP
@@ -43,4 +54,128 @@ char *xrl_strndup(const char *str, size_t len) {
 
 void *xrl_malloc(size_t size) {
 	return malloc(size);
-}
\ No newline at end of file
+}
+
+#define LOCK_SPINS 64
+
+void xrl_lock_acquire(int *lock) {
+	int spins = 0;
+
+	while (!xrl_atomic_cas_int(lock, 0, 1)) {
+		/* wait for the lock to look free, without writing to it */
+		while (xrl_atomic_load_int(lock) != 0) {
+			if (spins < LOCK_SPINS) {
+				spins++;
+				continue;
+			}
+#ifdef _WIN32
+			SwitchToThread();
+#elif defined(HAVE_SCHED_YIELD)
+			sched_yield();
+#endif
+		}
+	}
+}
+
+void xrl_lock_release(int *lock) {
+	xrl_atomic_store_int(lock, 0);
+}
+
+/* long enough for any number written out in full */
+#define STRTOD_BUFFER_SIZE 128
+
+/*
+ * Parses a number written in the C locale with the strtod of the current locale,
+ * by substituting the decimal point of the current locale for the first '.'.
+ * Used where the C locale cannot be selected for the calling thread only.
+ */
+static double strtod_decimal_point(const char *str, char **endptr) {
+	const char *point = localeconv()->decimal_point;
+	size_t point_length = strlen(point);
+	size_t dot = (size_t) -1, length, consumed, i, j;
+	char buffer[STRTOD_BUFFER_SIZE];
+	char *end;
+	double rv;
+
+	if (strcmp(point, ".") == 0)
+		return strtod(str, endptr);
+
+	/* only the characters that can be part of a number are copied */
+	length = strspn(str, " \t\n\v\f\r+-.0123456789aAbBcCdDeEfFiInNpPtTxXyY");
+	if (length + point_length >= STRTOD_BUFFER_SIZE)
+		length = STRTOD_BUFFER_SIZE - point_length - 1;
+
+	for (i = 0, j = 0; i < length; i++) {
+		if (str[i] == '.' && dot == (size_t) -1) {
+			dot = i;
+			memcpy(buffer + j, point, point_length);
+			j += point_length;
+		}
+		else
+			buffer[j++] = str[i];
+	}
+	buffer[j] = '\0';
+
+	rv = strtod(buffer, &end);
+
+	if (endptr != NULL) {
+		consumed = end - buffer;
+		if (dot != (size_t) -1 && consumed > dot)
+			consumed -= point_length - 1;
+		*endptr = (char *) str + consumed;
+	}
+
+	return rv;
+}
+
+/* The C locale is created on first use, and never freed. */
+
+#ifdef HAVE__CREATE_LOCALE
+static _locale_t c_locale = NULL;
+
+double xrl_strtod_c(const char *str, char **endptr) {
+	_locale_t locale = xrl_atomic_load_ptr(&c_locale);
+
+	if (locale == NULL) {
+		locale = _create_locale(LC_NUMERIC, "C");
+		if (locale == NULL)
+			return strtod_decimal_point(str, endptr);
+		if (!xrl_atomic_cas_ptr(&c_locale, NULL, locale)) {
+			/* another thread beat us to it */
+			_free_locale(locale);
+			locale = xrl_atomic_load_ptr(&c_locale);
+		}
+	}
+
+	return _strtod_l(str, endptr, locale);
+}
+#elif defined(HAVE_NEWLOCALE) && defined(HAVE_USELOCALE)
+static locale_t c_locale = (locale_t) 0;
+
+double xrl_strtod_c(const char *str, char **endptr) {
+	locale_t locale = xrl_atomic_load_ptr(&c_locale), old_locale;
+	double rv;
+
+	if (locale == (locale_t) 0) {
+		locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t) 0);
+		if (locale == (locale_t) 0)
+			return strtod_decimal_point(str, endptr);
+		if (!xrl_atomic_cas_ptr(&c_locale, (locale_t) 0, locale)) {
+			/* another thread beat us to it */
+			freelocale(locale);
+			locale = xrl_atomic_load_ptr(&c_locale);
+		}
+	}
+
+	/* uselocale only affects the calling thread */
+	old_locale = uselocale(locale);
+	rv = strtod(str, endptr);
+	uselocale(old_locale);
+
+	return rv;
+}
+#else
+double xrl_strtod_c(const char *str, char **endptr) {
+	return strtod_decimal_point(str, endptr);
+}
+#endif
@@ -0,0 +1,348 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "config.h"
+#include "xraylib.h"
+#include "xraylib-context.h"
+#include "xrayglob.h"
+#include "splint.h"
+#include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+
+struct _xrl_context {
+  /* the message always points to one of the predefined error messages */
+  xrl_error error;
+  int error_set;
+  xrl_precision precision;
+  xrl_interpolation interpolation;
+  int validation;
+  /* the last interval per interpolation grid (see xrayglob.h) and element */
+  int interval[GRIDNUM][ZMAX + 1];
+};
+
+xrl_context* xrl_context_new(xrl_error **error) {
+  xrl_context *ctx = malloc(sizeof(xrl_context));
+
+  if (ctx == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    return NULL;
+  }
+
+  ctx->error.code = XRL_ERROR_RUNTIME;
+  ctx->error.message = NULL;
+  ctx->error_set = 0;
+  ctx->precision = XRL_PRECISION_DOUBLE;
+  ctx->interpolation = XRL_INTERPOLATION_SPLINE;
+  ctx->validation = 1;
+  /* invalid intervals trigger a bisection on first use */
+  memset(ctx->interval, 0, sizeof(ctx->interval));
+
+  return ctx;
+}
+
+void xrl_context_free(xrl_context *ctx) {
+  free(ctx);
+}
+
+int xrl_context_set_precision(xrl_context *ctx, xrl_precision precision, xrl_error **error) {
+  if (ctx == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CONTEXT_NULL);
+    return 0;
+  }
+  if (precision != XRL_PRECISION_DOUBLE && precision != XRL_PRECISION_SINGLE) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_PRECISION);
+    return 0;
+  }
+  ctx->precision = precision;
+  return 1;
+}
+
+xrl_precision xrl_context_get_precision(const xrl_context *ctx) {
+  return ctx == NULL ? XRL_PRECISION_DOUBLE : ctx->precision;
+}
+
+int xrl_context_set_interpolation(xrl_context *ctx, xrl_interpolation interpolation, xrl_error **error) {
+  if (ctx == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, CONTEXT_NULL);
+    return 0;
+  }
+  if (interpolation != XRL_INTERPOLATION_SPLINE && interpolation != XRL_INTERPOLATION_LINEAR) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_INTERPOLATION);
+    return 0;
+  }
+  ctx->interpolation = interpolation;
+  return 1;
+}
+
+xrl_interpolation xrl_context_get_interpolation(const xrl_context *ctx) {
+  return ctx == NULL ? XRL_INTERPOLATION_SPLINE : ctx->interpolation;
+}
+
+void xrl_context_set_validation(xrl_context *ctx, int validation) {
+  if (ctx != NULL)
+    ctx->validation = validation != 0;
+}
+
+int xrl_context_get_validation(const xrl_context *ctx) {
+  return ctx == NULL ? 1 : ctx->validation;
+}
+
+const xrl_error* xrl_context_get_error(const xrl_context *ctx) {
+  if (ctx == NULL || !ctx->error_set)
+    return NULL;
+  return &ctx->error;
+}
+
+void xrl_context_clear_error(xrl_context *ctx) {
+  if (ctx == NULL)
+    return;
+  ctx->error.message = NULL;
+  ctx->error_set = 0;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+static void Context_SetError(xrl_context *ctx, xrl_error_code code, const char *message) {
+  XRL_STATS_COUNT_ERROR(code);
+  ctx->error.code = code;
+  ctx->error.message = (char *) message;
+  ctx->error_set = 1;
+}
+
+static double Context_Log(const xrl_context *ctx, double x) {
+  if (ctx->precision == XRL_PRECISION_SINGLE)
+    return logf((float) x);
+  return log(x);
+}
+
+static double Context_Exp(const xrl_context *ctx, double x) {
+  if (ctx->precision == XRL_PRECISION_SINGLE)
+    return expf((float) x);
+  return exp(x);
+}
+
+/* Interpolates a table with 1-based arrays, continuing from the last interval of this grid and element */
+static int Context_Interpolate(xrl_context *ctx, int grid, int Z, double xa[], double ya[], double y2a[], int n, double x, double *y) {
+  int sorted = Sorted_arr[Z][grid];
+  int *klo = &ctx->interval[grid][Z];
+
+  if (ctx->interpolation == XRL_INTERPOLATION_LINEAR) {
+    if (!lininterp_hunt(xa, ya, n, x, sorted, klo, y)) {
+      Context_SetError(ctx, XRL_ERROR_INVALID_ARGUMENT, x < xa[1] ? LININTERP_X_TOO_LOW : LININTERP_X_TOO_HIGH);
+      return 0;
+    }
+  }
+  else if (!splint_hunt(xa, ya, y2a, n, x, sorted, klo, y)) {
+    Context_SetError(ctx, XRL_ERROR_INVALID_ARGUMENT, x < xa[1] ? SPLINT_X_TOO_LOW : SPLINT_X_TOO_HIGH);
+    return 0;
+  }
+  return 1;
+}
+
+/* Cross sections are interpolated in log-log space */
+static double Context_CrossSection(xrl_context *ctx, int grid, int Z, double E, double scale, double *E_arr[], double *CS_arr[], double *CS_arr2[], const int NE[]) {
+  double ln_sigma;
+
+  /* the tables are indexed with Z, even without validation */
+  if (Z < 1 || Z > ZMAX || NE[Z] < 0) {
+    Context_SetError(ctx, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE);
+    return 0.0;
+  }
+
+  if (ctx->validation && E <= 0.0) {
+    Context_SetError(ctx, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_ENERGY);
+    return 0.0;
+  }
+
+  if (!Context_Interpolate(ctx, grid, Z, E_arr[Z] - 1, CS_arr[Z] - 1, CS_arr2[Z] - 1, NE[Z], Context_Log(ctx, E * scale), &ln_sigma))
+    return 0.0;
+
+  return Context_Exp(ctx, ln_sigma);
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+double CS_Photo_ctx(xrl_context *ctx, int Z, double E) {
+  XRL_STATS_FUNCTION
+  if (ctx == NULL)
+    return CS_Photo(Z, E, NULL);
+  return Context_CrossSection(ctx, PHOTO_GRID, Z, E, 1000.0, E_Photo_arr, CS_Photo_arr, CS_Photo_arr2, NE_Photo);
+}
+
+double CS_Rayl_ctx(xrl_context *ctx, int Z, double E) {
+  XRL_STATS_FUNCTION
+  if (ctx == NULL)
+    return CS_Rayl(Z, E, NULL);
+  return Context_CrossSection(ctx, RAYL_GRID, Z, E, 1000.0, E_Rayl_arr, CS_Rayl_arr, CS_Rayl_arr2, NE_Rayl);
+}
+
+double CS_Compt_ctx(xrl_context *ctx, int Z, double E) {
+  XRL_STATS_FUNCTION
+  if (ctx == NULL)
+    return CS_Compt(Z, E, NULL);
+  return Context_CrossSection(ctx, COMPT_GRID, Z, E, 1000.0, E_Compt_arr, CS_Compt_arr, CS_Compt_arr2, NE_Compt);
+}
+
+double CS_Energy_ctx(xrl_context *ctx, int Z, double E) {
+  XRL_STATS_FUNCTION
+  if (ctx == NULL)
+    return CS_Energy(Z, E, NULL);
+  /* the energy absorption coefficients are only available up to uranium */
+  if (Z > 92) {
+    Context_SetError(ctx, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE);
+    return 0.0;
+  }
+  return Context_CrossSection(ctx, ENERGY_GRID, Z, E, 1.0, E_Energy_arr, CS_Energy_arr, CS_Energy_arr2, NE_Energy);
+}
+
+double CS_Total_ctx(xrl_context *ctx, int Z, double E) {
+  XRL_STATS_FUNCTION
+  double photo, rayleigh, compton;
+
+  if (ctx == NULL)
+    return CS_Total(Z, E, NULL);
+
+  if ((photo = CS_Photo_ctx(ctx, Z, E)) == 0.0)
+    return 0.0;
+  if ((rayleigh = CS_Rayl_ctx(ctx, Z, E)) == 0.0)
+    return 0.0;
+  if ((compton = CS_Compt_ctx(ctx, Z, E)) == 0.0)
+    return 0.0;
+
+  return photo + rayleigh + compton;
+}
+
+/* the atomic number was validated by the cross section */
+static double Context_Barns(int Z, double cs) {
+  if (cs == 0.0)
+    return 0.0;
+  return cs * AtomicWeight_arr[Z] / AVOGNUM;
+}
+
+double CSb_Total_ctx(xrl_context *ctx, int Z, double E) {
+  XRL_STATS_FUNCTION
+  if (ctx == NULL)
+    return CSb_Total(Z, E, NULL);
+  return Context_Barns(Z, CS_Total_ctx(ctx, Z, E));
+}
+
+double CSb_Photo_ctx(xrl_context *ctx, int Z, double E) {
+  XRL_STATS_FUNCTION
+  if (ctx == NULL)
+    return CSb_Photo(Z, E, NULL);
+  return Context_Barns(Z, CS_Photo_ctx(ctx, Z, E));
+}
+
+double CSb_Rayl_ctx(xrl_context *ctx, int Z, double E) {
+  XRL_STATS_FUNCTION
+  if (ctx == NULL)
+    return CSb_Rayl(Z, E, NULL);
+  return Context_Barns(Z, CS_Rayl_ctx(ctx, Z, E));
+}
+
+double CSb_Compt_ctx(xrl_context *ctx, int Z, double E) {
+  XRL_STATS_FUNCTION
+  if (ctx == NULL)
+    return CSb_Compt(Z, E, NULL);
+  return Context_Barns(Z, CS_Compt_ctx(ctx, Z, E));
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+double FF_Rayl_ctx(xrl_context *ctx, int Z, double q) {
+  XRL_STATS_FUNCTION
+  double FF;
+
+  if (ctx == NULL)
+    return FF_Rayl(Z, q, NULL);
+
+  if (Z < 1 || Z > ZMAX || Nq_Rayl[Z] <= 0) {
+    Context_SetError(ctx, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE);
+    return 0.0;
+  }
+
+  if (ctx->validation && q < 0.0) {
+    Context_SetError(ctx, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_Q);
+    return 0.0;
+  }
+
+  if (q == 0.0)
+    return Z;
+
+  if (!Context_Interpolate(ctx, Q_RAYL_GRID, Z, q_Rayl_arr[Z] - 1, FF_Rayl_arr[Z] - 1, FF_Rayl_arr2[Z] - 1, Nq_Rayl[Z], q, &FF))
+    return 0.0;
+
+  return FF;
+}
+
+double SF_Compt_ctx(xrl_context *ctx, int Z, double q) {
+  XRL_STATS_FUNCTION
+  double SF;
+
+  if (ctx == NULL)
+    return SF_Compt(Z, q, NULL);
+
+  if (Z < 1 || Z > ZMAX || Nq_Compt[Z] <= 0) {
+    Context_SetError(ctx, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE);
+    return 0.0;
+  }
+
+  if (ctx->validation && q <= 0.0) {
+    Context_SetError(ctx, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_Q);
+    return 0.0;
+  }
+
+  if (!Context_Interpolate(ctx, Q_COMPT_GRID, Z, q_Compt_arr[Z] - 1, SF_Compt_arr[Z] - 1, SF_Compt_arr2[Z] - 1, Nq_Compt[Z], q, &SF))
+    return 0.0;
+
+  return SF;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+static double Context_Anomalous(xrl_context *ctx, int grid, int Z, double E, double *E_arr[], double *F_arr[], double *F_arr2[], const int NE[]) {
+  double F;
+
+  if (Z < 1 || Z > ZMAX || NE[Z] < 0) {
+    Context_SetError(ctx, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE);
+    return 0.0;
+  }
+
+  if (ctx->validation && E <= 0.0) {
+    Context_SetError(ctx, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_ENERGY);
+    return 0.0;
+  }
+
+  if (!Context_Interpolate(ctx, grid, Z, E_arr[Z] - 1, F_arr[Z] - 1, F_arr2[Z] - 1, NE[Z], E, &F))
+    return 0.0;
+
+  return F;
+}
+
+double Fi_ctx(xrl_context *ctx, int Z, double E) {
+  XRL_STATS_FUNCTION
+  if (ctx == NULL)
+    return Fi(Z, E, NULL);
+  return Context_Anomalous(ctx, FI_GRID, Z, E, E_Fi_arr, Fi_arr, Fi_arr2, NE_Fi);
+}
+
+double Fii_ctx(xrl_context *ctx, int Z, double E) {
+  XRL_STATS_FUNCTION
+  if (ctx == NULL)
+    return Fii(Z, E, NULL);
+  return Context_Anomalous(ctx, FII_GRID, Z, E, E_Fii_arr, Fii_arr, Fii_arr2, NE_Fii);
+}
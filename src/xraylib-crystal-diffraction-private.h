@@ -0,0 +1,36 @@
+/* Copyright (C) 2026 Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans 'AS IS' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef XRAYLIB_CRYSTAL_DIFFRACTION_PRIVATE_H
+#define XRAYLIB_CRYSTAL_DIFFRACTION_PRIVATE_H
+
+#include "xraylib-crystal-diffraction.h"
+
+/*
+ * The following methods are not visible outside the library!
+ */
+
+/* Grow the allocated size of c_array by n_new crystals. */
+int Crystal_ExtendArray(Crystal_Array* c_array, int n_new, xrl_error **error);
+
+/* Add the crystals of c_array to the official crystals, overwriting existing crystals if replace is non-zero. */
+int Crystal_RegistryAdd(Crystal_Array *c_array, int replace, xrl_error **error);
+
+/* A mapped library: the crystals follow the struct, the atoms and names live in the mapped file.
+ * Crystal_ArrayFree releases it through unmap, which keeps the mapping code out of prdata. */
+typedef struct {
+  Crystal_Array array;
+  void (*unmap)(Crystal_Array *c_array);
+  struct _xrl_mapped_file *file;
+} Crystal_MappedArray;
+
+#endif
@@ -0,0 +1,144 @@
+/* Copyright (C) 2026 Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans 'AS IS' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef XRAYLIB_DATA_IMAGE_PRIVATE_H
+#define XRAYLIB_DATA_IMAGE_PRIVATE_H
+
+/*
+ * Binary data images, written by prdata and loaded with XRayLoadDataImage.
+ *
+ * Layout, little-endian:
+ *   xrl_data_image_header
+ *   xrl_data_image_table[n_tables]
+ *   the contents of the tables, each starting at a multiple of XRL_DATA_IMAGE_ALIGNMENT bytes,
+ *   grouped by section (XRL_DATA_SECTION_*) with each section starting at a multiple of
+ *   XRL_DATA_IMAGE_SECTION_ALIGNMENT bytes, so its pages can be read in and dropped on their own
+ * The fixed size tables are stored as they are laid out in memory.
+ * The variable length tables store the arrays of all elements (and shells) back to back,
+ * their lengths follow from the count tables.
+ */
+
+#define XRL_DATA_IMAGE_MAGIC "XRLDATA"
+#define XRL_DATA_IMAGE_VERSION 2
+#define XRL_DATA_IMAGE_BYTE_ORDER 0x01020304
+#define XRL_DATA_IMAGE_ALIGNMENT 64
+#define XRL_DATA_IMAGE_NAME_SIZE 48
+
+typedef struct {
+  char magic[8];
+  int version;
+  int byte_order;
+  int header_size;
+  int n_tables;
+  int file_size;
+  int sizeof_int;
+  int reserved[8];
+} xrl_data_image_header;
+
+typedef struct {
+  char name[XRL_DATA_IMAGE_NAME_SIZE];
+  int offset;
+  int size;
+  int reserved[2];
+} xrl_data_image_table;
+
+/* fixed size tables: section, type, name and number of elements */
+#define XRL_DATA_IMAGE_FIXED_TABLES(X) \
+  X(XRL_DATA_SECTION_ATOMIC, double, AtomicWeight_arr, ZMAX + 1) \
+  X(XRL_DATA_SECTION_ATOMIC, double, ElementDensity_arr, ZMAX + 1) \
+  X(XRL_DATA_SECTION_ATOMIC, double, EdgeEnergy_arr, (ZMAX + 1) * SHELLNUM) \
+  X(XRL_DATA_SECTION_ATOMIC, double, AtomicLevelWidth_arr, (ZMAX + 1) * SHELLNUM) \
+  X(XRL_DATA_SECTION_ATOMIC, double, LineEnergy_arr, (ZMAX + 1) * LINENUM) \
+  X(XRL_DATA_SECTION_ATOMIC, double, FluorYield_arr, (ZMAX + 1) * SHELLNUM) \
+  X(XRL_DATA_SECTION_ATOMIC, double, JumpFactor_arr, (ZMAX + 1) * SHELLNUM) \
+  X(XRL_DATA_SECTION_ATOMIC, double, CosKron_arr, (ZMAX + 1) * TRANSNUM) \
+  X(XRL_DATA_SECTION_ATOMIC, double, RadRate_arr, (ZMAX + 1) * LINENUM) \
+  X(XRL_DATA_SECTION_ATOMIC, int, Sorted_arr, (ZMAX + 1) * GRIDNUM) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, int, NE_Photo, ZMAX + 1) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, int, NE_Rayl, ZMAX + 1) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, int, NE_Compt, ZMAX + 1) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, int, NE_Energy, ZMAX + 1) \
+  X(XRL_DATA_SECTION_SCATTERING_FACTORS, int, Nq_Rayl, ZMAX + 1) \
+  X(XRL_DATA_SECTION_SCATTERING_FACTORS, int, Nq_Compt, ZMAX + 1) \
+  X(XRL_DATA_SECTION_ANOMALOUS, int, NE_Fi, ZMAX + 1) \
+  X(XRL_DATA_SECTION_ANOMALOUS, int, NE_Fii, ZMAX + 1) \
+  X(XRL_DATA_SECTION_KISSEL, double, Electron_Config_Kissel, (ZMAX + 1) * SHELLNUM_K) \
+  X(XRL_DATA_SECTION_KISSEL, double, EdgeEnergy_Kissel, (ZMAX + 1) * SHELLNUM_K) \
+  X(XRL_DATA_SECTION_KISSEL, int, NE_Photo_Total_Kissel, ZMAX + 1) \
+  X(XRL_DATA_SECTION_KISSEL, int, NE_Photo_Partial_Kissel, (ZMAX + 1) * SHELLNUM_K) \
+  X(XRL_DATA_SECTION_COMPTON_PROFILES, int, NShells_ComptonProfiles, ZMAX + 1) \
+  X(XRL_DATA_SECTION_COMPTON_PROFILES, int, Npz_ComptonProfiles, ZMAX + 1) \
+  X(XRL_DATA_SECTION_AUGER, double, Auger_Rates, (ZMAX + 1) * AUGERNUM) \
+  X(XRL_DATA_SECTION_AUGER, double, Auger_Yields, (ZMAX + 1) * SHELLNUM_A) \
+  X(XRL_DATA_SECTION_AUGER, double, xrf_cross_sections_constants_full, (ZMAX + 1) * (M5_SHELL + 1) * (L3_SHELL + 1)) \
+  X(XRL_DATA_SECTION_AUGER, double, xrf_cross_sections_constants_auger_only, (ZMAX + 1) * (M5_SHELL + 1) * (L3_SHELL + 1))
+
+/* one array per element: section, name and the table with the number of values of each element */
+#define XRL_DATA_IMAGE_ELEMENT_TABLES(X) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, E_Photo_arr, NE_Photo) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, CS_Photo_arr, NE_Photo) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, CS_Photo_arr2, NE_Photo) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, E_Rayl_arr, NE_Rayl) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, CS_Rayl_arr, NE_Rayl) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, CS_Rayl_arr2, NE_Rayl) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, E_Compt_arr, NE_Compt) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, CS_Compt_arr, NE_Compt) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, CS_Compt_arr2, NE_Compt) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, E_Energy_arr, NE_Energy) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, CS_Energy_arr, NE_Energy) \
+  X(XRL_DATA_SECTION_CROSS_SECTIONS, CS_Energy_arr2, NE_Energy) \
+  X(XRL_DATA_SECTION_SCATTERING_FACTORS, q_Rayl_arr, Nq_Rayl) \
+  X(XRL_DATA_SECTION_SCATTERING_FACTORS, FF_Rayl_arr, Nq_Rayl) \
+  X(XRL_DATA_SECTION_SCATTERING_FACTORS, FF_Rayl_arr2, Nq_Rayl) \
+  X(XRL_DATA_SECTION_SCATTERING_FACTORS, q_Compt_arr, Nq_Compt) \
+  X(XRL_DATA_SECTION_SCATTERING_FACTORS, SF_Compt_arr, Nq_Compt) \
+  X(XRL_DATA_SECTION_SCATTERING_FACTORS, SF_Compt_arr2, Nq_Compt) \
+  X(XRL_DATA_SECTION_ANOMALOUS, E_Fi_arr, NE_Fi) \
+  X(XRL_DATA_SECTION_ANOMALOUS, Fi_arr, NE_Fi) \
+  X(XRL_DATA_SECTION_ANOMALOUS, Fi_arr2, NE_Fi) \
+  X(XRL_DATA_SECTION_ANOMALOUS, E_Fii_arr, NE_Fii) \
+  X(XRL_DATA_SECTION_ANOMALOUS, Fii_arr, NE_Fii) \
+  X(XRL_DATA_SECTION_ANOMALOUS, Fii_arr2, NE_Fii) \
+  X(XRL_DATA_SECTION_KISSEL, E_Photo_Total_Kissel, NE_Photo_Total_Kissel) \
+  X(XRL_DATA_SECTION_KISSEL, Photo_Total_Kissel, NE_Photo_Total_Kissel) \
+  X(XRL_DATA_SECTION_KISSEL, Photo_Total_Kissel2, NE_Photo_Total_Kissel) \
+  X(XRL_DATA_SECTION_COMPTON_PROFILES, UOCCUP_ComptonProfiles, NShells_ComptonProfiles) \
+  X(XRL_DATA_SECTION_COMPTON_PROFILES, pz_ComptonProfiles, Npz_ComptonProfiles) \
+  X(XRL_DATA_SECTION_COMPTON_PROFILES, Total_ComptonProfiles, Npz_ComptonProfiles) \
+  X(XRL_DATA_SECTION_COMPTON_PROFILES, Total_ComptonProfiles2, Npz_ComptonProfiles)
+
+/* one array per element and Kissel shell, with NE_Photo_Partial_Kissel values */
+#define XRL_DATA_IMAGE_KISSEL_TABLES(X) \
+  X(XRL_DATA_SECTION_KISSEL, E_Photo_Partial_Kissel) \
+  X(XRL_DATA_SECTION_KISSEL, Photo_Partial_Kissel) \
+  X(XRL_DATA_SECTION_KISSEL, Photo_Partial_Kissel2)
+
+/* one array per element and occupied shell, with Npz_ComptonProfiles values */
+#define XRL_DATA_IMAGE_COMPTON_TABLES(X) \
+  X(XRL_DATA_SECTION_COMPTON_PROFILES, Partial_ComptonProfiles) \
+  X(XRL_DATA_SECTION_COMPTON_PROFILES, Partial_ComptonProfiles2)
+
+#define XRL_DATA_IMAGE_COUNT2(a, b) + 1
+#define XRL_DATA_IMAGE_COUNT3(a, b, c) + 1
+#define XRL_DATA_IMAGE_COUNT4(a, b, c, d) + 1
+
+#define XRL_DATA_IMAGE_N_TABLES (0 \
+  XRL_DATA_IMAGE_FIXED_TABLES(XRL_DATA_IMAGE_COUNT4) \
+  XRL_DATA_IMAGE_ELEMENT_TABLES(XRL_DATA_IMAGE_COUNT3) \
+  XRL_DATA_IMAGE_KISSEL_TABLES(XRL_DATA_IMAGE_COUNT2) \
+  XRL_DATA_IMAGE_COMPTON_TABLES(XRL_DATA_IMAGE_COUNT2))
+
+/* the tables of a section are stored together, starting at a page boundary */
+#define XRL_DATA_IMAGE_SECTION_ALIGNMENT 4096
+#define XRL_DATA_IMAGE_N_SECTIONS 7
+
+#endif
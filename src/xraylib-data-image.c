@@ -0,0 +1,365 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "config.h"
+#include "xraylib.h"
+#include "xrayglob.h"
+#include "xraylib-fast.h"
+#include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
+#include "xraylib-mmap-private.h"
+#include "xraylib-data-image-private.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/* All table pointers that a data image redirects */
+typedef struct {
+#define X(section, type, name, count) void *name;
+  XRL_DATA_IMAGE_FIXED_TABLES(X)
+#undef X
+#define X(section, name, count) double *name[ZMAX + 1];
+  XRL_DATA_IMAGE_ELEMENT_TABLES(X)
+#undef X
+#define X(section, name) double *name[ZMAX + 1][SHELLNUM_K];
+  XRL_DATA_IMAGE_KISSEL_TABLES(X)
+#undef X
+#define X(section, name) double *name[ZMAX + 1][SHELLNUM_C];
+  XRL_DATA_IMAGE_COMPTON_TABLES(X)
+#undef X
+} DataImage_Tables;
+
+/* Byte range of the tables of a section within the image */
+typedef struct {
+  size_t begin;
+  size_t end;
+} DataImage_Section;
+
+/* the compiled-in tables, saved when the first image gets loaded */
+static DataImage_Tables builtin_tables;
+static int builtin_tables_saved = 0;
+static xrl_mapped_file *data_image = NULL;
+static DataImage_Section data_image_sections[XRL_DATA_IMAGE_N_SECTIONS];
+
+static void DataImage_Save(DataImage_Tables *tables) {
+#define X(section, type, name, count) tables->name = (void *) name;
+  XRL_DATA_IMAGE_FIXED_TABLES(X)
+#undef X
+#define X(section, name, count) memcpy(tables->name, name, sizeof(tables->name));
+  XRL_DATA_IMAGE_ELEMENT_TABLES(X)
+#undef X
+#define X(section, name) memcpy(tables->name, name, sizeof(tables->name));
+  XRL_DATA_IMAGE_KISSEL_TABLES(X)
+  XRL_DATA_IMAGE_COMPTON_TABLES(X)
+#undef X
+}
+
+static void DataImage_Apply(const DataImage_Tables *tables) {
+#define X(section, type, name, count) name = tables->name;
+  XRL_DATA_IMAGE_FIXED_TABLES(X)
+#undef X
+#define X(section, name, count) memcpy(name, tables->name, sizeof(tables->name));
+  XRL_DATA_IMAGE_ELEMENT_TABLES(X)
+#undef X
+#define X(section, name) memcpy(name, tables->name, sizeof(tables->name));
+  XRL_DATA_IMAGE_KISSEL_TABLES(X)
+  XRL_DATA_IMAGE_COMPTON_TABLES(X)
+#undef X
+
+  /* the read-only copies in xraylib-fast.h */
+  xrl_fast_atomic_weight = AtomicWeight_arr;
+  xrl_fast_element_density = ElementDensity_arr;
+  xrl_fast_edge_energy = (const double (*)[SHELLNUM]) EdgeEnergy_arr;
+  xrl_fast_fluor_yield = (const double (*)[SHELLNUM]) FluorYield_arr;
+  xrl_fast_jump_factor = (const double (*)[SHELLNUM]) JumpFactor_arr;
+  xrl_fast_atomic_level_width = (const double (*)[SHELLNUM]) AtomicLevelWidth_arr;
+  xrl_fast_line_energy = (const double (*)[LINENUM]) LineEnergy_arr;
+  xrl_fast_rad_rate = (const double (*)[LINENUM]) RadRate_arr;
+  xrl_fast_cos_kron = (const double (*)[TRANSNUM]) CosKron_arr;
+  xrl_fast_auger_rates = (const double (*)[AUGERNUM]) Auger_Rates;
+}
+
+/* Index of a single section flag */
+static int DataImage_SectionIndex(int section) {
+  int index = 0;
+
+  while ((section >>= 1) != 0)
+    index++;
+  return index;
+}
+
+/*
+ * Returns the contents of a table, provided it has the expected size, or NULL.
+ * The range of its section is extended to cover the table.
+ */
+static double* DataImage_Find(const xrl_mapped_file *file, int section, const char *name, size_t size, DataImage_Section *sections) {
+  DataImage_Section *range = &sections[DataImage_SectionIndex(section)];
+  const xrl_data_image_header *header = file->data;
+  const xrl_data_image_table *tables = (const xrl_data_image_table *) (header + 1);
+  int i;
+
+  for (i = 0; i < header->n_tables; i++) {
+    if (strncmp(tables[i].name, name, XRL_DATA_IMAGE_NAME_SIZE) != 0)
+      continue;
+    if (tables[i].size < 0 || (size_t) tables[i].size != size || tables[i].offset < 0 ||
+      tables[i].offset % XRL_DATA_IMAGE_ALIGNMENT != 0 || size > file->size || (size_t) tables[i].offset > file->size - size)
+      return NULL;
+    if (range->begin == range->end) {
+      range->begin = tables[i].offset;
+      range->end = tables[i].offset + size;
+    }
+    else {
+      if ((size_t) tables[i].offset < range->begin)
+        range->begin = tables[i].offset;
+      if (tables[i].offset + size > range->end)
+        range->end = tables[i].offset + size;
+    }
+    return (double *) ((const char *) file->data + tables[i].offset);
+  }
+  return NULL;
+}
+
+/* Negative counts mark missing data, just like zero */
+#define DATA_IMAGE_COUNT(count) ((count) > 0 ? (count) : 0)
+
+static size_t DataImage_Sum(const int *counts, int n) {
+  size_t sum = 0;
+  int i;
+
+  for (i = 0; i < n; i++)
+    sum += DATA_IMAGE_COUNT(counts[i]);
+  return sum;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+int XRayLoadDataImage(const char *file_name, xrl_error **error) {
+  XRL_STATS_FUNCTION
+  xrl_mapped_file *file;
+  const xrl_data_image_header *header;
+  DataImage_Tables *tables;
+  DataImage_Section sections[XRL_DATA_IMAGE_N_SECTIONS];
+  double *data;
+  size_t n_values;
+  int Z, shell;
+
+  if (file_name == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_IO, "NULL filenames are not allowed");
+    return 0;
+  }
+
+  if ((file = xrl_mapped_file_new(file_name, error)) == NULL)
+    return 0;
+
+  header = file->data;
+  if (file->size < sizeof(xrl_data_image_header) || memcmp(header->magic, XRL_DATA_IMAGE_MAGIC, sizeof(XRL_DATA_IMAGE_MAGIC)) != 0) {
+    xrl_set_error(error, XRL_ERROR_IO, "%s is not a xraylib data image", file_name);
+    xrl_mapped_file_free(file);
+    return 0;
+  }
+  if (header->version != XRL_DATA_IMAGE_VERSION || header->byte_order != XRL_DATA_IMAGE_BYTE_ORDER ||
+    header->header_size != sizeof(xrl_data_image_header) || header->sizeof_int != sizeof(int)) {
+    xrl_set_error(error, XRL_ERROR_IO, "%s was written by an incompatible version or platform", file_name);
+    xrl_mapped_file_free(file);
+    return 0;
+  }
+  if (header->file_size < 0 || (size_t) header->file_size != file->size || header->n_tables < 0 ||
+    (size_t) header->n_tables > (file->size - sizeof(xrl_data_image_header)) / sizeof(xrl_data_image_table)) {
+    xrl_set_error(error, XRL_ERROR_IO, "%s is corrupt", file_name);
+    xrl_mapped_file_free(file);
+    return 0;
+  }
+
+  tables = malloc(sizeof(DataImage_Tables));
+  if (tables == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    xrl_mapped_file_free(file);
+    return 0;
+  }
+
+  /* look up all tables before touching the current ones */
+  memset(sections, 0, sizeof(sections));
+#define X(section, type, name, count) \
+  if ((tables->name = DataImage_Find(file, section, #name, (count) * sizeof(type), sections)) == NULL) \
+    goto corrupt;
+  XRL_DATA_IMAGE_FIXED_TABLES(X)
+#undef X
+
+  for (Z = 0; Z <= ZMAX; Z++) {
+    if (((int *) tables->NShells_ComptonProfiles)[Z] > SHELLNUM_C)
+      goto corrupt;
+  }
+
+#define X(section, name, count) \
+  n_values = DataImage_Sum(tables->count, ZMAX + 1); \
+  if ((data = DataImage_Find(file, section, #name, n_values * sizeof(double), sections)) == NULL) \
+    goto corrupt; \
+  for (Z = 0; Z <= ZMAX; Z++) { \
+    tables->name[Z] = data; \
+    data += DATA_IMAGE_COUNT(((int *) tables->count)[Z]); \
+  }
+  XRL_DATA_IMAGE_ELEMENT_TABLES(X)
+#undef X
+
+#define X(section, name) \
+  n_values = DataImage_Sum(tables->NE_Photo_Partial_Kissel, (ZMAX + 1) * SHELLNUM_K); \
+  if ((data = DataImage_Find(file, section, #name, n_values * sizeof(double), sections)) == NULL) \
+    goto corrupt; \
+  for (Z = 0; Z <= ZMAX; Z++) { \
+    for (shell = 0; shell < SHELLNUM_K; shell++) { \
+      tables->name[Z][shell] = data; \
+      data += DATA_IMAGE_COUNT(((int (*)[SHELLNUM_K]) tables->NE_Photo_Partial_Kissel)[Z][shell]); \
+    } \
+  }
+  XRL_DATA_IMAGE_KISSEL_TABLES(X)
+#undef X
+
+  /* only the occupied shells have profiles */
+#define X(section, name) \
+  n_values = 0; \
+  for (Z = 0; Z <= ZMAX; Z++) { \
+    for (shell = 0; shell < ((int *) tables->NShells_ComptonProfiles)[Z]; shell++) { \
+      if (tables->UOCCUP_ComptonProfiles[Z][shell] > 0.0) \
+        n_values += DATA_IMAGE_COUNT(((int *) tables->Npz_ComptonProfiles)[Z]); \
+    } \
+  } \
+  if ((data = DataImage_Find(file, section, #name, n_values * sizeof(double), sections)) == NULL) \
+    goto corrupt; \
+  for (Z = 0; Z <= ZMAX; Z++) { \
+    for (shell = 0; shell < SHELLNUM_C; shell++) { \
+      if (shell < ((int *) tables->NShells_ComptonProfiles)[Z] && tables->UOCCUP_ComptonProfiles[Z][shell] > 0.0) { \
+        tables->name[Z][shell] = data; \
+        data += DATA_IMAGE_COUNT(((int *) tables->Npz_ComptonProfiles)[Z]); \
+      } \
+      else \
+        tables->name[Z][shell] = NULL; \
+    } \
+  }
+  XRL_DATA_IMAGE_COMPTON_TABLES(X)
+#undef X
+
+  if (!builtin_tables_saved) {
+    DataImage_Save(&builtin_tables);
+    builtin_tables_saved = 1;
+  }
+  DataImage_Apply(tables);
+  free(tables);
+
+  xrl_mapped_file_free(data_image);
+  data_image = file;
+  memcpy(data_image_sections, sections, sizeof(sections));
+
+  return 1;
+
+corrupt:
+  xrl_set_error(error, XRL_ERROR_IO, "%s is corrupt", file_name);
+  free(tables);
+  xrl_mapped_file_free(file);
+  return 0;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+void XRayUnloadDataImage(void) {
+  XRL_STATS_FUNCTION
+  if (data_image == NULL)
+    return;
+  DataImage_Apply(&builtin_tables);
+  xrl_mapped_file_free(data_image);
+  data_image = NULL;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+/* Reads one byte of every page of a table, faulting in the pages that are not resident yet */
+static void DataImage_Touch(const void *data, size_t size) {
+  const volatile char *bytes = data;
+  size_t i;
+
+  if (data == NULL || size == 0)
+    return;
+  for (i = 0; i < size; i += XRL_DATA_IMAGE_SECTION_ALIGNMENT)
+    (void) bytes[i];
+  (void) bytes[size - 1];
+}
+
+int XRayPreloadDataSections(int sections, xrl_error **error) {
+  XRL_STATS_FUNCTION
+  int Z, shell, i;
+
+  if ((sections & ~XRL_DATA_SECTION_ALL) != 0) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, INVALID_DATA_SECTIONS);
+    return 0;
+  }
+
+  if (data_image != NULL) {
+    for (i = 0; i < XRL_DATA_IMAGE_N_SECTIONS; i++) {
+      if (sections & (1 << i))
+        xrl_mapped_file_prefetch(data_image, data_image_sections[i].begin, data_image_sections[i].end - data_image_sections[i].begin);
+    }
+  }
+
+  /* go through the current table pointers, which works for the compiled-in tables as well */
+#define X(section, type, name, count) \
+  if (sections & section) \
+    DataImage_Touch(name, (count) * sizeof(type));
+  XRL_DATA_IMAGE_FIXED_TABLES(X)
+#undef X
+
+#define X(section, name, count) \
+  if (sections & section) { \
+    for (Z = 0; Z <= ZMAX; Z++) \
+      DataImage_Touch(name[Z], DATA_IMAGE_COUNT(count[Z]) * sizeof(double)); \
+  }
+  XRL_DATA_IMAGE_ELEMENT_TABLES(X)
+#undef X
+
+#define X(section, name) \
+  if (sections & section) { \
+    for (Z = 0; Z <= ZMAX; Z++) { \
+      for (shell = 0; shell < SHELLNUM_K; shell++) \
+        DataImage_Touch(name[Z][shell], DATA_IMAGE_COUNT(NE_Photo_Partial_Kissel[Z][shell]) * sizeof(double)); \
+    } \
+  }
+  XRL_DATA_IMAGE_KISSEL_TABLES(X)
+#undef X
+
+#define X(section, name) \
+  if (sections & section) { \
+    for (Z = 0; Z <= ZMAX; Z++) { \
+      for (shell = 0; shell < NShells_ComptonProfiles[Z] && shell < SHELLNUM_C; shell++) { \
+        if (UOCCUP_ComptonProfiles[Z][shell] > 0.0) \
+          DataImage_Touch(name[Z][shell], DATA_IMAGE_COUNT(Npz_ComptonProfiles[Z]) * sizeof(double)); \
+      } \
+    } \
+  }
+  XRL_DATA_IMAGE_COMPTON_TABLES(X)
+#undef X
+
+  return 1;
+}
+
+/*-------------------------------------------------------------------------------------------------- */
+
+void XRayReleaseDataSections(int sections) {
+  int i;
+
+  if (data_image == NULL)
+    return;
+
+  for (i = 0; i < XRL_DATA_IMAGE_N_SECTIONS; i++) {
+    if (sections & (1 << i))
+      xrl_mapped_file_evict(data_image, data_image_sections[i].begin, data_image_sections[i].end - data_image_sections[i].begin);
+  }
+}
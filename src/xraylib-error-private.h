@@ -68,10 +68,30 @@ void xrl_set_error_literal(xrl_error **err, xrl_error_code code, const char *mes
 #define INVALID_MILLER "Miller indices cannot all be zero"
 #define NEGATIVE_DEBYE_FACTOR "Debye-Waller factor must be strictly positive"
 #define CRYSTAL_NULL "Crystal cannot be NULL"
+#define CRYSTAL_ARRAY_MAPPED "Crystal arrays mapped with Crystal_ArrayMapBinary are read-only"
+#define REFLECTION_NULL "Reflection cannot be NULL"
+#define NEGATIVE_THICKNESS "Thickness must be strictly positive"
+#define INVALID_GEOMETRY "Invalid diffraction geometry"
+#define INVALID_POLARIZATION "Invalid polarization"
+#define REFLECTION_NOT_ACCESSIBLE "Reflection cannot be excited at this energy and geometry"
+#define NEGATIVE_D_MIN "d_min must be strictly positive"
+#define INVALID_GRAZING_ANGLE "Grazing angle must be between 0 and pi/2"
+#define NEGATIVE_ROUGHNESS "Roughness must be positive"
+#define INVALID_DATA_SECTIONS "Invalid data sections"
+#define CONTEXT_NULL "Context cannot be NULL"
+#define INVALID_PRECISION "Invalid precision"
+#define INVALID_INTERPOLATION "Invalid interpolation"
 #define SPLINT_X_TOO_LOW "Spline extrapolation is not allowed"
 #define SPLINT_X_TOO_HIGH "Spline extrapolation is not allowed"
 #define LININTERP_X_TOO_LOW "Linear extrapolation is not allowed"
 #define LININTERP_X_TOO_HIGH "Linear extrapolation is not allowed"
+#define NULL_ARRAY "Array arguments cannot be NULL"
+#define INVALID_ARRAY_LENGTH "Array length must be strictly positive"
+#define STATS_UNSUPPORTED "xraylib was built without statistics: reconfigure with --enable-stats"
+#define NEGATIVE_TIMING_INTERVAL "Timing interval must be positive"
+#define NULL_STATS "Statistics cannot be NULL"
+#define TABLE_NULL "Table name cannot be NULL"
+#define UNKNOWN_TABLE "Unknown table %s"
 
 #endif
 
@@ -13,6 +13,8 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans 'AS IS' AND ANY EXPRESS OR IMPLIED W
 #include "config.h"
 #include "xraylib-aux.h"
 #include "xraylib-error-private.h"
+#include "xraylib-atomic-private.h"
+#include "xraylib-stats-private.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -83,8 +85,65 @@ xrl_error* xrl_error_new_literal(xrl_error_code code, const char *message) {
 	return error;
 }
 
+/*
+ * Errors with literal messages are shared: every combination of code and message gets
+ * allocated once and is handed out by xrl_set_error_literal from then on, which keeps
+ * memory allocation out of functions that fail routinely, e.g. below an absorption edge.
+ * xrl_error_free leaves them alone, so callers see no difference.
+ * The table is indexed by the address of the message, which is nearly always a string literal,
+ * and the contents are compared as well in case a buffer gets reused for a different message.
+ * It only grows: slots are claimed with a compare-and-swap and become visible
+ * once their contents have been written.
+ */
+#define STATIC_ERRORS_SIZE 512
+#define STATIC_ERRORS_PROBES 16
+
+enum {
+	STATIC_ERROR_EMPTY,
+	STATIC_ERROR_WRITING,
+	STATIC_ERROR_READY
+};
+
+static xrl_error static_errors[STATIC_ERRORS_SIZE];
+static const char *static_errors_key[STATIC_ERRORS_SIZE];
+static int static_errors_state[STATIC_ERRORS_SIZE];
+
+static int xrl_error_is_static(const xrl_error *error) {
+	return error >= static_errors && error < static_errors + STATIC_ERRORS_SIZE;
+}
+
+/* Returns the shared error for code and message, or NULL if the table has no room for it */
+static xrl_error* xrl_error_get_static(xrl_error_code code, const char *message) {
+	size_t slot = (((size_t) message >> 3) ^ (size_t) code) % STATIC_ERRORS_SIZE;
+	int probe;
+
+	for (probe = 0 ; probe < STATIC_ERRORS_PROBES ; probe++, slot = (slot + 1) % STATIC_ERRORS_SIZE) {
+		int state = xrl_atomic_load_int(&static_errors_state[slot]);
+
+		if (state == STATIC_ERROR_EMPTY && xrl_atomic_cas_int(&static_errors_state[slot], STATIC_ERROR_EMPTY, STATIC_ERROR_WRITING)) {
+			char *copy = xrl_strdup(message);
+			if (copy == NULL) {
+				xrl_atomic_store_int(&static_errors_state[slot], STATIC_ERROR_EMPTY);
+				return NULL;
+			}
+			static_errors[slot].code = code;
+			static_errors[slot].message = copy;
+			static_errors_key[slot] = message;
+			xrl_atomic_store_int(&static_errors_state[slot], STATIC_ERROR_READY);
+			return &static_errors[slot];
+		}
+		/* another thread may have filled the slot in the meantime */
+		if (state != STATIC_ERROR_READY)
+			state = xrl_atomic_load_int(&static_errors_state[slot]);
+		if (state == STATIC_ERROR_READY && static_errors_key[slot] == message && static_errors[slot].code == code &&
+			strcmp(static_errors[slot].message, message) == 0)
+			return &static_errors[slot];
+	}
+	return NULL;
+}
+
 void xrl_error_free(xrl_error *error) {
-	if (error == NULL)
+	if (error == NULL || xrl_error_is_static(error))
 		return;
 
 	if (error->message)
@@ -123,6 +182,8 @@ void xrl_set_error(xrl_error **err, xrl_error_code code , const char *format, ..
 
 	va_list args;
 
+	XRL_STATS_COUNT_ERROR(code);
+
 	if (err == NULL)
 		return;
 
@@ -139,11 +200,15 @@ void xrl_set_error(xrl_error **err, xrl_error_code code , const char *format, ..
 }
 
 void xrl_set_error_literal(xrl_error **err, xrl_error_code code, const char *message) {
+	XRL_STATS_COUNT_ERROR(code);
+
 	if (err == NULL)
 		return;
 
-	if (*err == NULL)
-		*err = xrl_error_new_literal(code, message);
+	if (*err == NULL) {
+		if (message == NULL || (*err = xrl_error_get_static(code, message)) == NULL)
+			*err = xrl_error_new_literal(code, message);
+	}
 	else
 		fprintf(stderr, ERROR_OVERWRITTEN_WARNING, message);
 }
@@ -0,0 +1,46 @@
+/* Copyright (C) 2026 Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans 'AS IS' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef XRAYLIB_MMAP_PRIVATE_H
+#define XRAYLIB_MMAP_PRIVATE_H
+
+#include <stddef.h>
+#include "xraylib-error.h"
+
+/*
+ * Read-only view of the complete contents of a file.
+ * Where supported, the file is memory-mapped, otherwise it is read into memory.
+ * The data is aligned to at least 8 bytes.
+ */
+
+typedef struct _xrl_mapped_file xrl_mapped_file;
+
+struct _xrl_mapped_file {
+  const void *data;
+  size_t size;
+  void *priv;
+};
+
+xrl_mapped_file* xrl_mapped_file_new(const char *file_name, xrl_error **error);
+
+void xrl_mapped_file_free(xrl_mapped_file *file);
+
+/*
+ * Paging hints for a byte range of a mapped file: prefetch asks for the pages to be read in ahead of use,
+ * evict drops the pages that lie completely inside the range, they are read from the file again when touched.
+ * Both are no-ops when the contents were read into memory or when the platform offers no such hints.
+ */
+void xrl_mapped_file_prefetch(const xrl_mapped_file *file, size_t offset, size_t size);
+
+void xrl_mapped_file_evict(const xrl_mapped_file *file, size_t offset, size_t size);
+
+#endif
@@ -0,0 +1,254 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "config.h"
+#include "xraylib-mmap-private.h"
+#include "xraylib-error-private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+#elif defined(HAVE_MMAP)
+  #include <sys/types.h>
+  #include <sys/stat.h>
+  #include <sys/mman.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+/*
+ * priv is NULL when the contents were read into a malloc'ed buffer,
+ * otherwise it holds the platform specific mapping state.
+ */
+
+static xrl_mapped_file* xrl_mapped_file_read(const char *file_name, xrl_error **error) {
+  xrl_mapped_file *file;
+  FILE *fp;
+  long size;
+  void *data;
+
+  if ((fp = fopen(file_name, "rb")) == NULL) {
+    xrl_set_error(error, XRL_ERROR_IO, "Could not open %s for reading: %s", file_name, strerror(errno));
+    return NULL;
+  }
+
+  if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) < 0 || fseek(fp, 0, SEEK_SET) != 0) {
+    xrl_set_error(error, XRL_ERROR_IO, "Could not determine size of %s: %s", file_name, strerror(errno));
+    fclose(fp);
+    return NULL;
+  }
+
+  /* malloc returns memory suitably aligned for any type */
+  file = malloc(sizeof(xrl_mapped_file));
+  data = malloc(size > 0 ? size : 1);
+  if (file == NULL || data == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    free(file);
+    free(data);
+    fclose(fp);
+    return NULL;
+  }
+
+  if (fread(data, 1, size, fp) != (size_t) size) {
+    xrl_set_error(error, XRL_ERROR_IO, "Could not read %s", file_name);
+    free(file);
+    free(data);
+    fclose(fp);
+    return NULL;
+  }
+  fclose(fp);
+
+  file->data = data;
+  file->size = size;
+  file->priv = NULL;
+
+  return file;
+}
+
+#ifdef _WIN32
+
+typedef struct {
+  HANDLE file;
+  HANDLE mapping;
+} xrl_mapped_file_priv;
+
+xrl_mapped_file* xrl_mapped_file_new(const char *file_name, xrl_error **error) {
+  xrl_mapped_file *file;
+  xrl_mapped_file_priv *priv;
+  LARGE_INTEGER size;
+  HANDLE handle;
+
+  if (file_name == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_IO, "NULL filenames are not allowed");
+    return NULL;
+  }
+
+  handle = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+    /* let the portable implementation produce the error message */
+    if (handle != INVALID_HANDLE_VALUE)
+      CloseHandle(handle);
+    return xrl_mapped_file_read(file_name, error);
+  }
+
+  file = malloc(sizeof(xrl_mapped_file) + sizeof(xrl_mapped_file_priv));
+  if (file == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    CloseHandle(handle);
+    return NULL;
+  }
+  priv = (xrl_mapped_file_priv *) (file + 1);
+  priv->file = handle;
+  priv->mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  file->data = priv->mapping != NULL ? MapViewOfFile(priv->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+  if (file->data == NULL) {
+    if (priv->mapping != NULL)
+      CloseHandle(priv->mapping);
+    CloseHandle(handle);
+    free(file);
+    return xrl_mapped_file_read(file_name, error);
+  }
+  file->size = (size_t) size.QuadPart;
+  file->priv = priv;
+
+  return file;
+}
+
+void xrl_mapped_file_free(xrl_mapped_file *file) {
+  xrl_mapped_file_priv *priv;
+
+  if (file == NULL)
+    return;
+  if (file->priv == NULL) {
+    free((void *) file->data);
+    free(file);
+    return;
+  }
+  priv = file->priv;
+  UnmapViewOfFile(file->data);
+  CloseHandle(priv->mapping);
+  CloseHandle(priv->file);
+  free(file);
+}
+
+#elif defined(HAVE_MMAP)
+
+xrl_mapped_file* xrl_mapped_file_new(const char *file_name, xrl_error **error) {
+  xrl_mapped_file *file;
+  struct stat st;
+  void *data;
+  int fd;
+
+  if (file_name == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_IO, "NULL filenames are not allowed");
+    return NULL;
+  }
+
+  if ((fd = open(file_name, O_RDONLY)) < 0) {
+    xrl_set_error(error, XRL_ERROR_IO, "Could not open %s for reading: %s", file_name, strerror(errno));
+    return NULL;
+  }
+
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return xrl_mapped_file_read(file_name, error);
+  }
+
+  data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return xrl_mapped_file_read(file_name, error);
+
+  file = malloc(sizeof(xrl_mapped_file));
+  if (file == NULL) {
+    xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+    munmap(data, st.st_size);
+    return NULL;
+  }
+  file->data = data;
+  file->size = st.st_size;
+  file->priv = data;
+
+  return file;
+}
+
+void xrl_mapped_file_free(xrl_mapped_file *file) {
+  if (file == NULL)
+    return;
+  if (file->priv == NULL)
+    free((void *) file->data);
+  else
+    munmap(file->priv, file->size);
+  free(file);
+}
+
+#ifdef HAVE_MADVISE
+static void xrl_mapped_file_advise(const xrl_mapped_file *file, size_t begin, size_t end, int advice) {
+  size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+
+  if (file->priv == NULL || end > file->size)
+    return;
+  /* prefetch the pages that overlap with the range, evict only those that are fully inside */
+  if (advice == MADV_WILLNEED) {
+    begin -= begin % page_size;
+  }
+  else {
+    begin += (page_size - begin % page_size) % page_size;
+    end -= end % page_size;
+  }
+  if (end <= begin)
+    return;
+  madvise((char *) file->priv + begin, end - begin, advice);
+}
+
+void xrl_mapped_file_prefetch(const xrl_mapped_file *file, size_t offset, size_t size) {
+  xrl_mapped_file_advise(file, offset, offset + size, MADV_WILLNEED);
+}
+
+void xrl_mapped_file_evict(const xrl_mapped_file *file, size_t offset, size_t size) {
+  /* the mapping is shared and read-only, so the pages are reloaded from the file on the next access */
+  xrl_mapped_file_advise(file, offset, offset + size, MADV_DONTNEED);
+}
+#endif
+
+
+#else
+
+xrl_mapped_file* xrl_mapped_file_new(const char *file_name, xrl_error **error) {
+  if (file_name == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_IO, "NULL filenames are not allowed");
+    return NULL;
+  }
+  return xrl_mapped_file_read(file_name, error);
+}
+
+void xrl_mapped_file_free(xrl_mapped_file *file) {
+  if (file == NULL)
+    return;
+  free((void *) file->data);
+  free(file);
+}
+
+#endif
+
+#if defined(_WIN32) || !defined(HAVE_MMAP) || !defined(HAVE_MADVISE)
+void xrl_mapped_file_prefetch(const xrl_mapped_file *file, size_t offset, size_t size) {
+}
+
+void xrl_mapped_file_evict(const xrl_mapped_file *file, size_t offset, size_t size) {
+}
+#endif
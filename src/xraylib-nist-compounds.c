@@ -17,6 +17,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 #include "xrayvars.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 #include "xraylib-nist-compounds-internal.h" 
 #include <string.h>
 #include <search.h>
@@ -32,6 +33,7 @@ static int CompareCompoundDataNIST(const void *a, const void *b) {
 }
 
 struct compoundDataNIST *GetCompoundDataNISTByName(const char compoundString[], xrl_error **error) {
+	XRL_STATS_FUNCTION
 
 	struct compoundDataNIST *key = malloc(sizeof(struct compoundDataNIST));
 	struct compoundDataNIST *rv;
@@ -40,6 +42,9 @@ struct compoundDataNIST *GetCompoundDataNISTByName(const char compoundString[],
 #else
 	unsigned int nelp;
 #endif
+
+	XRL_STATS_COUNT(XRL_STATS_NIST_LOOKUPS);
+
 	if (key == NULL) {
 		xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
 		return NULL;
@@ -81,8 +86,11 @@ struct compoundDataNIST *GetCompoundDataNISTByName(const char compoundString[],
 }
 
 struct compoundDataNIST *GetCompoundDataNISTByIndex(int compoundIndex, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	struct compoundDataNIST *key;
 
+	XRL_STATS_COUNT(XRL_STATS_NIST_LOOKUPS);
+
 	if (compoundIndex < 0 || compoundIndex >= nCompoundDataNISTList) {
 		xrl_set_error(error, XRL_ERROR_INVALID_ARGUMENT, "%d is out of the range of indices covered by the NIST compound database", compoundIndex);
 		return NULL;
@@ -105,6 +113,7 @@ struct compoundDataNIST *GetCompoundDataNISTByIndex(int compoundIndex, xrl_error
 }
 
 char **GetCompoundDataNISTList(int *nCompounds, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	int i;
 	char **rv;
 
@@ -12,15 +12,16 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 
 #include "config.h"
 #include "xraylib-aux.h"
+#include "xraylib-aux-private.h"
 #include "xraylib.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 #include "xrayvars.h"
 #include "xrayglob.h"
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include <stdio.h>
-#include <locale.h>
 
 
 struct compoundAtom {
@@ -148,7 +149,7 @@ static int CompoundParserSimple(char compoundString[], struct compoundAtoms *ca,
 			}
 			else {
 				tempSubstring = xrl_strndup(upper_locs[i] + 2, j - 2);
-				tempnAtoms =  strtod(tempSubstring, &endPtr);
+				tempnAtoms =  xrl_strtod_c(tempSubstring, &endPtr);
 				if (endPtr != tempSubstring+strlen(tempSubstring)) {
 					xrl_set_error(error, XRL_ERROR_INVALID_ARGUMENT, "Invalid chemical formula: could not convert subscript %s to a real number", tempSubstring);
 					return 0;
@@ -189,7 +190,7 @@ static int CompoundParserSimple(char compoundString[], struct compoundAtoms *ca,
 			}
 			else {
 				tempSubstring = xrl_strndup(upper_locs[i] + 1, j - 1);
-				tempnAtoms =  strtod(tempSubstring, &endPtr);
+				tempnAtoms =  xrl_strtod_c(tempSubstring, &endPtr);
 				if (endPtr != tempSubstring + strlen(tempSubstring)) {
 					xrl_set_error(error, XRL_ERROR_INVALID_ARGUMENT, "Invalid chemical formula: could not convert subscript %s to a real number", tempSubstring);
 					return 0;
@@ -266,7 +267,7 @@ static int CompoundParserSimple(char compoundString[], struct compoundAtoms *ca,
 		}
 		else {
 			tempSubstring = xrl_strndup(brackets_end_locs[i]+1,j-1);
-			tempnAtoms =  strtod(tempSubstring,&endPtr);
+			tempnAtoms =  xrl_strtod_c(tempSubstring,&endPtr);
 			if (endPtr != tempSubstring+strlen(tempSubstring)) {
 				xrl_set_error(error, XRL_ERROR_INVALID_ARGUMENT, "Invalid chemical formula: could not convert subscript %s to a real number", tempSubstring);
 				return 0;
@@ -322,27 +323,24 @@ static int CompoundParserSimple(char compoundString[], struct compoundAtoms *ca,
 
 
 struct compoundData* CompoundParser(const char compoundString[], xrl_error **error) {
+	XRL_STATS_FUNCTION
 	struct compoundAtoms ca = {0.0, NULL};
 	int rvCPS,i;
 	double sum = 0.0;
 
 	char *compoundStringCopy;
-	char *backup_locale;
+
+	XRL_STATS_COUNT(XRL_STATS_COMPOUND_PARSES);
 
 	if (compoundString == NULL) {
 		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, "Compound cannot be NULL");
 		return NULL;
 	}
 
-	/* the locale is changed to default locale because we'll be using strtod later on */
-	backup_locale = setlocale(LC_NUMERIC, "C");
-
 	compoundStringCopy = xrl_strdup(compoundString);
 
 	rvCPS = CompoundParserSimple(compoundStringCopy, &ca, error);
 
-	setlocale(LC_NUMERIC, backup_locale);
-
 	if (rvCPS) {
 		struct compoundData *cd = malloc(sizeof(struct compoundData));
 		cd->nElements = ca.nElements;
@@ -382,6 +380,7 @@ void FreeCompoundData(struct compoundData *cd) {
 
 
 struct compoundData * add_compound_data(struct compoundData A, double weightA, struct compoundData B, double weightB) {
+	XRL_STATS_FUNCTION
 	struct compoundData *rv, *longest, *shortest;
 	int i,j,found=0;
 	double *longestW, *shortestW;
@@ -453,6 +452,7 @@ static int compareInt(const void *A, const void *B) {
 
 
 char *AtomicNumberToSymbol(int Z, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	if (Z < 1 || Z > MENDEL_MAX ) {
 		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE);
 		return NULL;
@@ -462,6 +462,7 @@ char *AtomicNumberToSymbol(int Z, xrl_error **error) {
 }
 
 int SymbolToAtomicNumber(const char *symbol, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	int i;
 
 	if (symbol == NULL) {
@@ -18,6 +18,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 
 #include "config.h"
 #include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
 #include "xrayvars.h"
 #include "xraylib-radionuclides.h"
 #include "xraylib-radionuclides-internal.h"
@@ -36,6 +37,7 @@ static int CompareRadioNuclideData(const void *a, const void *b) {
 }
 
 struct radioNuclideData *GetRadioNuclideDataByName(const char radioNuclideString[], xrl_error **error) {
+	XRL_STATS_FUNCTION
 
 	struct radioNuclideData *key = malloc(sizeof(struct radioNuclideData));
 	struct radioNuclideData *rv;
@@ -91,6 +93,7 @@ struct radioNuclideData *GetRadioNuclideDataByName(const char radioNuclideString
 }
 
 struct radioNuclideData *GetRadioNuclideDataByIndex(int radioNuclideIndex, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	struct radioNuclideData *key;
 
 	if (radioNuclideIndex < 0 || radioNuclideIndex >= nNuclideDataList) {
@@ -124,6 +127,7 @@ struct radioNuclideData *GetRadioNuclideDataByIndex(int radioNuclideIndex, xrl_e
 }
 
 char **GetRadioNuclideDataList(int *nRadioNuclides, xrl_error **error) {
+	XRL_STATS_FUNCTION
 	int i;
 	char **rv;
 
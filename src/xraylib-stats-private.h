@@ -0,0 +1,70 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef XRAYLIB_STATS_PRIVATE_H
+#define XRAYLIB_STATS_PRIVATE_H
+
+#include "xraylib-stats.h"
+
+/*
+ * XRL_STATS_FUNCTION goes at the very top of the body of every exported function that is counted.
+ * Without --enable-stats it expands to nothing; with it, it declares a counter site
+ * and a frame whose cleanup runs when the function returns, whichever return it takes.
+ */
+
+typedef enum {
+	XRL_STATS_COMPOUND_PARSES,
+	XRL_STATS_NIST_LOOKUPS,
+	XRL_STATS_COUNTERS
+} xrl_stats_counter;
+
+#ifdef XRL_STATS
+
+typedef struct {
+	const char *name;
+	int id;
+} xrl_stats_site;
+
+typedef struct {
+	int id;
+	int previous;
+	uint64_t start;
+} xrl_stats_frame;
+
+xrl_stats_frame xrl_stats_enter(xrl_stats_site *site);
+
+void xrl_stats_leave(xrl_stats_frame *frame);
+
+void xrl_stats_count(xrl_stats_counter counter);
+
+void xrl_stats_count_error(xrl_error_code code);
+
+#define XRL_STATS_FUNCTION \
+	static xrl_stats_site xrl_stats_site_ = {__func__, -1}; \
+	xrl_stats_frame xrl_stats_frame_ __attribute__((cleanup(xrl_stats_leave))) = xrl_stats_enter(&xrl_stats_site_);
+
+#define XRL_STATS_COUNT(counter) xrl_stats_count(counter)
+
+#define XRL_STATS_COUNT_ERROR(code) xrl_stats_count_error(code)
+
+#else
+
+#define XRL_STATS_FUNCTION
+
+#define XRL_STATS_COUNT(counter) ((void) 0)
+
+#define XRL_STATS_COUNT_ERROR(code) ((void) 0)
+
+#endif
+
+#endif
@@ -0,0 +1,512 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "config.h"
+#include "xraylib.h"
+#include "xraylib-stats-private.h"
+#include "xraylib-error-private.h"
+#include "xraylib-atomic-private.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#ifdef XRL_STATS
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <pthread.h>
+#endif
+
+/* more than the number of exported functions: ids of sites that lost a registration race are not reused */
+#define MAX_FUNCTIONS 256
+
+typedef struct {
+	uint64_t calls;
+	uint64_t internal_calls;
+	uint64_t errors[XRL_STATS_ERROR_CODES];
+	uint64_t timed_calls;
+	uint64_t time_ns;
+	uint64_t histogram[XRL_STATS_HISTOGRAM_BUCKETS];
+} function_counters;
+
+/* nothing but uint64_t counters, so that they can be summed as an array */
+typedef struct {
+	function_counters functions[MAX_FUNCTIONS];
+	uint64_t errors[XRL_STATS_ERROR_CODES];
+	uint64_t counters[XRL_STATS_COUNTERS];
+} totals;
+
+#define TOTALS_LENGTH (sizeof(totals) / sizeof(uint64_t))
+
+/*
+ * The counters of one thread. Only the owning thread writes them, with relaxed atomics,
+ * so that snapshots can read them concurrently without ever seeing a torn value.
+ * When the thread exits, its counters are added to those of the retired threads and the shard is freed.
+ */
+typedef struct _shard shard;
+
+struct _shard {
+	totals totals;
+	unsigned int countdown[MAX_FUNCTIONS];
+	int current; /* the innermost function that is running, which errors are attributed to */
+	int depth;
+	shard *next;
+};
+
+#define COUNTER_ADD(counter, value) xrl_atomic_store_relaxed_uint64(&(counter), xrl_atomic_load_relaxed_uint64(&(counter)) + (value))
+#define COUNTER_LOAD(counter) xrl_atomic_load_relaxed_uint64(&(counter))
+
+static __thread shard *thread_shard;
+
+/* the shards of the running threads, and the sum of those of the threads that exited */
+static shard *shards;
+static totals retired;
+
+/* calls shard_retire when a thread exits: 0 before it was created, 1 when it exists and -1 if that failed */
+static int shard_key_state;
+#ifdef _WIN32
+static DWORD shard_key;
+#else
+static pthread_key_t shard_key;
+#endif
+
+static xrl_stats_site *sites[MAX_FUNCTIONS];
+static int n_sites;
+
+static int timing_interval;
+
+/* protects the list of shards, the retired and baseline counters */
+static int stats_lock;
+static totals *baseline;
+
+static uint64_t stats_now(void) {
+#ifdef _WIN32
+	static LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	if (frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (uint64_t) ((double) counter.QuadPart * 1E9 / (double) frequency.QuadPart);
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+#ifdef _WIN32
+static void WINAPI shard_retire(void *data);
+#else
+static void shard_retire(void *data);
+#endif
+
+static shard* shard_get(void) {
+	shard *s = thread_shard;
+
+	if (s != NULL)
+		return s;
+
+	if ((s = calloc(1, sizeof(shard))) == NULL)
+		return NULL;
+	s->current = -1;
+
+	xrl_lock_acquire(&stats_lock);
+	if (shard_key_state == 0) {
+#ifdef _WIN32
+		shard_key = FlsAlloc(shard_retire);
+		shard_key_state = shard_key != FLS_OUT_OF_INDEXES ? 1 : -1;
+#else
+		shard_key_state = pthread_key_create(&shard_key, shard_retire) == 0 ? 1 : -1;
+#endif
+	}
+	/* without a key, the shard is kept after the thread exits */
+	if (shard_key_state == 1) {
+#ifdef _WIN32
+		FlsSetValue(shard_key, s);
+#else
+		pthread_setspecific(shard_key, s);
+#endif
+	}
+	s->next = shards;
+	shards = s;
+	xrl_lock_release(&stats_lock);
+
+	thread_shard = s;
+	return s;
+}
+
+#ifdef _WIN32
+static void WINAPI shard_retire(void *data) {
+#else
+static void shard_retire(void *data) {
+#endif
+	shard *s = data, **link;
+	uint64_t *dest = (uint64_t *) &retired;
+	const uint64_t *src = (const uint64_t *) &s->totals;
+	size_t i;
+
+	if (s == NULL)
+		return;
+
+	xrl_lock_acquire(&stats_lock);
+	for (link = &shards ; *link != s ; link = &(*link)->next)
+		;
+	*link = s->next;
+	for (i = 0 ; i < TOTALS_LENGTH ; i++)
+		dest[i] += src[i];
+	xrl_lock_release(&stats_lock);
+
+	thread_shard = NULL;
+	free(s);
+}
+
+static int register_site(xrl_stats_site *site) {
+	int id = xrl_atomic_inc_int(&n_sites) - 1;
+
+	if (id >= MAX_FUNCTIONS) {
+		/* out of room: the site is never counted */
+		xrl_atomic_cas_int(&site->id, -1, MAX_FUNCTIONS);
+	}
+	else if (xrl_atomic_cas_int(&site->id, -1, id)) {
+		xrl_atomic_store_ptr(&sites[id], site);
+	}
+	/* else another thread registered the site first */
+
+	return xrl_atomic_load_int(&site->id);
+}
+
+xrl_stats_frame xrl_stats_enter(xrl_stats_site *site) {
+	xrl_stats_frame frame = {-1, -1, 0};
+	shard *s = shard_get();
+	function_counters *counters;
+	int id, interval;
+
+	if (s == NULL)
+		return frame;
+
+	if ((id = xrl_atomic_load_int(&site->id)) < 0)
+		id = register_site(site);
+	if (id >= MAX_FUNCTIONS)
+		return frame;
+
+	counters = &s->totals.functions[id];
+	COUNTER_ADD(counters->calls, 1);
+	if (s->depth > 0)
+		COUNTER_ADD(counters->internal_calls, 1);
+
+	frame.id = id;
+	frame.previous = s->current;
+	s->current = id;
+	s->depth++;
+
+	interval = xrl_atomic_load_relaxed_int(&timing_interval);
+	if (interval > 0 && ++s->countdown[id] >= (unsigned int) interval) {
+		s->countdown[id] = 0;
+		frame.start = stats_now();
+	}
+
+	return frame;
+}
+
+void xrl_stats_leave(xrl_stats_frame *frame) {
+	shard *s = thread_shard;
+
+	if (frame->id < 0)
+		return;
+
+	s->current = frame->previous;
+	s->depth--;
+
+	if (frame->start != 0) {
+		function_counters *counters = &s->totals.functions[frame->id];
+		uint64_t elapsed = stats_now() - frame->start;
+		int bucket = 0;
+
+		while (bucket < XRL_STATS_HISTOGRAM_BUCKETS - 1 && (elapsed >> (bucket + 1)) != 0)
+			bucket++;
+
+		COUNTER_ADD(counters->timed_calls, 1);
+		COUNTER_ADD(counters->time_ns, elapsed);
+		COUNTER_ADD(counters->histogram[bucket], 1);
+	}
+}
+
+void xrl_stats_count(xrl_stats_counter counter) {
+	shard *s = shard_get();
+
+	if (s == NULL)
+		return;
+
+	COUNTER_ADD(s->totals.counters[counter], 1);
+}
+
+void xrl_stats_count_error(xrl_error_code code) {
+	shard *s = shard_get();
+
+	if (s == NULL || (int) code < 0 || code >= XRL_STATS_ERROR_CODES)
+		return;
+
+	COUNTER_ADD(s->totals.errors[code], 1);
+	if (s->current >= 0)
+		COUNTER_ADD(s->totals.functions[s->current].errors[code], 1);
+}
+
+/* the counters of all threads, called with stats_lock held */
+static void totals_sum(totals *sum) {
+	uint64_t *dest = (uint64_t *) sum;
+	shard *s;
+	size_t i;
+
+	memcpy(sum, &retired, sizeof(totals));
+
+	for (s = shards ; s != NULL ; s = s->next) {
+		uint64_t *src = (uint64_t *) &s->totals;
+		for (i = 0 ; i < TOTALS_LENGTH ; i++)
+			dest[i] += COUNTER_LOAD(src[i]);
+	}
+}
+
+int xrl_stats_enabled(void) {
+	return 1;
+}
+
+xrl_stats* xrl_stats_snapshot(xrl_error **error) {
+	xrl_stats *stats;
+	totals *sum;
+	int n, i, j;
+
+	if ((sum = malloc(sizeof(totals))) == NULL || (stats = calloc(1, sizeof(xrl_stats))) == NULL) {
+		xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+		free(sum);
+		return NULL;
+	}
+
+	if ((n = xrl_atomic_load_int(&n_sites)) > MAX_FUNCTIONS)
+		n = MAX_FUNCTIONS;
+
+	if ((stats->functions = calloc(n > 0 ? n : 1, sizeof(xrl_stats_function))) == NULL) {
+		xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+		free(sum);
+		free(stats);
+		return NULL;
+	}
+
+	xrl_lock_acquire(&stats_lock);
+	totals_sum(sum);
+	if (baseline != NULL) {
+		uint64_t *dest = (uint64_t *) sum;
+		const uint64_t *base = (const uint64_t *) baseline;
+		size_t k;
+		for (k = 0 ; k < TOTALS_LENGTH ; k++)
+			dest[k] -= base[k];
+	}
+	xrl_lock_release(&stats_lock);
+
+	for (i = 0 ; i < n ; i++) {
+		xrl_stats_site *site = xrl_atomic_load_ptr(&sites[i]);
+		const function_counters *counters = &sum->functions[i];
+		xrl_stats_function *function;
+
+		if (site == NULL)
+			continue;
+
+		function = &stats->functions[stats->n_functions++];
+		function->name = site->name;
+		function->calls = counters->calls;
+		function->internal_calls = counters->internal_calls;
+		for (j = 0 ; j < XRL_STATS_ERROR_CODES ; j++)
+			function->errors[j] = counters->errors[j];
+		function->timed_calls = counters->timed_calls;
+		function->time_ns = counters->time_ns;
+		for (j = 0 ; j < XRL_STATS_HISTOGRAM_BUCKETS ; j++)
+			function->histogram[j] = counters->histogram[j];
+	}
+
+	for (j = 0 ; j < XRL_STATS_ERROR_CODES ; j++)
+		stats->errors[j] = sum->errors[j];
+	stats->compound_parses = sum->counters[XRL_STATS_COMPOUND_PARSES];
+	stats->nist_lookups = sum->counters[XRL_STATS_NIST_LOOKUPS];
+
+	free(sum);
+	return stats;
+}
+
+int xrl_stats_reset(xrl_error **error) {
+	int rv = 1;
+
+	xrl_lock_acquire(&stats_lock);
+	if (baseline == NULL && (baseline = malloc(sizeof(totals))) == NULL) {
+		xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(errno));
+		rv = 0;
+	}
+	else {
+		totals_sum(baseline);
+	}
+	xrl_lock_release(&stats_lock);
+
+	return rv;
+}
+
+int xrl_stats_set_timing(int interval, xrl_error **error) {
+	if (interval < 0) {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NEGATIVE_TIMING_INTERVAL);
+		return 0;
+	}
+	xrl_atomic_store_relaxed_int(&timing_interval, interval);
+	return 1;
+}
+
+int xrl_stats_get_timing(void) {
+	return xrl_atomic_load_relaxed_int(&timing_interval);
+}
+
+#else
+
+int xrl_stats_enabled(void) {
+	return 0;
+}
+
+xrl_stats* xrl_stats_snapshot(xrl_error **error) {
+	xrl_set_error_literal(error, XRL_ERROR_UNSUPPORTED, STATS_UNSUPPORTED);
+	return NULL;
+}
+
+int xrl_stats_reset(xrl_error **error) {
+	xrl_set_error_literal(error, XRL_ERROR_UNSUPPORTED, STATS_UNSUPPORTED);
+	return 0;
+}
+
+int xrl_stats_set_timing(int interval, xrl_error **error) {
+	(void) interval;
+	xrl_set_error_literal(error, XRL_ERROR_UNSUPPORTED, STATS_UNSUPPORTED);
+	return 0;
+}
+
+int xrl_stats_get_timing(void) {
+	return 0;
+}
+
+#endif
+
+void xrl_stats_free(xrl_stats *stats) {
+	if (stats == NULL)
+		return;
+	free(stats->functions);
+	free(stats);
+}
+
+/* the JSON document is built in a buffer that doubles in size when needed */
+typedef struct {
+	char *str;
+	size_t len;
+	size_t size;
+	int failed;
+} json_buffer;
+
+static void json_append(json_buffer *buffer, const char *format, ...) GNUC_PRINTF(2, 3);
+
+static void json_append(json_buffer *buffer, const char *format, ...) {
+	char piece[256];
+	va_list args;
+	int len;
+
+	if (buffer->failed)
+		return;
+
+	va_start(args, format);
+	len = vsnprintf(piece, sizeof(piece), format, args);
+	va_end(args);
+
+	if (len < 0 || (size_t) len >= sizeof(piece)) {
+		buffer->failed = 1;
+		return;
+	}
+
+	if (buffer->len + len + 1 > buffer->size) {
+		size_t size = buffer->size > 0 ? 2 * buffer->size : 4096;
+		char *str;
+		while (buffer->len + len + 1 > size)
+			size *= 2;
+		if ((str = realloc(buffer->str, size)) == NULL) {
+			buffer->failed = 1;
+			return;
+		}
+		buffer->str = str;
+		buffer->size = size;
+	}
+
+	memcpy(buffer->str + buffer->len, piece, len + 1);
+	buffer->len += len;
+}
+
+static const char * const error_names[XRL_STATS_ERROR_CODES] = {
+	"memory",
+	"invalid_argument",
+	"io",
+	"type",
+	"unsupported",
+	"runtime"
+};
+
+static void json_append_errors(json_buffer *buffer, const uint64_t *errors) {
+	int i;
+
+	json_append(buffer, "{");
+	for (i = 0 ; i < XRL_STATS_ERROR_CODES ; i++)
+		json_append(buffer, "%s\"%s\": %" PRIu64, i > 0 ? ", " : "", error_names[i], errors[i]);
+	json_append(buffer, "}");
+}
+
+char* xrl_stats_to_json(const xrl_stats *stats, xrl_error **error) {
+	json_buffer buffer = {NULL, 0, 0, 0};
+	int i, j;
+
+	if (stats == NULL) {
+		xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, NULL_STATS);
+		return NULL;
+	}
+
+	json_append(&buffer, "{\n  \"functions\": [");
+	for (i = 0 ; i < stats->n_functions ; i++) {
+		const xrl_stats_function *function = &stats->functions[i];
+		int n_buckets = XRL_STATS_HISTOGRAM_BUCKETS;
+
+		/* the histogram is cut off after the slowest call */
+		while (n_buckets > 0 && function->histogram[n_buckets - 1] == 0)
+			n_buckets--;
+
+		json_append(&buffer, "%s\n    {\"name\": \"%s\", \"calls\": %" PRIu64 ", \"internal_calls\": %" PRIu64 ", \"errors\": ", i > 0 ? "," : "", function->name, function->calls, function->internal_calls);
+		json_append_errors(&buffer, function->errors);
+		json_append(&buffer, ", \"timed_calls\": %" PRIu64 ", \"time_ns\": %" PRIu64 ", \"histogram\": [", function->timed_calls, function->time_ns);
+		for (j = 0 ; j < n_buckets ; j++)
+			json_append(&buffer, "%s%" PRIu64, j > 0 ? ", " : "", function->histogram[j]);
+		json_append(&buffer, "]}");
+	}
+	json_append(&buffer, "\n  ],\n  \"errors\": ");
+	json_append_errors(&buffer, stats->errors);
+	json_append(&buffer, ",\n  \"compound_parses\": %" PRIu64 ",\n  \"nist_lookups\": %" PRIu64 "\n}\n", stats->compound_parses, stats->nist_lookups);
+
+	if (buffer.failed) {
+		free(buffer.str);
+		xrl_set_error(error, XRL_ERROR_MEMORY, MALLOC_ERROR, strerror(ENOMEM));
+		return NULL;
+	}
+
+	return buffer.str;
+}
@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "config.h"
+#include "xraylib.h"
+#include "xraylib-stats-private.h"
+#include "xrayglob.h"
+#include "xraylib-error-private.h"
+#include "xraylib-stats-private.h"
+#include "xraylib-data-image-private.h"
+
+#include <string.h>
+
+#define TABLE_COUNT(count) ((count) > 0 ? (count) : 0)
+
+static void Table_Set(const double *table, int length, const double **data, int *length_out) {
+  if (table == NULL || length <= 0) {
+    table = NULL;
+    length = 0;
+  }
+  if (data)
+    *data = table;
+  if (length_out)
+    *length_out = length;
+}
+
+int xrl_table_fixed(const char *name, const double **data, int *rows, int *columns, xrl_error **error) {
+  XRL_STATS_FUNCTION
+
+  if (name == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, TABLE_NULL);
+    return 0;
+  }
+
+#define X(section, type, table, count) \
+  if (strcmp(#type, "double") == 0 && strcmp(name, #table) == 0) { \
+    if (data) \
+      *data = (const double *) table; \
+    if (rows) \
+      *rows = ZMAX + 1; \
+    if (columns) \
+      *columns = (count) / (ZMAX + 1); \
+    return 1; \
+  }
+  XRL_DATA_IMAGE_FIXED_TABLES(X)
+#undef X
+
+  xrl_set_error(error, XRL_ERROR_INVALID_ARGUMENT, UNKNOWN_TABLE, name);
+  return 0;
+}
+
+int xrl_table_element(const char *name, int Z, const double **data, int *length, xrl_error **error) {
+  XRL_STATS_FUNCTION
+
+  if (name == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, TABLE_NULL);
+    return 0;
+  }
+
+#define X(section, table, count) \
+  if (strcmp(name, #table) == 0) { \
+    if (Z < 1 || Z > ZMAX) { \
+      xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE); \
+      return 0; \
+    } \
+    Table_Set(table[Z], TABLE_COUNT(count[Z]), data, length); \
+    return 1; \
+  }
+  XRL_DATA_IMAGE_ELEMENT_TABLES(X)
+#undef X
+
+  xrl_set_error(error, XRL_ERROR_INVALID_ARGUMENT, UNKNOWN_TABLE, name);
+  return 0;
+}
+
+int xrl_table_element_shell(const char *name, int Z, int shell, const double **data, int *length, xrl_error **error) {
+  XRL_STATS_FUNCTION
+
+  if (name == NULL) {
+    xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, TABLE_NULL);
+    return 0;
+  }
+
+#define X(section, table) \
+  if (strcmp(name, #table) == 0) { \
+    if (Z < 1 || Z > ZMAX) { \
+      xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE); \
+      return 0; \
+    } \
+    if (shell < 0 || shell >= SHELLNUM_K) { \
+      xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, UNKNOWN_SHELL); \
+      return 0; \
+    } \
+    Table_Set(table[Z][shell], TABLE_COUNT(NE_Photo_Partial_Kissel[Z][shell]), data, length); \
+    return 1; \
+  }
+  XRL_DATA_IMAGE_KISSEL_TABLES(X)
+#undef X
+
+  /* the arrays of the unoccupied shells are not set */
+#define X(section, table) \
+  if (strcmp(name, #table) == 0) { \
+    if (Z < 1 || Z > ZMAX) { \
+      xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, Z_OUT_OF_RANGE); \
+      return 0; \
+    } \
+    if (shell < 0 || shell >= SHELLNUM_C) { \
+      xrl_set_error_literal(error, XRL_ERROR_INVALID_ARGUMENT, UNKNOWN_SHELL); \
+      return 0; \
+    } \
+    if (shell < NShells_ComptonProfiles[Z] && UOCCUP_ComptonProfiles[Z][shell] > 0.0) \
+      Table_Set(table[Z][shell], TABLE_COUNT(Npz_ComptonProfiles[Z]), data, length); \
+    else \
+      Table_Set(NULL, 0, data, length); \
+    return 1; \
+  }
+  XRL_DATA_IMAGE_COMPTON_TABLES(X)
+#undef X
+
+  xrl_set_error(error, XRL_ERROR_INVALID_ARGUMENT, UNKNOWN_TABLE, name);
+  return 0;
+}
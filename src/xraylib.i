@@ -173,6 +173,31 @@ XRL_GNUC_BEGIN_IGNORE_DEPRECATIONS
 %ignore xrlComplex;
 %ignore radioNuclideData;
 %ignore FreeRadioNuclideData;
+%ignore DDCS_Compt;
+%ignore DDCSb_Compt;
+%ignore DDCS_Compt_CP;
+%ignore Refractive_Index_Batch;
+%ignore xrlOpticalConstants;
+%ignore Multilayer_Reflectivity;
+%ignore xrlLayer;
+%ignore Crystal_F_H_StructureFactor_Batch;
+%ignore Crystal_F_H_StructureFactor_Partial_Batch;
+%ignore Crystal_Reflection;
+%ignore Crystal_GetCrystalShared;
+%ignore Crystal_RockingCurve;
+%ignore Crystal_PowderReflection;
+%ignore Crystal_PowderReflections;
+%ignore Crystal_PowderProfile;
+%ignore Crystal_RockingCurve_Energy;
+%ignore Crystal_MakeShared;
+%ignore Crystal_Retain;
+%ignore Crystal_Release;
+%ignore Crystal_Reflection_New;
+%ignore Crystal_Reflection_Free;
+%ignore Crystal_Reflection_F_H;
+%ignore Crystal_Reflection_F_H_Batch;
+%ignore Crystal_ArrayMapBinary;
+%ignore Crystal_ArrayUnmapBinary;
 
 %typemap(in, numinputs=0) xrl_error **error (xrl_error *error = NULL) {
   $1 = &error;
@@ -15,6 +15,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 #include "xrf_cross_sections_aux.h"
 #include "xraylib-error-private.h"
 #include "xrayglob.h"
+#include "xraylib-fast.h"
 #include <stddef.h>
 #include <stdio.h>
 
@@ -30,7 +31,7 @@ double PL1_rad_cascade_kissel(int Z, double E, double PK, xrl_error **error) {
 		return 0.0;
 
 	if (PK > 0.0) {
-		rv += FluorYield(Z, K_SHELL, NULL) * PK * RadRate(Z, KL1_LINE, NULL);
+		rv += FluorYield_unchecked(Z, K_SHELL) * PK * RadRate_unchecked(Z, KL1_LINE);
 	}
 
 	return rv;
@@ -69,7 +70,7 @@ double PL2_pure_kissel(int Z, double E, double PL1, xrl_error **error) {
 		return 0.0;
 
 	if (PL1 > 0.0) {
-		rv += CosKronTransProb(Z, FL12_TRANS, NULL) * PL1;
+		rv += CosKronTransProb_unchecked(Z, FL12_TRANS) * PL1;
 	}
 	return rv;	
 }
@@ -82,11 +83,11 @@ double PL2_rad_cascade_kissel(int Z, double E, double PK, double PL1, xrl_error
 		return 0.0;
 
 	if (PK > 0.0) {
-		rv += FluorYield(Z, K_SHELL, NULL) * PK * RadRate(Z, KL2_LINE, NULL);
+		rv += FluorYield_unchecked(Z, K_SHELL) * PK * RadRate_unchecked(Z, KL2_LINE);
 	}
 
 	if (PL1 > 0.0) {
-		rv +=  CosKronTransProb(Z, FL12_TRANS, NULL) * PL1;
+		rv +=  CosKronTransProb_unchecked(Z, FL12_TRANS) * PL1;
 	}
 	return  rv;
 }
@@ -103,7 +104,7 @@ double PL2_auger_cascade_kissel(int Z, double E, double PK, double PL1, xrl_erro
 	}
 
 	if (PL1 > 0.0) {
-		rv += CosKronTransProb(Z, FL12_TRANS, NULL) * PL1;
+		rv += CosKronTransProb_unchecked(Z, FL12_TRANS) * PL1;
 	}
 	return  rv;
 }
@@ -120,7 +121,7 @@ double PL2_full_cascade_kissel(int Z, double E, double PK, double PL1, xrl_error
 	}
 		
 	if (PL1 > 0.0)
-		rv += CosKronTransProb(Z, FL12_TRANS, NULL) * PL1;
+		rv += CosKronTransProb_unchecked(Z, FL12_TRANS) * PL1;
 	return rv;
 }
 
@@ -132,10 +133,10 @@ double PL3_pure_kissel(int Z, double E, double PL1, double PL2, xrl_error **erro
 		return 0.0;
 
 	if (PL1 > 0.0)
-		rv += (CosKronTransProb(Z, FL13_TRANS, NULL) + CosKronTransProb(Z, FLP13_TRANS, NULL)) * PL1;
+		rv += (CosKronTransProb_unchecked(Z, FL13_TRANS) + CosKronTransProb_unchecked(Z, FLP13_TRANS)) * PL1;
 
 	if (PL2 > 0.0)
-		rv += CosKronTransProb(Z, FL23_TRANS, NULL) * PL2;
+		rv += CosKronTransProb_unchecked(Z, FL23_TRANS) * PL2;
 
 	return rv;
 }
@@ -148,13 +149,13 @@ double PL3_rad_cascade_kissel(int Z, double E, double PK, double PL1, double PL2
 		return rv;
 
 	if (PK > 0.0)
-		rv += FluorYield(Z, K_SHELL, NULL) * PK * RadRate(Z, KL3_LINE, NULL);
+		rv += FluorYield_unchecked(Z, K_SHELL) * PK * RadRate_unchecked(Z, KL3_LINE);
 
 	if (PL1 > 0.0)
-		rv += (CosKronTransProb(Z, FL13_TRANS, NULL) + CosKronTransProb(Z, FLP13_TRANS, NULL)) * PL1;
+		rv += (CosKronTransProb_unchecked(Z, FL13_TRANS) + CosKronTransProb_unchecked(Z, FLP13_TRANS)) * PL1;
 
 	if (PL2 > 0.0)
-		rv += CosKronTransProb(Z, FL23_TRANS, NULL) * PL2;
+		rv += CosKronTransProb_unchecked(Z, FL23_TRANS) * PL2;
 
 	return rv;
 }
@@ -170,10 +171,10 @@ double PL3_auger_cascade_kissel(int Z, double E, double PK, double PL1, double P
 		rv += PK * xrf_cross_sections_constants_auger_only[Z][L3_SHELL][K_SHELL];
 
 	if (PL1 > 0.0)
-		rv += (CosKronTransProb(Z, FL13_TRANS, NULL) + CosKronTransProb(Z, FLP13_TRANS, NULL)) * PL1;
+		rv += (CosKronTransProb_unchecked(Z, FL13_TRANS) + CosKronTransProb_unchecked(Z, FLP13_TRANS)) * PL1;
 
 	if (PL2 > 0.0)
-		rv += CosKronTransProb(Z, FL23_TRANS, NULL) * PL2;
+		rv += CosKronTransProb_unchecked(Z, FL23_TRANS) * PL2;
 
 	return  rv;
 }
@@ -189,10 +190,10 @@ double PL3_full_cascade_kissel(int Z, double E, double PK, double PL1, double PL
 		rv += PK * xrf_cross_sections_constants_full[Z][L3_SHELL][K_SHELL];
 
 	if (PL1 > 0.0)
-		rv += (CosKronTransProb(Z, FL13_TRANS, NULL) + CosKronTransProb(Z, FLP13_TRANS, NULL)) * PL1;
+		rv += (CosKronTransProb_unchecked(Z, FL13_TRANS) + CosKronTransProb_unchecked(Z, FLP13_TRANS)) * PL1;
 
 	if (PL2 > 0.0)
-		rv += CosKronTransProb(Z, FL23_TRANS, NULL) * PL2;
+		rv += CosKronTransProb_unchecked(Z, FL23_TRANS) * PL2;
 
 	return rv;
 }
@@ -209,13 +210,13 @@ double PM1_rad_cascade_kissel(int Z, double E, double PK, double PL1, double PL2
 		return rv;
 
 	if (PK > 0.0)
-		rv += FluorYield(Z, K_SHELL, NULL) * PK * RadRate(Z ,KM1_LINE, NULL);
+		rv += FluorYield_unchecked(Z, K_SHELL) * PK * RadRate_unchecked(Z, KM1_LINE);
 	if (PL1 > 0.0)
-		rv += FluorYield(Z, L1_SHELL, NULL) * PL1 * RadRate(Z, L1M1_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L1_SHELL) * PL1 * RadRate_unchecked(Z, L1M1_LINE);
 	if (PL2 > 0.0)
-		rv += FluorYield(Z, L2_SHELL, NULL) * PL2 * RadRate(Z, L2M1_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L2_SHELL) * PL2 * RadRate_unchecked(Z, L2M1_LINE);
 	if (PL3 > 0.0)
-		rv += FluorYield(Z, L3_SHELL, NULL) * PL3 * RadRate(Z, L3M1_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L3_SHELL) * PL3 * RadRate_unchecked(Z, L3M1_LINE);
 
 	return rv; 
 }
@@ -271,7 +272,7 @@ double PM2_pure_kissel(int Z, double E, double PM1, xrl_error **error) {
 		return 0.0;
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM12_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM12_TRANS) * PM1;
 		
 	return rv; 
 }
@@ -284,19 +285,19 @@ double PM2_rad_cascade_kissel(int Z, double E, double PK, double PL1, double PL2
 		return 0.0;
 
 	if (PK > 0.0)
-		rv += FluorYield(Z, K_SHELL, NULL) * PK * RadRate(Z, KM2_LINE, NULL);
+		rv += FluorYield_unchecked(Z, K_SHELL) * PK * RadRate_unchecked(Z, KM2_LINE);
 
 	if (PL1 > 0.0)
-		rv += FluorYield(Z, L1_SHELL, NULL) * PL1 * RadRate(Z, L1M2_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L1_SHELL) * PL1 * RadRate_unchecked(Z, L1M2_LINE);
 
 	if (PL2 > 0.0)
-		rv += FluorYield(Z, L2_SHELL, NULL) * PL2 * RadRate(Z, L2M2_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L2_SHELL) * PL2 * RadRate_unchecked(Z, L2M2_LINE);
 
 	if (PL3 > 0.0)
-		rv += FluorYield(Z, L3_SHELL, NULL) * PL3 * RadRate(Z, L3M2_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L3_SHELL) * PL3 * RadRate_unchecked(Z, L3M2_LINE);
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM12_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM12_TRANS) * PM1;
 
 	return rv;
 }
@@ -321,7 +322,7 @@ double PM2_auger_cascade_kissel(int Z, double E, double PK, double PL1, double P
 		rv += PL3 * xrf_cross_sections_constants_auger_only[Z][M2_SHELL][L3_SHELL];
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM12_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM12_TRANS) * PM1;
 
 	return rv;
 }
@@ -346,7 +347,7 @@ double PM2_full_cascade_kissel(int Z, double E, double PK, double PL1, double PL
 		rv += PL3 * xrf_cross_sections_constants_full[Z][M2_SHELL][L3_SHELL];
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM12_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM12_TRANS) * PM1;
 
 	return rv;
 }
@@ -359,10 +360,10 @@ double PM3_pure_kissel(int Z, double E, double PM1, double PM2, xrl_error **erro
 		return 0.0;
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM13_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM13_TRANS) * PM1;
 
 	if (PM2 > 0.0)
-		rv += CosKronTransProb(Z, FM23_TRANS, NULL) * PM2;
+		rv += CosKronTransProb_unchecked(Z, FM23_TRANS) * PM2;
 
 	return rv;
 }
@@ -375,22 +376,22 @@ double PM3_rad_cascade_kissel(int Z, double E, double PK, double PL1, double PL2
 		return 0.0;
 
 	if (PK > 0.0) 
-		rv += FluorYield(Z, K_SHELL, NULL) * PK * RadRate(Z, KM3_LINE, NULL);
+		rv += FluorYield_unchecked(Z, K_SHELL) * PK * RadRate_unchecked(Z, KM3_LINE);
 
 	if (PL1 > 0.0)
-		rv += FluorYield(Z, L1_SHELL, NULL) * PL1 * RadRate(Z, L1M3_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L1_SHELL) * PL1 * RadRate_unchecked(Z, L1M3_LINE);
 
 	if (PL2 > 0.0)
-		rv += FluorYield(Z, L2_SHELL, NULL) * PL2 * RadRate(Z, L2M3_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L2_SHELL) * PL2 * RadRate_unchecked(Z, L2M3_LINE);
 
 	if (PL3 > 0.0)
-		rv += FluorYield(Z, L3_SHELL, NULL) * PL3 * RadRate(Z, L3M3_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L3_SHELL) * PL3 * RadRate_unchecked(Z, L3M3_LINE);
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM13_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM13_TRANS) * PM1;
 	
 	if (PM2 > 0.0)
-		rv += CosKronTransProb(Z, FM23_TRANS, NULL) * PM2;
+		rv += CosKronTransProb_unchecked(Z, FM23_TRANS) * PM2;
 
 	return rv;
 }
@@ -409,9 +410,9 @@ double PM3_auger_cascade_kissel(int Z, double E, double PK, double PL1, double P
 	if (PL3 > 0.0) 
 		rv += PL3 * xrf_cross_sections_constants_auger_only[Z][M3_SHELL][L3_SHELL];
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM13_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM13_TRANS) * PM1;
 	if (PM2 > 0.0)
-		rv += CosKronTransProb(Z, FM23_TRANS, NULL) * PM2;
+		rv += CosKronTransProb_unchecked(Z, FM23_TRANS) * PM2;
 
 	return rv;
 }
@@ -436,10 +437,10 @@ double PM3_full_cascade_kissel(int Z, double E, double PK, double PL1, double PL
 		rv += PL3 * xrf_cross_sections_constants_full[Z][M3_SHELL][L3_SHELL];
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM13_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM13_TRANS) * PM1;
 	
 	if (PM2 > 0.0)
-		rv += CosKronTransProb(Z, FM23_TRANS, NULL) * PM2;
+		rv += CosKronTransProb_unchecked(Z, FM23_TRANS) * PM2;
 
 	return rv;
 }
@@ -452,13 +453,13 @@ double PM4_pure_kissel(int Z, double E, double PM1, double PM2, double PM3, xrl_
 		return 0.0;
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM14_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM14_TRANS) * PM1;
 
 	if (PM2 > 0.0)
-		rv += CosKronTransProb(Z, FM24_TRANS, NULL) * PM2;
+		rv += CosKronTransProb_unchecked(Z, FM24_TRANS) * PM2;
 
 	if (PM3 > 0.0)
-		rv += CosKronTransProb(Z, FM34_TRANS, NULL) * PM3;
+		rv += CosKronTransProb_unchecked(Z, FM34_TRANS) * PM3;
 
 	return rv;
 }
@@ -472,25 +473,25 @@ double PM4_rad_cascade_kissel(int Z, double E, double PK, double PL1, double PL2
 
 	/*yes I know that KM4 lines are forbidden... */
 	if (PK > 0.0) 
-		rv += FluorYield(Z, K_SHELL, NULL) * PK *RadRate(Z, KM4_LINE, NULL);
+		rv += FluorYield_unchecked(Z, K_SHELL) * PK *RadRate_unchecked(Z, KM4_LINE);
 
 	if (PL1 > 0.0)
-		rv += FluorYield(Z, L1_SHELL, NULL) * PL1 * RadRate(Z, L1M4_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L1_SHELL) * PL1 * RadRate_unchecked(Z, L1M4_LINE);
 
 	if (PL2 > 0.0)
-		rv += FluorYield(Z, L2_SHELL, NULL) * PL2 * RadRate(Z, L2M4_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L2_SHELL) * PL2 * RadRate_unchecked(Z, L2M4_LINE);
 
 	if (PL3 > 0.0)
-		rv += FluorYield(Z, L3_SHELL, NULL) * PL3 * RadRate(Z, L3M4_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L3_SHELL) * PL3 * RadRate_unchecked(Z, L3M4_LINE);
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM14_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM14_TRANS) * PM1;
 	
 	if (PM2 > 0.0)
-		rv += CosKronTransProb(Z, FM24_TRANS, NULL) * PM2;
+		rv += CosKronTransProb_unchecked(Z, FM24_TRANS) * PM2;
 
 	if (PM3 > 0.0)
-		rv += CosKronTransProb(Z, FM34_TRANS, NULL) * PM3;
+		rv += CosKronTransProb_unchecked(Z, FM34_TRANS) * PM3;
 
 	return rv;
 
@@ -511,13 +512,13 @@ double PM4_auger_cascade_kissel(int Z, double E, double PK, double PL1, double P
 		rv += PL3 * xrf_cross_sections_constants_auger_only[Z][M4_SHELL][L3_SHELL];
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM14_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM14_TRANS) * PM1;
 
 	if (PM2 > 0.0)
-		rv += CosKronTransProb(Z, FM24_TRANS, NULL) * PM2;
+		rv += CosKronTransProb_unchecked(Z, FM24_TRANS) * PM2;
 
 	if (PM3 > 0.0)	
-		rv += CosKronTransProb(Z, FM34_TRANS, NULL) * PM3;
+		rv += CosKronTransProb_unchecked(Z, FM34_TRANS) * PM3;
 
 	return rv;
 }
@@ -542,13 +543,13 @@ double PM4_full_cascade_kissel(int Z, double E, double PK, double PL1, double PL
 		rv += PL3 * xrf_cross_sections_constants_full[Z][M4_SHELL][L3_SHELL];
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM14_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM14_TRANS) * PM1;
 	
 	if (PM2 > 0.0)
-		rv += CosKronTransProb(Z, FM24_TRANS, NULL) * PM2;
+		rv += CosKronTransProb_unchecked(Z, FM24_TRANS) * PM2;
 
 	if (PM3 > 0.0)
-		rv += CosKronTransProb(Z, FM34_TRANS, NULL) * PM3;
+		rv += CosKronTransProb_unchecked(Z, FM34_TRANS) * PM3;
 
 	return rv;
 }
@@ -561,16 +562,16 @@ double PM5_pure_kissel(int Z, double E, double PM1, double PM2, double PM3, doub
 		return 0.0;
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM15_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM15_TRANS) * PM1;
 
 	if (PM2 > 0.0)
-		rv += CosKronTransProb(Z, FM25_TRANS, NULL) * PM2;
+		rv += CosKronTransProb_unchecked(Z, FM25_TRANS) * PM2;
 
 	if (PM3 > 0.0)
-		rv += CosKronTransProb(Z, FM35_TRANS, NULL) * PM3;
+		rv += CosKronTransProb_unchecked(Z, FM35_TRANS) * PM3;
 
 	if (PM4 > 0.0)
-		rv += CosKronTransProb(Z, FM45_TRANS, NULL) * PM4;
+		rv += CosKronTransProb_unchecked(Z, FM45_TRANS) * PM4;
 
 	return rv;
 }
@@ -584,28 +585,28 @@ double PM5_rad_cascade_kissel(int Z, double E, double PK, double PL1, double PL2
 
 	/*yes I know that KM5 lines are forbidden... */
 	if (PK > 0.0) 
-		rv += FluorYield(Z, K_SHELL, NULL) * PK * RadRate(Z, KM5_LINE, NULL);
+		rv += FluorYield_unchecked(Z, K_SHELL) * PK * RadRate_unchecked(Z, KM5_LINE);
 
 	if (PL1 > 0.0)
-		rv += FluorYield(Z, L1_SHELL, NULL) * PL1 * RadRate(Z, L1M5_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L1_SHELL) * PL1 * RadRate_unchecked(Z, L1M5_LINE);
 
 	if (PL2 > 0.0)
-		rv += FluorYield(Z, L2_SHELL, NULL) * PL2 * RadRate(Z, L2M5_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L2_SHELL) * PL2 * RadRate_unchecked(Z, L2M5_LINE);
 
 	if (PL3 > 0.0)
-		rv += FluorYield(Z, L3_SHELL, NULL) * PL3 * RadRate(Z, L3M5_LINE, NULL);
+		rv += FluorYield_unchecked(Z, L3_SHELL) * PL3 * RadRate_unchecked(Z, L3M5_LINE);
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM15_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM15_TRANS) * PM1;
 	
 	if (PM2 > 0.0)
-		rv += CosKronTransProb(Z, FM25_TRANS, NULL) * PM2;
+		rv += CosKronTransProb_unchecked(Z, FM25_TRANS) * PM2;
 
 	if (PM3 > 0.0)
-		rv += CosKronTransProb(Z, FM35_TRANS, NULL) * PM3;
+		rv += CosKronTransProb_unchecked(Z, FM35_TRANS) * PM3;
 
 	if (PM4 > 0.0)
-		rv += CosKronTransProb(Z, FM45_TRANS, NULL) * PM4;
+		rv += CosKronTransProb_unchecked(Z, FM45_TRANS) * PM4;
 
 	return rv;
 }
@@ -626,13 +627,13 @@ double PM5_auger_cascade_kissel(int Z, double E, double PK, double PL1, double P
 	if (PL3 > 0.0)
 		rv += PL3 * xrf_cross_sections_constants_auger_only[Z][M5_SHELL][L3_SHELL];
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM15_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM15_TRANS) * PM1;
 	if (PM2 > 0.0)
-		rv += CosKronTransProb(Z, FM25_TRANS, NULL) * PM2;
+		rv += CosKronTransProb_unchecked(Z, FM25_TRANS) * PM2;
 	if (PM3 > 0.0)	
-		rv += CosKronTransProb(Z, FM35_TRANS, NULL) * PM3;
+		rv += CosKronTransProb_unchecked(Z, FM35_TRANS) * PM3;
 	if (PM4 > 0.0)	
-		rv += CosKronTransProb(Z, FM45_TRANS, NULL) * PM4;
+		rv += CosKronTransProb_unchecked(Z, FM45_TRANS) * PM4;
 
 	return rv;
 }
@@ -657,16 +658,16 @@ double PM5_full_cascade_kissel(int Z, double E, double PK, double PL1, double PL
 		rv += PL3 * xrf_cross_sections_constants_full[Z][M5_SHELL][L3_SHELL];
 
 	if (PM1 > 0.0)
-		rv += CosKronTransProb(Z, FM15_TRANS, NULL) * PM1;
+		rv += CosKronTransProb_unchecked(Z, FM15_TRANS) * PM1;
 	
 	if (PM2 > 0.0)
-		rv += CosKronTransProb(Z, FM25_TRANS, NULL) * PM2;
+		rv += CosKronTransProb_unchecked(Z, FM25_TRANS) * PM2;
 
 	if (PM3 > 0.0)
-		rv += CosKronTransProb(Z, FM35_TRANS, NULL) * PM3;
+		rv += CosKronTransProb_unchecked(Z, FM35_TRANS) * PM3;
 
 	if (PM4 > 0.0)
-		rv += CosKronTransProb(Z, FM45_TRANS, NULL) * PM4;
+		rv += CosKronTransProb_unchecked(Z, FM45_TRANS) * PM4;
 
 	return rv;
 }
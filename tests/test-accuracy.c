@@ -0,0 +1,320 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+/*
+ * Accuracy versus speed of the evaluation tiers of xrl_context, against the reference evaluation
+ * of the functions without context (double precision cubic splines).
+ * Every interpolated table is sampled densely for all elements, and right next to every absorption edge.
+ * For every table and tier, the maximum and percentile relative errors are reported alongside the throughput,
+ * and the test fails when a tier exceeds the bounds documented in xraylib-context.h.
+ */
+
+#include "xraylib.h"
+#include "xraylib-error-private.h"
+#ifdef NDEBUG
+  #undef NDEBUG
+#endif
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+/* log-uniform samples per element, on top of the samples next to the edges */
+#define N_SAMPLES 1000
+/* relative distances from the edges that are sampled on both sides */
+static const double edge_offsets[] = {1E-9, 1E-7, 1E-5, 1E-3};
+#define N_EDGE_OFFSETS (sizeof(edge_offsets) / sizeof(edge_offsets[0]))
+/* samples this close to an edge are reported separately */
+#define EDGE_WINDOW 1E-4
+
+typedef double (*reference_function)(int Z, double x, xrl_error **error);
+typedef double (*tier_function)(xrl_context *ctx, int Z, double x);
+
+typedef struct {
+	const char *name;
+	reference_function reference;
+	tier_function evaluate;
+	double x_min, x_max; /* sampled range */
+	int edges;           /* 1 if the table has absorption edges */
+	double floor;        /* errors are relative to the largest of |reference| and floor */
+	double linear_max_error;      /* bounds of the linear tiers, from the measured errors with some headroom */
+	double linear_edge_max_error;
+} table;
+
+static const table tables[] = {
+	/* the cross sections are worst just above the L and M edges, where log-log linear interpolation cuts the corners */
+	{"CS_Total", CS_Total, CS_Total_ctx, 1.0, 1000.0, 1, 0.0, 0.2, 2E-3},
+	{"CS_Photo", CS_Photo, CS_Photo_ctx, 1.0, 1000.0, 1, 0.0, 0.2, 5E-4},
+	{"CS_Rayl", CS_Rayl, CS_Rayl_ctx, 1.0, 1000.0, 0, 0.0, 4E-2, 0.0},
+	{"CS_Compt", CS_Compt, CS_Compt_ctx, 1.0, 1000.0, 0, 0.0, 4E-2, 0.0},
+	{"CS_Energy", CS_Energy, CS_Energy_ctx, 1.0, 1000.0, 1, 0.0, 3E-2, 1E-12},
+	{"CSb_Total", CSb_Total, CSb_Total_ctx, 1.0, 1000.0, 1, 0.0, 0.2, 2E-3},
+	{"CSb_Photo", CSb_Photo, CSb_Photo_ctx, 1.0, 1000.0, 1, 0.0, 0.2, 5E-4},
+	{"CSb_Rayl", CSb_Rayl, CSb_Rayl_ctx, 1.0, 1000.0, 0, 0.0, 4E-2, 0.0},
+	{"CSb_Compt", CSb_Compt, CSb_Compt_ctx, 1.0, 1000.0, 0, 0.0, 4E-2, 0.0},
+	/* the scattering functions vanish at high and low q respectively, the anomalous scattering factors change sign */
+	{"FF_Rayl", FF_Rayl, FF_Rayl_ctx, 1E-3, 1E2, 0, 1E-2, 0.5, 0.0},
+	{"SF_Compt", SF_Compt, SF_Compt_ctx, 1E-3, 1E2, 0, 1E-2, 0.5, 0.0},
+	{"Fi", Fi, Fi_ctx, 1.0, 100.0, 1, 1E-2, 0.15, 1E-2},
+	{"Fii", Fii, Fii_ctx, 1.0, 100.0, 1, 1E-2, 5E-2, 1E-2},
+};
+#define N_TABLES (sizeof(tables) / sizeof(tables[0]))
+
+typedef struct {
+	const char *name;
+	xrl_precision precision;
+	xrl_interpolation interpolation;
+	double max_error;      /* bound on the relative error away from the edges, on top of the linear bound of the table */
+	double edge_max_error; /* bound on the relative error within EDGE_WINDOW of an edge, idem */
+} tier;
+
+/* single precision rounds energies within ~1E-7 of an edge onto its other side,
+ * where the cross section jumps by up to an order of magnitude */
+static const tier tiers[] = {
+	{"double/spline", XRL_PRECISION_DOUBLE, XRL_INTERPOLATION_SPLINE, 0.0, 0.0},
+	{"single/spline", XRL_PRECISION_SINGLE, XRL_INTERPOLATION_SPLINE, 1E-4, 10.0},
+	{"double/linear", XRL_PRECISION_DOUBLE, XRL_INTERPOLATION_LINEAR, 0.0, 0.0},
+	{"single/linear", XRL_PRECISION_SINGLE, XRL_INTERPOLATION_LINEAR, 1E-4, 10.0},
+};
+#define N_TIERS (sizeof(tiers) / sizeof(tiers[0]))
+
+typedef struct {
+	int Z;
+	double x;
+	int at_edge;
+	double reference;
+} sample;
+
+static double now(void) {
+	return (double) clock() / CLOCKS_PER_SEC;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+	double x = *(const double *) a, y = *(const double *) b;
+	return x < y ? -1 : x > y;
+}
+
+static int near_edge(int Z, double x, double window) {
+	int shell;
+
+	for (shell = K_SHELL ; shell <= N7_SHELL ; shell++) {
+		double edge = EdgeEnergy(Z, shell, NULL);
+		if (edge > 0.0 && fabs(x - edge) <= window * edge)
+			return 1;
+	}
+	return 0;
+}
+
+/* the samples of a table for which the reference evaluation succeeds */
+static sample* make_samples(const table *t, int *n_samples) {
+	sample *samples = malloc((size_t) (ZMAX + 1) * (N_SAMPLES + 2 * N_EDGE_OFFSETS * (N7_SHELL + 1)) * sizeof(sample));
+	int Z, i, shell, n = 0;
+	size_t j;
+
+	assert(samples != NULL);
+
+	for (Z = 1 ; Z <= ZMAX ; Z++) {
+		for (i = 0 ; i < N_SAMPLES ; i++) {
+			samples[n].Z = Z;
+			samples[n].x = t->x_min * exp((i + 0.5) / N_SAMPLES * log(t->x_max / t->x_min));
+			n++;
+		}
+		for (shell = K_SHELL ; t->edges && shell <= N7_SHELL ; shell++) {
+			double edge = EdgeEnergy(Z, shell, NULL);
+			if (edge < t->x_min || edge > t->x_max)
+				continue;
+			for (j = 0 ; j < N_EDGE_OFFSETS ; j++) {
+				samples[n].Z = Z;
+				samples[n++].x = edge * (1.0 - edge_offsets[j]);
+				samples[n].Z = Z;
+				samples[n++].x = edge * (1.0 + edge_offsets[j]);
+			}
+		}
+	}
+
+	/* drop the samples outside the tables */
+	for (i = 0, *n_samples = 0 ; i < n ; i++) {
+		samples[i].reference = t->reference(samples[i].Z, samples[i].x, NULL);
+		if (samples[i].reference == 0.0)
+			continue;
+		samples[i].at_edge = t->edges && near_edge(samples[i].Z, samples[i].x, EDGE_WINDOW);
+		samples[(*n_samples)++] = samples[i];
+	}
+
+	return samples;
+}
+
+/* throughput of the reference evaluation, in millions of evaluations per second */
+static double reference_throughput(const table *t, const sample *samples, int n) {
+	double start = now(), sum = 0.0, elapsed;
+	int i;
+
+	for (i = 0 ; i < n ; i++)
+		sum += t->reference(samples[i].Z, samples[i].x, NULL);
+	elapsed = now() - start;
+	assert(sum == sum);
+
+	return elapsed > 0.0 ? n / elapsed * 1E-6 : 0.0;
+}
+
+static int check_tier(const table *t, const tier *tr, const sample *samples, int n, double reference_mevals) {
+	xrl_context *ctx = xrl_context_new(NULL);
+	double *errors = malloc(n * sizeof(double)), *values = malloc(n * sizeof(double));
+	double start, elapsed, edge_max = 0.0, max_error = tr->max_error, edge_max_error = tr->edge_max_error;
+	int i, n_errors = 0, n_edge = 0, ok;
+
+	assert(ctx != NULL && errors != NULL && values != NULL);
+	assert(xrl_context_set_precision(ctx, tr->precision, NULL) == 1);
+	assert(xrl_context_set_interpolation(ctx, tr->interpolation, NULL) == 1);
+
+	if (tr->interpolation == XRL_INTERPOLATION_LINEAR) {
+		max_error += t->linear_max_error;
+		edge_max_error += t->linear_edge_max_error;
+	}
+
+	start = now();
+	for (i = 0 ; i < n ; i++)
+		values[i] = t->evaluate(ctx, samples[i].Z, samples[i].x);
+	elapsed = now() - start;
+
+	for (i = 0 ; i < n ; i++) {
+		double error = fabs(values[i] - samples[i].reference) / fmax(fabs(samples[i].reference), t->floor);
+		if (samples[i].at_edge) {
+			edge_max = fmax(edge_max, error);
+			n_edge++;
+		}
+		else {
+			errors[n_errors++] = error;
+		}
+	}
+	qsort(errors, n_errors, sizeof(double), compare_doubles);
+
+	ok = errors[n_errors - 1] <= max_error && edge_max <= edge_max_error;
+	printf("  %-10s %-14s %8d %10.2E %10.2E %10.2E %10.2E %10.2E %8.1f %8.1f%s\n",
+		t->name, tr->name, n,
+		errors[n_errors / 2], errors[(int) (n_errors * 0.99)], errors[(int) (n_errors * 0.999)], errors[n_errors - 1],
+		edge_max, reference_mevals, elapsed > 0.0 ? n / elapsed * 1E-6 : 0.0, ok ? "" : "  EXCEEDS BOUND");
+
+	xrl_context_free(ctx);
+	free(errors);
+	free(values);
+
+	return ok;
+}
+
+/* CSb_Photo_Partial has no alternative tiers: its sum over the shells, weighted by their occupancies (CSb_Photo_Total),
+ * is checked against the independent CSb_Photo table, away from the edges where the two datasets disagree on the fine structure.
+ * Below nitrogen, the Kissel subshell cross sections fall off far faster than CSb_Photo above a few keV, as do those of the other
+ * light and medium elements at the highest energies: the bounds are on the median per element and the overall 90th percentile,
+ * over the range where the datasets overlap (measured: 1.4E-2, 2.0E-3 and 9.8E-3).
+ * The extrapolation branch just above the edges is checked for being finite and positive. */
+#define PARTIAL_Z_MIN 7
+#define PARTIAL_X_MIN 1.0
+#define PARTIAL_X_MAX 100.0
+#define PARTIAL_EDGE_WINDOW 1E-2
+#define PARTIAL_MAX_ELEMENT_MEDIAN 3E-2
+#define PARTIAL_MAX_MEDIAN 5E-3
+#define PARTIAL_MAX_P90 2E-2
+
+static int check_photo_partial(void) {
+	double *errors = malloc((size_t) (ZMAX + 1) * N_SAMPLES * sizeof(double)), *element_errors = malloc(N_SAMPLES * sizeof(double));
+	double start = now(), elapsed, element_median_max = 0.0, median, p90;
+	int Z, shell, i, n = 0, n_errors = 0, element_median_Z = 0, ok;
+	size_t j;
+
+	assert(errors != NULL && element_errors != NULL);
+
+	for (Z = 1 ; Z <= ZMAX ; Z++) {
+		for (shell = K_SHELL ; shell <= N7_SHELL ; shell++) {
+			double edge = EdgeEnergy(Z, shell, NULL);
+			if (edge <= 0.0 || CSb_Photo_Partial(Z, shell, edge * 2.0, NULL) == 0.0)
+				continue;
+			for (j = 0 ; j < N_EDGE_OFFSETS ; j++) {
+				double cs = CSb_Photo_Partial(Z, shell, edge * (1.0 + edge_offsets[j]), NULL);
+				assert(cs > 0.0 && isfinite(cs));
+				n++;
+			}
+		}
+	}
+
+	for (Z = PARTIAL_Z_MIN ; Z <= ZMAX ; Z++) {
+		int n_element = 0;
+
+		for (i = 0 ; i < N_SAMPLES ; i++) {
+			double x = PARTIAL_X_MIN * exp((i + 0.5) / N_SAMPLES * log(PARTIAL_X_MAX / PARTIAL_X_MIN));
+			double total, reference;
+
+			if (near_edge(Z, x, PARTIAL_EDGE_WINDOW))
+				continue;
+			total = CSb_Photo_Total(Z, x, NULL);
+			reference = CSb_Photo(Z, x, NULL);
+			n++;
+			if (total == 0.0 || reference == 0.0)
+				continue;
+			element_errors[n_element++] = errors[n_errors++] = fabs(total - reference) / reference;
+		}
+		if (n_element == 0)
+			continue;
+		qsort(element_errors, n_element, sizeof(double), compare_doubles);
+		if (element_errors[n_element / 2] > element_median_max) {
+			element_median_max = element_errors[n_element / 2];
+			element_median_Z = Z;
+		}
+	}
+	elapsed = now() - start;
+	assert(n_errors > 0);
+
+	qsort(errors, n_errors, sizeof(double), compare_doubles);
+	median = errors[n_errors / 2];
+	p90 = errors[(int) (n_errors * 0.9)];
+	ok = median <= PARTIAL_MAX_MEDIAN && p90 <= PARTIAL_MAX_P90 && element_median_max <= PARTIAL_MAX_ELEMENT_MEDIAN;
+
+	printf("  %-10s %-14s %8d %10.2E %10s %10s %10s %10s %8s %8.1f%s\n", "CSb_Photo_Partial", "", n, median, "", "", "", "", "", elapsed > 0.0 ? n / elapsed * 1E-6 : 0.0, ok ? "" : "  EXCEEDS BOUND");
+	printf("  %-10s against CSb_Photo: p90 %.2E, largest median per element %.2E (Z = %d)\n", "CSb_Photo_Partial", p90, element_median_max, element_median_Z);
+
+	free(errors);
+	free(element_errors);
+
+	return ok;
+}
+
+int main(int argc, char **argv) {
+	size_t t, tr;
+	int n_failed = 0;
+
+	printf("relative errors against the reference, and throughput in millions of evaluations per second\n");
+	printf("  %-10s %-14s %8s %10s %10s %10s %10s %10s %8s %8s\n", "table", "tier", "samples", "median", "p99", "p99.9", "max", "edge max", "ref", "tier");
+
+	for (t = 0 ; t < N_TABLES ; t++) {
+		int n;
+		sample *samples = make_samples(&tables[t], &n);
+		double reference_mevals = reference_throughput(&tables[t], samples, n);
+
+		for (tr = 0 ; tr < N_TIERS ; tr++) {
+			if (!check_tier(&tables[t], &tiers[tr], samples, n, reference_mevals))
+				n_failed++;
+		}
+		free(samples);
+	}
+
+	if (!check_photo_partial())
+		n_failed++;
+
+	if (n_failed > 0)
+		printf("%d table(s) and tier(s) exceed their bounds\n", n_failed);
+
+	return n_failed > 0;
+}
@@ -20,12 +20,13 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 #include <stddef.h>
 #include <string.h>
 #include <math.h>
+#include <locale.h>
 
 int main(int argc, char *argv[]) {
 	xrl_error *error = NULL;
 	char *symbol = NULL;
 	struct compoundData *cd = NULL;
-	int Z;
+	int Z, i;
 
 	/* taken from https://github.com/KenanY/chemical-formula/blob/master/test/index.js */
 	/* good formulas */
@@ -128,5 +129,22 @@ int main(int argc, char *argv[]) {
 		xrlFree(symbol);
 	}
 
+	/* subscripts are parsed in the C locale, and the locale of the process is left alone */
+	for (i = 0 ; i < 3 ; i++) {
+		const char *locales[3] = {"de_DE.UTF-8", "fr_FR.UTF-8", "nl_BE.UTF-8"};
+		char locale[64];
+		if (setlocale(LC_NUMERIC, locales[i]) == NULL)
+			continue;
+		strncpy(locale, setlocale(LC_NUMERIC, NULL), sizeof(locale) - 1);
+		locale[sizeof(locale) - 1] = '\0';
+		cd = CompoundParser("H2.5O", &error);
+		assert(cd != NULL);
+		assert(error == NULL);
+		assert(cd->nAtomsAll == 3.5);
+		FreeCompoundData(cd);
+		assert(strcmp(setlocale(LC_NUMERIC, NULL), locale) == 0);
+	}
+	setlocale(LC_NUMERIC, "C");
+
 	return 0;
 }
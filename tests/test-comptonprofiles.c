@@ -20,9 +20,15 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED
 #include <string.h>
 #include <math.h>
 
+#define NCHANNELS 4000
+
 int main(int argc, char **argv) {
 	xrl_error *error = NULL;
 	double profile, profile1, profile2;
+	double E[NCHANNELS], ddcs[NCHANNELS], ddcs_H[NCHANNELS], ddcs_O[NCHANNELS];
+	double E0 = 20.0, theta = PI / 2.0, integral = 0.0;
+	int i, imax = 0, rv;
+	struct compoundData *cd;
 
 	/* pz == 0.0 */
 	profile = ComptonProfile(26, 0.0, &error);
@@ -146,7 +152,98 @@ int main(int argc, char **argv) {
 	assert(strcmp(error->message, SPLINT_X_TOO_HIGH) == 0);
 	xrl_clear_error(&error);
 
+	/* Doppler broadened spectra */
+	for (i = 0 ; i < NCHANNELS ; i++)
+		E[i] = (i + 0.5) * E0 / NCHANNELS;
+
+	rv = DDCSb_Compt(26, E0, theta, E, NCHANNELS, ddcs, &error);
+	assert(rv == 1);
+	assert(error == NULL);
+	for (i = 0 ; i < NCHANNELS ; i++) {
+		assert(ddcs[i] >= 0.0);
+		integral += ddcs[i] * E0 / NCHANNELS;
+		if (ddcs[i] > ddcs[imax])
+			imax = i;
+	}
+	/* the spectrum peaks at the Compton energy and integrates to the incoherent cross section */
+	assert(fabs(E[imax] - ComptonEnergy(E0, theta, NULL)) < 2.0 * E0 / NCHANNELS);
+	assert(fabs(integral - DCSb_Compt(26, E0, theta, NULL)) / integral < 0.01);
+
+	/* energy transfers below the K edge do not see the K electrons */
+	E[0] = E0 - EdgeEnergy(26, K_SHELL, NULL) - 0.1;
+	E[1] = E0 - EdgeEnergy(26, K_SHELL, NULL) + 0.1;
+	E[2] = E0;
+	E[3] = 0.0;
+	rv = DDCSb_Compt(26, E0, theta, E, 4, ddcs, &error);
+	assert(rv == 1);
+	assert(error == NULL);
+	assert(ddcs[0] > ddcs[1]);
+	assert(ddcs[2] == 0.0);
+	assert(ddcs[3] == 0.0);
+
+	for (i = 0 ; i < NCHANNELS ; i++)
+		E[i] = (i + 0.5) * E0 / NCHANNELS;
+
+	rv = DDCS_Compt(26, E0, theta, E, NCHANNELS, ddcs, &error);
+	assert(rv == 1);
+	assert(error == NULL);
+	integral = 0.0;
+	for (i = 0 ; i < NCHANNELS ; i++)
+		integral += ddcs[i] * E0 / NCHANNELS;
+	assert(fabs(integral - DCS_Compt(26, E0, theta, NULL)) / integral < 0.01);
+
+	/* compounds are mass fraction weighted sums of their elements */
+	rv = DDCS_Compt_CP("H2O", E0, theta, E, NCHANNELS, ddcs, &error);
+	assert(rv == 1);
+	assert(error == NULL);
+	rv = DDCS_Compt(1, E0, theta, E, NCHANNELS, ddcs_H, &error);
+	assert(rv == 1);
+	rv = DDCS_Compt(8, E0, theta, E, NCHANNELS, ddcs_O, &error);
+	assert(rv == 1);
+	cd = CompoundParser("H2O", NULL);
+	for (i = 0 ; i < NCHANNELS ; i++)
+		assert(fabs(ddcs[i] - cd->massFractions[0] * ddcs_H[i] - cd->massFractions[1] * ddcs_O[i]) <= 1E-12 * ddcs[i]);
+	FreeCompoundData(cd);
+
+	rv = DDCS_Compt_CP("Water, Liquid", E0, theta, E, NCHANNELS, ddcs_H, &error);
+	assert(rv == 1);
+	assert(error == NULL);
+
+	/* bad input */
+	rv = DDCSb_Compt(0, E0, theta, E, NCHANNELS, ddcs, &error);
+	assert(rv == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(error->message, Z_OUT_OF_RANGE) == 0);
+	xrl_clear_error(&error);
+
+	rv = DDCSb_Compt(26, 0.0, theta, E, NCHANNELS, ddcs, &error);
+	assert(rv == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(error->message, NEGATIVE_ENERGY) == 0);
+	xrl_clear_error(&error);
+
+	rv = DDCSb_Compt(26, E0, theta, NULL, NCHANNELS, ddcs, &error);
+	assert(rv == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(error->message, NULL_ARRAY) == 0);
+	xrl_clear_error(&error);
 
+	rv = DDCSb_Compt(26, E0, theta, E, 0, ddcs, &error);
+	assert(rv == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(error->message, INVALID_ARRAY_LENGTH) == 0);
+	xrl_clear_error(&error);
+
+	rv = DDCS_Compt_CP("auksjdhkajsdh", E0, theta, E, NCHANNELS, ddcs, &error);
+	assert(rv == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(error->message, UNKNOWN_COMPOUND) == 0);
+	xrl_clear_error(&error);
 
 	return 0;
 }
@@ -0,0 +1,176 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "xraylib.h"
+#include "xraylib-error-private.h"
+#ifdef NDEBUG
+  #undef NDEBUG
+#endif
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#define N_E 2000
+
+typedef double (*function)(int Z, double E, xrl_error **error);
+typedef double (*function_ctx)(xrl_context *ctx, int Z, double E);
+
+static const function functions[] = {CS_Total, CS_Photo, CS_Rayl, CS_Compt, CS_Energy, CSb_Total, CSb_Photo, CSb_Rayl, CSb_Compt, FF_Rayl, SF_Compt, Fi, Fii};
+static const function_ctx functions_ctx[] = {CS_Total_ctx, CS_Photo_ctx, CS_Rayl_ctx, CS_Compt_ctx, CS_Energy_ctx, CSb_Total_ctx, CSb_Photo_ctx, CSb_Rayl_ctx, CSb_Compt_ctx, FF_Rayl_ctx, SF_Compt_ctx, Fi_ctx, Fii_ctx};
+#define N_FUNCTIONS (sizeof(functions) / sizeof(functions[0]))
+
+/* single precision may put energies on the wrong side of an edge */
+static int near_edge(int Z, double E) {
+	int shell;
+
+	for (shell = K_SHELL ; shell <= N7_SHELL ; shell++) {
+		double edge = EdgeEnergy(Z, shell, NULL);
+		if (edge > 0.0 && fabs(E - edge) < 1E-4 * edge)
+			return 1;
+	}
+	return 0;
+}
+
+/* energies (or momentum transfers) going up and down again, crossing all edges */
+static double scan(int i) {
+	int j = i < N_E / 2 ? i : N_E - 1 - i;
+	return 1.0 + j * 99.0 / (N_E / 2) + (i % 7) * 1E-3;
+}
+
+int main(int argc, char **argv) {
+	xrl_error *error = NULL;
+	const xrl_error *ctx_error;
+	xrl_context *ctx;
+	size_t f;
+	int i, Z;
+
+	ctx = xrl_context_new(&error);
+	assert(ctx != NULL);
+	assert(error == NULL);
+	assert(xrl_context_get_precision(ctx) == XRL_PRECISION_DOUBLE);
+	assert(xrl_context_get_interpolation(ctx) == XRL_INTERPOLATION_SPLINE);
+	assert(xrl_context_get_validation(ctx) == 1);
+	assert(xrl_context_get_error(ctx) == NULL);
+
+	/* the default options reproduce the functions without context exactly */
+	for (f = 0 ; f < N_FUNCTIONS ; f++) {
+		for (Z = 1 ; Z <= 92 ; Z++) {
+			for (i = 0 ; i < N_E ; i++) {
+				double x = scan(i);
+				assert(functions_ctx[f](ctx, Z, x) == functions[f](Z, x, NULL));
+				assert(functions_ctx[f](NULL, Z, x) == functions[f](Z, x, NULL));
+			}
+		}
+	}
+	assert(xrl_context_get_error(ctx) == NULL);
+
+	/* so does the context without validation, for valid arguments */
+	xrl_context_set_validation(ctx, 0);
+	assert(xrl_context_get_validation(ctx) == 0);
+	for (f = 0 ; f < N_FUNCTIONS ; f++) {
+		for (i = 0 ; i < N_E ; i++)
+			assert(functions_ctx[f](ctx, 26, scan(i)) == functions[f](26, scan(i), NULL));
+	}
+	/* atomic numbers are checked regardless */
+	assert(CS_Photo_ctx(ctx, ZMAX + 1, 10.0) == 0.0);
+	assert(strcmp(xrl_context_get_error(ctx)->message, Z_OUT_OF_RANGE) == 0);
+	assert(FF_Rayl_ctx(ctx, -1, 1.0) == 0.0);
+	assert(Fii_ctx(ctx, 0, 10.0) == 0.0);
+	assert(CS_Energy_ctx(ctx, 94, 10.0) == 0.0);
+	xrl_context_clear_error(ctx);
+	xrl_context_set_validation(ctx, 1);
+
+	/* the photoionization energies of curium are not sorted around 4 keV, which must not confuse the interval walk */
+	for (i = 0 ; i <= 1000 ; i++) {
+		double E = 4.02 - 3E-5 * i;
+		assert(CS_Photo_ctx(ctx, 96, E) == CS_Photo(96, E, NULL));
+	}
+
+	/* errors are stored in the context */
+	assert(CS_Photo_ctx(ctx, 0, 10.0) == 0.0);
+	ctx_error = xrl_context_get_error(ctx);
+	assert(ctx_error != NULL);
+	assert(ctx_error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(ctx_error->message, Z_OUT_OF_RANGE) == 0);
+
+	/* and remain until the next error, using the same storage */
+	assert(CS_Photo_ctx(ctx, 26, 10.0) > 0.0);
+	assert(xrl_context_get_error(ctx) == ctx_error);
+	assert(CS_Total_ctx(ctx, 26, -1.0) == 0.0);
+	assert(xrl_context_get_error(ctx) == ctx_error);
+	assert(strcmp(ctx_error->message, NEGATIVE_ENERGY) == 0);
+	assert(CS_Energy_ctx(ctx, 94, 10.0) == 0.0);
+	assert(strcmp(ctx_error->message, Z_OUT_OF_RANGE) == 0);
+	assert(FF_Rayl_ctx(ctx, 26, -1.0) == 0.0);
+	assert(strcmp(ctx_error->message, NEGATIVE_Q) == 0);
+	assert(FF_Rayl_ctx(ctx, 26, 0.0) == 26.0);
+	assert(SF_Compt_ctx(ctx, 26, 0.0) == 0.0);
+	assert(strcmp(ctx_error->message, NEGATIVE_Q) == 0);
+	assert(CSb_Photo_ctx(ctx, 26, 1E6) == 0.0);
+	assert(strcmp(ctx_error->message, SPLINT_X_TOO_HIGH) == 0);
+	xrl_context_clear_error(ctx);
+	assert(xrl_context_get_error(ctx) == NULL);
+
+	/* linear interpolation goes through the same nodes */
+	assert(xrl_context_set_interpolation(ctx, XRL_INTERPOLATION_LINEAR, &error) == 1);
+	assert(xrl_context_get_interpolation(ctx) == XRL_INTERPOLATION_LINEAR);
+	for (Z = 1 ; Z <= 92 ; Z++) {
+		for (i = 0 ; i < N_E ; i++) {
+			double spline = CS_Rayl(Z, scan(i), NULL);
+			double linear = CS_Rayl_ctx(ctx, Z, scan(i));
+			assert(fabs(linear - spline) / spline < 5E-2);
+		}
+	}
+	assert(FF_Rayl_ctx(ctx, 26, 1E10) == 0.0);
+	assert(strcmp(xrl_context_get_error(ctx)->message, LININTERP_X_TOO_HIGH) == 0);
+	xrl_context_clear_error(ctx);
+	assert(xrl_context_set_interpolation(ctx, XRL_INTERPOLATION_SPLINE, &error) == 1);
+
+	/* single precision */
+	assert(xrl_context_set_precision(ctx, XRL_PRECISION_SINGLE, &error) == 1);
+	assert(xrl_context_get_precision(ctx) == XRL_PRECISION_SINGLE);
+	for (Z = 1 ; Z <= 92 ; Z++) {
+		for (i = 0 ; i < N_E ; i++) {
+			double full = CS_Total(Z, scan(i), NULL);
+			double single = CS_Total_ctx(ctx, Z, scan(i));
+			assert(fabs(single - full) / full < 1E-5 || near_edge(Z, scan(i)));
+		}
+	}
+	assert(xrl_context_get_error(ctx) == NULL);
+
+	/* invalid options */
+	assert(xrl_context_set_precision(ctx, (xrl_precision) 5, &error) == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(error->message, INVALID_PRECISION) == 0);
+	xrl_clear_error(&error);
+	assert(xrl_context_get_precision(ctx) == XRL_PRECISION_SINGLE);
+
+	assert(xrl_context_set_interpolation(ctx, (xrl_interpolation) -1, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, INVALID_INTERPOLATION) == 0);
+	xrl_clear_error(&error);
+
+	assert(xrl_context_set_precision(NULL, XRL_PRECISION_DOUBLE, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, CONTEXT_NULL) == 0);
+	xrl_clear_error(&error);
+
+	assert(xrl_context_get_error(NULL) == NULL);
+	xrl_context_clear_error(NULL);
+	xrl_context_free(ctx);
+	xrl_context_free(NULL);
+
+	return 0;
+}
@@ -181,6 +181,55 @@ int main(int argc, char **argv) {
 	}
 	Crystal_Free(cs);
 
+	/* shared crystals */
+	cs = Crystal_GetCrystalShared("Diamond", &error);
+	assert(cs != NULL);
+	assert(error == NULL);
+	assert(strcmp(cs->name, "Diamond") == 0);
+	assert(Crystal_GetCrystalShared("Diamond", NULL) == cs);
+	assert(Crystal_Retain(cs) == cs);
+	Crystal_Release(cs);
+	Crystal_Release(cs);
+	assert(Crystal_GetCrystalShared("Diamond", NULL) == cs);
+
+	cs_copy = Crystal_GetCrystalShared("Diamond copy 0", &error);
+	assert(cs_copy != NULL);
+	assert(error == NULL);
+	assert(strcmp(cs_copy->name, "Diamond copy 0") == 0);
+	assert(cs_copy->n_atom == cs->n_atom);
+	assert(fabs(cs_copy->volume - cs->volume) < 1E-4);
+
+	cs_copy = Crystal_MakeShared(cs, &error);
+	assert(cs_copy != NULL);
+	assert(error == NULL);
+	assert(cs_copy != cs);
+	assert(strcmp(cs_copy->name, "Diamond") == 0);
+	assert(memcmp(cs_copy->atom, cs->atom, cs->n_atom * sizeof(Crystal_Atom)) == 0);
+	assert(Crystal_Retain(cs_copy) == cs_copy);
+	Crystal_Release(cs_copy);
+	assert(fabs(Crystal_dSpacing(cs_copy, 1, 1, 1, NULL) - Crystal_dSpacing(cs, 1, 1, 1, NULL)) < 1E-12);
+	Crystal_Release(cs_copy);
+
+	cs = Crystal_GetCrystalShared("non-existent-crystal", &error);
+	assert(cs == NULL);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	xrl_clear_error(&error);
+
+	cs = Crystal_GetCrystalShared(NULL, &error);
+	assert(cs == NULL);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(error->message, CRYSTAL_NULL) == 0);
+	xrl_clear_error(&error);
+
+	cs = Crystal_MakeShared(NULL, &error);
+	assert(cs == NULL);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(error->message, CRYSTAL_NULL) == 0);
+	xrl_clear_error(&error);
+
 	/* bragg angle */
 	cs = Crystal_GetCrystal("Diamond", NULL, &error);
 	assert(cs != NULL);
@@ -335,5 +384,460 @@ int main(int argc, char **argv) {
 
 	/* TODO: Test Crystal_F_H_StructureFactor and Crystal_F_H_StructureFactor_Partial */
 
+	/* batched structure factors must match the single reflection ones */
+	for (i = 0 ; i < 3 ; i++) {
+		const char *names[3] = {"Si", "Diamond", "LiNbO3"};
+		int miller[3 * 8] = {1, 1, 1, 2, 2, 0, 0, 0, 0, 1, -1, 3, 4, 0, 0, 2, 0, 0, 3, 3, 1, 5, 3, 1};
+		xrlComplex F_H[8];
+		int j, flags;
+
+		cs = Crystal_GetCrystal(names[i], NULL, &error);
+		assert(cs != NULL);
+
+		for (flags = 0 ; flags < 4 ; flags++) {
+			int f0_flag = flags % 3, f_prime_flag = flags == 3 ? 0 : 2, f_prime2_flag = flags == 1 ? 0 : 2;
+			rv = Crystal_F_H_StructureFactor_Partial_Batch(cs, 17.4, miller, 8, 1.0, 1.0, f0_flag, f_prime_flag, f_prime2_flag, F_H, &error);
+			assert(rv == 1);
+			assert(error == NULL);
+			for (j = 0 ; j < 8 ; j++) {
+				xrlCplx_1 = Crystal_F_H_StructureFactor_Partial(cs, 17.4, miller[3 * j], miller[3 * j + 1], miller[3 * j + 2], 1.0, 1.0, f0_flag, f_prime_flag, f_prime2_flag, &error);
+				assert(error == NULL);
+				assert(fabs(F_H[j].re - xrlCplx_1.re) < 1E-9);
+				assert(fabs(F_H[j].im - xrlCplx_1.im) < 1E-9);
+			}
+		}
+
+		rv = Crystal_F_H_StructureFactor_Batch(cs, 12.0, miller, 8, 0.9, 1.0, F_H, &error);
+		assert(rv == 1);
+		assert(error == NULL);
+		for (j = 0 ; j < 8 ; j++) {
+			xrlCplx_1 = Crystal_F_H_StructureFactor(cs, 12.0, miller[3 * j], miller[3 * j + 1], miller[3 * j + 2], 0.9, 1.0, &error);
+			assert(error == NULL);
+			assert(fabs(F_H[j].re - xrlCplx_1.re) < 1E-9);
+			assert(fabs(F_H[j].im - xrlCplx_1.im) < 1E-9);
+		}
+
+		/* bad input */
+		rv = Crystal_F_H_StructureFactor_Batch(cs, -8.0, miller, 8, 1.0, 1.0, F_H, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, NEGATIVE_ENERGY) == 0);
+		xrl_clear_error(&error);
+
+		rv = Crystal_F_H_StructureFactor_Batch(cs, 8.0, miller, 8, 0.0, 1.0, F_H, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, NEGATIVE_DEBYE_FACTOR) == 0);
+		xrl_clear_error(&error);
+
+		rv = Crystal_F_H_StructureFactor_Batch(cs, 8.0, NULL, 8, 1.0, 1.0, F_H, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, NULL_ARRAY) == 0);
+		xrl_clear_error(&error);
+
+		rv = Crystal_F_H_StructureFactor_Batch(cs, 8.0, miller, 0, 1.0, 1.0, F_H, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, INVALID_ARRAY_LENGTH) == 0);
+		xrl_clear_error(&error);
+
+		rv = Crystal_F_H_StructureFactor_Partial_Batch(cs, 8.0, miller, 8, 1.0, 1.0, 3, 2, 2, F_H, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		xrl_clear_error(&error);
+
+		Crystal_Free(cs);
+	}
+
+	rv = Crystal_F_H_StructureFactor_Batch(NULL, 8.0, (int []) {1, 1, 1}, 1, 1.0, 1.0, &xrlCplx_1, &error);
+	assert(rv == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(error->message, CRYSTAL_NULL) == 0);
+	xrl_clear_error(&error);
+
+	/* prepared reflections: scan across the Ge K-edge, forwards and backwards */
+	{
+		double energies[201];
+		xrlComplex F_H[201];
+		Crystal_Reflection *reflection;
+		int j;
+
+		for (j = 0 ; j < 201 ; j++)
+			energies[j] = 10.5 + j * 0.006;
+
+		cs = Crystal_GetCrystal("Ge", NULL, &error);
+		assert(cs != NULL);
+
+		reflection = Crystal_Reflection_New(cs, 2, 2, 0, 0.9, 1.0, &error);
+		assert(reflection != NULL);
+		assert(error == NULL);
+
+		rv = Crystal_Reflection_F_H_Batch(reflection, energies, 201, F_H, &error);
+		assert(rv == 1);
+		assert(error == NULL);
+		for (j = 0 ; j < 201 ; j++) {
+			xrlCplx_1 = Crystal_F_H_StructureFactor(cs, energies[j], 2, 2, 0, 0.9, 1.0, &error);
+			assert(error == NULL);
+			assert(fabs(F_H[j].re - xrlCplx_1.re) < 1E-9);
+			assert(fabs(F_H[j].im - xrlCplx_1.im) < 1E-9);
+			xrlCplx_1 = Crystal_Reflection_F_H(reflection, energies[j], &error);
+			assert(error == NULL);
+			assert(fabs(F_H[j].re - xrlCplx_1.re) < 1E-9);
+			assert(fabs(F_H[j].im - xrlCplx_1.im) < 1E-9);
+		}
+
+		for (j = 0 ; j < 201 ; j++)
+			energies[j] = 11.7 - j * 0.006;
+
+		rv = Crystal_Reflection_F_H_Batch(reflection, energies, 201, F_H, &error);
+		assert(rv == 1);
+		assert(error == NULL);
+		for (j = 0 ; j < 201 ; j++) {
+			xrlCplx_1 = Crystal_F_H_StructureFactor(cs, energies[j], 2, 2, 0, 0.9, 1.0, &error);
+			assert(fabs(F_H[j].re - xrlCplx_1.re) < 1E-9);
+			assert(fabs(F_H[j].im - xrlCplx_1.im) < 1E-9);
+		}
+
+		/* bad input */
+		rv = Crystal_Reflection_F_H_Batch(reflection, energies, 0, F_H, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, INVALID_ARRAY_LENGTH) == 0);
+		xrl_clear_error(&error);
+
+		rv = Crystal_Reflection_F_H_Batch(reflection, NULL, 201, F_H, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, NULL_ARRAY) == 0);
+		xrl_clear_error(&error);
+
+		xrlCplx_1 = Crystal_Reflection_F_H(reflection, -8.0, &error);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, NEGATIVE_ENERGY) == 0);
+		xrl_clear_error(&error);
+
+		xrlCplx_1 = Crystal_Reflection_F_H(reflection, 1E6, &error);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, SPLINT_X_TOO_HIGH) == 0);
+		xrl_clear_error(&error);
+
+		Crystal_Reflection_Free(reflection);
+
+		/* forward scattering */
+		reflection = Crystal_Reflection_New(cs, 0, 0, 0, 1.0, 1.0, &error);
+		assert(reflection != NULL);
+		xrlCplx_1 = Crystal_Reflection_F_H(reflection, 8.0, &error);
+		assert(error == NULL);
+		xrlCplx_2 = Crystal_F_H_StructureFactor(cs, 8.0, 0, 0, 0, 1.0, 1.0, &error);
+		assert(fabs(xrlCplx_1.re - xrlCplx_2.re) < 1E-9);
+		assert(fabs(xrlCplx_1.im - xrlCplx_2.im) < 1E-9);
+		Crystal_Reflection_Free(reflection);
+
+		reflection = Crystal_Reflection_New(cs, 2, 2, 0, 0.0, 1.0, &error);
+		assert(reflection == NULL);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, NEGATIVE_DEBYE_FACTOR) == 0);
+		xrl_clear_error(&error);
+
+		Crystal_Free(cs);
+
+		reflection = Crystal_Reflection_New(NULL, 2, 2, 0, 1.0, 1.0, &error);
+		assert(reflection == NULL);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, CRYSTAL_NULL) == 0);
+		xrl_clear_error(&error);
+
+		xrlCplx_1 = Crystal_Reflection_F_H(NULL, 8.0, &error);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, REFLECTION_NULL) == 0);
+		xrl_clear_error(&error);
+	}
+
+	/* dynamical diffraction */
+	{
+		double delta_theta[4001], R[4001], energies[401], R_energy[401];
+		double width, width_pi, width_plus, width_minus, integral, theta_bragg;
+		int j;
+
+		cs = Crystal_GetCrystal("Si", NULL, &error);
+		assert(cs != NULL);
+
+		width = Crystal_DarwinWidth(cs, 8.048, 1, 1, 1, 0.0, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, &error);
+		assert(error == NULL);
+		assert(fabs(width - 34.09E-6) < 0.1E-6);
+
+		theta_bragg = Bragg_angle(cs, 8.048, 1, 1, 1, NULL);
+		width_pi = Crystal_DarwinWidth(cs, 8.048, 1, 1, 1, 0.0, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_PI, 1.0, &error);
+		assert(error == NULL);
+		assert(fabs(width_pi / width - fabs(cos(2.0 * theta_bragg))) < 1E-9);
+
+		/* asymmetric reflections: the widths for +alpha and -alpha are related through b */
+		width_plus = Crystal_DarwinWidth(cs, 8.048, 1, 1, 1, 0.1, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, &error);
+		width_minus = Crystal_DarwinWidth(cs, 8.048, 1, 1, 1, -0.1, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, &error);
+		assert(error == NULL);
+		assert(width_plus < width && width_minus > width);
+		assert(fabs(width_plus * width_minus / (width * width) - 1.0) < 1E-6);
+
+		/* energy scan at fixed angle must agree with the angular scan */
+		for (j = 0 ; j < 401 ; j++) {
+			energies[j] = 8.048 * (1.0 + (j - 200) * 1E-6);
+			delta_theta[j] = theta_bragg - asin(KEV2ANGST / energies[j] / (2.0 * Crystal_dSpacing(cs, 1, 1, 1, NULL)));
+		}
+		rv = Crystal_RockingCurve_Energy(cs, energies, 401, 1, 1, 1, theta_bragg, 0.0, INFINITY, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, R_energy, &error);
+		assert(rv == 1);
+		assert(error == NULL);
+		for (j = 0 ; j < 401 ; j++) {
+			rv = Crystal_RockingCurve(cs, energies[j], 1, 1, 1, 0.0, INFINITY, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, &delta_theta[j], 1, R, &error);
+			assert(rv == 1);
+			assert(fabs(R[0] - R_energy[j]) < 1E-3);
+		}
+
+		/* below the cut-off energy, the reflectivity vanishes */
+		energies[0] = 1.0;
+		rv = Crystal_RockingCurve_Energy(cs, energies, 1, 1, 1, 1, theta_bragg, 0.0, INFINITY, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, R_energy, &error);
+		assert(rv == 1);
+		assert(R_energy[0] == 0.0);
+
+		/* bad input */
+		width = Crystal_DarwinWidth(cs, 1.0, 1, 1, 1, 0.0, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, &error);
+		assert(width == 0.0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, REFLECTION_NOT_ACCESSIBLE) == 0);
+		xrl_clear_error(&error);
+
+		rv = Crystal_RockingCurve(cs, 8.048, 1, 1, 1, 0.0, 0.0, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, delta_theta, 10, R, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, NEGATIVE_THICKNESS) == 0);
+		xrl_clear_error(&error);
+
+		rv = Crystal_RockingCurve(cs, 8.048, 1, 1, 1, 0.0, 1.0, 2, CRYSTAL_POLARIZATION_SIGMA, 1.0, delta_theta, 10, R, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, INVALID_GEOMETRY) == 0);
+		xrl_clear_error(&error);
+
+		rv = Crystal_RockingCurve(cs, 8.048, 1, 1, 1, 0.0, 1.0, CRYSTAL_GEOMETRY_BRAGG, 2, 1.0, delta_theta, 10, R, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, INVALID_POLARIZATION) == 0);
+		xrl_clear_error(&error);
+
+		rv = Crystal_RockingCurve(cs, 8.048, 1, 1, 1, 0.0, 1.0, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, NULL, 10, R, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, NULL_ARRAY) == 0);
+		xrl_clear_error(&error);
+
+		rv = Crystal_RockingCurve_Energy(cs, energies, 0, 1, 1, 1, theta_bragg, 0.0, 1.0, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, R, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, INVALID_ARRAY_LENGTH) == 0);
+		xrl_clear_error(&error);
+
+		rv = Crystal_RockingCurve(cs, 8.048, 0, 0, 0, 0.0, 1.0, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, delta_theta, 10, R, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, INVALID_MILLER) == 0);
+		xrl_clear_error(&error);
+
+		Crystal_Free(cs);
+
+		/* diamond absorbs weakly at 20 keV: compare with the integrated reflectivities of a non-absorbing crystal */
+		cs = Crystal_GetCrystal("Diamond", NULL, &error);
+		assert(cs != NULL);
+
+		width = Crystal_DarwinWidth(cs, 20.0, 1, 1, 1, 0.0, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, &error);
+		assert(error == NULL);
+		for (j = 0 ; j < 4001 ; j++)
+			delta_theta[j] = (j - 2000) * 0.01 * width;
+
+		/* thick crystal, Bragg: 4/3 of the Darwin width, with total reflection in the centre */
+		rv = Crystal_RockingCurve(cs, 20.0, 1, 1, 1, 0.0, INFINITY, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, delta_theta, 4001, R, &error);
+		assert(rv == 1);
+		assert(error == NULL);
+		integral = 0.0;
+		for (j = 0 ; j < 4001 ; j++) {
+			assert(R[j] >= 0.0 && R[j] <= 1.0);
+			integral += R[j] * 0.01 * width;
+		}
+		assert(fabs(integral / (4.0 * width / 3.0) - 1.0) < 0.02);
+
+		/* Laue, averaged over the Pendellosung oscillations: pi / 4 of the Darwin width */
+		rv = Crystal_RockingCurve(cs, 20.0, 1, 1, 1, 0.0, 0.01, CRYSTAL_GEOMETRY_LAUE, CRYSTAL_POLARIZATION_SIGMA, 1.0, delta_theta, 4001, R, &error);
+		assert(rv == 1);
+		assert(error == NULL);
+		integral = 0.0;
+		for (j = 0 ; j < 4001 ; j++) {
+			assert(R[j] >= 0.0 && R[j] <= 1.0);
+			integral += R[j] * 0.01 * width;
+		}
+		assert(fabs(integral / (M_PI * width / 4.0) - 1.0) < 0.05);
+
+		Crystal_Free(cs);
+	}
+
+	/* powder diffraction */
+	{
+		const int expected_miller[8][4] = {{1, 1, 1, 8}, {2, 2, 0, 12}, {3, 1, 1, 24}, {4, 0, 0, 6}, {3, 3, 1, 24}, {4, 2, 2, 24}, {5, 1, 1, 24}, {3, 3, 3, 8}};
+		Crystal_PowderReflection *reflections;
+		double two_theta[6001], profile[6001], total, integral, lp, theta, F2_000;
+		int n_reflections, j, h, k, l, n_expected;
+
+		cs = Crystal_GetCrystal("Si", NULL, &error);
+		assert(cs != NULL);
+
+		/* 200 is forbidden by the glide planes, 222 by the positions of the atoms; 333 and 511 are not equivalent, even though they share their d-spacing */
+		reflections = Crystal_PowderReflections(cs, 8.048, 1.0, 1.0, &n_reflections, &error);
+		assert(reflections != NULL);
+		assert(error == NULL);
+		assert(n_reflections == 8);
+		total = 0.0;
+		for (j = 0 ; j < n_reflections ; j++) {
+			assert(reflections[j].h == expected_miller[j][0]);
+			assert(reflections[j].k == expected_miller[j][1]);
+			assert(reflections[j].l == expected_miller[j][2]);
+			assert(reflections[j].multiplicity == expected_miller[j][3]);
+			assert(fabs(reflections[j].d_spacing - Crystal_dSpacing(cs, reflections[j].h, reflections[j].k, reflections[j].l, NULL)) < 1E-12);
+			assert(fabs(reflections[j].two_theta - 2.0 * Bragg_angle(cs, 8.048, reflections[j].h, reflections[j].k, reflections[j].l, NULL)) < 1E-12);
+			xrlCplx_1 = Crystal_F_H_StructureFactor(cs, 8.048, reflections[j].h, reflections[j].k, reflections[j].l, 1.0, 1.0, NULL);
+			assert(fabs(reflections[j].F2 / (xrlCplx_1.re * xrlCplx_1.re + xrlCplx_1.im * xrlCplx_1.im) - 1.0) < 1E-3);
+			theta = reflections[j].two_theta / 2.0;
+			lp = (1.0 + cos(2.0 * theta) * cos(2.0 * theta)) / (sin(theta) * sin(theta) * cos(theta));
+			assert(fabs(reflections[j].intensity - reflections[j].multiplicity * reflections[j].F2 * lp) < 1E-9 * reflections[j].intensity);
+			if (j > 0)
+				assert(reflections[j].two_theta > reflections[j - 1].two_theta - 1E-9);
+			total += reflections[j].intensity;
+		}
+
+		/* the peaks have unit area */
+		for (j = 0 ; j < 6001 ; j++)
+			two_theta[j] = j * M_PI / 6000.0;
+		rv = Crystal_PowderProfile(reflections, n_reflections, 0.002, 0.0, two_theta, 6001, profile, &error);
+		assert(rv == 1);
+		assert(error == NULL);
+		integral = 0.0;
+		for (j = 0 ; j < 6001 ; j++)
+			integral += profile[j] * M_PI / 6000.0;
+		assert(fabs(integral / total - 1.0) < 1E-6);
+
+		rv = Crystal_PowderProfile(reflections, n_reflections, 0.002, 0.5, two_theta, 6001, profile, &error);
+		assert(rv == 1);
+		assert(error == NULL);
+		integral = 0.0;
+		for (j = 0 ; j < 6001 ; j++)
+			integral += profile[j] * M_PI / 6000.0;
+		assert(fabs(integral / total - 1.0) < 0.01);
+
+		/* bad input */
+		rv = Crystal_PowderProfile(reflections, n_reflections, 0.0, 0.5, two_theta, 6001, profile, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		xrl_clear_error(&error);
+
+		rv = Crystal_PowderProfile(reflections, n_reflections, 0.002, 1.5, two_theta, 6001, profile, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		xrl_clear_error(&error);
+
+		two_theta[10] = 5.0;
+		rv = Crystal_PowderProfile(reflections, n_reflections, 0.002, 0.5, two_theta, 6001, profile, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		xrl_clear_error(&error);
+
+		rv = Crystal_PowderProfile(NULL, n_reflections, 0.002, 0.5, two_theta, 6001, profile, &error);
+		assert(rv == 0);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, NULL_ARRAY) == 0);
+		xrl_clear_error(&error);
+
+		xrlFree(reflections);
+
+		/* the wavelength limits the number of reflections */
+		reflections = Crystal_PowderReflections(cs, 1.9, 0.1, 1.0, &n_reflections, &error);
+		assert(reflections != NULL);
+		assert(error == NULL);
+		assert(n_reflections == 0);
+		xrlFree(reflections);
+
+		reflections = Crystal_PowderReflections(cs, 8.048, 0.0, 1.0, &n_reflections, &error);
+		assert(reflections == NULL);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, NEGATIVE_D_MIN) == 0);
+		xrl_clear_error(&error);
+
+		reflections = Crystal_PowderReflections(cs, -8.048, 1.0, 1.0, &n_reflections, &error);
+		assert(reflections == NULL);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, NEGATIVE_ENERGY) == 0);
+		xrl_clear_error(&error);
+
+		Crystal_Free(cs);
+
+		reflections = Crystal_PowderReflections(NULL, 8.048, 1.0, 1.0, &n_reflections, &error);
+		assert(reflections == NULL);
+		assert(error != NULL);
+		assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+		assert(strcmp(error->message, CRYSTAL_NULL) == 0);
+		xrl_clear_error(&error);
+
+		/* hexagonal close packed: 001 is forbidden by the screw axis, and the multiplicities add up to the number of reflections that are not absent */
+		cs = Crystal_GetCrystal("Titanium", NULL, &error);
+		assert(cs != NULL);
+		reflections = Crystal_PowderReflections(cs, 17.48, 0.9, 1.0, &n_reflections, &error);
+		assert(reflections != NULL);
+		assert(error == NULL);
+		assert(n_reflections == 16);
+		assert(reflections[0].h == 1 && reflections[0].k == 0 && reflections[0].l == 0 && reflections[0].multiplicity == 6);
+		assert(reflections[1].h == 0 && reflections[1].k == 0 && reflections[1].l == 2 && reflections[1].multiplicity == 2);
+		assert(reflections[2].h == 1 && reflections[2].k == 0 && reflections[2].l == 1 && reflections[2].multiplicity == 12);
+		xrlCplx_1 = Crystal_F_H_StructureFactor(cs, 17.48, 0, 0, 0, 1.0, 1.0, NULL);
+		F2_000 = xrlCplx_1.re * xrlCplx_1.re + xrlCplx_1.im * xrlCplx_1.im;
+		n_expected = 0;
+		for (h = -4 ; h <= 4 ; h++)
+			for (k = -4 ; k <= 4 ; k++)
+				for (l = -6 ; l <= 6 ; l++) {
+					if ((h == 0 && k == 0 && l == 0) || Crystal_dSpacing(cs, h, k, l, NULL) < 0.9)
+						continue;
+					/* the coordinates of the atoms are rounded, so the absent reflections do not vanish exactly */
+					xrlCplx_1 = Crystal_F_H_StructureFactor(cs, 17.48, h, k, l, 1.0, 1.0, NULL);
+					if (xrlCplx_1.re * xrlCplx_1.re + xrlCplx_1.im * xrlCplx_1.im > 1E-6 * F2_000)
+						n_expected++;
+				}
+		for (j = 0 ; j < n_reflections ; j++)
+			n_expected -= reflections[j].multiplicity;
+		assert(n_expected == 0);
+		xrlFree(reflections);
+		Crystal_Free(cs);
+	}
+
 	return 0;
 }
@@ -0,0 +1,444 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <config.h>
+#include "xraylib.h"
+#include "xraylib-aux.h"
+#include "xraylib-error-private.h"
+#ifdef NDEBUG
+  #undef NDEBUG
+#endif
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define CRYSTALS_FILE "test-crystal_io.dat"
+#define BINARY_FILE "test-crystal_io.bin"
+#define CIF_FILE "test-crystal_io.cif"
+
+static const char *long_name = "Si_with_a_name_that_is_much_longer_than_the_twenty_characters_the_old_parser_supported";
+
+static void write_file(const char *file_name, const char *contents) {
+	FILE *fp = fopen(file_name, "wb");
+	assert(fp != NULL);
+	assert(fputs(contents, fp) >= 0);
+	assert(fclose(fp) == 0);
+}
+
+static void write_crystals_file(void) {
+	FILE *fp = fopen(CRYSTALS_FILE, "w");
+	int i;
+
+	assert(fp != NULL);
+	/* a comment line that is far longer than any line buffer used before */
+	fputs("#C ", fp);
+	for (i = 0; i < 10000; i++)
+		fputc('x', fp);
+	fputs("\n\n", fp);
+	fprintf(fp, "#S 14 %s\n", long_name);
+	fputs("#UCELL 5.43070 5.43070 5.43070 90.0000 90.0000 90.0000\n", fp);
+	fputs("#L  AtomicNumber  Fraction  X  Y  Z  Biso\n", fp);
+	fputs("14 1.0 0.0  0.0  0.0 0.45\n", fp);
+	fputs("14 1.0 0.0  0.5  0.5 0.45\n", fp);
+	fputs("14 1.0 0.5  0.0  0.5 0.45\n", fp);
+	fputs("14 1.0 0.5  0.5  0.0 0.45\n", fp);
+	fputs("\n", fp);
+	fputs("14 1.0 .25  .25  .25\n", fp);
+	fputs("14 1.0 .25  .75  .75\n", fp);
+	fputs("14 1.0 .75  .25  .75\n", fp);
+	fputs("14 1.0 .75  .75  .25\n", fp);
+	fputs("#S 3 LiF_test\n", fp);
+	fputs("#UCELL 4.0270 4.0270 4.0270 90.0000 90.0000 90.0000\n", fp);
+	fputs("#L  AtomicNumber  Fraction  X  Y  Z\n", fp);
+	/* no trailing newline on the last line */
+	fputs("3 1.0 0.0 0.0 0.0\n9 1.0 0.5 0.5 0.5", fp);
+	assert(fclose(fp) == 0);
+}
+
+static const char *cif_contents =
+	"# generated for the xraylib test suite\n"
+	"data_global\n"
+	"_publ_section_title\n"
+	";\n"
+	"A text field that mentions data_fake and loop_ without starting anything\n"
+	";\n"
+	"\n"
+	"data_Si_cif\n"
+	"_cell_length_a 5.43070(5)\n"
+	"_cell_length_b 5.43070(5)\n"
+	"_cell_length_c 5.43070(5)\n"
+	"_cell_angle_alpha 90\n"
+	"_cell_angle_beta 90\n"
+	"_CELL_ANGLE_GAMMA 90\n"
+	"_symmetry_space_group_name_H-M 'F d -3 m'\n"
+	"loop_\n"
+	"_symmetry_equiv_pos_site_id\n"
+	"_symmetry_equiv_pos_as_xyz\n"
+	"1 x,y,z\n"
+	"2 'x, y+1/2, z+1/2'\n"
+	"3 'x+1/2, y, z+1/2'\n"
+	"4 'x+1/2, y+1/2, z'\n"
+	"5 'x+1/4, y+1/4, z+1/4'\n"
+	"6 'x+1/4, y+3/4, z+3/4'\n"
+	"7 'x+3/4, y+1/4, z+3/4'\n"
+	"8 'x+3/4, y+3/4, z+1/4'\n"
+	"9 'x+1, y-1, z' # equivalent to the identity\n"
+	"loop_\n"
+	"_atom_site_label\n"
+	"_atom_site_type_symbol\n"
+	"_atom_site_fract_x\n"
+	"_atom_site_fract_y\n"
+	"_atom_site_fract_z\n"
+	"_atom_site_occupancy\n"
+	"Si1 Si 0.0 0.0 0.0 1.0\n"
+	"\n"
+	"data_NaCl_cif\n"
+	"_cell_length_a 5.6402\n"
+	"_cell_length_b 5.6402\n"
+	"_cell_length_c 5.6402\n"
+	"loop_\n"
+	"_space_group_symop_operation_xyz\n"
+	"'x,y,z' '-x,-y,-z' 'x,1/2+y,1/2+z' '1/2+x,y,1/2+z' '1/2+x,1/2+y,z'\n"
+	"loop_\n"
+	"_atom_site_label\n"
+	"_atom_site_fract_x\n"
+	"_atom_site_fract_y\n"
+	"_atom_site_fract_z\n"
+	"_atom_site_type_symbol\n"
+	"NA1 0 0 0 Na1+\n"
+	"CL1 0.5 0.5 0.5 Cl1-\n";
+
+static void test_read_file(void) {
+	xrl_error *error = NULL;
+	Crystal_Array *c_array;
+	Crystal_Struct *cs, *cs_builtin;
+	xrlComplex F_H, F_H_builtin;
+	int i;
+
+	write_crystals_file();
+
+	c_array = Crystal_ArrayInit(0, &error);
+	assert(c_array != NULL);
+	assert(Crystal_ReadFile(CRYSTALS_FILE, c_array, &error) == 1);
+	assert(error == NULL);
+	assert(c_array->n_crystal == 2);
+
+	/* sorted by name */
+	assert(strcmp(c_array->crystal[0].name, "LiF_test") == 0);
+	assert(c_array->crystal[0].n_atom == 2);
+	assert(c_array->crystal[0].atom[1].Zatom == 9);
+	assert(c_array->crystal[0].atom[1].z == 0.5);
+
+	cs = Crystal_GetCrystal(long_name, c_array, &error);
+	assert(cs != NULL);
+	assert(cs->n_atom == 8);
+	assert(fabs(cs->volume - pow(5.43070, 3)) < 1E-9);
+	assert(cs->atom[4].x == 0.25 && cs->atom[7].z == 0.25);
+	for (i = 0; i < 8; i++) {
+		assert(cs->atom[i].Zatom == 14);
+		assert(cs->atom[i].fraction == 1.0);
+	}
+
+	/* identical to the builtin Si */
+	cs_builtin = Crystal_GetCrystal("Si", NULL, &error);
+	assert(cs_builtin != NULL);
+	F_H = Crystal_F_H_StructureFactor(cs, 10.0, 1, 1, 1, 0.5, 1.0, &error);
+	F_H_builtin = Crystal_F_H_StructureFactor(cs_builtin, 10.0, 1, 1, 1, 0.5, 1.0, &error);
+	assert(fabs(F_H.re - F_H_builtin.re) < 1E-4);
+	assert(fabs(F_H.im - F_H_builtin.im) < 1E-4);
+	Crystal_Free(cs);
+	Crystal_Free(cs_builtin);
+	Crystal_ArrayFree(c_array);
+
+	/* errors */
+	c_array = Crystal_ArrayInit(0, NULL);
+
+	write_file(CRYSTALS_FILE, "#S 14 Si\n#L Z fraction x y z\n14 1.0 0.0 0.0 0.0\n");
+	assert(Crystal_ReadFile(CRYSTALS_FILE, c_array, &error) == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_IO);
+	assert(strcmp(error->message, "No #UCELL line found for crystal Si") == 0);
+	xrl_clear_error(&error);
+
+	write_file(CRYSTALS_FILE, "#S 14 Si\n#UCELL 5.4 5.4\n#L Z fraction x y z\n14 1.0 0.0 0.0 0.0\n");
+	assert(Crystal_ReadFile(CRYSTALS_FILE, c_array, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, "Malformed #UCELL line found for crystal Si") == 0);
+	xrl_clear_error(&error);
+
+	write_file(CRYSTALS_FILE, "#S 14 Si\n#UCELL 5.4 5.4 5.4 90 90 90\n#L Z fraction x y z\n14 1.0 0.0 0.0 0.0\n14 one 0.0 0.0 0.0\n");
+	assert(Crystal_ReadFile(CRYSTALS_FILE, c_array, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, "Could not parse atom position on line 1 for crystal Si") == 0);
+	xrl_clear_error(&error);
+
+	write_file(CRYSTALS_FILE, "#S 14 Si\n#UCELL 5.4 5.4 5.4 90 90 90\n#L Z fraction x y z\n");
+	assert(Crystal_ReadFile(CRYSTALS_FILE, c_array, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, "End of file encountered before definition was complete") == 0);
+	xrl_clear_error(&error);
+
+	write_file(CRYSTALS_FILE, "#S Si\n");
+	assert(Crystal_ReadFile(CRYSTALS_FILE, c_array, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, "Malformed '#S <num> <crystal_name>' construct") == 0);
+	xrl_clear_error(&error);
+
+	Crystal_ArrayFree(c_array);
+	remove(CRYSTALS_FILE);
+}
+
+static void test_binary(void) {
+	xrl_error *error = NULL;
+	Crystal_Array *c_array, *c_array_mapped;
+	Crystal_Struct *cs, *cs_mapped;
+	xrlComplex F_H, F_H_mapped;
+	char **crystals_list;
+	int i, nCrystals;
+
+	/* the official crystals */
+	assert(Crystal_ArrayWriteBinary(NULL, BINARY_FILE, &error) == 1);
+	assert(error == NULL);
+	c_array_mapped = Crystal_ArrayMapBinary(BINARY_FILE, &error);
+	assert(c_array_mapped != NULL);
+	assert(error == NULL);
+
+	crystals_list = Crystal_GetCrystalsList(NULL, &nCrystals, NULL);
+	assert(c_array_mapped->n_crystal == nCrystals);
+	for (i = 0; i < nCrystals; i++) {
+		cs = Crystal_GetCrystal(crystals_list[i], NULL, NULL);
+		cs_mapped = Crystal_GetCrystal(crystals_list[i], c_array_mapped, &error);
+		assert(cs_mapped != NULL);
+		assert(strcmp(cs->name, cs_mapped->name) == 0);
+		assert(cs->a == cs_mapped->a && cs->b == cs_mapped->b && cs->c == cs_mapped->c);
+		assert(cs->alpha == cs_mapped->alpha && cs->beta == cs_mapped->beta && cs->gamma == cs_mapped->gamma);
+		assert(cs->volume == cs_mapped->volume);
+		assert(cs->n_atom == cs_mapped->n_atom);
+		assert(memcmp(cs->atom, cs_mapped->atom, cs->n_atom * sizeof(Crystal_Atom)) == 0);
+		Crystal_Free(cs);
+		Crystal_Free(cs_mapped);
+		xrlFree(crystals_list[i]);
+	}
+	xrlFree(crystals_list);
+
+	/* the crystals of a mapped array can be used directly */
+	cs = Crystal_GetCrystalShared("Si", &error);
+	for (i = 0; i < c_array_mapped->n_crystal; i++) {
+		if (strcmp(c_array_mapped->crystal[i].name, "Si") == 0)
+			break;
+	}
+	assert(i < c_array_mapped->n_crystal);
+	F_H = Crystal_F_H_StructureFactor(cs, 10.0, 2, 2, 0, 0.5, 1.0, &error);
+	F_H_mapped = Crystal_F_H_StructureFactor(&c_array_mapped->crystal[i], 10.0, 2, 2, 0, 0.5, 1.0, &error);
+	assert(F_H.re == F_H_mapped.re && F_H.im == F_H_mapped.im);
+	Crystal_ArrayUnmapBinary(c_array_mapped);
+
+	/* a user array */
+	write_crystals_file();
+	c_array = Crystal_ArrayInit(0, NULL);
+	assert(Crystal_ReadFile(CRYSTALS_FILE, c_array, NULL) == 1);
+	assert(Crystal_ArrayWriteBinary(c_array, BINARY_FILE, &error) == 1);
+	c_array_mapped = Crystal_ArrayMapBinary(BINARY_FILE, &error);
+	assert(c_array_mapped != NULL);
+	assert(c_array_mapped->n_crystal == 2);
+	cs_mapped = Crystal_GetCrystal(long_name, c_array_mapped, &error);
+	assert(cs_mapped != NULL);
+	assert(cs_mapped->n_atom == 8);
+	assert(cs_mapped->atom[5].y == 0.75);
+
+	/* mapped arrays are read-only */
+	assert(c_array_mapped->mapped);
+	assert(Crystal_AddCrystal(cs_mapped, c_array_mapped, &error) == 0);
+	assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+	assert(strcmp(error->message, CRYSTAL_ARRAY_MAPPED) == 0);
+	xrl_clear_error(&error);
+	assert(Crystal_ReadFile(CRYSTALS_FILE, c_array_mapped, &error) == 0);
+	assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+	xrl_clear_error(&error);
+	assert(Crystal_ReadCIF(CIF_FILE, c_array_mapped, &error) == 0);
+	assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+	xrl_clear_error(&error);
+	assert(c_array_mapped->n_crystal == 2);
+	Crystal_Free(cs_mapped);
+	Crystal_ArrayUnmapBinary(c_array_mapped);
+
+	/* and Crystal_ArrayFree unmaps them */
+	c_array_mapped = Crystal_ArrayMapBinary(BINARY_FILE, &error);
+	assert(c_array_mapped != NULL);
+	Crystal_ArrayFree(c_array_mapped);
+	Crystal_ArrayFree(c_array);
+	Crystal_ArrayUnmapBinary(NULL);
+
+	/* errors */
+	assert(Crystal_ArrayMapBinary(CRYSTALS_FILE, &error) == NULL);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_IO);
+	assert(strcmp(error->message, CRYSTALS_FILE " is not a binary crystal library") == 0);
+	xrl_clear_error(&error);
+
+	/* truncated */
+	{
+		FILE *fp = fopen(BINARY_FILE, "rb");
+		char buffer[200];
+		size_t n;
+		assert(fp != NULL);
+		n = fread(buffer, 1, sizeof(buffer), fp);
+		assert(n == sizeof(buffer));
+		fclose(fp);
+		fp = fopen(BINARY_FILE, "wb");
+		assert(fp != NULL);
+		fwrite(buffer, 1, n, fp);
+		fclose(fp);
+	}
+	assert(Crystal_ArrayMapBinary(BINARY_FILE, &error) == NULL);
+	assert(error != NULL);
+	assert(strcmp(error->message, BINARY_FILE " is corrupt") == 0);
+	xrl_clear_error(&error);
+
+	remove(BINARY_FILE);
+	remove(CRYSTALS_FILE);
+
+	assert(Crystal_ArrayMapBinary(BINARY_FILE, &error) == NULL);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_IO);
+	xrl_clear_error(&error);
+
+	assert(Crystal_ArrayMapBinary(NULL, &error) == NULL);
+	assert(error != NULL);
+	assert(strcmp(error->message, "NULL filenames are not allowed") == 0);
+	xrl_clear_error(&error);
+
+	assert(Crystal_ArrayWriteBinary(NULL, NULL, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, "NULL filenames are not allowed") == 0);
+	xrl_clear_error(&error);
+}
+
+static void test_cif(void) {
+	xrl_error *error = NULL;
+	Crystal_Array *c_array;
+	Crystal_Struct *cs, *cs_builtin;
+	xrlComplex F_H, F_H_builtin;
+	int i;
+
+	write_file(CIF_FILE, cif_contents);
+
+	c_array = Crystal_ArrayInit(0, NULL);
+	assert(Crystal_ReadCIF(CIF_FILE, c_array, &error) == 1);
+	assert(error == NULL);
+	assert(c_array->n_crystal == 2);
+	assert(strcmp(c_array->crystal[0].name, "NaCl_cif") == 0);
+	assert(strcmp(c_array->crystal[1].name, "Si_cif") == 0);
+
+	/* the symmetry operators generate the diamond structure */
+	cs = &c_array->crystal[1];
+	assert(cs->n_atom == 8);
+	assert(fabs(cs->volume - pow(5.43070, 3)) < 1E-9);
+	assert(cs->alpha == 90.0 && cs->gamma == 90.0);
+	cs_builtin = Crystal_GetCrystal("Si", NULL, NULL);
+	for (i = 1; i < 5; i++) {
+		F_H = Crystal_F_H_StructureFactor(cs, 10.0, i, i, i % 2 ? i : 0, 0.5, 1.0, &error);
+		F_H_builtin = Crystal_F_H_StructureFactor(cs_builtin, 10.0, i, i, i % 2 ? i : 0, 0.5, 1.0, &error);
+		assert(fabs(F_H.re - F_H_builtin.re) < 1E-4);
+		assert(fabs(F_H.im - F_H_builtin.im) < 1E-4);
+	}
+	Crystal_Free(cs_builtin);
+
+	/* rock salt: the inversion generates no new positions, angles default to 90 degrees */
+	cs = &c_array->crystal[0];
+	assert(cs->n_atom == 8);
+	assert(cs->beta == 90.0);
+	for (i = 0; i < cs->n_atom; i++) {
+		assert(cs->atom[i].Zatom == (i < 4 ? 11 : 17));
+		assert(cs->atom[i].fraction == 1.0);
+		assert(cs->atom[i].x >= 0.0 && cs->atom[i].x < 1.0);
+	}
+	F_H = Crystal_F_H_StructureFactor(cs, 10.0, 1, 0, 0, 0.5, 1.0, &error);
+	assert(fabs(F_H.re) < 1E-10 && fabs(F_H.im) < 1E-10);
+
+	/* reading again overwrites */
+	assert(Crystal_ReadCIF(CIF_FILE, c_array, &error) == 1);
+	assert(c_array->n_crystal == 2);
+	Crystal_ArrayFree(c_array);
+
+	/* the official array */
+	assert(Crystal_ReadCIF(CIF_FILE, NULL, &error) == 1);
+	cs = Crystal_GetCrystal("NaCl_cif", NULL, &error);
+	assert(cs != NULL);
+	assert(cs->n_atom == 8);
+	Crystal_Free(cs);
+
+	/* errors */
+	c_array = Crystal_ArrayInit(0, NULL);
+
+	write_file(CIF_FILE, "data_empty\n_cell_length_a 5.0\n");
+	assert(Crystal_ReadCIF(CIF_FILE, c_array, &error) == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_IO);
+	assert(strcmp(error->message, "No crystal structures found in " CIF_FILE) == 0);
+	xrl_clear_error(&error);
+
+	write_file(CIF_FILE, "data_bad\n_cell_length_a 5.0\n_cell_length_b 5.0\n_cell_length_c 5.0\n_symmetry_equiv_pos_as_xyz 'x,y'\nloop_\n_atom_site_label\n_atom_site_fract_x\n_atom_site_fract_y\n_atom_site_fract_z\nC1 0 0 0\n");
+	assert(Crystal_ReadCIF(CIF_FILE, c_array, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, "Could not parse symmetry operator x,y in data block bad") == 0);
+	xrl_clear_error(&error);
+
+	write_file(CIF_FILE, "data_bad\n_cell_length_a 5.0\n_cell_length_b 5.0\nloop_\n_atom_site_label\n_atom_site_fract_x\n_atom_site_fract_y\n_atom_site_fract_z\nC1 0 0 0\n");
+	assert(Crystal_ReadCIF(CIF_FILE, c_array, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, "Incomplete unit cell in data block bad") == 0);
+	xrl_clear_error(&error);
+
+	write_file(CIF_FILE, "data_bad\n_cell_length_a 5.0\n_cell_length_b 5.0\n_cell_length_c 5.0\nloop_\n_atom_site_label\n_atom_site_fract_x\n_atom_site_fract_y\n_atom_site_fract_z\nXx1 0 0 0\n");
+	assert(Crystal_ReadCIF(CIF_FILE, c_array, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, "Unknown element Xx1 in data block bad") == 0);
+	xrl_clear_error(&error);
+
+	write_file(CIF_FILE, "data_bad\nloop_\n_atom_site_label\n_atom_site_fract_x\n_atom_site_fract_y\n_atom_site_fract_z\nC1 0 0\n");
+	assert(Crystal_ReadCIF(CIF_FILE, c_array, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, "Malformed loop in data block bad") == 0);
+	xrl_clear_error(&error);
+
+	write_file(CIF_FILE, "data_bad\n_publ_section_title\n;\nunterminated\n");
+	assert(Crystal_ReadCIF(CIF_FILE, c_array, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, "Unterminated text field in CIF file") == 0);
+	xrl_clear_error(&error);
+
+	assert(c_array->n_crystal == 0);
+	Crystal_ArrayFree(c_array);
+	remove(CIF_FILE);
+
+	assert(Crystal_ReadCIF(CIF_FILE, NULL, &error) == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_IO);
+	xrl_clear_error(&error);
+
+	assert(Crystal_ReadCIF(NULL, NULL, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, "NULL filenames are not allowed") == 0);
+	xrl_clear_error(&error);
+}
+
+int main(int argc, char **argv) {
+	test_read_file();
+	test_binary();
+	test_cif();
+
+	return 0;
+}
@@ -0,0 +1,224 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <config.h>
+#include "xraylib.h"
+#include "xraylib-fast.h"
+#include "xraylib-error-private.h"
+#include "xraylib-data-image-private.h"
+#ifdef NDEBUG
+  #undef NDEBUG
+#endif
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MODIFIED_FILE "test-data-image.img"
+#define N_VALUES 24
+
+/* at least one value from every table family */
+static void evaluate(double values[N_VALUES]) {
+	int i = 0;
+
+	values[i++] = AtomicWeight(26, NULL);
+	values[i++] = ElementDensity(79, NULL);
+	values[i++] = EdgeEnergy(82, L3_SHELL, NULL);
+	values[i++] = LineEnergy(29, KL3_LINE, NULL);
+	values[i++] = FluorYield(47, L2_SHELL, NULL);
+	values[i++] = JumpFactor(56, K_SHELL, NULL);
+	values[i++] = CosKronTransProb(74, FL13_TRANS, NULL);
+	values[i++] = RadRate(26, KL3_LINE, NULL);
+	values[i++] = AtomicLevelWidth(92, M5_SHELL, NULL);
+	values[i++] = CS_Photo(26, 10.0, NULL);
+	values[i++] = CS_Rayl(26, 10.0, NULL);
+	values[i++] = CS_Compt(26, 10.0, NULL);
+	values[i++] = CS_Energy(26, 10.0, NULL);
+	values[i++] = FF_Rayl(26, 1.0, NULL);
+	values[i++] = SF_Compt(26, 1.0, NULL);
+	values[i++] = Fi(29, 10.0, NULL);
+	values[i++] = Fii(29, 10.0, NULL);
+	values[i++] = CS_Photo_Total(82, 20.0, NULL);
+	values[i++] = CSb_Photo_Partial(82, L3_SHELL, 20.0, NULL);
+	values[i++] = ElectronConfig(82, M5_SHELL, NULL);
+	values[i++] = ComptonProfile(29, 1.0, NULL);
+	values[i++] = ComptonProfile_Partial(29, M5_SHELL, 1.0, NULL);
+	values[i++] = AugerRate(50, K_L1L1_AUGER, NULL);
+	values[i++] = CS_FluorLine_Kissel_Cascade(82, LA1_LINE, 30.0, NULL);
+	assert(i == N_VALUES);
+}
+
+static char* read_image(size_t *size) {
+	FILE *fp = fopen(XRL_DATA_IMAGE, "rb");
+	char *data;
+
+	assert(fp != NULL);
+	assert(fseek(fp, 0, SEEK_END) == 0);
+	*size = ftell(fp);
+	assert(fseek(fp, 0, SEEK_SET) == 0);
+	data = malloc(*size);
+	assert(data != NULL);
+	assert(fread(data, 1, *size, fp) == *size);
+	fclose(fp);
+	return data;
+}
+
+static void write_image(const char *data, size_t size) {
+	FILE *fp = fopen(MODIFIED_FILE, "wb");
+
+	assert(fp != NULL);
+	assert(fwrite(data, 1, size, fp) == size);
+	assert(fclose(fp) == 0);
+}
+
+int main(int argc, char **argv) {
+	xrl_error *error = NULL;
+	double builtin[N_VALUES], values[N_VALUES];
+	xrl_data_image_header *header;
+	xrl_data_image_table *tables;
+	double *atomic_weights = NULL;
+	char *data;
+	size_t size;
+	int i;
+
+	evaluate(builtin);
+
+	/* the image reproduces the compiled-in tables exactly */
+	assert(XRayLoadDataImage(XRL_DATA_IMAGE, &error) == 1);
+	assert(error == NULL);
+	evaluate(values);
+	for (i = 0 ; i < N_VALUES ; i++)
+		assert(values[i] == builtin[i]);
+
+	/* sections can be paged in and dropped without affecting the results */
+	assert(XRayPreloadDataSections(XRL_DATA_SECTION_ALL, &error) == 1);
+	assert(error == NULL);
+	evaluate(values);
+	for (i = 0 ; i < N_VALUES ; i++)
+		assert(values[i] == builtin[i]);
+	XRayReleaseDataSections(XRL_DATA_SECTION_ALL);
+	evaluate(values);
+	for (i = 0 ; i < N_VALUES ; i++)
+		assert(values[i] == builtin[i]);
+	XRayReleaseDataSections(XRL_DATA_SECTION_CROSS_SECTIONS | XRL_DATA_SECTION_KISSEL);
+	assert(XRayPreloadDataSections(XRL_DATA_SECTION_KISSEL, &error) == 1);
+	evaluate(values);
+	for (i = 0 ; i < N_VALUES ; i++)
+		assert(values[i] == builtin[i]);
+
+	assert(XRayPreloadDataSections(XRL_DATA_SECTION_ALL + 1, &error) == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(error->message, INVALID_DATA_SECTIONS) == 0);
+	xrl_clear_error(&error);
+
+	/* loading it again replaces the mapping */
+	assert(XRayLoadDataImage(XRL_DATA_IMAGE, &error) == 1);
+	evaluate(values);
+	for (i = 0 ; i < N_VALUES ; i++)
+		assert(values[i] == builtin[i]);
+
+	XRayUnloadDataImage();
+	evaluate(values);
+	for (i = 0 ; i < N_VALUES ; i++)
+		assert(values[i] == builtin[i]);
+	/* unloading twice is harmless */
+	XRayUnloadDataImage();
+
+	/* without an image, preloading touches the compiled-in tables and releasing does nothing */
+	assert(XRayPreloadDataSections(XRL_DATA_SECTION_ALL, &error) == 1);
+	XRayReleaseDataSections(XRL_DATA_SECTION_ALL);
+	evaluate(values);
+	for (i = 0 ; i < N_VALUES ; i++)
+		assert(values[i] == builtin[i]);
+
+	/* swap in a modified dataset */
+	data = read_image(&size);
+	header = (xrl_data_image_header *) data;
+	tables = (xrl_data_image_table *) (header + 1);
+	for (i = 0 ; i < header->n_tables ; i++) {
+		if (strcmp(tables[i].name, "AtomicWeight_arr") == 0)
+			atomic_weights = (double *) (data + tables[i].offset);
+	}
+	assert(atomic_weights != NULL);
+	atomic_weights[26] = 56.0;
+	write_image(data, size);
+	assert(XRayLoadDataImage(MODIFIED_FILE, &error) == 1);
+	assert(AtomicWeight(26, NULL) == 56.0);
+	assert(AtomicWeight_unchecked(26) == 56.0);
+	XRayUnloadDataImage();
+	assert(AtomicWeight(26, NULL) == builtin[0]);
+	assert(AtomicWeight_unchecked(26) == builtin[0]);
+
+	/* bad images leave the current tables untouched */
+	assert(XRayLoadDataImage(NULL, &error) == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_IO);
+	xrl_clear_error(&error);
+
+	assert(XRayLoadDataImage("non-existent-file.img", &error) == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_IO);
+	xrl_clear_error(&error);
+
+	memcpy(header->magic, "XRLCRYS", 8);
+	write_image(data, size);
+	assert(XRayLoadDataImage(MODIFIED_FILE, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, MODIFIED_FILE " is not a xraylib data image") == 0);
+	xrl_clear_error(&error);
+	memcpy(header->magic, XRL_DATA_IMAGE_MAGIC, 8);
+
+	header->version++;
+	write_image(data, size);
+	assert(XRayLoadDataImage(MODIFIED_FILE, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, MODIFIED_FILE " was written by an incompatible version or platform") == 0);
+	xrl_clear_error(&error);
+	header->version--;
+
+	/* truncated */
+	write_image(data, size / 2);
+	assert(XRayLoadDataImage(MODIFIED_FILE, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, MODIFIED_FILE " is corrupt") == 0);
+	xrl_clear_error(&error);
+
+	/* inconsistent counts */
+	for (i = 0 ; i < header->n_tables ; i++) {
+		if (strcmp(tables[i].name, "NE_Photo") == 0)
+			((int *) (data + tables[i].offset))[26]++;
+	}
+	write_image(data, size);
+	assert(XRayLoadDataImage(MODIFIED_FILE, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, MODIFIED_FILE " is corrupt") == 0);
+	xrl_clear_error(&error);
+
+	/* missing table */
+	strcpy(tables[0].name, "Unknown_arr");
+	write_image(data, size);
+	assert(XRayLoadDataImage(MODIFIED_FILE, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, MODIFIED_FILE " is corrupt") == 0);
+	xrl_clear_error(&error);
+
+	evaluate(values);
+	for (i = 0 ; i < N_VALUES ; i++)
+		assert(values[i] == builtin[i]);
+
+	free(data);
+	remove(MODIFIED_FILE);
+
+	return 0;
+}
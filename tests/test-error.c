@@ -17,6 +17,7 @@ THIS SOFTWARE IS PROVIDED BY Tom Schoonjans 'AS IS' AND ANY EXPRESS OR IMPLIED W
 #endif
 #include <assert.h>
 #include <string.h>
+#include <stdio.h>
 
 static void test_literal(void) {
 	xrl_error *error = NULL;
@@ -40,10 +41,69 @@ static void test_copy(void) {
 	xrl_error_free(copy);
 }
 
+static void test_shared(void) {
+	xrl_error *error = NULL, *previous, *copy;
+	char buffer[32];
+
+	/* literal errors are allocated once and shared afterwards */
+	xrl_set_error_literal(&error, XRL_ERROR_INVALID_ARGUMENT, TOO_LOW_EXCITATION_ENERGY);
+	previous = error;
+	xrl_error_free(error);
+	error = NULL;
+	xrl_set_error_literal(&error, XRL_ERROR_INVALID_ARGUMENT, TOO_LOW_EXCITATION_ENERGY);
+	assert(error == previous);
+	assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+	assert(strcmp(error->message, TOO_LOW_EXCITATION_ENERGY) == 0);
+	xrl_clear_error(&error);
+	assert(error == NULL);
+
+	/* the code is part of the key */
+	xrl_set_error_literal(&error, XRL_ERROR_RUNTIME, TOO_LOW_EXCITATION_ENERGY);
+	assert(error != previous);
+	assert(xrl_error_matches(error, XRL_ERROR_RUNTIME));
+	xrl_clear_error(&error);
+
+	/* so is the contents of the message, not its address */
+	strcpy(buffer, "first message");
+	xrl_set_error_literal(&error, XRL_ERROR_IO, buffer);
+	previous = error;
+	error = NULL;
+	strcpy(buffer, "second message");
+	xrl_set_error_literal(&error, XRL_ERROR_IO, buffer);
+	assert(error != previous);
+	assert(strcmp(previous->message, "first message") == 0);
+	assert(strcmp(error->message, "second message") == 0);
+
+	/* copies are independent */
+	copy = xrl_error_copy(error);
+	assert(copy != error);
+	assert(strcmp(copy->message, "second message") == 0);
+	xrl_error_free(copy);
+	xrl_error_free(error);
+	xrl_error_free(previous);
+}
+
+static void test_many(void) {
+	xrl_error *error = NULL;
+	char buffer[32];
+	int i;
+
+	/* more messages than there is room for are allocated as usual */
+	for (i = 0 ; i < 1000 ; i++) {
+		sprintf(buffer, "message %d", i);
+		xrl_set_error_literal(&error, XRL_ERROR_IO, buffer);
+		assert(error != NULL);
+		assert(strcmp(error->message, buffer) == 0);
+		xrl_clear_error(&error);
+	}
+}
+
 int main(int argc, char *argv[]) {
 
 	test_literal();
 	test_copy();
+	test_shared();
+	test_many();
 
 	return 0;
 }
@@ -0,0 +1,65 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "xraylib.h"
+#include "xraylib-fast.h"
+#ifdef NDEBUG
+  #undef NDEBUG
+#endif
+#include <assert.h>
+#include <stddef.h>
+
+/* the lines whose energy LineEnergy derives from other lines */
+static int is_derived_line(int line) {
+	static const int derived_lines[] = {KO_LINE, KP_LINE, L1N67_LINE, L1O45_LINE, L1P23_LINE, L2P23_LINE, L3O45_LINE, L3P23_LINE, L3P45_LINE};
+	size_t i;
+
+	for (i = 0 ; i < sizeof(derived_lines)/sizeof(derived_lines[0]) ; i++)
+		if (derived_lines[i] == line)
+			return 1;
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	int Z, i;
+
+	/* the unchecked accessors agree with the checked functions for all valid arguments, including missing data */
+	for (Z = 1 ; Z <= ZMAX ; Z++) {
+		assert(AtomicWeight_unchecked(Z) == AtomicWeight(Z, NULL));
+		assert(ElementDensity_unchecked(Z) == ElementDensity(Z, NULL));
+		for (i = K_SHELL ; i < SHELLNUM ; i++) {
+			assert(EdgeEnergy_unchecked(Z, i) == EdgeEnergy(Z, i, NULL));
+			assert(FluorYield_unchecked(Z, i) == FluorYield(Z, i, NULL));
+			assert(JumpFactor_unchecked(Z, i) == JumpFactor(Z, i, NULL));
+			assert(AtomicLevelWidth_unchecked(Z, i) == AtomicLevelWidth(Z, i, NULL));
+		}
+		for (i = -1 ; i >= -LINENUM ; i--) {
+			assert(RadRate_unchecked(Z, i) == RadRate(Z, i, NULL));
+			if (!is_derived_line(i))
+				assert(LineEnergy_unchecked(Z, i) == LineEnergy(Z, i, NULL));
+		}
+		for (i = FL12_TRANS ; i < TRANSNUM ; i++)
+			assert(CosKronTransProb_unchecked(Z, i) == CosKronTransProb(Z, i, NULL));
+		for (i = K_L1L1_AUGER ; i <= M4_M5Q3_AUGER ; i++)
+			assert(AugerRate_unchecked(Z, i) == AugerRate(Z, i, NULL));
+	}
+
+	/* a few known values */
+	assert(AtomicWeight_unchecked(26) > 55.8 && AtomicWeight_unchecked(26) < 55.9);
+	assert(EdgeEnergy_unchecked(26, K_SHELL) > 7.1 && EdgeEnergy_unchecked(26, K_SHELL) < 7.12);
+	assert(RadRate_unchecked(26, KL3_LINE) > 0.5);
+	assert(LineEnergy_unchecked(26, KL3_LINE) > 6.40 && LineEnergy_unchecked(26, KL3_LINE) < 6.41);
+
+	return 0;
+}
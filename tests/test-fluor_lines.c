@@ -182,5 +182,38 @@ int main(int argc, char **argv) {
 	assert(fabs(line_energy - LineEnergy(82, KP1_LINE, NULL)) < 1E-6);
 	assert(error == NULL);
 
+	/* composed lines lie between the energies of their own components: L3P23_LINE used to return the energy of L3O45_LINE */
+	{
+		int composed[][3] = {
+			{L1N67_LINE, L1N6_LINE, L1N7_LINE},
+			{L1O45_LINE, L1O4_LINE, L1O5_LINE},
+			{L1P23_LINE, L1P2_LINE, L1P3_LINE},
+			{L2P23_LINE, L2P2_LINE, L2P3_LINE},
+			{L3O45_LINE, L3O4_LINE, L3O5_LINE},
+			{L3P23_LINE, L3P2_LINE, L3P3_LINE},
+			{L3P45_LINE, L3P4_LINE, L3P5_LINE},
+		};
+		int i, Z, n = 0;
+
+		for (i = 0 ; i < sizeof(composed) / sizeof(composed[0]) ; i++) {
+			for (Z = 1 ; Z <= ZMAX ; Z++) {
+				double energy1 = LineEnergy(Z, composed[i][1], NULL);
+				double energy2 = LineEnergy(Z, composed[i][2], NULL);
+				if (energy1 == 0.0 || energy2 == 0.0)
+					continue;
+				line_energy = LineEnergy(Z, composed[i][0], &error);
+				assert(error == NULL);
+				assert(line_energy >= (energy1 < energy2 ? energy1 : energy2) - 1E-9);
+				assert(line_energy <= (energy1 < energy2 ? energy2 : energy1) + 1E-9);
+				n++;
+			}
+		}
+		assert(n > 0);
+
+		line_energy = LineEnergy(92, L3P23_LINE, &error);
+		assert(error == NULL);
+		assert(fabs(line_energy - LineEnergy(92, L3O45_LINE, NULL)) > 0.05);
+	}
+
 	return 0;
 }
@@ -0,0 +1,166 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "xraylib.h"
+#include "xraylib-error-private.h"
+#ifdef NDEBUG
+  #undef NDEBUG
+#endif
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#define N_THETA 300
+#define N_E 5
+
+int main(int argc, char **argv) {
+	xrl_error *error = NULL;
+	xrlLayer substrate[1] = {{"Si", 2.33, 0.0, 0.0}};
+	xrlLayer same[2] = {{"Si", 2.33, 100E-7, 0.0}, {"Si", 2.33, 0.0, 0.0}};
+	xrlLayer film[2] = {{"Au", 19.3, 30E-7, 0.0}, {"Si", 2.33, 0.0, 0.0}};
+	xrlLayer rough[2] = {{"Au", 19.3, 30E-7, 0.5E-7}, {"Si", 2.33, 0.0, 0.5E-7}};
+	xrlLayer mirror[41];
+	xrlOpticalConstants constants[1];
+	double energies[N_E] = {5.0, 8.048, 12.0, 17.479, 30.0};
+	double theta[N_THETA], R[N_E * N_THETA], R_single[N_THETA], R_other[N_E * N_THETA];
+	int i, j, n_extrema;
+
+	for (j = 0 ; j < N_THETA ; j++)
+		theta[j] = j * 2E-4;
+
+	/* a bare substrate reduces to the Fresnel reflectivity */
+	assert(Multilayer_Reflectivity(substrate, 1, energies, N_E, theta, N_THETA, R, &error) == 1);
+	assert(error == NULL);
+	for (i = 0 ; i < N_E ; i++) {
+		for (j = 0 ; j < N_THETA ; j++) {
+			assert(Refractive_Index_Batch("Si", &energies[i], 1, 2.33, theta[j], constants, NULL) == 1);
+			assert(fabs(R[i * N_THETA + j] - constants[0].reflectivity) < 1E-8 * constants[0].reflectivity + 1E-15);
+		}
+		/* everything is reflected at zero grazing angle */
+		assert(fabs(R[i * N_THETA] - 1.0) < 1E-12);
+	}
+
+	/* an interface between identical materials is invisible */
+	assert(Multilayer_Reflectivity(same, 2, energies, N_E, theta, N_THETA, R_other, &error) == 1);
+	for (i = 0 ; i < N_E * N_THETA ; i++)
+		assert(fabs(R_other[i] - R[i]) < 1E-10 * R[i] + 1E-15);
+
+	/* a thin film produces Kiessig fringes above its critical angle, spaced by about lambda / (2 d) */
+	assert(Multilayer_Reflectivity(film, 2, energies, N_E, theta, N_THETA, R, &error) == 1);
+	for (i = 0 ; i < N_E * N_THETA ; i++)
+		assert(R[i] >= 0.0 && R[i] <= 1.0);
+	n_extrema = 0;
+	for (j = 1 ; j < N_THETA - 1 ; j++) {
+		if (theta[j] < 0.01)
+			continue;
+		if ((R[N_THETA + j] - R[N_THETA + j - 1]) * (R[N_THETA + j + 1] - R[N_THETA + j]) < 0.0)
+			n_extrema++;
+	}
+	/* 8.048 keV, 30 nm: fringe period of 2.6 mrad over the 50 mrad above 10 mrad */
+	assert(n_extrema >= 30 && n_extrema <= 45);
+
+	/* roughness damps the reflectivity away from total reflection */
+	assert(Multilayer_Reflectivity(rough, 2, energies, N_E, theta, N_THETA, R_other, &error) == 1);
+	for (i = 0 ; i < N_E ; i++) {
+		assert(fabs(R_other[i * N_THETA] - 1.0) < 1E-12);
+		for (j = 100 ; j < N_THETA ; j++)
+			assert(R_other[i * N_THETA + j] < R[i * N_THETA + j]);
+	}
+
+	/* computing all energies at once matches computing them one by one */
+	for (i = 0 ; i < 40 ; i += 2) {
+		mirror[i].material = "W";
+		mirror[i].density = 19.3;
+		mirror[i].thickness = 1.2E-7;
+		mirror[i].roughness = 0.3E-7;
+		mirror[i + 1].material = "Si";
+		mirror[i + 1].density = 2.33;
+		mirror[i + 1].thickness = 2.8E-7;
+		mirror[i + 1].roughness = 0.3E-7;
+	}
+	mirror[40] = substrate[0];
+	assert(Multilayer_Reflectivity(mirror, 41, energies, N_E, theta, N_THETA, R, &error) == 1);
+	for (i = 0 ; i < N_E ; i++) {
+		assert(Multilayer_Reflectivity(mirror, 41, &energies[i], 1, theta, N_THETA, R_single, &error) == 1);
+		for (j = 0 ; j < N_THETA ; j++)
+			assert(R_single[j] == R[i * N_THETA + j]);
+	}
+	/* the first Bragg peak of the 4 nm period at 8.048 keV lies near 19.7 mrad and stands out from its surroundings */
+	assert(R[N_THETA + 99] > 10.0 * R[N_THETA + 80]);
+	assert(R[N_THETA + 99] > 10.0 * R[N_THETA + 120]);
+
+	/* bad input */
+	assert(Multilayer_Reflectivity(NULL, 1, energies, N_E, theta, N_THETA, R, &error) == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(error->message, NULL_ARRAY) == 0);
+	xrl_clear_error(&error);
+
+	assert(Multilayer_Reflectivity(film, 2, energies, N_E, theta, N_THETA, NULL, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, NULL_ARRAY) == 0);
+	xrl_clear_error(&error);
+
+	assert(Multilayer_Reflectivity(film, 0, energies, N_E, theta, N_THETA, R, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, INVALID_ARRAY_LENGTH) == 0);
+	xrl_clear_error(&error);
+
+	assert(Multilayer_Reflectivity(film, 2, energies, N_E, theta, 0, R, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, INVALID_ARRAY_LENGTH) == 0);
+	xrl_clear_error(&error);
+
+	film[0].thickness = 0.0;
+	assert(Multilayer_Reflectivity(film, 2, energies, N_E, theta, N_THETA, R, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, NEGATIVE_THICKNESS) == 0);
+	xrl_clear_error(&error);
+	film[0].thickness = 30E-7;
+
+	film[1].roughness = -1E-7;
+	assert(Multilayer_Reflectivity(film, 2, energies, N_E, theta, N_THETA, R, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, NEGATIVE_ROUGHNESS) == 0);
+	xrl_clear_error(&error);
+	film[1].roughness = 0.0;
+
+	theta[0] = -0.1;
+	assert(Multilayer_Reflectivity(film, 2, energies, N_E, theta, N_THETA, R, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, INVALID_GRAZING_ANGLE) == 0);
+	xrl_clear_error(&error);
+	theta[0] = 0.0;
+
+	film[0].material = "Auu";
+	assert(Multilayer_Reflectivity(film, 2, energies, N_E, theta, N_THETA, R, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, UNKNOWN_COMPOUND) == 0);
+	xrl_clear_error(&error);
+	film[0].material = "Au";
+
+	film[0].density = 0.0;
+	assert(Multilayer_Reflectivity(film, 2, energies, N_E, theta, N_THETA, R, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, NEGATIVE_DENSITY) == 0);
+	xrl_clear_error(&error);
+
+	energies[0] = 0.0;
+	assert(Multilayer_Reflectivity(substrate, 1, energies, N_E, theta, N_THETA, R, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, NEGATIVE_ENERGY) == 0);
+	xrl_clear_error(&error);
+
+	return 0;
+}
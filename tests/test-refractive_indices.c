@@ -25,6 +25,9 @@ int main(int argc, char **argv) {
 	xrl_error *error = NULL;
 	double re, im;
 	xrlComplex cplx;
+	double energies[200];
+	xrlOpticalConstants constants[200], constants_low[1], constants_high[1];
+	int i;
 
 	/* The refractive index funtions accept both chemical formulas and NIST catalog entries.
 	 * If the latter is used, it is possible to use the NIST density, if the density that gets passed is 0 or less
@@ -159,7 +162,82 @@ int main(int argc, char **argv) {
 	assert(strcmp(error->message, NEGATIVE_DENSITY) == 0);
 	xrl_clear_error(&error);
 
+	/* batched optical constants: sweep up, down and across the Au L3 edge */
+	for (i = 0 ; i < 200 ; i++) {
+		energies[i] = i < 100 ? 5.0 + i * 0.1 : 20.0 - (i - 100) * 0.15;
+	}
+	assert(Refractive_Index_Batch("Au", energies, 200, 19.3, 0.002, constants, &error) == 1);
+	assert(error == NULL);
+	for (i = 0 ; i < 200 ; i++) {
+		cplx = Refractive_Index("Au", energies[i], 19.3, NULL);
+		assert(fabs(1.0 - constants[i].delta - cplx.re) < 1E-14);
+		assert(fabs(constants[i].beta - cplx.im) < 1E-12 * cplx.im);
+		assert(fabs(constants[i].critical_angle - sqrt(2.0 * constants[i].delta)) < 1E-15);
+		assert(fabs(constants[i].attenuation_length * CS_Total_CP("Au", energies[i], NULL) * 19.3 - 1.0) < 1E-12);
+		assert(constants[i].reflectivity > 0.0 && constants[i].reflectivity < 1.0);
+	}
+
+	/* NIST compounds use their own density when the density is not positive */
+	assert(Refractive_Index_Batch("Air, Dry (near sea level)", energies, 10, 0.0, 0.0, constants, &error) == 1);
+	for (i = 0 ; i < 10 ; i++) {
+		assert(fabs(1.0 - constants[i].delta - Refractive_Index_Re("Air, Dry (near sea level)", energies[i], 0.0, NULL)) < 1E-15);
+		assert(constants[i].reflectivity == 1.0);
+	}
+
+	/* total external reflection below the critical angle, and a fast drop above it */
+	energies[0] = 8.048;
+	assert(Refractive_Index_Batch("Au", energies, 1, 19.3, 0.0, constants, &error) == 1);
+	assert(fabs(constants[0].critical_angle - 9.6E-3) < 0.3E-3);
+	assert(Refractive_Index_Batch("Au", energies, 1, 19.3, constants[0].critical_angle / 2.0, constants_low, &error) == 1);
+	assert(Refractive_Index_Batch("Au", energies, 1, 19.3, constants[0].critical_angle * 5.0, constants_high, &error) == 1);
+	assert(constants_low[0].reflectivity > 0.8);
+	assert(constants_high[0].reflectivity < 1E-3);
+	/* far above the critical angle R approaches (delta^2 + beta^2) / (4 sin^4 theta) */
+	assert(Refractive_Index_Batch("Au", energies, 1, 19.3, 0.2, constants_high, &error) == 1);
+	assert(fabs(constants_high[0].reflectivity / ((pow(constants[0].delta, 2) + pow(constants[0].beta, 2)) / (4 * pow(sin(0.2), 4))) - 1.0) < 1E-2);
+
+	assert(Refractive_Index_Batch("Au", NULL, 1, 19.3, 0.0, constants, &error) == 0);
+	assert(error != NULL);
+	assert(error->code == XRL_ERROR_INVALID_ARGUMENT);
+	assert(strcmp(error->message, NULL_ARRAY) == 0);
+	xrl_clear_error(&error);
+
+	assert(Refractive_Index_Batch("Au", energies, 1, 19.3, 0.0, NULL, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, NULL_ARRAY) == 0);
+	xrl_clear_error(&error);
+
+	assert(Refractive_Index_Batch("Au", energies, 0, 19.3, 0.0, constants, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, INVALID_ARRAY_LENGTH) == 0);
+	xrl_clear_error(&error);
+
+	assert(Refractive_Index_Batch("Au", energies, 1, 19.3, -0.1, constants, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, INVALID_GRAZING_ANGLE) == 0);
+	xrl_clear_error(&error);
+
+	assert(Refractive_Index_Batch("Auu", energies, 1, 19.3, 0.0, constants, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, UNKNOWN_COMPOUND) == 0);
+	xrl_clear_error(&error);
+
+	assert(Refractive_Index_Batch("Au", energies, 1, 0.0, 0.0, constants, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, NEGATIVE_DENSITY) == 0);
+	xrl_clear_error(&error);
+
+	energies[1] = -1.0;
+	assert(Refractive_Index_Batch("Au", energies, 2, 19.3, 0.0, constants, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, NEGATIVE_ENERGY) == 0);
+	xrl_clear_error(&error);
+
+	energies[1] = 1E6;
+	assert(Refractive_Index_Batch("Au", energies, 2, 19.3, 0.0, constants, &error) == 0);
+	assert(error != NULL);
+	assert(strcmp(error->message, SPLINT_X_TOO_HIGH) == 0);
+	xrl_clear_error(&error);
 
-	
 	return 0;
 }
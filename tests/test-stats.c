@@ -0,0 +1,152 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "xraylib.h"
+#ifdef NDEBUG
+  #undef NDEBUG
+#endif
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+
+static const xrl_stats_function* find_function(const xrl_stats *stats, const char *name) {
+	int i;
+
+	for (i = 0 ; i < stats->n_functions ; i++)
+		if (strcmp(stats->functions[i].name, name) == 0)
+			return &stats->functions[i];
+	return NULL;
+}
+
+static uint64_t histogram_sum(const xrl_stats_function *function) {
+	uint64_t sum = 0;
+	int i;
+
+	for (i = 0 ; i < XRL_STATS_HISTOGRAM_BUCKETS ; i++)
+		sum += function->histogram[i];
+	return sum;
+}
+
+int main(int argc, char **argv) {
+	xrl_error *error = NULL;
+	xrl_stats *stats;
+	const xrl_stats_function *function;
+	char *json;
+	int i;
+
+	if (!xrl_stats_enabled()) {
+		assert(xrl_stats_snapshot(&error) == NULL);
+		assert(xrl_error_matches(error, XRL_ERROR_UNSUPPORTED));
+		xrl_clear_error(&error);
+		assert(xrl_stats_reset(&error) == 0);
+		assert(xrl_error_matches(error, XRL_ERROR_UNSUPPORTED));
+		xrl_clear_error(&error);
+		assert(xrl_stats_set_timing(1, &error) == 0);
+		assert(xrl_error_matches(error, XRL_ERROR_UNSUPPORTED));
+		xrl_clear_error(&error);
+		assert(xrl_stats_get_timing() == 0);
+		assert(xrl_stats_to_json(NULL, &error) == NULL);
+		assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+		xrl_clear_error(&error);
+		return 0;
+	}
+
+	assert(xrl_stats_reset(&error) == 1);
+	assert(error == NULL);
+
+	for (i = 0 ; i < 100 ; i++)
+		assert(CS_Total(26, 10.0, NULL) > 0.0);
+	/* errors are counted even when the caller does not ask for them */
+	assert(CS_Total(0, 10.0, NULL) == 0.0);
+	/* a chemical formula, and a NIST compound that the parser fails on first */
+	assert(CS_Total_CP("H2O", 10.0, NULL) > 0.0);
+	assert(CS_Total_CP("Water, Liquid", 10.0, NULL) > 0.0);
+
+	stats = xrl_stats_snapshot(&error);
+	assert(stats != NULL);
+	assert(error == NULL);
+
+	function = find_function(stats, "CS_Total");
+	assert(function != NULL);
+	assert(function->calls == 105);
+	assert(function->internal_calls == 4);
+	assert(function->errors[XRL_ERROR_INVALID_ARGUMENT] == 1);
+	assert(function->errors[XRL_ERROR_MEMORY] == 0);
+	assert(function->timed_calls == 0);
+
+	function = find_function(stats, "CS_Photo");
+	assert(function != NULL);
+	assert(function->calls == 104);
+	assert(function->internal_calls == 104);
+	assert(function->errors[XRL_ERROR_INVALID_ARGUMENT] == 0);
+
+	function = find_function(stats, "CS_Total_CP");
+	assert(function != NULL);
+	assert(function->calls == 2);
+	assert(function->internal_calls == 0);
+
+	function = find_function(stats, "CompoundParser");
+	assert(function != NULL);
+	assert(function->calls == 2);
+	assert(function->internal_calls == 2);
+	assert(function->errors[XRL_ERROR_INVALID_ARGUMENT] == 1);
+
+	assert(stats->compound_parses == 2);
+	assert(stats->nist_lookups == 1);
+	assert(stats->errors[XRL_ERROR_INVALID_ARGUMENT] == 2);
+
+	json = xrl_stats_to_json(stats, &error);
+	assert(json != NULL);
+	assert(error == NULL);
+	assert(strstr(json, "{\"name\": \"CS_Total\", \"calls\": 105, \"internal_calls\": 4, \"errors\": {\"memory\": 0, \"invalid_argument\": 1,") != NULL);
+	assert(strstr(json, "\"compound_parses\": 2") != NULL);
+	assert(strstr(json, "\"nist_lookups\": 1") != NULL);
+	xrlFree(json);
+	xrl_stats_free(stats);
+
+	/* timing */
+	assert(xrl_stats_set_timing(-1, &error) == 0);
+	assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+	xrl_clear_error(&error);
+	assert(xrl_stats_get_timing() == 0);
+
+	assert(xrl_stats_set_timing(2, &error) == 1);
+	assert(xrl_stats_get_timing() == 2);
+	for (i = 0 ; i < 10 ; i++)
+		assert(FF_Rayl(26, 1.0, NULL) > 0.0);
+	assert(xrl_stats_set_timing(0, NULL) == 1);
+	for (i = 0 ; i < 10 ; i++)
+		assert(FF_Rayl(26, 1.0, NULL) > 0.0);
+
+	stats = xrl_stats_snapshot(&error);
+	assert(stats != NULL);
+	function = find_function(stats, "FF_Rayl");
+	assert(function != NULL);
+	assert(function->calls == 20);
+	assert(function->timed_calls == 5);
+	assert(histogram_sum(function) == 5);
+	xrl_stats_free(stats);
+
+	/* a reset leaves the functions that were called, with all their counters at zero */
+	assert(xrl_stats_reset(NULL) == 1);
+	stats = xrl_stats_snapshot(&error);
+	assert(stats != NULL);
+	function = find_function(stats, "CS_Total");
+	assert(function != NULL);
+	assert(function->calls == 0);
+	assert(function->errors[XRL_ERROR_INVALID_ARGUMENT] == 0);
+	assert(stats->compound_parses == 0);
+	xrl_stats_free(stats);
+
+	return 0;
+}
@@ -0,0 +1,108 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "xraylib.h"
+#ifdef NDEBUG
+  #undef NDEBUG
+#endif
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+
+static int close_to(double a, double b) {
+	return fabs(a - b) <= 1E-6 * fabs(b);
+}
+
+int main(int argc, char **argv) {
+	xrl_error *error = NULL;
+	const double *data, *energies;
+	int rows, columns, length, n_energies, i;
+
+	/* fixed size tables */
+	assert(xrl_table_fixed("AtomicWeight_arr", &data, &rows, &columns, &error) == 1);
+	assert(error == NULL);
+	assert(rows == ZMAX + 1);
+	assert(columns == 1);
+	assert(data[26] == AtomicWeight(26, NULL));
+
+	assert(xrl_table_fixed("RadRate_arr", &data, &rows, &columns, &error) == 1);
+	assert(rows == ZMAX + 1);
+	assert(columns == LINENUM);
+	assert(data[26 * columns - KL3_LINE - 1] == RadRate(26, KL3_LINE, NULL));
+	assert(data[82 * columns - L3M5_LINE - 1] == RadRate(82, L3M5_LINE, NULL));
+
+	assert(xrl_table_fixed("xrf_cross_sections_constants_full", NULL, &rows, &columns, &error) == 1);
+	assert(columns == (M5_SHELL + 1) * (L3_SHELL + 1));
+
+	/* one array per element */
+	assert(xrl_table_element("E_Photo_arr", 26, &energies, &n_energies, &error) == 1);
+	assert(error == NULL);
+	assert(n_energies > 0);
+	assert(xrl_table_element("CS_Photo_arr", 26, &data, &length, &error) == 1);
+	assert(length == n_energies);
+	for (i = 0 ; i < length ; i += 10)
+		assert(close_to(exp(data[i]), CS_Photo(26, exp(energies[i]) / 1000.0, NULL)));
+
+	assert(xrl_table_element("q_Rayl_arr", 82, &energies, &n_energies, &error) == 1);
+	assert(xrl_table_element("FF_Rayl_arr", 82, &data, &length, &error) == 1);
+	assert(length == n_energies);
+	for (i = 1 ; i < length ; i += 10)
+		assert(close_to(data[i], FF_Rayl(82, energies[i], NULL)));
+
+	/* one array per element and shell */
+	assert(xrl_table_element_shell("E_Photo_Partial_Kissel", 26, K_SHELL, &energies, &n_energies, &error) == 1);
+	assert(xrl_table_element_shell("Photo_Partial_Kissel", 26, K_SHELL, &data, &length, &error) == 1);
+	assert(length == n_energies);
+	assert(length > 0);
+	/* the Kissel energies start below the edge */
+	for (i = 0 ; i < length ; i += 10) {
+		if (exp(energies[i]) > EdgeEnergy(26, K_SHELL, NULL))
+			assert(close_to(exp(data[i]), CSb_Photo_Partial(26, K_SHELL, exp(energies[i]), NULL)));
+	}
+
+	/* no data */
+	assert(xrl_table_element_shell("Photo_Partial_Kissel", 1, M5_SHELL, &data, &length, &error) == 1);
+	assert(error == NULL);
+	assert(data == NULL);
+	assert(length == 0);
+	assert(xrl_table_element_shell("Partial_ComptonProfiles", 1, M5_SHELL, &data, &length, &error) == 1);
+	assert(data == NULL);
+	assert(length == 0);
+	assert(xrl_table_element_shell("Partial_ComptonProfiles", 26, K_SHELL, &data, &length, &error) == 1);
+	assert(length > 0);
+
+	/* errors */
+	assert(xrl_table_fixed("NE_Photo", &data, &rows, &columns, &error) == 0);
+	assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+	xrl_clear_error(&error);
+	assert(xrl_table_fixed(NULL, &data, &rows, &columns, &error) == 0);
+	assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+	xrl_clear_error(&error);
+	assert(xrl_table_element("E_Photo_Partial_Kissel", 26, &data, &length, &error) == 0);
+	assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+	xrl_clear_error(&error);
+	assert(xrl_table_element("E_Photo_arr", 0, &data, &length, &error) == 0);
+	assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+	xrl_clear_error(&error);
+	assert(xrl_table_element("E_Photo_arr", ZMAX + 1, &data, &length, &error) == 0);
+	assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+	xrl_clear_error(&error);
+	assert(xrl_table_element_shell("Photo_Partial_Kissel", 26, SHELLNUM_K, &data, &length, &error) == 0);
+	assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+	xrl_clear_error(&error);
+	assert(xrl_table_element_shell("Partial_ComptonProfiles", 26, -1, &data, &length, &error) == 0);
+	assert(xrl_error_matches(error, XRL_ERROR_INVALID_ARGUMENT));
+	xrl_clear_error(&error);
+
+	return 0;
+}
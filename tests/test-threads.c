@@ -0,0 +1,405 @@
+/* Copyright (c) 2026, Tom Schoonjans
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * The names of the contributors may not be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY Tom Schoonjans ''AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL Tom Schoonjans BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+/*
+ * Concurrency stress test: every family of functions is evaluated from many threads at once,
+ * while other threads extend the official array of crystals and take statistics snapshots,
+ * and the results are compared with those of a single-threaded run.
+ * The threads are run again with a data image loaded, while some of them page its sections in and out.
+ * Configure with --enable-thread-sanitizer (or meson's -Db_sanitize=thread)
+ * to have ThreadSanitizer check for data races as well.
+ */
+
+#include "xraylib.h"
+#include "xraylib-error-private.h"
+#include "xraylib-stats.h"
+#ifdef NDEBUG
+  #undef NDEBUG
+#endif
+#include <assert.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#define N_THREADS 64
+#define N_ROUNDS 10
+/* one in every WRITER_STRIDE threads also adds crystals */
+#define WRITER_STRIDE 8
+#define MAX_RESULTS 20000
+#define CIF_FILE "test-threads.cif"
+
+#define ADD(value) do { assert(n < MAX_RESULTS); results[n++] = (value); } while (0)
+
+static const double energies[] = {1.5, 8.04778, 17.47934, 59.5409};
+#define N_ENERGIES (sizeof(energies) / sizeof(energies[0]))
+
+static const char *compounds[] = {"H2O", "SiO2", "Ca5(PO4)3F", "C6H12O6", "Fe2.5Ni0.5O4"};
+#define N_COMPOUNDS (sizeof(compounds) / sizeof(compounds[0]))
+
+static const char *cif_contents =
+	"data_Si_cif\n"
+	"_cell_length_a 5.43070\n"
+	"_cell_length_b 5.43070\n"
+	"_cell_length_c 5.43070\n"
+	"_cell_angle_alpha 90\n"
+	"_cell_angle_beta 90\n"
+	"_cell_angle_gamma 90\n"
+	"loop_\n"
+	"_symmetry_equiv_pos_as_xyz\n"
+	"x,y,z\n"
+	"'x, y+1/2, z+1/2'\n"
+	"'x+1/2, y, z+1/2'\n"
+	"'x+1/2, y+1/2, z'\n"
+	"'x+1/4, y+1/4, z+1/4'\n"
+	"'x+1/4, y+3/4, z+3/4'\n"
+	"'x+3/4, y+1/4, z+3/4'\n"
+	"'x+3/4, y+3/4, z+1/4'\n"
+	"loop_\n"
+	"_atom_site_type_symbol\n"
+	"_atom_site_fract_x\n"
+	"_atom_site_fract_y\n"
+	"_atom_site_fract_z\n"
+	"Si 0.0 0.0 0.0\n";
+
+static double *reference;
+static int n_reference;
+/* 0: compiled-in tables, 1: data image */
+static int phase;
+
+/* evaluates the same sequence of calls every time, returning the number of results */
+static int evaluate(double *results) {
+	xrl_error *error = NULL;
+	xrl_context *ctx;
+	struct compoundData *cd;
+	struct compoundDataNIST *cdn;
+	struct radioNuclideData *rnd;
+	Crystal_Struct *crystal;
+	Crystal_Array *c_array;
+	Crystal_Reflection *reflection;
+	Crystal_PowderReflection *powder;
+	xrlComplex z, F_H[4];
+	xrlOpticalConstants constants[N_ENERGIES];
+	xrlLayer layers[2] = {{"Au", 19.3, 30E-7, 0.0}, {"Si", 2.33, 0.0, 0.0}};
+	const int miller[] = {1, 1, 1, 2, 2, 0, 3, 1, 1, 4, 0, 0};
+	const double E_compt[] = {15.0, 16.0, 17.0, 18.0, 19.0};
+	const double delta_theta[3] = {-2E-5, 0.0, 2E-5};
+	const double E_rocking[3] = {8.0, 8.04778, 8.1};
+	double theta[3] = {1E-3, 5E-3, 1E-2}, R[5];
+	int Z, i, j, n_powder, n = 0;
+
+	/* atomic data */
+	for (Z = 1 ; Z <= 92 ; Z += 7) {
+		ADD(AtomicWeight(Z, NULL));
+		ADD(ElementDensity(Z, NULL));
+		ADD(LineEnergy(Z, KL3_LINE, NULL));
+		ADD(RadRate(Z, KL3_LINE, NULL));
+		ADD(CosKronTransProb(Z, FL13_TRANS, NULL));
+		ADD(AugerRate(Z, K_L1L1_AUGER, NULL));
+		ADD(ElectronConfig(Z, K_SHELL, NULL));
+		for (i = K_SHELL ; i <= M5_SHELL ; i++) {
+			ADD(EdgeEnergy(Z, i, NULL));
+			ADD(FluorYield(Z, i, NULL));
+			ADD(JumpFactor(Z, i, NULL));
+			ADD(AtomicLevelWidth(Z, i, NULL));
+			ADD(AugerYield(Z, i, NULL));
+			ADD(ComptonProfile_Partial(Z, i, 1.5, NULL));
+		}
+		ADD(ComptonProfile(Z, 1.5, NULL));
+	}
+
+	/* cross sections, scattering and anomalous scattering factors */
+	for (Z = 1 ; Z <= 92 ; Z += 7) {
+		for (i = 0 ; i < (int) N_ENERGIES ; i++) {
+			double E = energies[i];
+			ADD(CS_Total(Z, E, NULL));
+			ADD(CS_Photo(Z, E, NULL));
+			ADD(CS_Rayl(Z, E, NULL));
+			ADD(CS_Compt(Z, E, NULL));
+			ADD(CS_Energy(Z, E, NULL));
+			ADD(CSb_Total(Z, E, NULL));
+			ADD(DCS_Rayl(Z, E, 0.5, NULL));
+			ADD(DCSP_Compt(Z, E, 0.5, 1.0, NULL));
+			ADD(FF_Rayl(Z, MomentTransf(E, 0.5, NULL), NULL));
+			ADD(SF_Compt(Z, MomentTransf(E, 0.5, NULL), NULL));
+			ADD(Fi(Z, E, NULL));
+			ADD(Fii(Z, E, NULL));
+			ADD(CS_Photo_Partial(Z, K_SHELL, E, NULL));
+			ADD(CS_Total_Kissel(Z, E, NULL));
+			ADD(CS_FluorLine(Z, KL3_LINE, E, NULL));
+			ADD(CS_FluorLine_Kissel_Cascade(Z, L3M5_LINE, E, NULL));
+			ADD(CS_FluorShell_Kissel_Radiative_Cascade(Z, L2_SHELL, E, NULL));
+			ADD(CSb_FluorLine_Kissel_Nonradiative_Cascade(Z, KL2_LINE, E, NULL));
+		}
+	}
+	for (Z = 1 ; Z <= 92 ; Z += 13) {
+		assert(DDCS_Compt(Z, 20.0, 1.0, E_compt, 5, R, NULL) == 1);
+		for (i = 0 ; i < 5 ; i++)
+			ADD(R[i]);
+		assert(DDCSb_Compt(Z, 20.0, 1.0, E_compt, 5, R, NULL) == 1);
+		for (i = 0 ; i < 5 ; i++)
+			ADD(R[i]);
+	}
+	ADD(CS_KN(20.0, NULL));
+	ADD(DCSP_KN(20.0, 0.5, 1.0, NULL));
+	ADD(ComptonEnergy(20.0, 0.5, NULL));
+
+	/* evaluation contexts, which are owned by a single thread */
+	ctx = xrl_context_new(NULL);
+	assert(ctx != NULL);
+	for (j = 0 ; j < 2 ; j++) {
+		assert(xrl_context_set_interpolation(ctx, j == 0 ? XRL_INTERPOLATION_SPLINE : XRL_INTERPOLATION_LINEAR, NULL) == 1);
+		for (Z = 1 ; Z <= 92 ; Z += 7) {
+			for (i = 0 ; i < (int) N_ENERGIES ; i++) {
+				ADD(CS_Total_ctx(ctx, Z, energies[i]));
+				ADD(Fi_ctx(ctx, Z, energies[i]));
+			}
+		}
+	}
+	xrl_context_free(ctx);
+
+	/* compounds, which go through the parser */
+	for (j = 0 ; j < (int) N_COMPOUNDS ; j++) {
+		cd = CompoundParser(compounds[j], NULL);
+		assert(cd != NULL);
+		ADD(cd->nAtomsAll);
+		ADD(cd->molarMass);
+		FreeCompoundData(cd);
+		for (i = 0 ; i < (int) N_ENERGIES ; i++) {
+			ADD(CS_Total_CP(compounds[j], energies[i], NULL));
+			ADD(CS_Energy_CP(compounds[j], energies[i], NULL));
+			ADD(Refractive_Index_Re(compounds[j], energies[i], 2.0, NULL));
+			ADD(Refractive_Index_Im(compounds[j], energies[i], 2.0, NULL));
+		}
+		assert(Refractive_Index_Batch(compounds[j], energies, (int) N_ENERGIES, 2.0, 5E-3, constants, NULL) == 1);
+		for (i = 0 ; i < (int) N_ENERGIES ; i++) {
+			ADD(constants[i].delta);
+			ADD(constants[i].beta);
+			ADD(constants[i].critical_angle);
+			ADD(constants[i].attenuation_length);
+			ADD(constants[i].reflectivity);
+		}
+		assert(DDCS_Compt_CP(compounds[j], 20.0, 1.0, E_compt, 5, R, NULL) == 1);
+		for (i = 0 ; i < 5 ; i++)
+			ADD(R[i]);
+	}
+	cdn = GetCompoundDataNISTByName("Water, Liquid", NULL);
+	assert(cdn != NULL);
+	ADD(cdn->density);
+	ADD(cdn->massFractions[0]);
+	FreeCompoundDataNIST(cdn);
+	rnd = GetRadioNuclideDataByName("55Fe", NULL);
+	assert(rnd != NULL);
+	ADD(rnd->XrayIntensities[0]);
+	FreeRadioNuclideData(rnd);
+	ADD(SymbolToAtomicNumber("Fe", NULL));
+
+	/* crystals from the official array */
+	crystal = Crystal_GetCrystalShared("Si", NULL);
+	assert(crystal != NULL);
+	ADD(Bragg_angle(crystal, 8.04778, 1, 1, 1, NULL));
+	z = Crystal_F_H_StructureFactor(crystal, 8.04778, 1, 1, 1, 1.0, 1.0, NULL);
+	ADD(z.re);
+	ADD(z.im);
+	assert(Crystal_F_H_StructureFactor_Batch(crystal, 8.04778, miller, 4, 1.0, 1.0, F_H, NULL) == 1);
+	for (i = 0 ; i < 4 ; i++) {
+		ADD(F_H[i].re);
+		ADD(F_H[i].im);
+	}
+	assert(Crystal_F_H_StructureFactor_Partial_Batch(crystal, 8.04778, miller, 4, 1.0, 1.0, 2, 0, 2, F_H, NULL) == 1);
+	for (i = 0 ; i < 4 ; i++) {
+		ADD(F_H[i].re);
+		ADD(F_H[i].im);
+	}
+	reflection = Crystal_Reflection_New(crystal, 2, 2, 0, 1.0, 1.0, NULL);
+	assert(reflection != NULL);
+	z = Crystal_Reflection_F_H(reflection, 8.04778, NULL);
+	ADD(z.re);
+	ADD(z.im);
+	assert(Crystal_Reflection_F_H_Batch(reflection, E_rocking, 3, F_H, NULL) == 1);
+	for (i = 0 ; i < 3 ; i++) {
+		ADD(F_H[i].re);
+		ADD(F_H[i].im);
+	}
+	Crystal_Reflection_Free(reflection);
+	ADD(Crystal_DarwinWidth(crystal, 8.04778, 1, 1, 1, 0.0, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0, NULL));
+	assert(Crystal_RockingCurve(crystal, 8.04778, 1, 1, 1, 0.0, 0.1, CRYSTAL_GEOMETRY_BRAGG, CRYSTAL_POLARIZATION_SIGMA, 1.0,
+		delta_theta, 3, R, NULL) == 1);
+	for (i = 0 ; i < 3 ; i++)
+		ADD(R[i]);
+	assert(Crystal_RockingCurve_Energy(crystal, E_rocking, 3, 1, 1, 1, Bragg_angle(crystal, 8.04778, 1, 1, 1, NULL),
+		0.0, 0.1, CRYSTAL_GEOMETRY_LAUE, CRYSTAL_POLARIZATION_PI, 1.0, R, NULL) == 1);
+	for (i = 0 ; i < 3 ; i++)
+		ADD(R[i]);
+	powder = Crystal_PowderReflections(crystal, 8.04778, 1.0, 1.0, &n_powder, NULL);
+	assert(powder != NULL);
+	ADD(n_powder);
+	for (i = 0 ; i < n_powder ; i++) {
+		ADD(powder[i].two_theta);
+		ADD(powder[i].intensity);
+	}
+	assert(Crystal_PowderProfile(powder, n_powder, 1E-2, 0.5, theta, 3, R, NULL) == 1);
+	for (i = 0 ; i < 3 ; i++)
+		ADD(R[i]);
+	xrlFree(powder);
+	crystal = Crystal_GetCrystal("LiF", NULL, NULL);
+	assert(crystal != NULL);
+	ADD(Crystal_dSpacing(crystal, 2, 0, 0, NULL));
+	Crystal_Free(crystal);
+
+	/* crystals read into a private array */
+	c_array = Crystal_ArrayInit(0, NULL);
+	assert(c_array != NULL);
+	assert(Crystal_ReadCIF(CIF_FILE, c_array, NULL) == 1);
+	assert(c_array->n_crystal == 1);
+	ADD(c_array->crystal[0].volume);
+	z = Crystal_F_H_StructureFactor(&c_array->crystal[0], 8.04778, 1, 1, 1, 1.0, 1.0, NULL);
+	ADD(z.re);
+	ADD(z.im);
+	Crystal_ArrayFree(c_array);
+
+	/* multilayers */
+	assert(Multilayer_Reflectivity(layers, 2, energies + 1, 1, theta, 3, R, NULL) == 1);
+	for (i = 0 ; i < 3 ; i++)
+		ADD(R[i]);
+
+	/* errors, which are shared between threads */
+	ADD(CS_Total(0, 10.0, &error));
+	assert(error != NULL && strcmp(error->message, Z_OUT_OF_RANGE) == 0);
+	xrl_clear_error(&error);
+	ADD(CS_FluorLine(26, KL3_LINE, 5.0, &error));
+	assert(error != NULL && strcmp(error->message, TOO_LOW_EXCITATION_ENERGY) == 0);
+	xrl_clear_error(&error);
+	assert(CompoundParser("Xx2", &error) == NULL);
+	assert(error != NULL && error->code == XRL_ERROR_INVALID_ARGUMENT);
+	xrl_clear_error(&error);
+
+	return n;
+}
+
+static void* thread_main(void *data) {
+	int id = (int) (size_t) data;
+	double *results = malloc(MAX_RESULTS * sizeof(double));
+	int round, i, n;
+
+	assert(results != NULL);
+
+	for (round = 0 ; round < N_ROUNDS ; round++) {
+		if (id % WRITER_STRIDE == 0) {
+			Crystal_Struct *crystal = Crystal_GetCrystal("Si", NULL, NULL);
+			char name[64];
+			assert(crystal != NULL);
+			sprintf(name, "Si_thread_%d_%d_%d", phase, id, round);
+			free(crystal->name);
+			crystal->name = name;
+			assert(Crystal_AddCrystal(crystal, NULL, NULL) == 1);
+			crystal->name = NULL;
+			Crystal_Free(crystal);
+		}
+		else if (id % WRITER_STRIDE == 1) {
+			/* counters keep changing, so only check that the snapshots are consistent */
+			xrl_stats *stats = xrl_stats_snapshot(NULL);
+			assert((stats != NULL) == xrl_stats_enabled());
+			if (stats != NULL) {
+				char *json = xrl_stats_to_json(stats, NULL);
+				assert(json != NULL);
+				xrlFree(json);
+				xrl_stats_free(stats);
+			}
+		}
+		else if (id % WRITER_STRIDE == 2 && phase == 1) {
+			if (round % 2 == 0)
+				XRayReleaseDataSections(XRL_DATA_SECTION_ALL);
+			else
+				assert(XRayPreloadDataSections(XRL_DATA_SECTION_ALL, NULL) == 1);
+		}
+
+		n = evaluate(results);
+		assert(n == n_reference);
+		for (i = 0 ; i < n ; i++)
+			assert(results[i] == reference[i]);
+	}
+
+	free(results);
+	return NULL;
+}
+
+/* the number of CS_Total calls counted so far, or 0 without statistics */
+static uint64_t cs_total_calls(void) {
+	xrl_stats *stats = xrl_stats_snapshot(NULL);
+	uint64_t calls = 0;
+	int i;
+
+	if (stats == NULL)
+		return 0;
+	for (i = 0 ; i < stats->n_functions ; i++)
+		if (strcmp(stats->functions[i].name, "CS_Total") == 0)
+			calls = stats->functions[i].calls;
+	xrl_stats_free(stats);
+	return calls;
+}
+
+static void run_threads(void) {
+	pthread_t threads[N_THREADS];
+	int i, round;
+
+	for (i = 0 ; i < N_THREADS ; i++)
+		assert(pthread_create(&threads[i], NULL, thread_main, (void *) (size_t) i) == 0);
+	for (i = 0 ; i < N_THREADS ; i++)
+		assert(pthread_join(threads[i], NULL) == 0);
+
+	/* all crystals added by the writers made it into the official array */
+	for (i = 0 ; i < N_THREADS ; i += WRITER_STRIDE) {
+		for (round = 0 ; round < N_ROUNDS ; round++) {
+			char name[64];
+			Crystal_Struct *crystal;
+			sprintf(name, "Si_thread_%d_%d_%d", phase, i, round);
+			crystal = Crystal_GetCrystalShared(name, NULL);
+			assert(crystal != NULL);
+			assert(crystal->a == Crystal_GetCrystalShared("Si", NULL)->a);
+		}
+	}
+}
+
+int main(int argc, char **argv) {
+	FILE *fp;
+	uint64_t calls_per_evaluation;
+
+	fp = fopen(CIF_FILE, "wb");
+	assert(fp != NULL);
+	assert(fputs(cif_contents, fp) >= 0);
+	assert(fclose(fp) == 0);
+
+	reference = malloc(MAX_RESULTS * sizeof(double));
+	assert(reference != NULL);
+	n_reference = evaluate(reference);
+	calls_per_evaluation = cs_total_calls();
+
+	run_threads();
+	/* the counts of the threads that exited are kept */
+	assert(cs_total_calls() == calls_per_evaluation * (1 + N_THREADS * N_ROUNDS));
+
+#ifdef XRL_DATA_IMAGE
+	/* the image holds the same tables, so the results do not change */
+	assert(XRayLoadDataImage(XRL_DATA_IMAGE, NULL) == 1);
+	phase = 1;
+	run_threads();
+	XRayUnloadDataImage();
+#endif
+
+	free(reference);
+	remove(CIF_FILE);
+
+	return 0;
+}